@@ -1,7 +1,10 @@
 package vlab.cs.ucsb.edu;
 
 import java.math.BigInteger;
+import java.nio.ByteBuffer;
+import java.util.HashSet;
 import java.util.Map;
+import java.util.Set;
 
 /**
  * ABC Java Interface
@@ -85,6 +88,11 @@ public class DriverProxy {
 	}
 
 	private long driverPointer;
+
+	/**
+	 * Model counter handles that are not released yet
+	 */
+	private final Set<Long> modelCounterHandles = new HashSet<Long>();
 	
 	static {
 		System.loadLibrary("abc");
@@ -120,6 +128,74 @@ public class DriverProxy {
 
 	public native boolean isSatisfiable(final String constraint);
 
+	/**
+	 * Incremental solving, constraints are added to the current assertion level and
+	 * automata of solved levels are kept until the level is popped
+	 */
+	public native void push(final int numLevels);
+
+	public native void pop(final int numLevels);
+
+	public native boolean isSatisfiableIncremental(final String constraint);
+
+	/**
+	 * Result of a query of a batch, counts are in the order of the bounds
+	 */
+	public static class BatchResult {
+		public final boolean isSatisfiable;
+		public final BigInteger[] intCounts;
+		public final BigInteger[] strCounts;
+
+		private BatchResult(final boolean isSatisfiable, final BigInteger[] intCounts, final BigInteger[] strCounts) {
+			this.isSatisfiable = isSatisfiable;
+			this.intCounts = intCounts;
+			this.strCounts = strCounts;
+		}
+	}
+
+	/**
+	 * Solves and counts all constraints in a single native call, equivalent queries are solved
+	 * once and a query that extends the commands of an earlier query is solved on top of it.
+	 * The driver is reset afterwards.
+	 */
+	public BatchResult[] solveBatch(final String[] constraints, final long[] intBounds, final long[] strBounds) {
+		final int[] encoded = solveBatchEncoded(constraints, intBounds, strBounds);
+		final BatchResult[] results = new BatchResult[constraints.length];
+		int position = 0;
+		for (int i = 0; i < constraints.length; ++i) {
+			final boolean isSatisfiable = encoded[position++] != 0;
+			final BigInteger[] intCounts = new BigInteger[intBounds.length];
+			for (int j = 0; j < intCounts.length; ++j) {
+				position = decodeLimbs(encoded, position, intCounts, j);
+			}
+			final BigInteger[] strCounts = new BigInteger[strBounds.length];
+			for (int j = 0; j < strCounts.length; ++j) {
+				position = decodeLimbs(encoded, position, strCounts, j);
+			}
+			results[i] = new BatchResult(isSatisfiable, intCounts, strCounts);
+		}
+		return results;
+	}
+
+	/**
+	 * Reads a limb count followed by 32 bit limbs, most significant limb first
+	 */
+	private static int decodeLimbs(final int[] encoded, int position, final BigInteger[] counts, final int index) {
+		final int numOfLimbs = encoded[position++];
+		final byte[] magnitude = new byte[4 * numOfLimbs];
+		for (int k = 0; k < numOfLimbs; ++k) {
+			final int limb = encoded[position++];
+			magnitude[4 * k] = (byte) (limb >>> 24);
+			magnitude[4 * k + 1] = (byte) (limb >>> 16);
+			magnitude[4 * k + 2] = (byte) (limb >>> 8);
+			magnitude[4 * k + 3] = (byte) limb;
+		}
+		counts[index] = new BigInteger(1, magnitude);
+		return position;
+	}
+
+	private native int[] solveBatchEncoded(final String[] constraints, final long[] intBounds, final long[] strBounds);
+
 	public native BigInteger countVariable(final String varName, final long bound);
 	
 	public native BigInteger countInts(final long bound);
@@ -127,6 +203,17 @@ public class DriverProxy {
 	public native BigInteger countStrs(final long bound);
 	
 	public native BigInteger count(final long intBound, final long strBound);
+
+	/**
+	 * Counts for all bounds in a single sweep, results are in the order of bounds
+	 */
+	public native BigInteger[] countVariableRange(final String varName, final long[] bounds);
+
+	public native BigInteger[] countIntsRange(final long[] bounds);
+
+	public native BigInteger[] countStrsRange(final long[] bounds);
+
+	public native BigInteger[] countRange(final long[] bounds);
 	
 	public native byte[] getModelCounterForVariable(final String varName);
 	
@@ -140,6 +227,110 @@ public class DriverProxy {
 
 	public native BigInteger count(final long intBound, final long strBound, final byte[] modelCounter);
 
+	/**
+	 * Model counters kept on the native side, counting with a handle does not copy or
+	 * deserialize the counter. Handles must be released with releaseModelCounterHandle.
+	 * A handle must only be used by one thread at a time, counting updates the caches of the
+	 * counter. Calls on a released or unknown handle throw IllegalStateException.
+	 */
+	public long getModelCounterHandle() {
+		return track(newModelCounterHandle());
+	}
+
+	public long getModelCounterHandleForVariable(final String varName) {
+		return track(newModelCounterHandleForVariable(varName));
+	}
+
+	/**
+	 * Loads a counter serialized by getModelCounter or serializeModelCounter from the remaining
+	 * bytes of a direct buffer without copying them
+	 */
+	public long loadModelCounterHandle(final ByteBuffer modelCounter) {
+		if (!modelCounter.isDirect()) {
+			throw new IllegalArgumentException("model counter buffer must be direct");
+		}
+		return track(loadModelCounterHandle(modelCounter, modelCounter.position(), modelCounter.remaining()));
+	}
+
+	/**
+	 * Direct buffer over the native serialized counter, it is valid until the handle is released
+	 * and must not be read afterwards
+	 */
+	public ByteBuffer serializeModelCounter(final long handle) {
+		return serializeModelCounterHandle(check(handle));
+	}
+
+	public BigInteger countIntsWithHandle(final long handle, final long bound) {
+		return countIntsWithModelCounterHandle(check(handle), bound);
+	}
+
+	public BigInteger countStrsWithHandle(final long handle, final long bound) {
+		return countStrsWithModelCounterHandle(check(handle), bound);
+	}
+
+	public BigInteger countWithHandle(final long handle, final long intBound, final long strBound) {
+		return countWithModelCounterHandle(check(handle), intBound, strBound);
+	}
+
+	public BigInteger[] countIntsRangeWithHandle(final long handle, final long[] bounds) {
+		return countIntsRangeWithModelCounterHandle(check(handle), bounds);
+	}
+
+	public BigInteger[] countStrsRangeWithHandle(final long handle, final long[] bounds) {
+		return countStrsRangeWithModelCounterHandle(check(handle), bounds);
+	}
+
+	public BigInteger[] countRangeWithHandle(final long handle, final long[] bounds) {
+		return countRangeWithModelCounterHandle(check(handle), bounds);
+	}
+
+	public void releaseModelCounterHandle(final long handle) {
+		synchronized (modelCounterHandles) {
+			if (!modelCounterHandles.remove(handle)) {
+				throw new IllegalStateException("model counter handle is released or unknown");
+			}
+		}
+		deleteModelCounterHandle(handle);
+	}
+
+	private long track(final long handle) {
+		synchronized (modelCounterHandles) {
+			modelCounterHandles.add(handle);
+		}
+		return handle;
+	}
+
+	private long check(final long handle) {
+		synchronized (modelCounterHandles) {
+			if (!modelCounterHandles.contains(handle)) {
+				throw new IllegalStateException("model counter handle is released or unknown");
+			}
+		}
+		return handle;
+	}
+
+	private native long newModelCounterHandle();
+
+	private native long newModelCounterHandleForVariable(final String varName);
+
+	private native long loadModelCounterHandle(final ByteBuffer modelCounter, final int position, final int length);
+
+	private native ByteBuffer serializeModelCounterHandle(final long handle);
+
+	private native BigInteger countIntsWithModelCounterHandle(final long handle, final long bound);
+
+	private native BigInteger countStrsWithModelCounterHandle(final long handle, final long bound);
+
+	private native BigInteger countWithModelCounterHandle(final long handle, final long intBound, final long strBound);
+
+	private native BigInteger[] countIntsRangeWithModelCounterHandle(final long handle, final long[] bounds);
+
+	private native BigInteger[] countStrsRangeWithModelCounterHandle(final long handle, final long[] bounds);
+
+	private native BigInteger[] countRangeWithModelCounterHandle(final long handle, final long[] bounds);
+
+	private native void deleteModelCounterHandle(final long handle);
+
 	public native void printResultAutomaton();
 
 	public native void printResultAutomaton(String filePath);
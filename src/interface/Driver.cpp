@@ -11,19 +11,29 @@ namespace Vlab {
 
 //const Log::Level Driver::TAG = Log::DRIVER;
 bool Driver::IS_LOGGING_INITIALIZED = false;
+std::unique_ptr<Solver::ResultCache> Driver::RESULT_CACHE = nullptr;
 
 Driver::Driver()
     : script_(nullptr),
       symbol_table_(nullptr),
       constraint_information_(nullptr),
-      is_model_counter_cached_ { false } {
+      is_model_counter_cached_ { false },
+      is_solve_skipped_ { false },
+      is_cached_sat_ { false },
+      options_(Option::Context::Current()) {
   bound_decrease_ = 0;
 }
 
 Driver::~Driver() {
-  delete symbol_table_;
-  delete script_;
-  delete constraint_information_;
+  SolverContext context(*this);
+  ClearCachedValues();
+  if (assertion_levels_.empty()) {
+    delete symbol_table_;
+    delete script_;
+    delete constraint_information_;
+  } else {
+    ClearAssertionLevels();
+  }
   Theory::Automaton::CleanUp();
 }
 
@@ -66,71 +76,96 @@ void Driver::ast2dot(std::string file_name) {
 }
 
 void Driver::InitializeSolver() {
+  SolverContext context(*this);
 
   symbol_table_ = new Solver::SymbolTable();
   constraint_information_ = new Solver::ConstraintInformation();
 
   Solver::Initializer initializer(script_, symbol_table_);
-  initializer.start();
+  Util::Profiler::TimePass("initializer", [&]() { initializer.start(); });
 
   std::string output_root {"./output"};
 
   Solver::SyntacticProcessor syntactic_processor(script_);
-  syntactic_processor.start();
+  Util::Profiler::TimePass("syntactic_processor", [&]() { syntactic_processor.start(); });
 
   // last parameter is if we try to optimized ite terms 
   Solver::SyntacticOptimizer syntactic_optimizer(script_, symbol_table_, not Option::Solver::ENABLE_EQUIVALENCE_CLASSES);
-  syntactic_optimizer.start();
+  Util::Profiler::TimePass("syntactic_optimizer", [&]() { syntactic_optimizer.start(); });
 
   int count = 0;
   if (Option::Solver::ENABLE_EQUIVALENCE_CLASSES) {
     Solver::EquivalenceGenerator equivalence_generator(script_, symbol_table_);
     do {
-      equivalence_generator.start();
+      Util::Profiler::TimePass("equivalence_generator", [&]() { equivalence_generator.start(); });
     } while (equivalence_generator.has_constant_substitution());
 
     // optimize ite now that equivalences have been propagated
     
     Solver::SyntacticOptimizer syntactic_optimizer2(script_, symbol_table_, true);
-    syntactic_optimizer2.start();
+    Util::Profiler::TimePass("syntactic_optimizer", [&]() { syntactic_optimizer2.start(); });
 
     Solver::EquivalenceGenerator equivalence_generator2(script_, symbol_table_);
     do {
-      equivalence_generator2.start();
+      Util::Profiler::TimePass("equivalence_generator", [&]() { equivalence_generator2.start(); });
     } while (equivalence_generator2.has_constant_substitution());
 
     Solver::SyntacticProcessor syntactic_processor2(script_);
-    syntactic_processor2.start();
+    Util::Profiler::TimePass("syntactic_processor", [&]() { syntactic_processor2.start(); });
   } else {
 
   }
 
   Solver::DependencySlicer dependency_slicer(script_, symbol_table_, constraint_information_);
-	dependency_slicer.start();
+  Util::Profiler::TimePass("dependency_slicer", [&]() { dependency_slicer.start(); });
 
   if (Option::Solver::ENABLE_IMPLICATIONS) {
     Solver::ImplicationRunner implication_runner(script_, symbol_table_, constraint_information_);
-    implication_runner.start();
+    Util::Profiler::TimePass("implication_runner", [&]() { implication_runner.start(); });
   }
 
   Solver::FormulaOptimizer formula_optimizer(script_, symbol_table_);
-  formula_optimizer.start();
+  Util::Profiler::TimePass("formula_optimizer", [&]() { formula_optimizer.start(); });
 
   if (Option::Solver::ENABLE_SORTING_HEURISTICS) {
     Solver::ConstraintSorter constraint_sorter(script_, symbol_table_);
-    constraint_sorter.start();
+    Util::Profiler::TimePass("constraint_sorter", [&]() { constraint_sorter.start(); });
   }
 
 }
 
 void Driver::Solve() {
-  Solver::ConstraintSolver constraint_solver(script_, symbol_table_, constraint_information_);
-  constraint_solver.start();
+  SolverContext context(*this);
   is_model_counter_cached_ = false;
   model_counter_ = Solver::ModelCounter();
+  is_solve_skipped_ = false;
+  result_cache_key_.clear();
+
+  auto result_cache = GetResultCache();
+  if (result_cache != nullptr) {
+    result_cache_key_ = GetResultCacheKey();
+    std::string result;
+    if (result_cache->Get(result_cache_key_, result)) {
+      LoadCachedResult(result);
+      DVLOG(1) << "result cache hit: " << Solver::ResultCache::Hash(result_cache_key_);
+      is_solve_skipped_ = true;
+      return;
+    }
+  }
+
+  Solver::ConstraintSolver constraint_solver(script_, symbol_table_, constraint_information_);
+  Util::Profiler::TimePass("constraint_solver", [&]() { constraint_solver.start(); });
+
+  if (result_cache != nullptr) {
+    CacheResult();
+  }
 }
 
 bool Driver::is_sat() {
+  SolverContext context(*this);
+  if (is_solve_skipped_) {
+    return is_cached_sat_;
+  }
   return symbol_table_->isSatisfiable();
 }
 
@@ -138,6 +173,7 @@ bool Driver::is_sat() {
  * TODO: Fix issue when bound is small and counting a single variable, tuple count to returns 0 but projected count is nonzero
  */
 Theory::BigInteger Driver::CountVariable(const std::string var_name, const unsigned long bound) {
+  CountingContext context(*this);
   Theory::BigInteger projected_count, tuple_count;
   tuple_count = GetModelCounterForVariable(var_name,false).Count(bound, bound);
   projected_count = GetModelCounterForVariable(var_name,true).Count(bound, bound);
@@ -146,19 +182,23 @@ Theory::BigInteger Driver::CountVariable(const std::string var_name, const unsig
 }
 
 Theory::BigInteger Driver::CountInts(const unsigned long bound) {
+  CountingContext context(*this);
   return GetModelCounter().CountInts(bound);
 }
 
 Theory::BigInteger Driver::CountInts(const unsigned long bound, std::vector<std::string> count_tuple_variables) {
+  SolverContext context(*this);
   LOG(FATAL) << "Not yet implemented";
   return GetModelCounter().CountInts(bound);
 }
 
 Theory::BigInteger Driver::CountStrs(const unsigned long bound) {
+  CountingContext context(*this);
   return GetModelCounter().CountStrs(bound);
 }
 
 Theory::BigInteger Driver::CountStrs(const unsigned long bound, std::vector<std::string> count_tuple_variables) {
+  SolverContext context(*this);
   Theory::BigInteger projected_count, tuple_count;
 
   if(count_tuple_variables.size() == 0) {
@@ -170,6 +210,7 @@ Theory::BigInteger Driver::CountStrs(const unsigned long bound, std::vector<std:
   std::string v1 = count_tuple_variables[0];
   std::string v2 = count_tuple_variables[1];
   
+  EnsureSolved();
 
   auto variable = symbol_table_->get_variable(v1);
   auto representative_variable = symbol_table_->get_representative_variable_of_at_scope(script_, variable);
@@ -179,9 +220,11 @@ Theory::BigInteger Driver::CountStrs(const unsigned long bound, std::vector<std:
   auto f = str_auto->GetFormula();
 
   Theory::StringAutomaton_ptr temp_auto = nullptr;
-  for(auto it : f->GetVariableCoefficientMap()) {
-    if(it.first != v1 and it.first != v2) {
-      temp_auto = str_auto->ProjectAwayVariable(it.first);
+  // copied, the formula is deleted with the automaton
+  const auto variables = f->GetVariables();
+  for(auto& variable : variables) {
+    if(variable != v1 and variable != v2) {
+      temp_auto = str_auto->ProjectAwayVariable(variable);
       delete str_auto;
       str_auto = temp_auto;
     }
@@ -194,30 +237,60 @@ Theory::BigInteger Driver::CountStrs(const unsigned long bound, std::vector<std:
   // std::cin.get();
 
   Solver::ModelCounter mc;
-  mc.add_symbolic_counter(str_auto->GetSymbolicCounter());
+  mc.add_symbolic_counter(GetStringSymbolicCounter(str_auto));
   return mc.Count(bound,bound);
 
 }
 
 Theory::BigInteger Driver::Count(const unsigned long int_bound, const unsigned long str_bound) {
+  CountingContext context(*this);
   return CountInts(int_bound) * CountStrs(str_bound);
 }
 
+std::vector<Theory::BigInteger> Driver::CountVariableRange(const std::string var_name, const std::vector<unsigned long>& bounds) {
+  CountingContext context(*this);
+  auto tuple_counts = GetModelCounterForVariable(var_name,false).CountRange(bounds);
+  auto projected_counts = GetModelCounterForVariable(var_name,true).CountRange(bounds);
+  for (std::size_t i = 0; i < projected_counts.size(); ++i) {
+    if (tuple_counts[i] < projected_counts[i]) {
+      projected_counts[i] = tuple_counts[i];
+    }
+  }
+  return projected_counts;
+}
+
+std::vector<Theory::BigInteger> Driver::CountIntsRange(const std::vector<unsigned long>& bounds) {
+  CountingContext context(*this);
+  return GetModelCounter().CountIntsRange(bounds);
+}
+
+std::vector<Theory::BigInteger> Driver::CountStrsRange(const std::vector<unsigned long>& bounds) {
+  CountingContext context(*this);
+  return GetModelCounter().CountStrsRange(bounds);
+}
+
+std::vector<Theory::BigInteger> Driver::CountRange(const std::vector<unsigned long>& bounds) {
+  CountingContext context(*this);
+  return GetModelCounter().CountRange(bounds);
+}
+
 Solver::ModelCounter& Driver::GetModelCounterForVariable(const std::string var_name, bool project) {
+  SolverContext context(*this);
   auto variable = symbol_table_->get_variable(var_name);
   auto representative_variable = symbol_table_->get_representative_variable_of_at_scope(script_, variable);
 
 //  auto it = variable_model_counter_.find(representative_variable);
 //  if (it == variable_model_counter_.end()) {
-    SetModelCounterForVariable(var_name,project);
+    Util::Profiler::TimePass("model_counter", [&]() { SetModelCounterForVariable(var_name,project); });
     auto it = variable_model_counter_.find(representative_variable);
   //}
   return it->second;
 }
 
 Solver::ModelCounter& Driver::GetModelCounter() {
+  SolverContext context(*this);
   if (not is_model_counter_cached_) {
-    SetModelCounter();
+    Util::Profiler::TimePass("model_counter", [this]() { SetModelCounter(); });
   }
   return model_counter_;
 }
@@ -249,6 +322,7 @@ int Driver::GetNumStrVariables() {
 }
 
 void Driver::SetModelCounterForVariable(const std::string var_name, bool project) {
+  EnsureSolved();
   auto variable = symbol_table_->get_variable(var_name);
   auto representative_variable = symbol_table_->get_representative_variable_of_at_scope(script_, variable);
   Solver::Value_ptr var_value = nullptr;
@@ -278,7 +352,7 @@ void Driver::SetModelCounterForVariable(const std::string var_name, bool project
   } else {
     switch (var_value->getType()) {
       case Vlab::Solver::Value::Type::STRING_AUTOMATON:
-        mc.add_symbolic_counter(var_value->getStringAutomaton()->GetSymbolicCounter());
+        mc.add_symbolic_counter(GetStringSymbolicCounter(var_value->getStringAutomaton()));
         break;
       case Vlab::Solver::Value::Type::BINARYINT_AUTOMATON:
         mc.add_symbolic_counter(var_value->getBinaryIntAutomaton()->GetSymbolicCounter());
@@ -322,13 +396,13 @@ void Driver::SetModelCounter() {
         std::vector<std::string> vars_to_project;
 
         // LOG(INFO) << "VARIABLE: " << variable_entry.first;
-        for (auto& el : formula->GetVariableCoefficientMap()) {
-          // LOG(INFO) << "  has " << el.first << " at track " << formula->GetVariableIndex(el.first);
-          if (symbol_table_->get_variable_unsafe(el.first) != nullptr) {
+        for (auto& variable : formula->GetVariables()) {
+          // LOG(INFO) << "  has " << variable << " at track " << formula->GetVariableIndex(variable);
+          if (symbol_table_->get_variable_unsafe(variable) != nullptr) {
             ++num_bin_var;
             has_actual_var = true;
           } else {
-            vars_to_project.push_back(el.first);
+            vars_to_project.push_back(variable);
           }
         }
 
@@ -371,12 +445,12 @@ void Driver::SetModelCounter() {
 
         // string_auto->inspectAuto(false,false);
 
-        for (auto& el : formula->GetVariableCoefficientMap()) {
-          if (symbol_table_->get_variable_unsafe(el.first) != nullptr) {
-            auto v = symbol_table_->get_variable(el.first);
+        for (auto& variable : formula->GetVariables()) {
+          if (symbol_table_->get_variable_unsafe(variable) != nullptr) {
+            auto v = symbol_table_->get_variable(variable);
             if(symbol_table_->is_sorted_variable(v)) {
 
-              string_auto = string_auto->ProjectAwayVariable(el.first);
+              string_auto = string_auto->ProjectAwayVariable(variable);
             }
             ++num_str_var;
           }
@@ -385,7 +459,7 @@ void Driver::SetModelCounter() {
         // string_auto->inspectAuto(false,false);
 
 
-				model_counter_.add_symbolic_counter(string_auto->GetSymbolicCounter());
+				model_counter_.add_symbolic_counter(GetStringSymbolicCounter(string_auto));
       }
       	break;
       case Vlab::Solver::Value::Type::INT_AUTOMATON: {
@@ -411,9 +485,13 @@ void Driver::SetModelCounter() {
   model_counter_.set_num_of_unconstraint_str_vars(number_of_untracked_str_variables);
 
   is_model_counter_cached_ = true;
+  if (not result_cache_key_.empty()) {
+    CacheResult();
+  }
 }
 
 void Driver::inspectResult(Solver::Value_ptr value, std::string file_name) {
+  SolverContext context(*this);
   std::ofstream outfile(file_name.c_str());
 
   if (!outfile.good()) {
@@ -431,6 +509,7 @@ void Driver::inspectResult(Solver::Value_ptr value, std::string file_name) {
 }
 
 void Driver::printResult(Solver::Value_ptr value, std::ostream& out) {
+  SolverContext context(*this);
   switch (value->getType()) {
     case Solver::Value::Type::STRING_AUTOMATON:
       value->getStringAutomaton()->toDotAscii(false, out);
@@ -446,11 +525,35 @@ void Driver::printResult(Solver::Value_ptr value, std::ostream& out) {
   }
 }
 
-std::map<SMT::Variable_ptr, Solver::Value_ptr> Driver::getSatisfyingVariables() const {
+std::map<SMT::Variable_ptr, Solver::Value_ptr> Driver::getSatisfyingVariables() {
+  SolverContext context(*this);
+  EnsureSolved();
   return symbol_table_->get_values_at_scope(script_);
 }
 
+Theory::SymbolicCounter Driver::GetStringSymbolicCounter(Theory::StringAutomaton_ptr string_auto) {
+  auto formula = string_auto->GetFormula();
+  if (formula != nullptr and formula->GetNumberOfVariables() == 1) {
+    auto variable = symbol_table_->get_variable_unsafe(formula->GetVariableAtIndex(0));
+    auto encoding = (variable == nullptr) ? nullptr : symbol_table_->get_string_encoding(variable);
+    if (encoding != nullptr) {
+      return string_auto->GetSymbolicCounter(*encoding);
+    }
+  }
+  return string_auto->GetSymbolicCounter();
+}
+
+std::string Driver::DecodeStringExample(const std::string& var_name, const std::string& example) {
+  auto variable = symbol_table_->get_variable_unsafe(var_name);
+  auto encoding = (variable == nullptr) ? nullptr : symbol_table_->get_string_encoding(variable);
+  if (encoding == nullptr) {
+    return example;
+  }
+  return encoding->Decode(example);
+}
+
 std::map<std::string, std::string> Driver::getSatisfyingExamples() {
+  SolverContext context(*this);
   std::map<std::string, std::string> results;
   for (auto& variable_entry : getSatisfyingVariables()) {
     if (Solver::Value::Type::BINARYINT_AUTOMATON == variable_entry.second->getType()) {
@@ -461,9 +564,9 @@ std::map<std::string, std::string> Driver::getSatisfyingExamples() {
     } else if(Solver::Value::Type::STRING_AUTOMATON == variable_entry.second->getType()) {
     	auto string_auto = variable_entry.second->getStringAutomaton();
     	auto string_formula = string_auto->GetFormula();
-    	for(auto it : string_formula->GetVariableCoefficientMap()) {
-    		auto single_string_auto = string_auto->GetAutomatonForVariable(it.first);
-    		results[it.first] = single_string_auto->GetAnAcceptingString();
+    	for(auto& variable : string_formula->GetVariables()) {
+    		auto single_string_auto = string_auto->GetAutomatonForVariable(variable);
+    		results[variable] = DecodeStringExample(variable, single_string_auto->GetAnAcceptingString());
     		delete single_string_auto;
     	}
 
@@ -476,6 +579,7 @@ std::map<std::string, std::string> Driver::getSatisfyingExamples() {
 }
 
 std::map<std::string, std::string> Driver::getSatisfyingExamplesRandom() {
+  SolverContext context(*this);
   std::map<std::string, std::string> results;
 
 
@@ -484,17 +588,17 @@ std::map<std::string, std::string> Driver::getSatisfyingExamplesRandom() {
   // SHOULD ONLY BE EMPTY RIGHT AFTER SOLVING, ONLY STRING AUTOMATA
   if(not cached_values_.empty()) {
   	for(auto it : cached_values_) {
-  		results[it.first] = cached_values_[it.first]->getStringAutomaton()->GetAnAcceptingStringRandom();
+  		results[it.first] = DecodeStringExample(it.first, cached_values_[it.first]->getStringAutomaton()->GetAnAcceptingStringRandom());
   	}
   } else {
 		for (auto& variable_entry : getSatisfyingVariables()) {
 			if(Solver::Value::Type::STRING_AUTOMATON == variable_entry.second->getType()) {
 				auto string_auto = variable_entry.second->getStringAutomaton();
 				auto string_formula = string_auto->GetFormula();
-				for(auto it : string_formula->GetVariableCoefficientMap()) {
-					auto single_string_auto = string_auto->GetAutomatonForVariable(it.first);
-					results[it.first] = single_string_auto->GetAnAcceptingStringRandom();
-					cached_values_[it.first] = new Solver::Value(single_string_auto);
+				for(auto& variable : string_formula->GetVariables()) {
+					auto single_string_auto = string_auto->GetAutomatonForVariable(variable);
+					results[variable] = DecodeStringExample(variable, single_string_auto->GetAnAcceptingStringRandom());
+					cached_values_[variable] = new Solver::Value(single_string_auto);
 				}
 			}
 		}
@@ -503,6 +607,7 @@ std::map<std::string, std::string> Driver::getSatisfyingExamplesRandom() {
 }
 
 std::map<std::string, std::string> Driver::getSatisfyingExamplesRandomBounded(const int bound) {
+  SolverContext context(*this);
   std::map<std::string, std::string> results;
 
   // check to see if we've cached automata/projected-automata for variables first
@@ -510,16 +615,16 @@ std::map<std::string, std::string> Driver::getSatisfyingExamplesRandomBounded(co
   // SHOULD ONLY BE EMPTY RIGHT AFTER SOLVING, ONLY STRING AUTOMATA
   if(not cached_bounded_values_.empty()) {
   	for(auto it : cached_bounded_values_) {
-  		results[it.first] = cached_bounded_values_[it.first]->getStringAutomaton()->GetAnAcceptingStringRandom();
+  		results[it.first] = DecodeStringExample(it.first, cached_bounded_values_[it.first]->getStringAutomaton()->GetAnAcceptingStringRandom());
   	}
   } else {
 		for (auto& variable_entry : getSatisfyingVariables()) {
 			if(Solver::Value::Type::STRING_AUTOMATON == variable_entry.second->getType()) {
 				auto string_auto = variable_entry.second->getStringAutomaton();
 				auto string_formula = string_auto->GetFormula();
-				for(auto it : string_formula->GetVariableCoefficientMap()) {
-					auto single_string_auto = string_auto->GetAutomatonForVariable(it.first);
-          auto length_auto = Theory::StringAutomaton::MakeAnyStringLengthLessThanOrEqualTo(bound);
+				for(auto& variable : string_formula->GetVariables()) {
+					auto single_string_auto = string_auto->GetAutomatonForVariable(variable);
+          auto length_auto = Theory::StringAutomaton::MakeAnyStringLengthLessThanOrEqualTo(bound, single_string_auto->get_number_of_bdd_variables());
 					auto single_string_auto_bounded = single_string_auto->Intersect(length_auto);
           delete length_auto;
 					delete single_string_auto;
@@ -528,8 +633,8 @@ std::map<std::string, std::string> Driver::getSatisfyingExamplesRandomBounded(co
             single_string_auto_bounded = nullptr;
             continue;
           }
-					results[it.first] = single_string_auto_bounded->GetAnAcceptingStringRandom();
-					cached_bounded_values_[it.first] = new Solver::Value(single_string_auto_bounded);
+					results[variable] = DecodeStringExample(variable, single_string_auto_bounded->GetAnAcceptingStringRandom());
+					cached_bounded_values_[variable] = new Solver::Value(single_string_auto_bounded);
 				}
 			}
 		}
@@ -538,6 +643,22 @@ std::map<std::string, std::string> Driver::getSatisfyingExamplesRandomBounded(co
 }
 
 void Driver::reset() {
+  SolverContext context(*this);
+  ClearCachedValues();
+  if (assertion_levels_.empty()) {
+    delete symbol_table_;
+    delete script_;
+  } else {
+    ClearAssertionLevels();
+  }
+  script_ = nullptr;
+  symbol_table_ = nullptr;
+  result_cache_key_.clear();
+  is_solve_skipped_ = false;
+//  LOG(INFO) << "Driver reseted.";
+}
+
+void Driver::ClearCachedValues() {
 	for(auto &iter : cached_values_) {
 		delete iter.second;
 		iter.second = nullptr;
@@ -550,15 +671,554 @@ void Driver::reset() {
 	}
 	cached_bounded_values_.clear();
 
-  delete symbol_table_;
-  delete script_;
+  variable_model_counter_.clear();
+  is_model_counter_cached_ = false;
+  model_counter_ = Solver::ModelCounter();
+}
+
+Driver::SolverContext::SolverContext(Driver& driver)
+    : mona_lock_(Theory::Automaton::GetMonaMutex()),
+      options_(driver.options_),
+      profile_(driver.options_.enable_profiling ? &driver.profile_ : nullptr) {
+}
+
+Driver::CountingContext::CountingContext(Driver& driver)
+    : options_(driver.options_),
+      profile_(driver.options_.enable_profiling ? &driver.profile_ : nullptr) {
+}
+
+const Util::Profile& Driver::GetProfile() const {
+  return profile_;
+}
+
+void Driver::ResetProfile() {
+  profile_.Clear();
+}
+
+Solver::ResultCache_ptr Driver::GetResultCache() {
+  if (Option::Solver::RESULT_CACHE_SIZE <= 0) {
+    return nullptr;
+  }
+  if (RESULT_CACHE == nullptr) {
+    std::unique_ptr<Solver::ResultCache> memory_cache(new Solver::LruResultCache(Option::Solver::RESULT_CACHE_SIZE));
+    if (Option::Solver::RESULT_CACHE_PATH.empty()) {
+      RESULT_CACHE = std::move(memory_cache);
+    } else {
+      std::unique_ptr<Solver::ResultCache> disk_cache(new Solver::FileResultCache(Option::Solver::RESULT_CACHE_PATH));
+      RESULT_CACHE.reset(new Solver::TieredResultCache(std::move(memory_cache), std::move(disk_cache)));
+    }
+  }
+  return RESULT_CACHE.get();
+}
+
+std::string Driver::GetResultCacheKey() {
+  auto script = script_->clone();
+  Solver::NormalizationConstraintSorter constraint_sorter(script, symbol_table_);
+  constraint_sorter.start();
+  // literals are kept, rewriting their characters maps different constants to the same key
+  Solver::NormalizationRenamer renamer(script, symbol_table_, false);
+  renamer.start();
+
+  std::stringstream key_text;
+  // options that change the solutions or how they are approximated
+  key_text << Option::Solver::USE_SIGNED_INTEGERS << Option::Solver::USE_MULTITRACK_AUTO
+           << Option::Solver::FORCE_DNF_FORMULA << Option::Solver::COUNT_BOUND_EXACT
+           << Option::Solver::USE_SINGLE_AUTO << Option::Solver::USE_REGEX_SPLITTER
+           << Option::Solver::USE_PREFIX_SHORTENER << Option::Solver::CONCAT_COLLAPSE_HEURISTIC << std::endl;
+  // variables without constraints are counted but do not appear in the script
+  for (auto type : {SMT::Variable::Type::INT, SMT::Variable::Type::STRING}) {
+    key_text << symbol_table_->get_num_of_variables(type) << " "
+             << symbol_table_->get_num_of_substituted_variables(script_, type) << std::endl;
+  }
+  // types of the renamed variables, the script alone does not tell e.g. int and string equalities apart
+  const auto& variable_mapping = renamer.GetVariableMapping();
+  std::vector<std::string> renamed_variables(variable_mapping.size());
+  for (auto& entry : variable_mapping) {
+    renamed_variables[std::stoul(entry.second.substr(1))] = entry.first;
+  }
+  for (std::size_t i = 0; i < renamed_variables.size(); ++i) {
+    auto variable = symbol_table_->get_variable_unsafe(renamed_variables[i]);
+    key_text << "v" << i << " " << (variable == nullptr ? "-" : variable->TVariable::str()) << std::endl;
+  }
+  if (symbol_table_->has_count_variable()) {
+    auto count_variable_name = symbol_table_->get_count_variable()->getName();
+    auto it = variable_mapping.find(count_variable_name);
+    key_text << "count " << (it == variable_mapping.end() ? "- " + count_variable_name : it->second) << std::endl;
+  }
+  Solver::Ast2Dot ast2dot(&key_text);
+  ast2dot.start(script);
+  delete script;
+  return key_text.str();
+}
+
+/**
+ * Stores the satisfiability result and the model counter when it is computed
+ */
+void Driver::CacheResult() {
+  std::stringstream os;
+  {
+    cereal::BinaryOutputArchive ar(os);
+    bool is_satisfiable = is_sat();
+    ar(is_satisfiable);
+    ar(is_model_counter_cached_);
+    if (is_model_counter_cached_) {
+      model_counter_.save(ar);
+    }
+  }
+  GetResultCache()->Put(result_cache_key_, os.str());
+}
+
+/**
+ * Loads a result stored by CacheResult, solving runs later only when variable values are needed
+ * @param result
+ */
+void Driver::LoadCachedResult(const std::string& result) {
+  std::stringstream is(result);
+  cereal::BinaryInputArchive ar(is);
+  bool has_model_counter = false;
+  ar(is_cached_sat_);
+  ar(has_model_counter);
+  if (has_model_counter) {
+    model_counter_.load(ar);
+    is_model_counter_cached_ = true;
+  }
+}
+
+void Driver::EnsureSolved() {
+  if (not is_solve_skipped_) {
+    return;
+  }
+  is_solve_skipped_ = false;
+  Solver::ConstraintSolver constraint_solver(script_, symbol_table_, constraint_information_);
+  Util::Profiler::TimePass("constraint_solver", [&]() { constraint_solver.start(); });
+}
+
+void Driver::Push(const unsigned num_levels) {
+  if (assertion_levels_.empty()) {
+    assertion_levels_.push_back(AssertionLevel());
+  }
+  for (unsigned i = 0; i < num_levels; ++i) {
+    assertion_levels_.push_back(AssertionLevel());
+  }
+}
+
+bool Driver::Pop(const unsigned num_levels) {
+  SolverContext context(*this);
+  if (num_levels >= std::max<std::size_t>(assertion_levels_.size(), 1)) {
+    LOG(ERROR) << "cannot pop " << num_levels << " assertion levels, " << GetNumOfAssertionLevels() << " are pushed";
+    return false;
+  }
+  if (num_levels == 0) {
+    return true;
+  }
+  ClearCachedValues();
+  for (unsigned i = 0; i < num_levels; ++i) {
+    auto& level = assertion_levels_.back();
+    ReleaseAssertionLevel(level);
+    for (auto command : level.commands) {
+      delete command;
+    }
+    assertion_levels_.pop_back();
+  }
+  ActivateAssertionLevel(assertion_levels_.size() - 1);
+  return true;
+}
+
+unsigned Driver::GetNumOfAssertionLevels() const {
+  return assertion_levels_.empty() ? 0 : assertion_levels_.size() - 1;
+}
+
+int Driver::ParseIncremental(std::istream* in) {
+  SolverContext context(*this);
+  SMT::Script_ptr script = nullptr;
+  SMT::Scanner scanner(in);
+  SMT::Parser parser(script, scanner);
+  int res = parser.parse();
+  CHECK_EQ(0, res)<< "Syntax error";
+
+  if (assertion_levels_.empty()) {
+    assertion_levels_.push_back(AssertionLevel());
+  }
+  for (auto command : *script->command_list) {
+    switch (command->getType()) {
+      case SMT::Command::Type::PUSH:
+        Push(dynamic_cast<SMT::Push_ptr>(command)->num_levels());
+        break;
+      case SMT::Command::Type::POP:
+        if (not Pop(dynamic_cast<SMT::Pop_ptr>(command)->num_levels())) {
+          // commands before the pop are kept
+          delete script;
+          return 1;
+        }
+        break;
+      default: {
+        auto& level = assertion_levels_.back();
+        if (level.is_solved) {
+          // the level changes, its state is solved again on top of the levels below
+          ClearCachedValues();
+          ReleaseAssertionLevel(level);
+        }
+        level.commands.push_back(command->clone());
+        break;
+      }
+    }
+  }
+  delete script;
+  return res;
+}
+
+bool Driver::CheckSat() {
+  SolverContext context(*this);
+  if (assertion_levels_.empty()) {
+    assertion_levels_.push_back(AssertionLevel());
+  }
+  const int top_index = assertion_levels_.size() - 1;
+  auto& top_level = assertion_levels_[top_index];
+  if (top_level.is_solved) {
+    ActivateAssertionLevel(top_index);
+    return top_level.is_sat;
+  }
+
+  ClearCachedValues();
+  int prefix_index = top_index - 1;
+  while (prefix_index >= 0 and not assertion_levels_[prefix_index].is_solved) {
+    --prefix_index;
+  }
+
+  // adding constraints to an unsatisfiable prefix keeps it unsatisfiable
+  if (prefix_index >= 0 and not assertion_levels_[prefix_index].is_sat) {
+    top_level.is_solved = true;
+    top_level.is_sat = false;
+    ActivateAssertionLevel(top_index);
+    return false;
+  }
+
+  SolveAssertionLevels(prefix_index + 1);
+  if (prefix_index >= 0 and top_level.is_sat) {
+    const auto& prefix_level = assertion_levels_[prefix_index];
+    if (prefix_level.is_relational or top_level.is_relational or not ConjoinAssertionLevel(prefix_level)) {
+      // relations cannot be conjoined variable by variable, solve the whole stack
+      DVLOG(1) << "solving all assertion levels";
+      ReleaseAssertionLevel(top_level);
+      SolveAssertionLevels(0);
+    }
+  }
+  return top_level.is_sat;
+}
+
+std::vector<Driver::BatchResult> Driver::SolveBatch(const std::vector<std::string>& constraints,
+                                                    const std::vector<unsigned long>& int_bounds,
+                                                    const std::vector<unsigned long>& str_bounds) {
+  std::vector<BatchResult> results;
+  results.reserve(constraints.size());
+  // constraints solved in this batch and their results, repeated queries are answered without
+  // parsing, equivalent queries with different texts are answered by the result cache when it is enabled
+  std::map<std::string, std::size_t> solved_queries;
+  // commands of the pushed assertion levels, level i + 1 keeps the commands of level_commands[i]
+  std::vector<std::vector<std::string>> level_commands;
+  reset();
+  for (auto& constraint : constraints) {
+    auto it = solved_queries.find(constraint);
+    if (it != solved_queries.end()) {
+      results.push_back(results[it->second]);
+      continue;
+    }
+
+    std::vector<std::string> commands;
+    bool has_assertion_stack_commands = false;
+    for (auto& command : SplitCommands(constraint)) {
+      auto name_start = command.find_first_not_of(" \t\r\n", 1);
+      auto name = command.substr(name_start, command.find_first_of(" \t\r\n()", name_start) - name_start);
+      if (name == "push" or name == "pop") {
+        has_assertion_stack_commands = true;
+      } else if (name != "check-sat") {
+        commands.push_back(command);
+      }
+    }
+
+    BatchResult result;
+    {
+      SolverContext context(*this);
+      if (has_assertion_stack_commands) {
+        // the query uses the assertion stack itself, it is solved on its own
+        reset();
+        level_commands.clear();
+        std::istringstream input(constraint);
+        Parse(&input);
+        InitializeSolver();
+        Solve();
+        result.is_sat = is_sat();
+      } else {
+        if (assertion_levels_.empty()) {
+          reset();
+        }
+        // the levels whose commands start the query are kept, the query is solved on top of them
+        std::size_t num_of_kept_levels = 0;
+        std::size_t num_of_kept_commands = 0;
+        while (num_of_kept_levels < level_commands.size()) {
+          auto& kept_commands = level_commands[num_of_kept_levels];
+          if (num_of_kept_commands + kept_commands.size() > commands.size()
+              or not std::equal(kept_commands.begin(), kept_commands.end(), commands.begin() + num_of_kept_commands)) {
+            break;
+          }
+          num_of_kept_commands += kept_commands.size();
+          ++num_of_kept_levels;
+        }
+        Pop(level_commands.size() - num_of_kept_levels);
+        level_commands.resize(num_of_kept_levels);
+        if (num_of_kept_commands < commands.size()) {
+          std::stringstream level_text;
+          for (std::size_t i = num_of_kept_commands; i < commands.size(); ++i) {
+            level_text << commands[i] << "\n";
+          }
+          level_text << "(check-sat)\n";
+          Push();
+          ParseIncremental(&level_text);
+          level_commands.push_back(std::vector<std::string>(commands.begin() + num_of_kept_commands, commands.end()));
+        }
+        DVLOG(1) << "batch query reuses " << num_of_kept_levels << " assertion levels";
+        result.is_sat = CheckSat();
+      }
+    }
+
+    // counting does not hold the MONA lock, drivers on other threads solve meanwhile
+    if (result.is_sat) {
+      if (not int_bounds.empty()) {
+        result.int_counts = CountIntsRange(int_bounds);
+      }
+      if (not str_bounds.empty()) {
+        result.str_counts = CountStrsRange(str_bounds);
+      }
+    } else {
+      result.int_counts.assign(int_bounds.size(), 0);
+      result.str_counts.assign(str_bounds.size(), 0);
+    }
+    solved_queries[constraint] = results.size();
+    results.push_back(std::move(result));
+  }
+  reset();
+  return results;
+}
+
+/**
+ * Splits a script into the texts of its top level commands, comments and the whitespace
+ * between commands are dropped
+ * @param text
+ * @return command texts in script order
+ */
+std::vector<std::string> Driver::SplitCommands(const std::string& text) {
+  std::vector<std::string> commands;
+  std::string command;
+  int depth = 0;
+  std::size_t i = 0;
+  auto is_symbol_char = [](const char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) or std::strchr("._+-*=%/?!$~&^<>@", c) != nullptr;
+  };
+  // copies a literal that ends with the given character, a backslash escapes the given characters
+  auto copy_literal = [&text, &i, &command](const char end, const std::string& escaped) {
+    command += text[i++];
+    while (i < text.size()) {
+      const char c = text[i++];
+      command += c;
+      if (c == '\\' and i < text.size() and escaped.find(text[i]) != std::string::npos) {
+        command += text[i++];
+      } else if (c == end) {
+        return;
+      }
+    }
+  };
+  while (i < text.size()) {
+    const char c = text[i];
+    if (c == ';') {
+      i = std::min(text.find('\n', i), text.size());
+    } else if (depth == 0 and c != '(') {
+      ++i;
+    } else if (c == '"') {
+      // doubled quotes of a string are read as two adjacent strings
+      copy_literal('"', "\\");
+    } else if (c == '|') {
+      copy_literal('|', "");
+    } else if (c == '/' and not is_symbol_char(command.back())) {
+      copy_literal('/', "\\/");
+    } else {
+      command += text[i++];
+      if (c == '(') {
+        ++depth;
+      } else if (c == ')' and --depth == 0) {
+        commands.push_back(command);
+        command.clear();
+      }
+    }
+  }
+  return commands;
+}
+
+/**
+ * Solves the assertions of the levels starting from the given level together with the
+ * declarations of all levels, the state is kept in the top level
+ * @param first_assertion_level
+ */
+void Driver::SolveAssertionLevels(const int first_assertion_level) {
+  auto commands = new SMT::CommandList();
+  SMT::Command_ptr check_sat = nullptr;
+  for (int i = 0; i < static_cast<int>(assertion_levels_.size()); ++i) {
+    for (auto command : assertion_levels_[i].commands) {
+      if (SMT::Command::Type::CHECK_SAT == command->getType()) {
+        check_sat = command;
+      } else if (i >= first_assertion_level or SMT::Command::Type::ASSERT != command->getType()) {
+        commands->push_back(command->clone());
+      }
+    }
+  }
+  // the initializer drops commands after the last check-sat, all levels are checked together
+  if (check_sat != nullptr) {
+    commands->push_back(check_sat->clone());
+  }
+  script_ = new SMT::Script(commands);
+  InitializeSolver();
+  Solve();
+  // levels keep variable values to conjoin them later
+  EnsureSolved();
+
+  auto& top_level = assertion_levels_.back();
+  top_level.script = script_;
+  top_level.symbol_table = symbol_table_;
+  top_level.constraint_information = constraint_information_;
+  top_level.is_solved = true;
+  top_level.is_sat = symbol_table_->isSatisfiable();
+  top_level.is_relational = HasRelationalValues();
+}
+
+/**
+ * Conjoins the variable values of a solved prefix level into the current state, both states
+ * must be free of relational values and of compact string encodings
+ * @param prefix_level
+ * @return false if a value cannot be conjoined
+ */
+bool Driver::ConjoinAssertionLevel(const AssertionLevel& prefix_level) {
+  if (prefix_level.symbol_table->has_string_encodings() or symbol_table_->has_string_encodings()) {
+    return false;
+  }
+  std::vector<std::pair<SMT::Variable_ptr, Solver::Value_ptr>> prefix_values;
+  for (auto& variable_entry : prefix_level.symbol_table->get_variables()) {
+    auto prefix_value = prefix_level.symbol_table->get_value_at_scope(prefix_level.script, variable_entry.second);
+    if (prefix_value == nullptr) {
+      continue;
+    }
+    auto variable = symbol_table_->get_variable_unsafe(variable_entry.first);
+    if (variable == nullptr) {
+      continue;
+    }
+    // equivalent variables share a value named after their representative
+    if (prefix_level.symbol_table->get_representative_variable_of_at_scope(prefix_level.script, variable_entry.second) != variable_entry.second
+        or symbol_table_->get_representative_variable_of_at_scope(script_, variable) != variable) {
+      return false;
+    }
+    auto value = symbol_table_->get_value_at_scope(script_, variable);
+    if (value != nullptr and value->getType() != prefix_value->getType()) {
+      return false;
+    }
+    prefix_values.push_back(std::make_pair(variable, prefix_value));
+  }
+
+  symbol_table_->push_scope(script_);
+  for (auto& variable_value : prefix_values) {
+    bool is_satisfiable = false;
+    if (symbol_table_->get_value_at_scope(script_, variable_value.first) == nullptr) {
+      // unconstrained in the current state
+      is_satisfiable = symbol_table_->set_value(variable_value.first, variable_value.second);
+    } else {
+      is_satisfiable = symbol_table_->IntersectValue(variable_value.first, variable_value.second);
+    }
+    symbol_table_->update_satisfiability_result(is_satisfiable);
+  }
+  symbol_table_->pop_scope();
+  assertion_levels_.back().is_sat = symbol_table_->isSatisfiable();
+  return true;
+}
+
+/**
+ * @return true if a value of the current state constrains more than one variable
+ */
+bool Driver::HasRelationalValues() {
+  for (auto& variable_value : symbol_table_->get_values_at_scope(script_)) {
+    auto value = variable_value.second;
+    switch (value->getType()) {
+      case Solver::Value::Type::STRING_AUTOMATON:
+        if (value->getStringAutomaton()->GetNumTracks() > 1) {
+          return true;
+        }
+        break;
+      case Solver::Value::Type::BINARYINT_AUTOMATON: {
+        auto formula = value->getBinaryIntAutomaton()->GetFormula();
+        if (formula == nullptr or formula->GetNumberOfVariables() > 1) {
+          return true;
+        }
+        break;
+      }
+      case Solver::Value::Type::INT_AUTOMATON:
+        break;
+      default:
+        return true;
+    }
+  }
+  return false;
+}
+
+void Driver::ReleaseAssertionLevel(AssertionLevel& level) {
+  if (script_ == level.script and script_ != nullptr) {
+    script_ = nullptr;
+    symbol_table_ = nullptr;
+    constraint_information_ = nullptr;
+  }
+  delete level.symbol_table;
+  delete level.script;
+  delete level.constraint_information;
+  level.script = nullptr;
+  level.symbol_table = nullptr;
+  level.constraint_information = nullptr;
+  level.is_solved = false;
+  level.is_sat = false;
+  level.is_relational = false;
+}
+
+/**
+ * Points the driver state to the state of the given level, or the closest level below
+ * it with a state
+ * @param level_index
+ */
+void Driver::ActivateAssertionLevel(const int level_index) {
   script_ = nullptr;
   symbol_table_ = nullptr;
-//  LOG(INFO) << "Driver reseted.";
+  constraint_information_ = nullptr;
+  for (int i = level_index; i >= 0; --i) {
+    if (assertion_levels_[i].script != nullptr) {
+      script_ = assertion_levels_[i].script;
+      symbol_table_ = assertion_levels_[i].symbol_table;
+      constraint_information_ = assertion_levels_[i].constraint_information;
+      return;
+    }
+  }
+}
+
+void Driver::ClearAssertionLevels() {
+  for (auto& level : assertion_levels_) {
+    ReleaseAssertionLevel(level);
+    for (auto command : level.commands) {
+      delete command;
+    }
+  }
+  assertion_levels_.clear();
+  script_ = nullptr;
+  symbol_table_ = nullptr;
+  constraint_information_ = nullptr;
 }
 
 std::vector<std::string> Driver::GetSimpleRegexes(std::string re_var, int num_regexes, int alpha, int omega) {
+  SolverContext context(*this);
+  EnsureSolved();
   auto var = symbol_table_->get_variable(re_var);
+  CHECK(symbol_table_->get_string_encoding(var) == nullptr) << "regexes of compact string encodings are not supported: " << re_var;
   auto var_val = symbol_table_->get_value_at_scope(script_,var);
   auto var_val_auto = var_val->getStringAutomaton();
 
@@ -590,6 +1250,9 @@ std::vector<std::string> Driver::GetSimpleRegexes(std::string re_var, int num_re
 }
 
 void Driver::set_option(const Option::Name option) {
+  // the values stay active on the calling thread
+  std::lock_guard<std::recursive_mutex> lock(Theory::Automaton::GetMonaMutex());
+  options_.Activate();
   switch (option) {
     case Option::Name::USE_SIGNED_INTEGERS:
       Option::Solver::USE_SIGNED_INTEGERS = true;
@@ -651,24 +1314,82 @@ void Driver::set_option(const Option::Name option) {
     case Option::Name::DFA_TO_RE:
       Option::Solver::DFA_TO_RE = true;
       break;
+    case Option::Name::ENABLE_DIRECT_REGEX_CONSTRUCTION:
+      Option::Theory::USE_DIRECT_REGEX_CONSTRUCTION = true;
+      break;
+    case Option::Name::DISABLE_DIRECT_REGEX_CONSTRUCTION:
+      Option::Theory::USE_DIRECT_REGEX_CONSTRUCTION = false;
+      break;
+    case Option::Name::ENABLE_SYMBOLIC_ARITHMETIC_CONSTRUCTION:
+      Option::Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION = true;
+      break;
+    case Option::Name::DISABLE_SYMBOLIC_ARITHMETIC_CONSTRUCTION:
+      Option::Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION = false;
+      break;
+    case Option::Name::ENABLE_CONJUNCT_ORDERING:
+      Option::Solver::ORDER_CONJUNCTS = true;
+      break;
+    case Option::Name::DISABLE_CONJUNCT_ORDERING:
+      Option::Solver::ORDER_CONJUNCTS = false;
+      break;
+    case Option::Name::ENABLE_COMPONENT_TIME_REPORT:
+      Option::Solver::REPORT_COMPONENT_TIMES = true;
+      break;
+    case Option::Name::DISABLE_COMPONENT_TIME_REPORT:
+      Option::Solver::REPORT_COMPONENT_TIMES = false;
+      break;
+    case Option::Name::ENABLE_PROFILING:
+      Option::Solver::ENABLE_PROFILING = true;
+      break;
+    case Option::Name::DISABLE_PROFILING:
+      Option::Solver::ENABLE_PROFILING = false;
+      break;
+    case Option::Name::ENABLE_COMPACT_STRING_ENCODING:
+      Option::Solver::COMPACT_STRING_ENCODING = true;
+      break;
+    case Option::Name::DISABLE_COMPACT_STRING_ENCODING:
+      Option::Solver::COMPACT_STRING_ENCODING = false;
+      break;
     default:
       LOG(ERROR)<< "option is not recognized: " << static_cast<int>(option);
       break;
     }
-  }
+  options_ = Option::Context::Current();
+}
 
 void Driver::set_option(const Option::Name option, const int value) {
+  // the values stay active on the calling thread
+  std::lock_guard<std::recursive_mutex> lock(Theory::Automaton::GetMonaMutex());
+  options_.Activate();
   switch (option) {
     case Option::Name::REGEX_FLAG:
       Util::RegularExpression::DEFAULT = value;
       break;
+    case Option::Name::COUNTING_METHOD:
+      Option::Theory::COUNTING_METHOD = static_cast<Option::CountingMethod>(value);
+      break;
+    case Option::Name::RESULT_CACHE_SIZE:
+      Option::Solver::RESULT_CACHE_SIZE = value;
+      RESULT_CACHE = nullptr;
+      break;
+    case Option::Name::REGEX_CACHE_SIZE:
+      Option::Theory::REGEX_CACHE_SIZE = value;
+      Theory::StringAutomaton::GetRegexAutoCache().SetCapacity(value);
+      break;
+    case Option::Name::COUNT_THREADS:
+      Option::Solver::COUNT_THREADS = value;
+      break;
     default:
       LOG(ERROR)<< "option is not recognized: " << static_cast<int>(option) << " -> " << value;
       break;
     }
+  options_ = Option::Context::Current();
 }
 
 void Driver::set_option(const Option::Name option, const std::string value) {
+  // the values stay active on the calling thread
+  std::lock_guard<std::recursive_mutex> lock(Theory::Automaton::GetMonaMutex());
+  options_.Activate();
   switch (option) {
     case Option::Name::OUTPUT_PATH:
       Option::Solver::OUTPUT_PATH = value;
@@ -678,10 +1399,15 @@ void Driver::set_option(const Option::Name option, const std::string value) {
       Option::Solver::SCRIPT_PATH = value;
       Option::Theory::SCRIPT_PATH = value;
       break;
+    case Option::Name::RESULT_CACHE_PATH:
+      Option::Solver::RESULT_CACHE_PATH = value;
+      RESULT_CACHE = nullptr;
+      break;
     default:
       LOG(ERROR)<< "option is not recognized: " << static_cast<int>(option) << " -> " << value;
       break;
     }
+  options_ = Option::Context::Current();
 }
 
 void Driver::test() {
@@ -8,14 +8,19 @@
 #ifndef SRC_DRIVER_H_
 #define SRC_DRIVER_H_
 
+#include <cctype>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 #include <algorithm>
 
 #include <glog/logging.h>
@@ -40,6 +45,7 @@
 #include "solver/ModelCounter.h"
 #include "solver/options/Solver.h"
 #include "solver/RegexDivideConquer.h"
+#include "solver/ResultCache.h"
 #include "solver/SymbolTable.h"
 #include "solver/SyntacticOptimizer.h"
 #include "solver/SyntacticProcessor.h"
@@ -52,6 +58,7 @@
 #include "theory/StringFormula.h"
 #include "theory/Formula.h"
 #include "theory/SymbolicCounter.h"
+#include "utils/Profiler.h"
 #include "utils/Serialize.h"
 
 #include "solver/NormalizationConstraintSorter.h"
@@ -65,6 +72,12 @@ class location;
 
 namespace Vlab {
 
+/**
+ * Drivers can run on different threads, each driver keeps its own option values.
+ * Automata operations of all drivers are serialized as MONA is not reentrant, concurrent
+ * drivers do not solve in parallel: initializing and solving of one driver wait for the
+ * solver of any other driver. Only parsing and counting with a built model counter overlap.
+ */
 class Driver {
 public:
   Driver();
@@ -89,6 +102,16 @@ public:
   Theory::BigInteger CountStrs(const unsigned long bound, std::vector<std::string> count_tuple_variables);
   Theory::BigInteger Count(const unsigned long int_bound, const unsigned long str_bound);
 
+  /**
+   * Batch counting, counts for all bounds are computed in a single forward sweep
+   * @param bounds in any order
+   * @return counts in the order of bounds
+   */
+  std::vector<Theory::BigInteger> CountVariableRange(const std::string var_name, const std::vector<unsigned long>& bounds);
+  std::vector<Theory::BigInteger> CountIntsRange(const std::vector<unsigned long>& bounds);
+  std::vector<Theory::BigInteger> CountStrsRange(const std::vector<unsigned long>& bounds);
+  std::vector<Theory::BigInteger> CountRange(const std::vector<unsigned long>& bounds);
+
   Solver::ModelCounter& GetModelCounterForVariable(const std::string var_name, bool project = true);
   Solver::ModelCounter& GetModelCounter();
 
@@ -97,21 +120,92 @@ public:
 
   void printResult(Solver::Value_ptr value, std::ostream& out);
   void inspectResult(Solver::Value_ptr value, std::string file_name);
-  std::map<SMT::Variable_ptr, Solver::Value_ptr> getSatisfyingVariables() const;
+  std::map<SMT::Variable_ptr, Solver::Value_ptr> getSatisfyingVariables();
   std::map<std::string, std::string> getSatisfyingExamples();
   std::map<std::string, std::string> getSatisfyingExamplesRandom();
   std::map<std::string, std::string> getSatisfyingExamplesRandomBounded(const int bound);
 
   void reset();
+
+  /**
+   * Incremental solving with SMT-LIB assertion stack semantics. Commands, including declarations,
+   * are kept per assertion level and the solver state of a level is kept until the level is
+   * popped, automata of a solved prefix are reused when constraints are added on top of it.
+   */
+  void Push(const unsigned num_levels = 1);
+  /**
+   * @param num_levels
+   * @return false if fewer levels are pushed, the stack is not changed then
+   */
+  bool Pop(const unsigned num_levels = 1);
+  /**
+   * @return number of pushed assertion levels
+   */
+  unsigned GetNumOfAssertionLevels() const;
+  /**
+   * Parses commands into the current assertion level, push and pop commands are applied in order
+   * @param in
+   * @return parser result, 1 if a pop has no matching push, commands before it are kept
+   */
+  int ParseIncremental(std::istream* in = &std::cin);
+  /**
+   * Solves the current assertion stack, only the levels added since the closest solved level
+   * are solved again when the values of that level can be conjoined variable by variable
+   * @return satisfiability of the current assertion stack
+   */
+  bool CheckSat();
+
+  struct BatchResult {
+    bool is_sat = false;
+    std::vector<Theory::BigInteger> int_counts;
+    std::vector<Theory::BigInteger> str_counts;
+  };
+
+  /**
+   * Solves and counts a batch of queries in one call. Queries are solved on the assertion stack,
+   * the commands of a query that start with the commands of earlier queries are not solved again,
+   * e.g. path conditions that extend each other. Repeated queries are solved once, regex automata
+   * and the result cache are shared by all queries. Each query holds the MONA lock only while it
+   * is solved, counting runs without it. The driver is reset when the batch is done.
+   * @param constraints
+   * @param int_bounds bounds of the int counts of each query
+   * @param str_bounds bounds of the string counts of each query
+   * @return results in the order of constraints, counts of unsatisfiable queries are 0
+   */
+  std::vector<BatchResult> SolveBatch(const std::vector<std::string>& constraints,
+                                      const std::vector<unsigned long>& int_bounds,
+                                      const std::vector<unsigned long>& str_bounds);
 //	void solveAst();
   std::vector<std::string> GetSimpleRegexes(std::string re_var, int num_regexes = 1, int alpha = 0, int omega = 0);
 
+  /**
+   * Measurements of the driver operations that ran while profiling was enabled, they accumulate
+   * until the profile is reset
+   * @return pass, component, automata operation and counting measurements
+   */
+  const Util::Profile& GetProfile() const;
+  void ResetProfile();
+
   void set_option(const Option::Name option);
   void set_option(const Option::Name option, const int value);
   void set_option(const Option::Name option, const std::string value);
 
   void test();
 
+  /**
+   * Activates the options and the profile of a driver without the MONA lock. Counting with a
+   * built model counter does not use automata, drivers on other threads solve meanwhile.
+   * Model counters are built in a nested SolverContext. Public for model counters that are
+   * kept outside of the driver, e.g. by the Java interface.
+   */
+  class CountingContext {
+  public:
+    CountingContext(Driver& driver);
+  private:
+    Option::ScopedContext options_;
+    Util::Profiler::ScopedProfile profile_;
+  };
+
   SMT::Script_ptr script_;
   Solver::SymbolTable_ptr symbol_table_;
   Solver::ConstraintInformation_ptr constraint_information_;
@@ -121,8 +215,81 @@ public:
   std::string file_;
 
 protected:
+  /**
+   * Activates the options and the profile of a driver on the calling thread and holds the MONA
+   * lock for the duration of a driver operation, nested operations share the lock
+   */
+  class SolverContext {
+  public:
+    SolverContext(Driver& driver);
+  private:
+    std::lock_guard<std::recursive_mutex> mona_lock_;
+    Option::ScopedContext options_;
+    Util::Profiler::ScopedProfile profile_;
+  };
+
+  /**
+   * Commands asserted at a level of the assertion stack and the solver state of the stack up
+   * to and including the level. The state is owned by the level, it is nullptr when the level
+   * is not solved or shares the unsatisfiable state of a level below it.
+   */
+  struct AssertionLevel {
+    SMT::CommandList commands;
+    SMT::Script_ptr script = nullptr;
+    Solver::SymbolTable_ptr symbol_table = nullptr;
+    Solver::ConstraintInformation_ptr constraint_information = nullptr;
+    bool is_solved = false;
+    bool is_sat = false;
+    bool is_relational = false;
+  };
+
   void SetModelCounterForVariable(const std::string var_name, bool project = true);
   void SetModelCounter();
+  void ClearCachedValues();
+  /**
+   * @param string_auto automaton of a string variable or group
+   * @return counter of the automaton, a single variable automaton built with a compact encoding
+   * counts the characters of its codes
+   */
+  Theory::SymbolicCounter GetStringSymbolicCounter(Theory::StringAutomaton_ptr string_auto);
+  /**
+   * @param var_name string variable
+   * @param example accepted string of the automaton of the variable
+   * @return the example in characters if the automaton is built with a compact encoding
+   */
+  std::string DecodeStringExample(const std::string& var_name, const std::string& example);
+
+  /**
+   * Result cache shared by all drivers, nullptr when it is disabled
+   */
+  Solver::ResultCache_ptr GetResultCache();
+  /**
+   * Canonical text of the initialized script, constraints that differ only in the order of
+   * conjuncts or in variable names map to the same key
+   * @return result cache key
+   */
+  std::string GetResultCacheKey();
+  void CacheResult();
+  void LoadCachedResult(const std::string& result);
+  /**
+   * Runs the constraint solver when the result was loaded from the result cache and
+   * variable values are needed
+   */
+  void EnsureSolved();
+
+  static std::vector<std::string> SplitCommands(const std::string& text);
+  void SolveAssertionLevels(const int first_assertion_level);
+  bool ConjoinAssertionLevel(const AssertionLevel& prefix_level);
+  bool HasRelationalValues();
+  void ReleaseAssertionLevel(AssertionLevel& level);
+  void ActivateAssertionLevel(const int level_index);
+  void ClearAssertionLevels();
+
+  /**
+   * Assertion stack of incremental solving, script_, symbol_table_ and constraint_information_
+   * point to the state of a level when it is not empty
+   */
+  std::vector<AssertionLevel> assertion_levels_;
 
   bool is_model_counter_cached_;
   Solver::ModelCounter model_counter_;
@@ -144,8 +311,29 @@ protected:
 
   int bound_decrease_;
 
+  /**
+   * Result cache key of the current script, empty when the result cache is disabled
+   */
+  std::string result_cache_key_;
+  bool is_solve_skipped_;
+  bool is_cached_sat_;
+
+  /**
+   * Option values of the driver, set_option updates them together with the values of the calling thread
+   */
+  Option::Context options_;
+
+  /**
+   * Active while a driver operation runs when profiling is enabled
+   */
+  Util::Profile profile_;
+
 private:
   static bool IS_LOGGING_INITIALIZED;
+  /**
+   * Shared by all drivers, accessed under the MONA lock
+   */
+  static std::unique_ptr<Solver::ResultCache> RESULT_CACHE;
 
 };
 
@@ -40,6 +40,7 @@
 
 std::vector<unsigned long> parse_count_bounds(std::string);
 std::vector<std::string> parse_count_vars(std::string);
+void write_profile(const Vlab::Driver&, std::string);
 
 int main(const int argc, const char **argv) {
   google::InstallFailureSignalHandler();
@@ -69,6 +70,7 @@ int main(const int argc, const char **argv) {
   unsigned long num_models = 0;
   std::string re_var = "";
   std::string re_var_file = "";
+  std::string profile_file = "";
 
   bool count_tuple = false;
   bool count_tuple_variables = false;
@@ -144,6 +146,46 @@ int main(const int argc, const char **argv) {
       str_bounds = parse_count_bounds(bounds_str);
       int_bounds = str_bounds;
       ++i;
+    } else if (argv[i] == std::string("--count-method")) {
+      std::string method {argv[i + 1]};
+      if (method == "iteration") {
+        driver.set_option(Vlab::Option::Name::COUNTING_METHOD, static_cast<int>(Vlab::Option::CountingMethod::ITERATION));
+      } else if (method == "squaring") {
+        driver.set_option(Vlab::Option::Name::COUNTING_METHOD, static_cast<int>(Vlab::Option::CountingMethod::SQUARING));
+      } else if (method == "recurrence") {
+        driver.set_option(Vlab::Option::Name::COUNTING_METHOD, static_cast<int>(Vlab::Option::CountingMethod::RECURRENCE));
+      } else if (method == "modular") {
+        driver.set_option(Vlab::Option::Name::COUNTING_METHOD, static_cast<int>(Vlab::Option::CountingMethod::MODULAR));
+      } else {
+        driver.set_option(Vlab::Option::Name::COUNTING_METHOD, static_cast<int>(Vlab::Option::CountingMethod::AUTO));
+      }
+      ++i;
+    } else if (argv[i] == std::string("--disable-direct-regex")) {
+      driver.set_option(Vlab::Option::Name::DISABLE_DIRECT_REGEX_CONSTRUCTION);
+    } else if (argv[i] == std::string("--disable-symbolic-arithmetic")) {
+      driver.set_option(Vlab::Option::Name::DISABLE_SYMBOLIC_ARITHMETIC_CONSTRUCTION);
+    } else if (argv[i] == std::string("--disable-conjunct-ordering")) {
+      driver.set_option(Vlab::Option::Name::DISABLE_CONJUNCT_ORDERING);
+    } else if (argv[i] == std::string("--report-component-times")) {
+      driver.set_option(Vlab::Option::Name::ENABLE_COMPONENT_TIME_REPORT);
+    } else if (argv[i] == std::string("--profile")) {
+      driver.set_option(Vlab::Option::Name::ENABLE_PROFILING);
+      profile_file = argv[i + 1];
+      ++i;
+    } else if (argv[i] == std::string("--compact-string-encoding")) {
+      driver.set_option(Vlab::Option::Name::ENABLE_COMPACT_STRING_ENCODING);
+    } else if (argv[i] == std::string("--count-threads")) {
+      driver.set_option(Vlab::Option::Name::COUNT_THREADS, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--regex-cache-size")) {
+      driver.set_option(Vlab::Option::Name::REGEX_CACHE_SIZE, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--result-cache-size")) {
+      driver.set_option(Vlab::Option::Name::RESULT_CACHE_SIZE, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--result-cache")) {
+      driver.set_option(Vlab::Option::Name::RESULT_CACHE_PATH, std::string(argv[i + 1]));
+      ++i;
     } else if (argv[i] == std::string("--get-models")) {
     	num_models = std::stoi(argv[i+1]);
     	++i;
@@ -173,6 +215,13 @@ int main(const int argc, const char **argv) {
       std::cout << std::setw(col) << "-bv or --bound-var <values>" << ": model count integer bit length bound e.g., -b 10 or a set of bounds e.g., -b \"4,8,16\"" << std::endl;
       std::cout << std::setw(col) << "--count-variable <name>" << ": model counts projected variable instead of tuples e.g., --count-variable x" << std::endl;
       std::cout << std::setw(col) << "--count-bound-exact" << ": model counts solutions of length exactly equal to given bound" << std::endl;
+      std::cout << std::setw(col) << "--count-method <method>" << ": auto (default), iteration, squaring, recurrence or modular for raising count matrix to the bound" << std::endl;
+      std::cout << std::setw(col) << "--count-threads <n>" << ": counts independent components on n threads, 0 uses all cores (default 1)" << std::endl;
+      std::cout << std::setw(col) << "--compact-string-encoding" << ": builds string automata of single variable components over the characters they mention" << std::endl;
+      std::cout << std::setw(col) << "--regex-cache-size <n>" << ": number of dfa states kept in the regex automata cache, 0 disables it (default 100000)" << std::endl;
+      std::cout << std::setw(col) << "--result-cache-size <n>" << ": keeps results of n normalized queries in memory, 0 (default) disables caching" << std::endl;
+      std::cout << std::setw(col) << "--result-cache <path>" << ": keeps cached results in a file across runs, needs --result-cache-size" << std::endl;
+      std::cout << std::setw(col) << "--profile <path>" << ": writes pass times, automata operation counts and sizes, and counting times as json, - writes to stdout" << std::endl;
       std::cout << std::setw(col) << "--use-unsigned" << ": allows only positive integers" << std::endl;
       std::cout << std::setw(col) << "--use-signed" << ": allows positive and negative integers" << std::endl;
       std::cout << std::setw(col) << "--use-multitrack" << ": uses multitrack automata for strings" << std::endl;
@@ -235,23 +284,33 @@ int main(const int argc, const char **argv) {
     if(count_variables.empty()) count_variables.push_back("");
 
 
+    // all bounds are counted in one sweep, a single bound keeps its own time in the report
+    auto report_counts = [](const std::string& label, const std::vector<unsigned long>& bounds,
+        const std::vector<Vlab::Theory::BigInteger>& counts, std::chrono::steady_clock::duration count_time) {
+      auto time_ms = std::chrono::duration<long double, std::milli>(count_time).count();
+      if (bounds.size() == 1) {
+        LOG(INFO) << "report " << label << ": " << bounds[0] << " count: " << counts[0] << " time: " << time_ms << " ms";
+        return;
+      }
+      for (std::size_t i = 0; i < bounds.size(); ++i) {
+        LOG(INFO) << "report " << label << ": " << bounds[i] << " count: " << counts[i];
+      }
+      LOG(INFO) << "report " << label << " sweep of " << bounds.size() << " bounds time: " << time_ms << " ms";
+    };
+
     if (count_tuple) {
-      for (auto b : str_bounds) {
+      if (not str_bounds.empty()) {
         start = std::chrono::steady_clock::now();
-        auto count = driver.CountStrs(b);
+        auto counts = driver.CountStrsRange(str_bounds);
         end = std::chrono::steady_clock::now();
-        auto count_time = end - start;
-        LOG(INFO) << "report (TUPLE) bound: " << b << " count: " << count << " time: "
-                  << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+        report_counts("(TUPLE) bound", str_bounds, counts, end - start);
       }
 
-      for (auto b : int_bounds) {
+      if (not int_bounds.empty()) {
         start = std::chrono::steady_clock::now();
-        auto count = driver.CountInts(b);
+        auto counts = driver.CountIntsRange(int_bounds);
         end = std::chrono::steady_clock::now();
-        auto count_time = end - start;
-        LOG(INFO) << "report (TUPLE) bound: " << b << " count: " << count << " time: "
-                  << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+        report_counts("(TUPLE) bound", int_bounds, counts, end - start);
       }
     }
 
@@ -273,6 +332,7 @@ int main(const int argc, const char **argv) {
       //   LOG(INFO) << "report (TUPLE) bound: " << b << " count: " << count << " time: "
       //             << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
       // }
+      write_profile(driver, profile_file);
       return 0;
     }
     
@@ -281,22 +341,17 @@ int main(const int argc, const char **argv) {
       count_variable = count_var;
       if (not count_variable.empty()) {
         LOG(INFO) << "report var: " << count_variable;
-        for (auto b : int_bounds) {
+        if (not int_bounds.empty()) {
           start = std::chrono::steady_clock::now();
-          auto count_result = driver.CountVariable(count_variable, b);
+          auto counts = driver.CountVariableRange(count_variable, int_bounds);
           end = std::chrono::steady_clock::now();
-          auto count_time = end - start;
-          LOG(INFO) << "report bound: " << b << " count: " << count_result << " time: "
-                    << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+          report_counts("bound", int_bounds, counts, end - start);
         }
-        for (auto b : str_bounds) {
+        if (not str_bounds.empty()) {
           start = std::chrono::steady_clock::now();
-          auto count_result = driver.CountVariable(count_variable, b);
+          auto counts = driver.CountVariableRange(count_variable, str_bounds);
           end = std::chrono::steady_clock::now();
-          auto count_time = end - start;
-          LOG(INFO) << "report bound: " << b << " count: " << count_result << " time: "
-                    << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
-
+          report_counts("bound", str_bounds, counts, end - start);
         }
       } else if (not count_tuple) {
         if (int_bounds.size() == 1 and str_bounds.size() == 1 and int_bounds[0] == str_bounds[0]) {
@@ -310,21 +365,17 @@ int main(const int argc, const char **argv) {
                     << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
         } else {
           
-          for (auto b : int_bounds) {
+          if (not int_bounds.empty()) {
             start = std::chrono::steady_clock::now();
-            auto count = driver.CountInts(b);
+            auto counts = driver.CountIntsRange(int_bounds);
             end = std::chrono::steady_clock::now();
-            auto count_time = end - start;
-            LOG(INFO) << "report bound (integer): " << b << " count: " << count << " time: "
-                      << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+            report_counts("bound (integer)", int_bounds, counts, end - start);
           }
-          for (auto b : str_bounds) {
+          if (not str_bounds.empty()) {
             start = std::chrono::steady_clock::now();
-            auto count = driver.CountStrs(b);
+            auto counts = driver.CountStrsRange(str_bounds);
             end = std::chrono::steady_clock::now();
-            auto count_time = end - start;
-            LOG(INFO) << "report bound (string): " << b << " count: " << count << " time: "
-                      << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+            report_counts("bound (string)", str_bounds, counts, end - start);
           }
         }
 
@@ -356,6 +407,8 @@ int main(const int argc, const char **argv) {
     LOG(INFO) << "report count: 0 time: 0";
   }
 
+  write_profile(driver, profile_file);
+
   LOG(INFO) << "done.";
 
   if (file != nullptr) {
@@ -383,4 +436,19 @@ std::vector<std::string> parse_count_vars(std::string count_vars) {
     vars.push_back(tok);
   }
   return vars;
-}
\ No newline at end of file
+}
+
+void write_profile(const Vlab::Driver& driver, std::string profile_file) {
+  if (profile_file.empty()) {
+    return;
+  }
+  if (profile_file == "-") {
+    driver.GetProfile().WriteJson(std::cout);
+    return;
+  }
+  std::ofstream out(profile_file.c_str(), std::ofstream::out | std::ofstream::trunc);
+  if (not out) {
+    LOG(FATAL) << "Could not write profile to file; file name = " << profile_file;
+  }
+  driver.GetProfile().WriteJson(out);
+}
@@ -156,38 +156,31 @@ void ArithmeticConstraintSolver::visitAnd(And_ptr and_term) {
 	// 	}
 	// }
 
+  // conjuncts are planned before their values are constructed, smallest first
+  ConjunctPlanner planner (symbol_table_);
 	for (auto term : *(and_term->term_list)) {
 		auto formula = arithmetic_formula_generator_.get_term_formula(term);
 		// Do not visit child or terms here, handle them in POSTVISIT AND
 		if (formula != nullptr and (dynamic_cast<Or_ptr>(term) == nullptr)) {
 			has_arithmetic_formula = true;
-			visit(term);
-			auto param = get_term_value(term);
-			is_satisfiable = param->is_satisfiable();
-			if (is_satisfiable) {
-//        if (and_value == nullptr) {
-//          and_value = param->clone();
-//        } else {
-//          auto old_value = and_value;
-//          and_value = and_value->Intersect(param);
-//          delete old_value;
-//          is_satisfiable = and_value->is_satisfiable();
-//        }
-				auto term_group_name = arithmetic_formula_generator_.get_term_group_name(term);
-				if(term_group_name.empty()) {
-					LOG(FATAL) << "Term has no group!";
-				}
-				//LOG(INFO) << "------------ " << *term << " has group name " << term_group_name;
-				symbol_table_->IntersectValue(term_group_name,param);
-				is_satisfiable = symbol_table_->get_value(term_group_name)->is_satisfiable();
-			}
-			clear_term_value(term);
-			if (not is_satisfiable) {
-				break;
+			auto term_group_name = arithmetic_formula_generator_.get_term_group_name(term);
+			if(term_group_name.empty()) {
+				LOG(FATAL) << "Term has no group!";
 			}
+			planner.Add(term, term_group_name, formula->GetNumberOfVariables());
 		}
 	}
 
+  is_satisfiable = planner.Intersect([this](Term_ptr term) {
+    visit(term);
+    return get_term_value(term);
+  }, [this](Term_ptr term) {
+    clear_term_value(term);
+  });
+
+  Util::Profiler::AddComponent({ "arithmetic", group_name, planner.GetNumOfConjuncts(), planner.GetNumOfConstructedConjuncts(),
+                                 planner.GetConstructionTime(), planner.GetIntersectionTime() });
+
   DVLOG(VLOG_LEVEL) << "visit children of component end: " << *and_term << "@" << and_term;
 
   DVLOG(VLOG_LEVEL) << "post visit component start: " << *and_term << "@" << and_term;
@@ -432,6 +425,8 @@ void ArithmeticConstraintSolver::postVisitOr(Or_ptr or_term) {
 
   std::string group_name = arithmetic_formula_generator_.get_term_group_name(or_term);
   std::map<std::string,Value_ptr> or_values;
+  // values of the disjuncts are unioned once all of them are collected
+  std::map<std::string, std::vector<Value_ptr>> disjunct_values;
 
   for (auto term : *(or_term->term_list)) {
     symbol_table_->push_scope(term);
@@ -455,32 +450,32 @@ void ArithmeticConstraintSolver::postVisitOr(Or_ptr or_term) {
 			Value_ptr subgroup_scope_value = symbol_table_->get_value_at_scope(term,subgroup_variable);
 			if(subgroup_scope_value != nullptr) {
 				has_arithmetic_formula = true;
+				is_satisfiable = subgroup_scope_value->is_satisfiable() or is_satisfiable;
 				if(or_values.find(group) == or_values.end()) {
-					or_values[group] = subgroup_scope_value->clone();
-				} else {
-					auto old_value = or_values[group];
-					or_values[group] = or_values[group]->union_(subgroup_scope_value);
-					delete old_value;
+				  disjunct_values[group].push_back(subgroup_scope_value->clone());
 				}
-				
 				symbol_table_->clear_value(subgroup_variable,term);
-			} else {
+			} else if(or_values.find(group) == or_values.end()) {
+			  // union with any int is any int, values of the other disjuncts are not needed
         ArithmeticFormula_ptr group_formula = arithmetic_formula_generator_.get_group_formula(group);
         BinaryIntAutomaton_ptr any_int_auto = BinaryIntAutomaton::MakeAnyInt(group_formula->clone(),not Option::Solver::USE_SIGNED_INTEGERS);
-        Value_ptr any_int_val = new Value(any_int_auto);
-  		  if(or_values.find(group) == or_values.end()) {
-          or_values[group] = any_int_val;
-  		  } else {
-  		    // should union, but union with any string is any string.
-  		    delete or_values[group];
-  		    or_values[group] = any_int_val;
-  		  }
+        or_values[group] = new Value(any_int_auto);
+        for (auto value : disjunct_values[group]) {
+          delete value;
+        }
+        disjunct_values[group].clear();
+        is_satisfiable = true;
       }
-      is_satisfiable = or_values[group]->is_satisfiable() or is_satisfiable;
 		}
     symbol_table_->pop_scope();
 	}
 
+  for (auto& it : disjunct_values) {
+    if (not it.second.empty()) {
+      or_values[it.first] = Value::union_all(it.second);
+    }
+  }
+
 
   DVLOG(VLOG_LEVEL) << "collect child results end: " << *or_term << "@" << or_term;
 
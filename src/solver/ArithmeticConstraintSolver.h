@@ -8,6 +8,7 @@
 #ifndef SOLVER_ARITHMETICCONSTRAINTSOLVER_H_
 #define SOLVER_ARITHMETICCONSTRAINTSOLVER_H_
 
+#include <chrono>
 #include <iostream>
 #include <map>
 #include <string>
@@ -20,8 +21,10 @@
 #include "../smt/typedefs.h"
 #include "../theory/ArithmeticFormula.h"
 #include "../theory/BinaryIntAutomaton.h"
+#include "../utils/Profiler.h"
 #include "ArithmeticFormulaGenerator.h"
 #include "AstTraverser.h"
+#include "ConjunctPlanner.h"
 #include "ConstraintInformation.h"
 #include "SymbolTable.h"
 #include "Value.h"
@@ -12,7 +12,35 @@ namespace Solver {
 
 using namespace SMT;
 
-int Ast2Dot::name_counter = 0;
+thread_local int Ast2Dot::name_counter = 0;
+
+/**
+ * Escapes quotes, backslashes and line breaks so that literals cannot end a label,
+ * different labels always give different dot text
+ */
+static std::string escape_label(const std::string& label) {
+  std::string escaped;
+  escaped.reserve(label.size());
+  for (char c : label) {
+    switch (c) {
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      case '\r':
+        escaped += "\\r";
+        break;
+      default:
+        escaped += c;
+    }
+  }
+  return escaped;
+}
 
 Ast2Dot::Ast2Dot(std::ostream* out)
         : m_out(out), count(0) {
@@ -51,7 +79,7 @@ void Ast2Dot::add_edge(u_int64_t p, u_int64_t c) {
 }
 
 void Ast2Dot::add_node(u_int64_t c, std::string label) {
-  *m_out << "\"" << c << "\" [label=\"" << label << "\"];" << std::endl;
+  *m_out << "\"" << c << "\" [label=\"" << escape_label(label) << "\"];" << std::endl;
 }
 
 void Ast2Dot::draw(std::string label, Visitable_ptr p) {
@@ -68,7 +96,7 @@ void Ast2Dot::draw(std::string label, Visitable_ptr p) {
 
 void Ast2Dot::draw_terminal(std::string label) {
   count++;
-  *m_out << "\"" << count << "\" [label=\"" << label << "\"];" << std::endl;
+  *m_out << "\"" << count << "\" [label=\"" << escape_label(label) << "\"];" << std::endl;
   add_edge(s.top(), count);
 }
 
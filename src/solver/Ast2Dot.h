@@ -117,7 +117,7 @@ private:
   std::ostream* m_out; //file for writting output
   u_int64_t count; //used to give each node a uniq id
   std::stack<u_int64_t> s; //stack for tracking parent/child pairs
-  static int name_counter;
+  static thread_local int name_counter;
 
 };
 
@@ -0,0 +1,80 @@
+/*
+ * ConjunctPlanner.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "ConjunctPlanner.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Vlab {
+namespace Solver {
+
+const int ConjunctPlanner::VLOG_LEVEL = 13;
+
+ConjunctPlanner::ConjunctPlanner(SymbolTable_ptr symbol_table)
+    : symbol_table_ { symbol_table },
+      num_of_constructed_conjuncts_ { 0 },
+      construction_ms_ { 0 },
+      intersection_ms_ { 0 } {
+}
+
+ConjunctPlanner::~ConjunctPlanner() {
+}
+
+void ConjunctPlanner::Add(SMT::Term_ptr term, const std::string& group_name, const std::size_t estimated_size) {
+  conjuncts_.push_back(Conjunct { term, group_name, estimated_size });
+}
+
+bool ConjunctPlanner::Intersect(ValueConstructor construct_value, ValueReleaser release_value) {
+  if (Option::Solver::ORDER_CONJUNCTS) {
+    // stable so that conjuncts of the same size keep their order
+    std::stable_sort(conjuncts_.begin(), conjuncts_.end(), [](const Conjunct& left, const Conjunct& right) {
+      return left.estimated_size < right.estimated_size;
+    });
+  }
+  for (auto& conjunct : conjuncts_) {
+    auto start = std::chrono::steady_clock::now();
+    Value_ptr value = construct_value(conjunct.term);
+    ++num_of_constructed_conjuncts_;
+    auto construction_end = std::chrono::steady_clock::now();
+    construction_ms_ += std::chrono::duration<double, std::milli>(construction_end - start).count();
+
+    DVLOG(VLOG_LEVEL) << "intersect conjunct of estimated size " << conjunct.estimated_size << " into group " << conjunct.group_name;
+    bool is_satisfiable = value->is_satisfiable();
+    if (is_satisfiable) {
+      symbol_table_->IntersectValue(conjunct.group_name, value);
+      is_satisfiable = symbol_table_->get_value(conjunct.group_name)->is_satisfiable();
+    }
+    release_value(conjunct.term);
+    intersection_ms_ += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - construction_end).count();
+    if (not is_satisfiable) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::size_t ConjunctPlanner::GetNumOfConjuncts() const {
+  return conjuncts_.size();
+}
+
+std::size_t ConjunctPlanner::GetNumOfConstructedConjuncts() const {
+  return num_of_constructed_conjuncts_;
+}
+
+double ConjunctPlanner::GetConstructionTime() const {
+  return construction_ms_;
+}
+
+double ConjunctPlanner::GetIntersectionTime() const {
+  return intersection_ms_;
+}
+
+} /* namespace Solver */
+} /* namespace Vlab */
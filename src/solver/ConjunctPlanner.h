@@ -0,0 +1,94 @@
+/*
+ * ConjunctPlanner.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_SOLVER_CONJUNCTPLANNER_H_
+#define SRC_SOLVER_CONJUNCTPLANNER_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "../smt/ast.h"
+#include "options/Solver.h"
+#include "SymbolTable.h"
+#include "Value.h"
+
+namespace Vlab {
+namespace Solver {
+
+/**
+ * Intersects the values of the conjuncts of a component into the values of their groups.
+ * Conjuncts are planned before their values are constructed, smallest estimated automaton
+ * first, so that a large relation meets a group value that the small conjuncts already
+ * constrained. Each value is intersected as soon as it is constructed and the remaining
+ * conjuncts are not constructed once a value is empty.
+ */
+class ConjunctPlanner {
+ public:
+  /**
+   * Constructs the value of a conjunct, the value stays owned by the caller
+   */
+  using ValueConstructor = std::function<Value_ptr(SMT::Term_ptr)>;
+  /**
+   * Releases the value of a conjunct once it is intersected
+   */
+  using ValueReleaser = std::function<void(SMT::Term_ptr)>;
+
+  ConjunctPlanner(SymbolTable_ptr symbol_table);
+  ~ConjunctPlanner();
+
+  /**
+   * @param term
+   * @param group_name
+   * @param estimated_size estimated size of the automaton of the term, known before its value
+   *        is constructed, e.g. the number of variables of its formula
+   */
+  void Add(SMT::Term_ptr term, const std::string& group_name, const std::size_t estimated_size);
+
+  /**
+   * Constructs the values of the added conjuncts and intersects them into their group values,
+   * in the order they are added if conjunct ordering is disabled
+   * @param construct_value
+   * @param release_value
+   * @return false if a conjunct value or a group value becomes empty
+   */
+  bool Intersect(ValueConstructor construct_value, ValueReleaser release_value);
+
+  std::size_t GetNumOfConjuncts() const;
+  /**
+   * @return number of conjuncts whose values are constructed, less than the number of conjuncts
+   *         if intersection stopped early
+   */
+  std::size_t GetNumOfConstructedConjuncts() const;
+  double GetConstructionTime() const;
+  double GetIntersectionTime() const;
+
+ private:
+  struct Conjunct {
+    SMT::Term_ptr term;
+    std::string group_name;
+    std::size_t estimated_size;
+  };
+
+  SymbolTable_ptr symbol_table_;
+  std::vector<Conjunct> conjuncts_;
+  std::size_t num_of_constructed_conjuncts_;
+  double construction_ms_;
+  double intersection_ms_;
+
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Solver */
+} /* namespace Vlab */
+
+#endif /* SRC_SOLVER_CONJUNCTPLANNER_H_ */
@@ -14,7 +14,7 @@ using namespace SMT;
 using namespace Theory;
 
 const int ConstraintSolver::VLOG_LEVEL = 11;
-bool ConstraintSolver::many_vars = false;
+thread_local bool ConstraintSolver::many_vars = false;
 
 ConstraintSolver::ConstraintSolver(Script_ptr script, SymbolTable_ptr symbol_table,
                                    ConstraintInformation_ptr constraint_information)
@@ -24,7 +24,8 @@ ConstraintSolver::ConstraintSolver(Script_ptr script, SymbolTable_ptr symbol_tab
       constraint_information_(constraint_information),
       arithmetic_constraint_solver_(script, symbol_table, constraint_information,
                                     Option::Solver::USE_SIGNED_INTEGERS),
-      string_constraint_solver_(script, symbol_table, constraint_information) {
+      string_constraint_solver_(script, symbol_table, constraint_information),
+      string_encoding_ { nullptr } {
 	Automaton::SetCountBoundExact(Option::Solver::COUNT_BOUND_EXACT);
 }
 
@@ -179,6 +180,10 @@ void ConstraintSolver::visitAnd(And_ptr and_term) {
     }
 
     DVLOG(VLOG_LEVEL) << "Multi-track solving done: " << *and_term << "@" << and_term;
+
+    if (Option::Solver::COMPACT_STRING_ENCODING and symbol_table_->top_scope() == root_) {
+      string_encoding_ = set_string_encoding(and_term);
+    }
   }
 
   DVLOG(VLOG_LEVEL) << "visit children start: " << *and_term << "@" << and_term;
@@ -218,6 +223,10 @@ void ConstraintSolver::visitAnd(And_ptr and_term) {
     }
   }
 
+  if (is_component) {
+    string_encoding_ = nullptr;
+  }
+
   Value_ptr result = new Value(is_satisfiable);
   setTermValue(and_term, result);
 }
@@ -251,6 +260,9 @@ void ConstraintSolver::visitOr(Or_ptr or_term) {
 
   //if (constraint_information_->has_mixed_constraint(or_term)) {
   if(true) {
+    // disjuncts are solved one after another, their values are built with automata operations
+    // that need the MONA lock and they share the term values of the solvers; postVisitOr
+    // merges the values of the scopes with Value::union_all
     for (auto& term : *(or_term->term_list)) {
       symbol_table_->push_scope(term);
       bool is_scope_satisfiable = check_and_visit(term);
@@ -715,7 +727,9 @@ void ConstraintSolver::visitIn(In_ptr in_term) {
     auto left_var = dynamic_cast<QualIdentifier_ptr>(in_term->left_term);
     auto right_constant = dynamic_cast<TermConstant_ptr>(in_term->right_term);
     Variable_ptr var = symbol_table_->get_variable(left_var->getVarName());
-    auto temp = StringAutomaton::MakeRegexAuto(right_constant->getValue());
+    auto temp = (string_encoding_ == nullptr) ?
+        StringAutomaton::MakeRegexAuto(right_constant->getValue()) :
+        StringAutomaton::MakeRegexAuto(right_constant->getValue(), *string_encoding_);
     auto formula = new Theory::StringFormula();
     formula->AddVariable(left_var->getVarName(), 1);
     formula->SetType(Theory::StringFormula::Type::VAR);
@@ -814,7 +828,7 @@ void ConstraintSolver::visitNotContains(NotContains_ptr not_contains_term) {
     delete sub_strings_auto;
     sub_strings_auto = nullptr;
     if (difference_auto->IsEmptyLanguage()) {
-      result = new Value(Theory::StringAutomaton::MakePhi());
+      result = new Value(Theory::StringAutomaton::MakePhi(param_subject->getStringAutomaton()->get_number_of_bdd_variables()));
     } else {
       result = param_subject->clone();
     }
@@ -860,7 +874,7 @@ void ConstraintSolver::visitNotBegins(NotBegins_ptr not_begins_term) {
     delete prefixes_auto;
     prefixes_auto = nullptr;
     if (difference_auto->IsEmptyLanguage()) {
-      result = new Value(Theory::StringAutomaton::MakePhi());
+      result = new Value(Theory::StringAutomaton::MakePhi(param_subject->getStringAutomaton()->get_number_of_bdd_variables()));
     } else {
       result = param_subject->clone();
     }
@@ -904,7 +918,7 @@ void ConstraintSolver::visitNotEnds(NotEnds_ptr not_ends_term) {
     delete suffixes_auto;
     suffixes_auto = nullptr;
     if (difference_auto->IsEmptyLanguage()) {
-      result = new Value(Theory::StringAutomaton::MakePhi());
+      result = new Value(Theory::StringAutomaton::MakePhi(param_subject->getStringAutomaton()->get_number_of_bdd_variables()));
     } else {
       result = param_subject->clone();
     }
@@ -1319,10 +1333,18 @@ void ConstraintSolver::visitTermConstant(TermConstant_ptr term_constant) {
       // TODO instead we may use string constants before going into automaton
       // and keep it unless we need automaton
       // this may complicate the code with a perf gain ??
-      result = new Value(Theory::StringAutomaton::MakeString(term_constant->getValue()));
+      if (string_encoding_ == nullptr) {
+        result = new Value(Theory::StringAutomaton::MakeString(term_constant->getValue()));
+      } else {
+        result = new Value(Theory::StringAutomaton::MakeString(term_constant->getValue(), *string_encoding_));
+      }
       break;
       case Primitive::Type::REGEX:
-      result = new Value(Theory::StringAutomaton::MakeRegexAuto(term_constant->getValue()));
+      if (string_encoding_ == nullptr) {
+        result = new Value(Theory::StringAutomaton::MakeRegexAuto(term_constant->getValue()));
+      } else {
+        result = new Value(Theory::StringAutomaton::MakeRegexAuto(term_constant->getValue(), *string_encoding_));
+      }
       break;
       default:
       LOG(FATAL) << "unhandled term constant: " << *term_constant;
@@ -1550,5 +1572,141 @@ bool ConstraintSolver::process_mixed_integer_string_constraints_in(Term_ptr term
   return is_satisfiable;
 }
 
+/**
+ * Conjuncts of the component have to be membership, containment, prefix or suffix constraints
+ * between a string variable and a constant. They are solved on the automaton of the variable
+ * alone, so the codes of the constants are all that the automata of the component combine.
+ */
+const Theory::StringEncoding* ConstraintSolver::set_string_encoding(And_ptr and_term) {
+  if (constraint_information_->has_arithmetic_constraint(and_term)) {
+    return nullptr;
+  }
+
+  StringEncoding encoding;
+  std::vector<Variable_ptr> variables;
+  for (auto term : *(and_term->term_list)) {
+    Term_ptr variable_term = nullptr, constant_term = nullptr;
+    // visitIn builds the automaton of its constant as a regex
+    bool is_regex_constant = false;
+    switch (term->type()) {
+      case Term::Type::IN: {
+        auto in_term = dynamic_cast<In_ptr>(term);
+        variable_term = in_term->left_term;
+        constant_term = in_term->right_term;
+        is_regex_constant = true;
+        break;
+      }
+      case Term::Type::NOTIN: {
+        auto not_in_term = dynamic_cast<NotIn_ptr>(term);
+        variable_term = not_in_term->left_term;
+        constant_term = not_in_term->right_term;
+        break;
+      }
+      case Term::Type::CONTAINS: {
+        auto contains_term = dynamic_cast<Contains_ptr>(term);
+        variable_term = contains_term->subject_term;
+        constant_term = contains_term->search_term;
+        break;
+      }
+      case Term::Type::NOTCONTAINS: {
+        auto not_contains_term = dynamic_cast<NotContains_ptr>(term);
+        variable_term = not_contains_term->subject_term;
+        constant_term = not_contains_term->search_term;
+        break;
+      }
+      case Term::Type::BEGINS: {
+        auto begins_term = dynamic_cast<Begins_ptr>(term);
+        variable_term = begins_term->subject_term;
+        constant_term = begins_term->search_term;
+        break;
+      }
+      case Term::Type::NOTBEGINS: {
+        auto not_begins_term = dynamic_cast<NotBegins_ptr>(term);
+        variable_term = not_begins_term->subject_term;
+        constant_term = not_begins_term->search_term;
+        break;
+      }
+      case Term::Type::ENDS: {
+        auto ends_term = dynamic_cast<Ends_ptr>(term);
+        variable_term = ends_term->subject_term;
+        constant_term = ends_term->search_term;
+        break;
+      }
+      case Term::Type::NOTENDS: {
+        auto not_ends_term = dynamic_cast<NotEnds_ptr>(term);
+        variable_term = not_ends_term->subject_term;
+        constant_term = not_ends_term->search_term;
+        break;
+      }
+      default:
+        return nullptr;
+    }
+
+    auto qi_term = dynamic_cast<QualIdentifier_ptr>(variable_term);
+    auto term_constant = dynamic_cast<TermConstant_ptr>(constant_term);
+    if (qi_term == nullptr or term_constant == nullptr or constraint_information_->has_string_constraint(term)) {
+      return nullptr;
+    }
+    Variable_ptr variable = symbol_table_->get_variable(qi_term->getVarName());
+    if (Variable::Type::STRING != variable->getType()) {
+      return nullptr;
+    }
+    if (Primitive::Type::STRING == term_constant->getValueType() and not is_regex_constant) {
+      encoding.AddString(term_constant->getValue());
+    } else if (Primitive::Type::STRING == term_constant->getValueType() or Primitive::Type::REGEX == term_constant->getValueType()) {
+      Util::RegularExpression regular_expression (term_constant->getValue());
+      encoding.AddRegex(&regular_expression);
+    } else {
+      return nullptr;
+    }
+    if (std::find(variables.begin(), variables.end(), variable) == variables.end()) {
+      variables.push_back(variable);
+    }
+  }
+
+  if (variables.empty()) {
+    return nullptr;
+  }
+
+  // a component that is solved again keeps the encoding its values are built with
+  if (symbol_table_->get_string_encoding(variables.front()) != nullptr) {
+    for (auto variable : variables) {
+      CHECK(symbol_table_->get_string_encoding(variable) != nullptr) << "mixed string encodings in a component";
+    }
+    return symbol_table_->get_string_encoding(variables.front());
+  }
+
+  auto any_string_auto = StringAutomaton::MakeAnyString();
+  for (auto variable : variables) {
+    auto variable_value = symbol_table_->get_value(variable);
+    if (variable_value == nullptr or Value::Type::STRING_AUTOMATON != variable_value->getType()
+        or variable_value->getStringAutomaton()->GetNumTracks() != 1
+        or variable_value->getStringAutomaton()->get_number_of_bdd_variables() != any_string_auto->get_number_of_bdd_variables()
+        or not variable_value->getStringAutomaton()->IsEqual(any_string_auto)) {
+      delete any_string_auto;
+      return nullptr;
+    }
+  }
+  delete any_string_auto;
+
+  encoding.Compact();
+  if (encoding.IsIdentity()) {
+    return nullptr;
+  }
+
+  DVLOG(VLOG_LEVEL) << "string encoding with " << encoding.GetAlphabetSize() << " codes: " << *and_term << "@" << and_term;
+  for (auto variable : variables) {
+    symbol_table_->set_string_encoding(variable, encoding);
+    auto string_auto = StringAutomaton::MakeAnyString(encoding.GetNumOfBddVariables());
+    auto formula = string_auto->GetFormula();
+    formula->SetType(StringFormula::Type::VAR);
+    formula->AddVariable(variable->getName(), 1);
+    Value_ptr value = new Value(string_auto);
+    symbol_table_->set_value(variable, value);
+    delete value;
+  }
+  return symbol_table_->get_string_encoding(variables.front());
+}
+
 } /* namespace Solver */
 } /* namespace Vlab */
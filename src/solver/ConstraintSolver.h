@@ -8,6 +8,7 @@
 #ifndef SOLVER_CONSTRAINTSOLVER_H_
 #define SOLVER_CONSTRAINTSOLVER_H_
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 #include <string>
@@ -133,6 +134,14 @@ class ConstraintSolver: public SMT::Visitor {
   void visit_children_of(SMT::Term_ptr term);
   bool check_and_visit(SMT::Term_ptr term);
   bool process_mixed_integer_string_constraints_in(SMT::Term_ptr term);
+  /**
+   * Sets a compact encoding for the string variables of a component if each conjunct of it
+   * restricts a single string variable with a string or regex constant and the variables
+   * are not restricted yet.
+   * @param and_term component
+   * @return encoding the string automata of the component are built with, nullptr for the full alphabet
+   */
+  const Theory::StringEncoding* set_string_encoding(SMT::And_ptr and_term);
 
   int iteration_count_;
   SMT::Script_ptr root_;
@@ -142,6 +151,11 @@ class ConstraintSolver: public SMT::Visitor {
   ArithmeticConstraintSolver arithmetic_constraint_solver_;
   StringConstraintSolver string_constraint_solver_;
 
+  /**
+   * Encoding of the component being solved, nullptr if its automata use the full alphabet
+   */
+  const Theory::StringEncoding* string_encoding_;
+
   TermValueMap term_values_;
 
   std::vector<SMT::Term_ptr> path_trace_;
@@ -149,7 +163,7 @@ class ConstraintSolver: public SMT::Visitor {
 
   // for relational variables that need to be updated
   std::vector<SMT::Variable_ptr> tagged_variables;
-  static bool many_vars;
+  static thread_local bool many_vars;
  private:
   static const int VLOG_LEVEL;
 };
@@ -42,6 +42,43 @@ void Initializer::visitScript(Script_ptr script) {
 
   CommandList_ptr commands = script->command_list;
 
+  // the result is the result of the last check-sat, later commands do not change it
+  auto last_check_sat = std::find_if(commands->rbegin(), commands->rend(), [](Command_ptr command) {
+    return command->getType() == Command::Type::CHECK_SAT;
+  }).base();
+  if (last_check_sat != commands->begin()) {
+    for (auto iter = last_check_sat; iter != commands->end(); ++iter) {
+      delete (*iter);
+    }
+    commands->erase(last_check_sat, commands->end());
+  }
+
+  // number of commands kept at each push, a pop drops the assertions and declarations made since the matching push
+  std::vector<std::size_t> assertion_levels;
+  for (auto iter = commands->begin(); iter != commands->end();) {
+    if ((*iter)->getType() == Command::Type::PUSH) {
+      const std::size_t num_commands = iter - commands->begin();
+      assertion_levels.insert(assertion_levels.end(), dynamic_cast<Push_ptr>(*iter)->num_levels(), num_commands);
+      delete (*iter);
+      iter = commands->erase(iter);
+    } else if ((*iter)->getType() == Command::Type::POP) {
+      const unsigned num_levels = dynamic_cast<Pop_ptr>(*iter)->num_levels();
+      CHECK_LE(num_levels, assertion_levels.size()) << "pop without a matching push";
+      delete (*iter);
+      iter = commands->erase(iter);
+      if (num_levels > 0) {
+        const std::size_t num_commands = assertion_levels[assertion_levels.size() - num_levels];
+        assertion_levels.resize(assertion_levels.size() - num_levels);
+        for (auto popped = commands->begin() + num_commands; popped != iter; ++popped) {
+          delete (*popped);
+        }
+        iter = commands->erase(commands->begin() + num_commands, iter);
+      }
+    } else {
+      iter++;
+    }
+  }
+
   for (auto iter = commands->begin(); iter != commands->end();) {
     if ((*iter)->getType() != Command::Type::ASSERT) {
       visit(*iter);
@@ -9,6 +9,7 @@
 #define SOLVER_INITIALIZER_H_
 
 
+#include <algorithm>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -43,7 +43,71 @@ void ModelCounter::add_symbolic_counter(const Theory::SymbolicCounter& counter)
 
 
 Theory::BigInteger ModelCounter::CountInts(const unsigned long bound) {
-  Theory::BigInteger result(1);
+  return CountIntsRange({bound}).front();
+}
+
+Theory::BigInteger ModelCounter::CountStrs(const unsigned long bound) {
+  return CountStrsRange({bound}).front();
+}
+
+Theory::BigInteger ModelCounter::Count(const unsigned long int_bound, const unsigned long str_bound) {
+  return CountInts(int_bound) * CountStrs(str_bound);
+}
+
+std::vector<Theory::BigInteger> ModelCounter::CountIntsRange(const std::vector<unsigned long>& bounds) {
+  std::vector<Theory::BigInteger> results(bounds.size(), 0);
+  std::vector<bool> is_within_bound(bounds.size(), false);
+  std::vector<unsigned long> bounds_to_count;
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    is_within_bound[i] = IsConstantIntsWithinBound(bounds[i]);
+    if (is_within_bound[i]) {
+      bounds_to_count.push_back(bounds[i]);
+    } // otherwise count is 0, no need to compute further
+  }
+  if (bounds_to_count.empty()) {
+    return results;
+  }
+
+  std::vector<Theory::BigInteger> counts(bounds_to_count.size(), 1);
+  for (auto& counter_results : CountSymbolicCounters(false, bounds_to_count)) {
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+      counts[i] *= counter_results[i];
+    }
+  }
+
+  for (std::size_t i = 0, j = 0; i < bounds.size(); ++i) {
+    if (is_within_bound[i]) {
+      results[i] = counts[j] * CountUnconstraintInts(bounds[i]);
+      ++j;
+    }
+  }
+  return results;
+}
+
+std::vector<Theory::BigInteger> ModelCounter::CountStrsRange(const std::vector<unsigned long>& bounds) {
+  std::vector<Theory::BigInteger> results(bounds.size(), 1);
+  for (auto& counter_results : CountSymbolicCounters(true, bounds)) {
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      results[i] *= counter_results[i];
+    }
+  }
+
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    results[i] *= CountUnconstraintStrs(bounds[i]);
+  }
+  return results;
+}
+
+std::vector<Theory::BigInteger> ModelCounter::CountRange(const std::vector<unsigned long>& bounds) {
+  auto results = CountIntsRange(bounds);
+  auto str_results = CountStrsRange(bounds);
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    results[i] *= str_results[i];
+  }
+  return results;
+}
+
+bool ModelCounter::IsConstantIntsWithinBound(const unsigned long bound) const {
   for (int i : constant_ints_) {
     Theory::BigInteger value(i);
     auto shift = bound;
@@ -58,67 +122,93 @@ Theory::BigInteger ModelCounter::CountInts(const unsigned long bound) {
     }
 
     if (not (value <= upper_bound and value >= lower_bound)) {
-     return 0; // no need to compute further
+      return false;
     }
   }
+  return true;
+}
 
-
+std::vector<std::vector<Theory::BigInteger>> ModelCounter::CountSymbolicCounters(const bool count_strings,
+                                                                                 const std::vector<unsigned long>& bounds) {
+  auto start = std::chrono::steady_clock::now();
+  auto record_time = [count_strings, &start]() {
+    auto end = std::chrono::steady_clock::now();
+    Util::Profiler::AddCountTime(count_strings ? "strings" : "ints",
+                                 std::chrono::duration<double, std::milli>(end - start).count());
+  };
+  std::vector<Theory::SymbolicCounter*> counters;
   for (Theory::SymbolicCounter& counter : symbolic_counters_) {
-    if (Theory::SymbolicCounter::Type::STRING != counter.type()) {
-      result = result * counter.Count(bound);
+    if ((Theory::SymbolicCounter::Type::STRING == counter.type()) == count_strings) {
+      counters.push_back(&counter);
     }
   }
 
-  if (unconstraint_int_vars_ > 0) {
-//   if (use_signed_integers_) {
-//     result = result
-//            * boost::multiprecision::pow(
-//                (boost::multiprecision::pow(
-//                    boost::multiprecision::cpp_int(2),
-//                    (bound+1)) - 1),
-//                unconstraint_int_vars_);
-//     LOG(INFO) << result << " (signed)";
-//   } else {
-     result = result
-         * boost::multiprecision::pow(boost::multiprecision::cpp_int(2),
-                                      (unconstraint_int_vars_ * (bound + (use_signed_integers_ ? 1 : 0))));
-//   }
+  std::vector<std::vector<Theory::BigInteger>> results(counters.size());
+  std::size_t num_of_threads = Option::Solver::COUNT_THREADS;
+  if (num_of_threads == 0) {
+    num_of_threads = std::max(1u, std::thread::hardware_concurrency());
   }
-
-  return result;
-}
-
-Theory::BigInteger ModelCounter::CountStrs(const unsigned long bound) {
-  Theory::BigInteger result(1);
-
-  for (Theory::SymbolicCounter& counter : symbolic_counters_) {
-    if (Theory::SymbolicCounter::Type::STRING == counter.type()) {
-      result = result * counter.Count(bound);
+  num_of_threads = std::min(num_of_threads, counters.size());
+  if (num_of_threads <= 1) {
+    for (std::size_t i = 0; i < counters.size(); ++i) {
+      results[i] = counters[i]->CountRange(bounds);
     }
+    record_time();
+    return results;
   }
 
-  if (unconstraint_str_vars_ > 0) {
-  	if(count_bound_exact_) {
-  		Theory::BigInteger single_unconstraint_str_count = (boost::multiprecision::pow(
-				boost::multiprecision::cpp_int(256), bound));
-			result = result
-			 * boost::multiprecision::pow(single_unconstraint_str_count,
-																		unconstraint_str_vars_);
-  	} else {
-			Theory::BigInteger single_unconstraint_str_count = (boost::multiprecision::pow(
-				boost::multiprecision::cpp_int(256), (bound + 1)) - 1)
-						/ 255;
-			result = result
-			 * boost::multiprecision::pow(single_unconstraint_str_count,
-																		unconstraint_str_vars_);
-  	}
+  // counting does not touch MONA, workers only need the option values of the calling thread
+  const Option::Context context = Option::Context::Current();
+  std::atomic<std::size_t> next_counter { 0 };
+  // an exception must not leave a worker, it is rethrown on the calling thread after all workers joined
+  std::vector<std::exception_ptr> errors(num_of_threads);
+  auto count = [&counters, &results, &bounds, &context, &next_counter, &errors](const std::size_t t) {
+    try {
+      Option::ScopedContext scoped_context(context);
+      for (std::size_t i = next_counter++; i < counters.size(); i = next_counter++) {
+        results[i] = counters[i]->CountRange(bounds);
+      }
+    } catch (...) {
+      errors[t] = std::current_exception();
+      next_counter = counters.size();
+    }
+  };
+  std::vector<std::thread> workers;
+  for (std::size_t t = 1; t < num_of_threads; ++t) {
+    workers.push_back(std::thread(count, t));
+  }
+  count(0);
+  for (auto& worker : workers) {
+    worker.join();
   }
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  record_time();
+  return results;
+}
 
-  return result;
+Theory::BigInteger ModelCounter::CountUnconstraintInts(const unsigned long bound) const {
+  if (unconstraint_int_vars_ <= 0) {
+    return 1;
+  }
+  return boost::multiprecision::pow(boost::multiprecision::cpp_int(2),
+                                    (unconstraint_int_vars_ * (bound + (use_signed_integers_ ? 1 : 0))));
 }
 
-Theory::BigInteger ModelCounter::Count(const unsigned long int_bound, const unsigned long str_bound) {
-  return CountInts(int_bound) * CountStrs(str_bound);
+Theory::BigInteger ModelCounter::CountUnconstraintStrs(const unsigned long bound) const {
+  if (unconstraint_str_vars_ <= 0) {
+    return 1;
+  }
+  Theory::BigInteger single_unconstraint_str_count;
+  if (count_bound_exact_) {
+    single_unconstraint_str_count = boost::multiprecision::pow(boost::multiprecision::cpp_int(256), bound);
+  } else {
+    single_unconstraint_str_count = (boost::multiprecision::pow(boost::multiprecision::cpp_int(256), (bound + 1)) - 1) / 255;
+  }
+  return boost::multiprecision::pow(single_unconstraint_str_count, unconstraint_str_vars_);
 }
 
 std::string ModelCounter::str() const {
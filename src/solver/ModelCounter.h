@@ -8,17 +8,24 @@
 #ifndef SRC_SOLVER_MODELCOUNTER_H_
 #define SRC_SOLVER_MODELCOUNTER_H_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <functional>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <glog/logging.h>
 
 #include "../cereal/types/vector.hpp"
 #include "../theory/SymbolicCounter.h"
+#include "../utils/Profiler.h"
 #include "../utils/Serialize.h"
+#include "options/Solver.h"
 
 namespace Vlab {
 namespace Solver {
@@ -37,6 +44,22 @@ class ModelCounter {
   Theory::BigInteger CountStrs(const unsigned long bound);
   Theory::BigInteger Count(const unsigned long int_bound, const unsigned long str_bound);
 
+  /**
+   * Batch versions of the counting functions, each symbolic counter sweeps
+   * the sorted bounds once instead of restarting for every smaller bound
+   * @param bounds in any order
+   * @return counts in the order of bounds
+   */
+  std::vector<Theory::BigInteger> CountIntsRange(const std::vector<unsigned long>& bounds);
+  std::vector<Theory::BigInteger> CountStrsRange(const std::vector<unsigned long>& bounds);
+
+  /**
+   * Same as calling Count(bound, bound) for each bound
+   * @param bounds
+   * @return
+   */
+  std::vector<Theory::BigInteger> CountRange(const std::vector<unsigned long>& bounds);
+
   template <class Archive>
   void save(Archive& ar) const {
     ar(use_signed_integers_);
@@ -57,6 +80,20 @@ class ModelCounter {
   std::string str() const;
   friend std::ostream& operator<<(std::ostream& os, const ModelCounter& mc);
  protected:
+  bool IsConstantIntsWithinBound(const unsigned long bound) const;
+  /**
+   * Counts the symbolic counters of strings or of integers. Counters belong to independent
+   * components, they are counted on up to Option::Solver::COUNT_THREADS threads. Counting time
+   * is recorded in the active profile.
+   * @param count_strings
+   * @param bounds
+   * @return counts of each counter for the bounds, in the order the counters are added
+   */
+  std::vector<std::vector<Theory::BigInteger>> CountSymbolicCounters(const bool count_strings,
+                                                                     const std::vector<unsigned long>& bounds);
+  Theory::BigInteger CountUnconstraintInts(const unsigned long bound) const;
+  Theory::BigInteger CountUnconstraintStrs(const unsigned long bound) const;
+
   bool use_signed_integers_;
   bool count_bound_exact_;
   int unconstraint_int_vars_;
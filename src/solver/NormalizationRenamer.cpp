@@ -9,15 +9,17 @@ namespace Solver {
 
 using namespace SMT;
 
-NormalizationRenamer::NormalizationRenamer(Script_ptr script, SymbolTable_ptr symbol_table)
+NormalizationRenamer::NormalizationRenamer(Script_ptr script, SymbolTable_ptr symbol_table, bool rename_constants)
     : root_(script),
-      symbol_table_(symbol_table) {
+      symbol_table_(symbol_table),
+      rename_constants_(rename_constants) {
 }
 
 NormalizationRenamer::NormalizationRenamer(Script_ptr script, SymbolTable_ptr symbol_table,
                         std::map<std::string,std::string> var_map, std::map<char,char> char_map)
     : root_ (script),
       symbol_table_(symbol_table),
+      rename_constants_(true),
       variable_mapping_(var_map),
       alphabet_mapping_(char_map) {
 
@@ -61,16 +63,19 @@ void NormalizationRenamer::visitTerm(Term_ptr term) {
 }
 
 void NormalizationRenamer::visitExclamation(Exclamation_ptr exclamation_term) {
+  visit_children_of(exclamation_term);
 }
 
 void NormalizationRenamer::visitExists(Exists_ptr exists_term) {
+  visit_children_of(exists_term);
 }
 
 void NormalizationRenamer::visitForAll(ForAll_ptr for_all_term) {
+  visit_children_of(for_all_term);
 }
 
 void NormalizationRenamer::visitLet(Let_ptr let_term) {
-  LOG(ERROR) << "optimizations are not checked for let term";
+  visit_children_of(let_term);
 }
 
 void NormalizationRenamer::visitAnd(And_ptr and_term) {
@@ -112,7 +117,7 @@ void NormalizationRenamer::visitTimes(Times_ptr times_term) {
 }
 
 void NormalizationRenamer::visitDiv(Div_ptr div_term) {
-  LOG(FATAL) << "implement me";
+  visit_children_of(div_term);
 }
 
 void NormalizationRenamer::visitEq(Eq_ptr eq_term) {
@@ -219,6 +224,7 @@ void NormalizationRenamer::visitToInt(ToInt_ptr to_int_term) {
 }
 
 void NormalizationRenamer::visitReplace(Replace_ptr replace_term) {
+  visit_children_of(replace_term);
 }
 
 void NormalizationRenamer::visitCount(Count_ptr count_term) {
@@ -226,33 +232,43 @@ void NormalizationRenamer::visitCount(Count_ptr count_term) {
 }
 
 void NormalizationRenamer::visitIte(Ite_ptr ite_term) {
+  visit_children_of(ite_term);
 }
 
 void NormalizationRenamer::visitReConcat(ReConcat_ptr re_concat_term) {
+  visit_children_of(re_concat_term);
 }
 
 void NormalizationRenamer::visitReUnion(ReUnion_ptr re_union_term) {
+  visit_children_of(re_union_term);
 }
 
 void NormalizationRenamer::visitReInter(ReInter_ptr re_inter_term) {
+  visit_children_of(re_inter_term);
 }
 
 void NormalizationRenamer::visitReStar(ReStar_ptr re_star_term) {
+  visit_children_of(re_star_term);
 }
 
 void NormalizationRenamer::visitRePlus(RePlus_ptr re_plus_term) {
+  visit_children_of(re_plus_term);
 }
 
 void NormalizationRenamer::visitReOpt(ReOpt_ptr re_opt_term) {
+  visit_children_of(re_opt_term);
 }
 
 void NormalizationRenamer::visitToRegex(ToRegex_ptr to_regex_term) {
+  visit_children_of(to_regex_term);
 }
 
 void NormalizationRenamer::visitUnknownTerm(Unknown_ptr unknown_term) {
+  visit_children_of(unknown_term);
 }
 
 void NormalizationRenamer::visitAsQualIdentifier(AsQualIdentifier_ptr as_qid_term) {
+  RenameVariable(as_qid_term->identifier->symbol);
 }
 
 void NormalizationRenamer::visitQualIdentifier(QualIdentifier_ptr qi_term) {
@@ -269,17 +285,13 @@ void NormalizationRenamer::visitQualIdentifier(QualIdentifier_ptr qi_term) {
 //  }
 
   // root scope
-
-  if(variable_mapping_.find(var_name) == variable_mapping_.end()) {
-    std::string new_var_name = "v"+std::to_string(variable_mapping_.size());
-    variable_mapping_[var_name] = new_var_name;
-    qi_term->identifier->symbol->setData(new_var_name);
-  } else {
-    qi_term->identifier->symbol->setData(variable_mapping_[var_name]);
-  }
+  RenameVariable(qi_term->identifier->symbol);
 }
 
 void NormalizationRenamer::visitTermConstant(TermConstant_ptr term_constant) {
+  if (not rename_constants_) {
+    return;
+  }
 
     //
 ////
@@ -367,9 +379,31 @@ void NormalizationRenamer::visitAttribute(Attribute_ptr attribute) {
 }
 
 void NormalizationRenamer::visitSortedVar(SortedVar_ptr sorted_var) {
+  RenameVariable(sorted_var->symbol);
 }
 
 void NormalizationRenamer::visitVarBinding(VarBinding_ptr var_binding) {
+  RenameVariable(var_binding->symbol);
+  visit(var_binding->term);
+}
+
+const std::map<std::string, std::string>& NormalizationRenamer::GetVariableMapping() const {
+  return variable_mapping_;
+}
+
+/**
+ * Bound and free variables share the mapping, a name is renamed the same way everywhere
+ * @param symbol
+ */
+void NormalizationRenamer::RenameVariable(Primitive_ptr symbol) {
+  std::string var_name = symbol->getData();
+  if(variable_mapping_.find(var_name) == variable_mapping_.end()) {
+    std::string new_var_name = "v"+std::to_string(variable_mapping_.size());
+    variable_mapping_[var_name] = new_var_name;
+    symbol->setData(new_var_name);
+  } else {
+    symbol->setData(variable_mapping_[var_name]);
+  }
 }
 
 char NormalizationRenamer::AddToMap(Visitable_ptr term, char c) {
@@ -27,7 +27,10 @@ namespace Solver {
 
 class NormalizationRenamer : public SMT::Visitor {
 public:
-  NormalizationRenamer(SMT::Script_ptr, SymbolTable_ptr);
+  /**
+   * @param rename_constants when false only variables are renamed and literals are kept as they are
+   */
+  NormalizationRenamer(SMT::Script_ptr, SymbolTable_ptr, bool rename_constants = true);
   NormalizationRenamer(SMT::Script_ptr, SymbolTable_ptr, std::map<std::string,std::string> var_mapping,
                                             std::map<char,char> char_mapping);
   virtual ~NormalizationRenamer();
@@ -79,18 +82,18 @@ public:
   void visitReplace(SMT::Replace_ptr) override;
   void visitCount(SMT::Count_ptr) override;
   void visitIte(SMT::Ite_ptr) override;
-  void visitIsDigit(SMT::IsDigit_ptr) override {};
-  void visitToCode(SMT::ToCode_ptr) override {};
-  void visitFromCode(SMT::FromCode_ptr) override {};
+  void visitIsDigit(SMT::IsDigit_ptr is_digit_term) override { visit_children_of(is_digit_term); };
+  void visitToCode(SMT::ToCode_ptr to_code_term) override { visit_children_of(to_code_term); };
+  void visitFromCode(SMT::FromCode_ptr from_code_term) override { visit_children_of(from_code_term); };
   void visitReConcat(SMT::ReConcat_ptr) override;
   void visitReUnion(SMT::ReUnion_ptr) override;
   void visitReInter(SMT::ReInter_ptr) override;
   void visitReStar(SMT::ReStar_ptr) override;
   void visitRePlus(SMT::RePlus_ptr) override;
   void visitReOpt(SMT::ReOpt_ptr) override;
-  void visitReLoop(SMT::ReLoop_ptr) override {};
-  void visitReComp(SMT::ReComp_ptr) override {};
-  void visitReDiff(SMT::ReDiff_ptr) override {};
+  void visitReLoop(SMT::ReLoop_ptr re_loop_term) override { visit_children_of(re_loop_term); };
+  void visitReComp(SMT::ReComp_ptr re_comp_term) override { visit_children_of(re_comp_term); };
+  void visitReDiff(SMT::ReDiff_ptr re_diff_term) override { visit_children_of(re_diff_term); };
   void visitToRegex(SMT::ToRegex_ptr) override;
   void visitUnknownTerm(SMT::Unknown_ptr) override;
   void visitAsQualIdentifier(SMT::AsQualIdentifier_ptr) override;
@@ -108,11 +111,19 @@ public:
   void visitPrimitive(SMT::Primitive_ptr) override;
   void visitVariable(SMT::Variable_ptr) override;
 
+  /**
+   * @return original variable names and their new names, new names are numbered in the order
+   * the variables are first seen
+   */
+  const std::map<std::string,std::string>& GetVariableMapping() const;
+
 protected:
   char AddToMap(SMT::Visitable_ptr, char);
+  void RenameVariable(SMT::Primitive_ptr symbol);
 
   SMT::Script_ptr root_;
   SymbolTable_ptr symbol_table_;
+  bool rename_constants_;
   std::set<char> special_chars_ = {'.','+','?','*','-','|','(',')','[',']','{','}','#'};
 
   std::map<std::string,std::string> variable_mapping_;
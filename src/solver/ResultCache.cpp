@@ -0,0 +1,228 @@
+/*
+ * ResultCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "ResultCache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace Vlab {
+namespace Solver {
+
+ResultCache::ResultCache() {
+}
+
+ResultCache::~ResultCache() {
+}
+
+std::string ResultCache::Hash(const std::string& text) {
+  uint64_t hash = Fnv1a(text.data(), text.size());
+  static const char digits[] = "0123456789abcdef";
+  std::string key(16, '0');
+  for (int i = 15; i >= 0; --i) {
+    key[i] = digits[hash & 0xf];
+    hash >>= 4;
+  }
+  return key;
+}
+
+uint64_t ResultCache::Fnv1a(const char* data, const std::size_t length) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (std::size_t i = 0; i < length; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+LruResultCache::LruResultCache(const std::size_t capacity)
+    : capacity_ { capacity } {
+  CHECK_GT(capacity_, 0) << "cache capacity must be positive";
+}
+
+LruResultCache::~LruResultCache() {
+}
+
+bool LruResultCache::Get(const std::string& key, std::string& value) {
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return false;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  value = it->second->second;
+  return true;
+}
+
+void LruResultCache::Put(const std::string& key, const std::string& value) {
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->second = value;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+  if (entries_.size() == capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.push_front(std::make_pair(key, value));
+  index_[key] = entries_.begin();
+}
+
+std::size_t LruResultCache::size() const {
+  return entries_.size();
+}
+
+FileResultCache::FileResultCache(const std::string& file_path)
+    : file_path_ { file_path }, fd_ { -1 }, data_ { nullptr }, mapped_size_ { 0 }, file_size_ { 0 } {
+  fd_ = open(file_path_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  CHECK_GE(fd_, 0) << "cannot open result cache: " << file_path_;
+  struct stat file_stat;
+  int result = fstat(fd_, &file_stat);
+  CHECK_EQ(0, result) << "cannot stat result cache: " << file_path_;
+  file_size_ = file_stat.st_size;
+  Map();
+
+  const std::size_t header_size = 2 * sizeof(uint32_t);
+  std::size_t offset = 0;
+  while (offset + header_size <= file_size_) {
+    uint32_t key_length, value_length;
+    std::memcpy(&key_length, data_ + offset, sizeof(uint32_t));
+    std::memcpy(&value_length, data_ + offset + sizeof(uint32_t), sizeof(uint32_t));
+    const std::size_t record_size = header_size + key_length + value_length;
+    if (offset + record_size > file_size_) {
+      break;
+    }
+    Index(Record { offset + header_size, key_length, value_length }, data_ + offset + header_size);
+    offset += record_size;
+  }
+
+  if (offset != file_size_) {
+    // drops a record cut off by an interrupted write so that new records stay aligned
+    LOG(WARNING)<< "truncating incomplete record in result cache: " << file_path_;
+    Unmap();
+    result = ftruncate(fd_, offset);
+    CHECK_EQ(0, result) << "cannot truncate result cache: " << file_path_;
+    file_size_ = offset;
+    Map();
+  }
+}
+
+FileResultCache::~FileResultCache() {
+  Unmap();
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+bool FileResultCache::Get(const std::string& key, std::string& value) {
+  auto it = index_.find(Fnv1a(key.data(), key.size()));
+  if (it == index_.end()) {
+    return false;
+  }
+  for (auto& record : it->second) {
+    if (HasKey(record, key.data(), key.size())) {
+      value.assign(data_ + record.key_offset + record.key_length, record.value_length);
+      return true;
+    }
+  }
+  return false;
+}
+
+void FileResultCache::Put(const std::string& key, const std::string& value) {
+  uint32_t key_length = key.size();
+  uint32_t value_length = value.size();
+  std::string record;
+  record.reserve(2 * sizeof(uint32_t) + key_length + value_length);
+  record.append(reinterpret_cast<const char*>(&key_length), sizeof(uint32_t));
+  record.append(reinterpret_cast<const char*>(&value_length), sizeof(uint32_t));
+  record.append(key);
+  record.append(value);
+
+  std::size_t written = 0;
+  while (written < record.size()) {
+    auto n = write(fd_, record.data() + written, record.size() - written);
+    CHECK_GT(n, 0) << "cannot write result cache: " << file_path_;
+    written += n;
+  }
+  const std::size_t key_offset = file_size_ + 2 * sizeof(uint32_t);
+  file_size_ += record.size();
+  Index(Record { key_offset, key_length, value_length }, key.data());
+}
+
+void FileResultCache::Map() {
+  if (file_size_ == 0) {
+    return;
+  }
+  void* data = mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, fd_, 0);
+  CHECK(data != MAP_FAILED) << "cannot map result cache: " << file_path_;
+  data_ = static_cast<const char*>(data);
+  mapped_size_ = file_size_;
+}
+
+void FileResultCache::Unmap() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), mapped_size_);
+  }
+  data_ = nullptr;
+  mapped_size_ = 0;
+}
+
+bool FileResultCache::HasKey(const Record& record, const char* key, const std::size_t key_length) {
+  if (record.key_length != key_length) {
+    return false;
+  }
+  if (record.key_offset + record.key_length + record.value_length > mapped_size_) {
+    // the record is appended after the file was mapped
+    Unmap();
+    Map();
+  }
+  return std::memcmp(data_ + record.key_offset, key, key_length) == 0;
+}
+
+void FileResultCache::Index(const Record& record, const char* key) {
+  auto& records = index_[Fnv1a(key, record.key_length)];
+  for (auto& indexed_record : records) {
+    if (HasKey(indexed_record, key, record.key_length)) {
+      indexed_record = record;
+      return;
+    }
+  }
+  records.push_back(record);
+}
+
+TieredResultCache::TieredResultCache(std::unique_ptr<ResultCache> memory_cache,
+                                     std::unique_ptr<ResultCache> disk_cache)
+    : memory_cache_(std::move(memory_cache)), disk_cache_(std::move(disk_cache)) {
+}
+
+TieredResultCache::~TieredResultCache() {
+}
+
+bool TieredResultCache::Get(const std::string& key, std::string& value) {
+  if (memory_cache_->Get(key, value)) {
+    return true;
+  }
+  if (disk_cache_->Get(key, value)) {
+    memory_cache_->Put(key, value);
+    return true;
+  }
+  return false;
+}
+
+void TieredResultCache::Put(const std::string& key, const std::string& value) {
+  memory_cache_->Put(key, value);
+  disk_cache_->Put(key, value);
+}
+
+} /* namespace Solver */
+} /* namespace Vlab */
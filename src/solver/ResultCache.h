@@ -0,0 +1,144 @@
+/*
+ * ResultCache.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_SOLVER_RESULTCACHE_H_
+#define SRC_SOLVER_RESULTCACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+namespace Vlab {
+namespace Solver {
+
+/**
+ * Key-value store for serialized solver results, keys are the canonical texts of normalized
+ * constraints and are compared in full, the hash only locates them.
+ */
+class ResultCache {
+ public:
+  ResultCache();
+  virtual ~ResultCache();
+
+  /**
+   * @param key
+   * @param value is set when the key is found
+   * @return true if the key is found
+   */
+  virtual bool Get(const std::string& key, std::string& value) = 0;
+  virtual void Put(const std::string& key, const std::string& value) = 0;
+
+  /**
+   * Stable 64-bit FNV-1a hash, the same text hashes to the same key across runs
+   * @param text
+   * @return hash in hexadecimal
+   */
+  static std::string Hash(const std::string& text);
+
+ protected:
+  static uint64_t Fnv1a(const char* data, const std::size_t length);
+};
+
+using ResultCache_ptr = ResultCache*;
+
+/**
+ * In-memory tier, evicts the least recently used entry when full.
+ */
+class LruResultCache : public ResultCache {
+ public:
+  LruResultCache(const std::size_t capacity);
+  virtual ~LruResultCache();
+
+  bool Get(const std::string& key, std::string& value) override;
+  void Put(const std::string& key, const std::string& value) override;
+  std::size_t size() const;
+
+ protected:
+  using Entry = std::pair<std::string, std::string>;
+
+  const std::size_t capacity_;
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+/**
+ * On-disk tier, records are appended to a single file and read through a memory mapping.
+ * A record is [key length][value length][key][value] with 32-bit lengths, a later record
+ * of a key shadows the earlier ones. Keys stay in the file, the index keeps their hashes and
+ * a lookup compares the stored key with the requested one.
+ */
+class FileResultCache : public ResultCache {
+ public:
+  FileResultCache(const std::string& file_path);
+  virtual ~FileResultCache();
+
+  bool Get(const std::string& key, std::string& value) override;
+  void Put(const std::string& key, const std::string& value) override;
+
+ protected:
+  struct Record {
+    std::size_t key_offset;
+    uint32_t key_length;
+    uint32_t value_length;
+  };
+
+  void Map();
+  void Unmap();
+  /**
+   * @param record
+   * @param key
+   * @param key_length
+   * @return true if the record is stored under the given key
+   */
+  bool HasKey(const Record& record, const char* key, const std::size_t key_length);
+  /**
+   * Adds a record to the index, replacing the record of the same key
+   * @param record
+   * @param key of the record, must stay valid when the file is mapped again
+   */
+  void Index(const Record& record, const char* key);
+
+  const std::string file_path_;
+  int fd_;
+  const char* data_;
+  std::size_t mapped_size_;
+  std::size_t file_size_;
+  /**
+   * Latest records of the keys with the same hash
+   */
+  std::unordered_map<uint64_t, std::vector<Record>> index_;
+};
+
+/**
+ * Memory tier in front of the disk tier, disk hits are promoted to memory.
+ */
+class TieredResultCache : public ResultCache {
+ public:
+  TieredResultCache(std::unique_ptr<ResultCache> memory_cache, std::unique_ptr<ResultCache> disk_cache);
+  virtual ~TieredResultCache();
+
+  bool Get(const std::string& key, std::string& value) override;
+  void Put(const std::string& key, const std::string& value) override;
+
+ protected:
+  std::unique_ptr<ResultCache> memory_cache_;
+  std::unique_ptr<ResultCache> disk_cache_;
+};
+
+} /* namespace Solver */
+} /* namespace Vlab */
+
+#endif /* SRC_SOLVER_RESULTCACHE_H_ */
@@ -124,13 +124,12 @@ void StringConstraintSolver::visitAnd(And_ptr and_term) {
 
   DVLOG(VLOG_LEVEL) << "visit children of component start: " << *and_term << "@" << and_term;
 
-  bool is_satisfiable = true;
   bool has_string_formula = false;
 
   std::string group_name = string_formula_generator_.get_term_group_name(and_term);
-  Value_ptr and_value = nullptr;
-
 
+  // conjuncts are planned before their values are constructed, smallest first
+  ConjunctPlanner planner (symbol_table_);
   for (auto t : *(and_term->term_list)) {
     auto term = t;
     if(Exists_ptr exists_term = dynamic_cast<Exists_ptr>(t)) {
@@ -141,33 +140,23 @@ void StringConstraintSolver::visitAnd(And_ptr and_term) {
     // Do not visit child or terms here, handle them in POSTVISIT AND
     if (formula != nullptr and (dynamic_cast<Or_ptr>(term) == nullptr) and (dynamic_cast<Exists_ptr>(term) == nullptr)) {
       has_string_formula = true;
-      visit(term);
-      auto param = get_term_value(term);
-      is_satisfiable = param->is_satisfiable();
-      if (is_satisfiable) {
-//        if (and_value == nullptr) {
-//          and_value = param->clone();
-//        } else {
-//          auto old_value = and_value;
-//          and_value = and_value->Intersect(param);
-//          delete old_value;
-//          is_satisfiable = and_value->is_satisfiable();
-//        }
-      	auto term_group_name = string_formula_generator_.get_term_group_name(term);
-				if(term_group_name.empty()) {
-					LOG(FATAL) << "Term has no group!";
-				}
-				// LOG(INFO) << *term << "@" << term << " has " << "term group name: " << term_group_name;
-				symbol_table_->IntersectValue(term_group_name,param);
-				is_satisfiable = symbol_table_->get_value(term_group_name)->is_satisfiable();
-      }
-      clear_term_value(term);
-      if (not is_satisfiable) {
-        break;
+      auto term_group_name = string_formula_generator_.get_term_group_name(term);
+      if(term_group_name.empty()) {
+        LOG(FATAL) << "Term has no group!";
       }
+      planner.Add(term, term_group_name, formula->GetNumberOfVariables());
     }
   }
-  // std::cin.get();
+
+  bool is_satisfiable = planner.Intersect([this](Term_ptr term) {
+    visit(term);
+    return get_term_value(term);
+  }, [this](Term_ptr term) {
+    clear_term_value(term);
+  });
+
+  Util::Profiler::AddComponent({ "string", group_name, planner.GetNumOfConjuncts(), planner.GetNumOfConstructedConjuncts(),
+                                 planner.GetConstructionTime(), planner.GetIntersectionTime() });
 
   DVLOG(VLOG_LEVEL) << "visit children of component end: " << *and_term << "@" << and_term;
 
@@ -353,6 +342,8 @@ void StringConstraintSolver::postVisitOr(Or_ptr or_term) {
     // }
     or_values[group] = new Value(Theory::StringAutomaton::MakePhi(group_formula->clone()));
   }
+  // values of the disjuncts are unioned once all of them are collected
+  std::map<std::string, std::vector<Value_ptr>> disjunct_values;
 
   for (auto t : *(or_term->term_list)) {
     auto term = t;
@@ -393,14 +384,18 @@ void StringConstraintSolver::postVisitOr(Or_ptr or_term) {
   	}
 
   	for(auto it: temp_or_values) {
-      auto union_value = or_values[it.first]->union_(it.second);
-      delete it.second; it.second = nullptr;
-      delete or_values[it.first];
-      or_values[it.first] = union_value;
+  	  disjunct_values[it.first].push_back(it.second);
     }
 //  	symbol_table_->pop_scope();
   }
 
+  for (auto& it : disjunct_values) {
+    if (not it.second.empty()) {
+      delete or_values[it.first];
+      or_values[it.first] = Value::union_all(it.second);
+    }
+  }
+
   DVLOG(VLOG_LEVEL) << "collect child results end: " << *or_term << "@" << or_term;
 
   DVLOG(VLOG_LEVEL) << "update result start: " << *or_term << "@" << or_term;
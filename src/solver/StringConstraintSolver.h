@@ -8,6 +8,7 @@
 #ifndef SRC_SOLVER_STRINGCONSTRAINTSOLVER_H_
 #define SRC_SOLVER_STRINGCONSTRAINTSOLVER_H_
 
+#include <chrono>
 #include <iostream>
 #include <map>
 #include <string>
@@ -19,7 +20,9 @@
 #include "../theory/StringAutomaton.h"
 #include "../theory/StringFormula.h"
 #include "../theory/Formula.h"
+#include "../utils/Profiler.h"
 #include "AstTraverser.h"
+#include "ConjunctPlanner.h"
 #include "ConstraintInformation.h"
 #include "StringFormulaGenerator.h"
 #include "SymbolTable.h"
@@ -185,8 +185,8 @@ void StringFormulaGenerator::visitOr(Or_ptr or_term) {
       for (auto &sg_it : subgroups) {
         auto f = get_group_formula(sg_it);
 
-        for (auto var_iter : f->GetVariableCoefficientMap()) {
-          variable_group_map_[var_iter.first] = temp_subgroup_name;
+        for (auto& variable : f->GetVariables()) {
+          variable_group_map_[variable] = temp_subgroup_name;
         }
 
         for (auto &term_group_iter : term_group_map_) {
@@ -1409,13 +1409,13 @@ void StringFormulaGenerator::visitVarBinding(VarBinding_ptr var_binding) {
 
 void StringFormulaGenerator::project_variable_from_formulas(std::string var) {
   for(auto it : term_formula_) {
-    if(it.second->GetVariableCoefficientMap().find(var) != it.second->GetVariableCoefficientMap().end()) {
+    if(it.second->HasVariable(var)) {
       it.second->RemoveVariable(var);
     }
   }
 
   for(auto it : group_formula_) {
-    if(it.second->GetVariableCoefficientMap().find(var) != it.second->GetVariableCoefficientMap().end()) {
+    if(it.second->HasVariable(var)) {
       it.second->RemoveVariable(var);
     }
   }
@@ -1650,11 +1650,11 @@ void StringFormulaGenerator::set_group_mappings() {
 		symbol_table_->pop_scope();
 
     //LOG(INFO) << "Group " << el.first << " Initial Value: " << symbol_table_->get_value_at_scope(root_,symbol_table_->get_variable(el.first));
-    for (const auto& var_entry : el.second->GetVariableCoefficientMap()) {
+    for (const auto& variable : el.second->GetVariables()) {
     	//val->getStringAutomaton()->inspectAuto(false,true);
-   	// LOG(INFO) << "Setting Mapping: " << var_entry.first << " -> " << el.first;
-      symbol_table_->add_variable_group_mapping(var_entry.first, el.first);
-    //  LOG(INFO) << "-- " << var_entry.first;
+   	// LOG(INFO) << "Setting Mapping: " << variable << " -> " << el.first;
+      symbol_table_->add_variable_group_mapping(variable, el.first);
+    //  LOG(INFO) << "-- " << variable;
     }
 
     //LOG(INFO) << "";
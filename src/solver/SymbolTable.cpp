@@ -318,7 +318,10 @@ Value_ptr SymbolTable::get_value(Variable_ptr variable) {
   }
     break;
   case Variable::Type::STRING: {
-  	auto str_auto = Theory::StringAutomaton::MakeAnyString();
+    auto encoding = get_string_encoding(variable);
+    auto str_auto = (encoding == nullptr) ?
+        Theory::StringAutomaton::MakeAnyString() :
+        Theory::StringAutomaton::MakeAnyString(encoding->GetNumOfBddVariables());
   	// str auto should always have formula
 		// TODO: Remove check after testing
   	auto str_formula = str_auto->GetFormula();
@@ -413,6 +416,23 @@ void SymbolTable::clear_variable_values() {
 	variable_projected_value_table_.clear();
 
 	variable_group_map_.clear();
+	variable_string_encoding_table_.clear();
+}
+
+void SymbolTable::set_string_encoding(Variable_ptr variable, const Theory::StringEncoding& encoding) {
+  variable_string_encoding_table_[variable] = encoding;
+}
+
+const Theory::StringEncoding* SymbolTable::get_string_encoding(Variable_ptr variable) {
+  auto it = variable_string_encoding_table_.find(variable);
+  if (it == variable_string_encoding_table_.end()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+bool SymbolTable::has_string_encodings() const {
+  return not variable_string_encoding_table_.empty();
 }
 
 void SymbolTable::project_variable_all_scopes(std::string var_name) {
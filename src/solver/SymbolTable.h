@@ -102,6 +102,19 @@ public:
   VariableValueMap& get_values_at_scope(SMT::Visitable_ptr scope);
   void clear_variable_values();
 
+  /**
+   * Records the compact encoding the string automata of a variable are built with.
+   * @param variable string variable
+   * @param encoding encoding shared by the component of the variable
+   */
+  void set_string_encoding(SMT::Variable_ptr variable, const Theory::StringEncoding& encoding);
+  /**
+   * @param variable string variable
+   * @return encoding of the variable, nullptr if its automata use the full alphabet
+   */
+  const Theory::StringEncoding* get_string_encoding(SMT::Variable_ptr variable);
+  bool has_string_encodings() const;
+
   void project_variable_all_scopes(std::string var_name);
   void project_variable_at_scope(SMT::Visitable_ptr, std::string var_name);
 
@@ -218,6 +231,11 @@ private:
    */
   VariableValueTable variable_value_table_;
 
+  /**
+   * Compact encodings of string variables whose automata are not over the full alphabet
+   */
+  std::map<SMT::Variable_ptr, Theory::StringEncoding> variable_string_encoding_table_;
+
   /**
     * string names of a terms children, mainly for ANDS
     */
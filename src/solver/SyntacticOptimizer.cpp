@@ -12,7 +12,7 @@ namespace Solver {
 
 using namespace SMT;
 
-unsigned SyntacticOptimizer::name_counter = 0;
+thread_local unsigned SyntacticOptimizer::name_counter = 0;
 const int SyntacticOptimizer::VLOG_LEVEL = 18;
 
 SyntacticOptimizer::SyntacticOptimizer(Script_ptr script, SymbolTable_ptr symbol_table, bool transform_ite)
@@ -159,7 +159,7 @@ protected:
   SMT::Script_ptr root_;
   SymbolTable_ptr symbol_table_;
   std::function<void(SMT::Term_ptr&)> callback_;
-  static unsigned name_counter;
+  static thread_local unsigned name_counter;
   bool transform_ite_;
 private:
   static const int VLOG_LEVEL;
@@ -224,6 +224,30 @@ Value_ptr Value::union_(Value_ptr other_value) const {
   return union_value;
 }
 
+Value_ptr Value::union_all(std::vector<Value_ptr>& values) {
+  if (values.empty()) {
+    return nullptr;
+  }
+  while (values.size() > 1) {
+    std::size_t num_of_unions = values.size() / 2;
+    for (std::size_t i = 0; i < num_of_unions; ++i) {
+      auto left_value = values[2 * i];
+      auto right_value = values[2 * i + 1];
+      values[i] = left_value->union_(right_value);
+      delete left_value;
+      delete right_value;
+    }
+    if (values.size() % 2 == 1) {
+      values[num_of_unions] = values.back();
+      ++num_of_unions;
+    }
+    values.resize(num_of_unions);
+  }
+  auto union_value = values[0];
+  values.clear();
+  return union_value;
+}
+
 Value_ptr Value::intersect(Value_ptr other_value) const {
   Value_ptr intersection_value = nullptr;
   if (Type::STRING_AUTOMATON == type and Type::STRING_AUTOMATON == other_value->type) {
@@ -10,6 +10,7 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -71,6 +72,14 @@ class Value {
   Theory::StringAutomaton_ptr getStringAutomaton() const;
 
   Value_ptr union_(Value_ptr other_value) const;
+  /**
+   * Unions the values pairwise in a balanced tree, neighbours first, so that each value takes part
+   * in a logarithmic number of unions. Unions run one after another on the calling thread, every
+   * automata operation needs the MONA lock.
+   * @param values values to union, they are deleted
+   * @return union of the values, nullptr if there are none
+   */
+  static Value_ptr union_all(std::vector<Value_ptr>& values);
   Value_ptr intersect(Value_ptr other_value) const;
   Value_ptr complement() const;
   Value_ptr difference(Value_ptr other_value) const;
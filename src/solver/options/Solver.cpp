@@ -10,26 +10,107 @@
 
 #include "Solver.h"
 
+#include "../../utils/RegularExpression.h"
+
 namespace Vlab {
 namespace Option {
 
-bool Solver::USE_SIGNED_INTEGERS = true;
-bool Solver::USE_MULTITRACK_AUTO = true;
-bool Solver::ENABLE_EQUIVALENCE_CLASSES = true;
-bool Solver::ENABLE_DEPENDENCY_ANALYSIS = true;
-bool Solver::ENABLE_IMPLICATIONS = true;
-bool Solver::ENABLE_LEN_IMPLICATIONS = true;
-bool Solver::ENABLE_SORTING_HEURISTICS = true;
-bool Solver::FORCE_DNF_FORMULA = false;
-bool Solver::COUNT_BOUND_EXACT = false;
-bool Solver::USE_SINGLE_AUTO = false;
-bool Solver::USE_REGEX_SPLITTER = false;
-bool Solver::USE_PREFIX_SHORTENER = false;
-bool Solver::CONCAT_COLLAPSE_HEURISTIC = false;
-bool Solver::DFA_TO_RE = false;
-
-
-std::string Solver::OUTPUT_PATH         = ".";
-std::string Solver::SCRIPT_PATH         = ".";
+thread_local bool Solver::USE_SIGNED_INTEGERS = true;
+thread_local bool Solver::USE_MULTITRACK_AUTO = true;
+thread_local bool Solver::ENABLE_EQUIVALENCE_CLASSES = true;
+thread_local bool Solver::ENABLE_DEPENDENCY_ANALYSIS = true;
+thread_local bool Solver::ENABLE_IMPLICATIONS = true;
+thread_local bool Solver::ENABLE_LEN_IMPLICATIONS = true;
+thread_local bool Solver::ENABLE_SORTING_HEURISTICS = true;
+thread_local bool Solver::FORCE_DNF_FORMULA = false;
+thread_local bool Solver::COUNT_BOUND_EXACT = false;
+thread_local bool Solver::USE_SINGLE_AUTO = false;
+thread_local bool Solver::USE_REGEX_SPLITTER = false;
+thread_local bool Solver::USE_PREFIX_SHORTENER = false;
+thread_local bool Solver::CONCAT_COLLAPSE_HEURISTIC = false;
+thread_local bool Solver::DFA_TO_RE = false;
+thread_local bool Solver::ORDER_CONJUNCTS = true;
+thread_local bool Solver::REPORT_COMPONENT_TIMES = false;
+thread_local bool Solver::ENABLE_PROFILING = false;
+thread_local int Solver::COUNT_THREADS = 1;
+thread_local bool Solver::COMPACT_STRING_ENCODING = false;
+int Solver::RESULT_CACHE_SIZE = 0;
+
+
+thread_local std::string Solver::OUTPUT_PATH         = ".";
+thread_local std::string Solver::SCRIPT_PATH         = ".";
+std::string Solver::RESULT_CACHE_PATH   = "";
+
+Context Context::Current() {
+  Context context;
+  context.use_signed_integers = Solver::USE_SIGNED_INTEGERS;
+  context.use_multitrack_auto = Solver::USE_MULTITRACK_AUTO;
+  context.enable_equivalence_classes = Solver::ENABLE_EQUIVALENCE_CLASSES;
+  context.enable_dependency_analysis = Solver::ENABLE_DEPENDENCY_ANALYSIS;
+  context.enable_implications = Solver::ENABLE_IMPLICATIONS;
+  context.enable_len_implications = Solver::ENABLE_LEN_IMPLICATIONS;
+  context.enable_sorting_heuristics = Solver::ENABLE_SORTING_HEURISTICS;
+  context.force_dnf_formula = Solver::FORCE_DNF_FORMULA;
+  context.count_bound_exact = Solver::COUNT_BOUND_EXACT;
+  context.use_single_auto = Solver::USE_SINGLE_AUTO;
+  context.use_regex_splitter = Solver::USE_REGEX_SPLITTER;
+  context.use_prefix_shortener = Solver::USE_PREFIX_SHORTENER;
+  context.concat_collapse_heuristic = Solver::CONCAT_COLLAPSE_HEURISTIC;
+  context.dfa_to_re = Solver::DFA_TO_RE;
+  context.order_conjuncts = Solver::ORDER_CONJUNCTS;
+  context.report_component_times = Solver::REPORT_COMPONENT_TIMES;
+  context.enable_profiling = Solver::ENABLE_PROFILING;
+  context.count_threads = Solver::COUNT_THREADS;
+  context.compact_string_encoding = Solver::COMPACT_STRING_ENCODING;
+  context.output_path = Solver::OUTPUT_PATH;
+  context.script_path = Solver::SCRIPT_PATH;
+  context.tmp_path = Theory::TMP_PATH;
+  context.theory_script_path = Theory::SCRIPT_PATH;
+  context.counting_method = Theory::COUNTING_METHOD;
+  context.use_direct_regex_construction = Theory::USE_DIRECT_REGEX_CONSTRUCTION;
+  context.use_symbolic_arithmetic_construction = Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION;
+  context.regex_flag = Util::RegularExpression::DEFAULT;
+  return context;
+}
+
+void Context::Activate() const {
+  Solver::USE_SIGNED_INTEGERS = use_signed_integers;
+  Solver::USE_MULTITRACK_AUTO = use_multitrack_auto;
+  Solver::ENABLE_EQUIVALENCE_CLASSES = enable_equivalence_classes;
+  Solver::ENABLE_DEPENDENCY_ANALYSIS = enable_dependency_analysis;
+  Solver::ENABLE_IMPLICATIONS = enable_implications;
+  Solver::ENABLE_LEN_IMPLICATIONS = enable_len_implications;
+  Solver::ENABLE_SORTING_HEURISTICS = enable_sorting_heuristics;
+  Solver::FORCE_DNF_FORMULA = force_dnf_formula;
+  Solver::COUNT_BOUND_EXACT = count_bound_exact;
+  Solver::USE_SINGLE_AUTO = use_single_auto;
+  Solver::USE_REGEX_SPLITTER = use_regex_splitter;
+  Solver::USE_PREFIX_SHORTENER = use_prefix_shortener;
+  Solver::CONCAT_COLLAPSE_HEURISTIC = concat_collapse_heuristic;
+  Solver::DFA_TO_RE = dfa_to_re;
+  Solver::ORDER_CONJUNCTS = order_conjuncts;
+  Solver::REPORT_COMPONENT_TIMES = report_component_times;
+  Solver::ENABLE_PROFILING = enable_profiling;
+  Solver::COUNT_THREADS = count_threads;
+  Solver::COMPACT_STRING_ENCODING = compact_string_encoding;
+  Solver::OUTPUT_PATH = output_path;
+  Solver::SCRIPT_PATH = script_path;
+  Theory::TMP_PATH = tmp_path;
+  Theory::SCRIPT_PATH = theory_script_path;
+  Theory::COUNTING_METHOD = counting_method;
+  Theory::USE_DIRECT_REGEX_CONSTRUCTION = use_direct_regex_construction;
+  Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION = use_symbolic_arithmetic_construction;
+  Util::RegularExpression::DEFAULT = regex_flag;
+}
+
+ScopedContext::ScopedContext(const Context& context)
+    : previous_(Context::Current()) {
+  context.Activate();
+}
+
+ScopedContext::~ScopedContext() {
+  previous_.Activate();
+}
+
 } /* namespace Option */
 } /* namespace Vlab */
@@ -13,6 +13,8 @@
 
 #include <string>
 
+#include "../../theory/options/Theory.h"
+
 namespace Vlab {
 namespace Option {
 
@@ -39,27 +41,137 @@ enum class Name: int {
   OUTPUT_PATH,
   SCRIPT_PATH,
   CONCAT_COLLAPSE_HEURISTIC,
-  DFA_TO_RE
+  DFA_TO_RE,
+  COUNTING_METHOD,
+  RESULT_CACHE_SIZE,
+  RESULT_CACHE_PATH,
+  REGEX_CACHE_SIZE,
+  ENABLE_DIRECT_REGEX_CONSTRUCTION,
+  DISABLE_DIRECT_REGEX_CONSTRUCTION,
+  ENABLE_SYMBOLIC_ARITHMETIC_CONSTRUCTION,
+  DISABLE_SYMBOLIC_ARITHMETIC_CONSTRUCTION,
+  ENABLE_CONJUNCT_ORDERING,
+  DISABLE_CONJUNCT_ORDERING,
+  ENABLE_COMPONENT_TIME_REPORT,
+  DISABLE_COMPONENT_TIME_REPORT,
+  ENABLE_PROFILING,
+  DISABLE_PROFILING,
+  COUNT_THREADS,
+  ENABLE_COMPACT_STRING_ENCODING,
+  DISABLE_COMPACT_STRING_ENCODING
 };
 
+/**
+ * Option values are thread local so that drivers on different threads do not see each
+ * other's settings, result cache options are process wide as the cache is shared.
+ */
 class Solver {
 public:
-  static bool USE_SIGNED_INTEGERS;
-  static bool USE_MULTITRACK_AUTO;
-  static bool ENABLE_EQUIVALENCE_CLASSES;
-  static bool ENABLE_DEPENDENCY_ANALYSIS;
-  static bool ENABLE_IMPLICATIONS;
-  static bool ENABLE_LEN_IMPLICATIONS;
-  static bool ENABLE_SORTING_HEURISTICS;
-  static bool FORCE_DNF_FORMULA;
-  static bool COUNT_BOUND_EXACT;
-  static bool USE_SINGLE_AUTO;
-  static bool USE_REGEX_SPLITTER;
-  static bool USE_PREFIX_SHORTENER;
-  static bool CONCAT_COLLAPSE_HEURISTIC;
-  static bool DFA_TO_RE;
-  static std::string OUTPUT_PATH;
-  static std::string SCRIPT_PATH;
+  static thread_local bool USE_SIGNED_INTEGERS;
+  static thread_local bool USE_MULTITRACK_AUTO;
+  static thread_local bool ENABLE_EQUIVALENCE_CLASSES;
+  static thread_local bool ENABLE_DEPENDENCY_ANALYSIS;
+  static thread_local bool ENABLE_IMPLICATIONS;
+  static thread_local bool ENABLE_LEN_IMPLICATIONS;
+  static thread_local bool ENABLE_SORTING_HEURISTICS;
+  static thread_local bool FORCE_DNF_FORMULA;
+  static thread_local bool COUNT_BOUND_EXACT;
+  static thread_local bool USE_SINGLE_AUTO;
+  static thread_local bool USE_REGEX_SPLITTER;
+  static thread_local bool USE_PREFIX_SHORTENER;
+  static thread_local bool CONCAT_COLLAPSE_HEURISTIC;
+  static thread_local bool DFA_TO_RE;
+  /**
+   * Intersects the conjuncts of a component smallest first instead of in the order they appear
+   */
+  static thread_local bool ORDER_CONJUNCTS;
+  /**
+   * Reports the time spent on each component
+   */
+  static thread_local bool REPORT_COMPONENT_TIMES;
+  /**
+   * Records pass times, automata sizes and counting times in the profile of the driver
+   */
+  static thread_local bool ENABLE_PROFILING;
+  /**
+   * Number of threads that count independent components, 0 uses all cores.
+   * Only counting runs in parallel; components are still solved one after another on the
+   * calling thread, there is no parallel component solving or task graph.
+   */
+  static thread_local int COUNT_THREADS;
+  /**
+   * Builds the automata of a component whose conjuncts each restrict a single string variable
+   * with a constant over a compact alphabet of the characters the component mentions
+   */
+  static thread_local bool COMPACT_STRING_ENCODING;
+  static thread_local std::string OUTPUT_PATH;
+  static thread_local std::string SCRIPT_PATH;
+  /**
+   * Number of solve results kept in memory across queries, 0 disables the result cache
+   */
+  static int RESULT_CACHE_SIZE;
+  /**
+   * File that keeps solve results across runs, empty keeps them only in memory
+   */
+  static std::string RESULT_CACHE_PATH;
+};
+
+/**
+ * Snapshot of the thread local option values, a driver keeps its own snapshot and
+ * activates it on the thread that runs it.
+ */
+class Context {
+public:
+  /**
+   * @return option values of the calling thread
+   */
+  static Context Current();
+  /**
+   * Sets the option values of the calling thread
+   */
+  void Activate() const;
+
+  bool use_signed_integers;
+  bool use_multitrack_auto;
+  bool enable_equivalence_classes;
+  bool enable_dependency_analysis;
+  bool enable_implications;
+  bool enable_len_implications;
+  bool enable_sorting_heuristics;
+  bool force_dnf_formula;
+  bool count_bound_exact;
+  bool use_single_auto;
+  bool use_regex_splitter;
+  bool use_prefix_shortener;
+  bool concat_collapse_heuristic;
+  bool dfa_to_re;
+  bool order_conjuncts;
+  bool report_component_times;
+  bool enable_profiling;
+  int count_threads;
+  bool compact_string_encoding;
+  std::string output_path;
+  std::string script_path;
+  std::string tmp_path;
+  std::string theory_script_path;
+  CountingMethod counting_method;
+  bool use_direct_regex_construction;
+  bool use_symbolic_arithmetic_construction;
+  int regex_flag;
+};
+
+/**
+ * Activates a context on the calling thread and restores the previous values when it goes out of scope
+ */
+class ScopedContext {
+public:
+  ScopedContext(const Context& context);
+  ~ScopedContext();
+  ScopedContext(const ScopedContext&) = delete;
+  ScopedContext& operator=(const ScopedContext&) = delete;
+
+private:
+  const Context previous_;
 };
 
 } /* namespace Option */
@@ -26,7 +26,6 @@ ArithmeticFormula::ArithmeticFormula(const ArithmeticFormula& other)
     : Formula(other),
     	type_(other.type_),
       constant_(other.constant_) {
-  this->variable_coefficient_map_ = other.variable_coefficient_map_;
   this->boolean_variable_value_map_ = other.boolean_variable_value_map_;
   this->mixed_terms_ = other.mixed_terms_;
 }
@@ -38,23 +37,24 @@ ArithmeticFormula_ptr ArithmeticFormula::clone() const {
 std::string ArithmeticFormula::str() const {
   std::stringstream ss;
 
-  for (auto& el : variable_coefficient_map_) {
-    const int coefficient = el.second;
+  for (std::size_t i = 0; i < coefficients_.size(); ++i) {
+    const int coefficient = coefficients_[i];
+    const std::string& variable = layout_->variables[i];
     if (coefficient > 0) {
       ss << " + ";
       if (coefficient > 1) {
         ss << coefficient;
       }
-      ss << el.first;
+      ss << variable;
     } else if (coefficient < 0) {
       ss << " - ";
       if (coefficient < -1) {
         ss << std::abs(coefficient);
       }
-      ss << el.first;
+      ss << variable;
     } else {
       if (type_ == Type::INTERSECT or type_ == Type::UNION) {
-        ss << " " << el.first;
+        ss << " " << variable;
       }
     }
   }
@@ -174,8 +174,8 @@ void ArithmeticFormula::SetConstant(int constant) {
 }
 
 bool ArithmeticFormula::IsConstant() const {
-  for (const auto& el : variable_coefficient_map_) {
-    if (el.second != 0) {
+  for (const int coefficient : coefficients_) {
+    if (coefficient != 0) {
       return false;
     }
   }
@@ -223,13 +223,9 @@ bool ArithmeticFormula::UpdateMixedConstraintRelations() {
 ArithmeticFormula_ptr ArithmeticFormula::Add(ArithmeticFormula_ptr other_formula) {
   auto result = new ArithmeticFormula(*this);
 
-  for (const auto& el : other_formula->variable_coefficient_map_) {
-    auto it = result->variable_coefficient_map_.find(el.first);
-    if (it != result->variable_coefficient_map_.end()) {
-      it->second = it->second + el.second;
-    } else {
-      result->variable_coefficient_map_.insert(el);
-    }
+  const auto index_map = result->MergeLayout(*other_formula);
+  for (std::size_t i = 0; i < index_map.size(); ++i) {
+    result->coefficients_[index_map[i]] += other_formula->coefficients_[i];
   }
   result->constant_ = result->constant_ + other_formula->constant_;
 
@@ -244,13 +240,9 @@ ArithmeticFormula_ptr ArithmeticFormula::Subtract(ArithmeticFormula_ptr other_fo
 
   auto result = new ArithmeticFormula(*this);
 
-  for (const auto& el : other_formula->variable_coefficient_map_) {
-    auto it = result->variable_coefficient_map_.find(el.first);
-    if (it != result->variable_coefficient_map_.end()) {
-      it->second = it->second - el.second;
-    } else {
-      result->variable_coefficient_map_[el.first] = -el.second;
-    }
+  const auto index_map = result->MergeLayout(*other_formula);
+  for (std::size_t i = 0; i < index_map.size(); ++i) {
+    result->coefficients_[index_map[i]] -= other_formula->coefficients_[i];
   }
 
   result->constant_ = result->constant_ - other_formula->constant_;
@@ -261,8 +253,8 @@ ArithmeticFormula_ptr ArithmeticFormula::Subtract(ArithmeticFormula_ptr other_fo
 
 ArithmeticFormula_ptr ArithmeticFormula::Multiply(int value) {
   auto result = new ArithmeticFormula(*this);
-  for (auto& coeff : result->variable_coefficient_map_) {
-    coeff.second = value * coeff.second;
+  for (auto& coeff : result->coefficients_) {
+    coeff = value * coeff;
   }
   result->constant_ = value * constant_;
   return result;
@@ -308,14 +300,14 @@ ArithmeticFormula_ptr ArithmeticFormula::negate() {
  * @returns false if formula is not satisfiable and catched by simplification
  */
 bool ArithmeticFormula::Simplify() {
-  if (variable_coefficient_map_.size() == 0) {
+  if (coefficients_.size() == 0) {
     return true;
   }
 
-  int gcd_value = variable_coefficient_map_.begin()->second;
+  int gcd_value = coefficients_.front();
 
-  for (const auto& el : variable_coefficient_map_) {
-    gcd_value = Util::Math::gcd(gcd_value, el.second);
+  for (const int coefficient : coefficients_) {
+    gcd_value = Util::Math::gcd(gcd_value, coefficient);
   }
 
   if (gcd_value == 0) {
@@ -345,8 +337,8 @@ bool ArithmeticFormula::Simplify() {
       break;
     }
 
-  for (auto& c : variable_coefficient_map_) {
-    c.second = c.second / gcd_value;
+  for (auto& c : coefficients_) {
+    c = c / gcd_value;
   }
 
   return true;
@@ -354,10 +346,10 @@ bool ArithmeticFormula::Simplify() {
 
 int ArithmeticFormula::CountOnes(unsigned long n) const {
   int ones = 0;
-  for (const auto& el : variable_coefficient_map_) {
-    if (el.second != 0) {
+  for (const int coefficient : coefficients_) {
+    if (coefficient != 0) {
       if (n & 1) {
-        ones += el.second;
+        ones += coefficient;
       }
       n >>= 1;
     }
@@ -372,11 +364,7 @@ void ArithmeticFormula::MergeVariables(Formula_ptr formula) {
 		LOG(FATAL) << "failed cast in MergeVariables, both not arithmetic formulas";
 	}
 
-  for (auto& el : other->variable_coefficient_map_) {
-    if (variable_coefficient_map_.find(el.first) == variable_coefficient_map_.end()) {
-      variable_coefficient_map_[el.first] = 0;
-    }
-  }
+  MergeLayout(*other);
   mixed_terms_.insert(other->mixed_terms_.begin(), other->mixed_terms_.end());
 }
 
@@ -387,13 +375,13 @@ bool ArithmeticFormula::GetVarNamesIfEqualityOfTwoVars(std::string &v1, std::str
   v1.clear();
   v2.clear();
   int active_vars = 0;
-  for (auto& el : variable_coefficient_map_) {
-    if (el.second != 0) {
+  for (std::size_t i = 0; i < coefficients_.size(); ++i) {
+    if (coefficients_[i] != 0) {
       ++active_vars;
-      if (el.second == 1) {
-        v1 = el.first;
-      } else if (el.second == -1) {
-        v2 = el.first;
+      if (coefficients_[i] == 1) {
+        v1 = layout_->variables[i];
+      } else if (coefficients_[i] == -1) {
+        v2 = layout_->variables[i];
       }
       if (active_vars > 2) {
         return false;
@@ -69,6 +69,28 @@ public:
   int CountOnes(unsigned long n) const;
   virtual void MergeVariables(Formula_ptr);
 
+  /**
+   * Relations to mixed terms refer to the syntax tree and are not saved
+   */
+  template <class Archive>
+  void save(Archive& ar) const {
+    Formula::save(ar);
+    ar(static_cast<int>(type_));
+    ar(boolean_variable_value_map_);
+    ar(constant_);
+  }
+
+  template <class Archive>
+  void load(Archive& ar) {
+    Formula::load(ar);
+    int type = 0;
+    ar(type);
+    type_ = static_cast<Type>(type);
+    ar(boolean_variable_value_map_);
+    ar(constant_);
+    mixed_terms_.clear();
+  }
+
   friend std::ostream& operator<<(std::ostream& os, const ArithmeticFormula& formula);
 
 protected:
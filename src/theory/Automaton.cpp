@@ -7,18 +7,27 @@
 
 #include "Automaton.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../utils/MemoryInputBuffer.h"
+#include "../utils/Profiler.h"
+#include "DFATransformer.h"
+
 namespace Vlab {
 namespace Theory {
 
 const int Automaton::VLOG_LEVEL = 9;
 
-int Automaton::name_counter = 0;
-int Automaton::next_state = 0;
+thread_local int Automaton::name_counter = 0;
+thread_local int Automaton::next_state = 0;
 
-unsigned long Automaton::next_id = 0;
+std::atomic<unsigned long> Automaton::next_id { 0 };
 
-std::unordered_map<int, int*> Automaton::bdd_variable_indices;
-bool Automaton::count_bound_exact_;
+thread_local std::unordered_map<int, std::unique_ptr<int[]>> Automaton::bdd_variable_indices;
+thread_local bool Automaton::count_bound_exact_ = false;
 
 const std::string Automaton::Name::NONE = "none";
 const std::string Automaton::Name::BOOL = "BoolAutomaton";
@@ -32,7 +41,9 @@ Automaton::Automaton(Automaton::Type type)
 }
 
 Automaton::Automaton(Automaton::Type type, DFA_ptr dfa, int num_of_variables)
-        : type_(type), is_counter_cached_{false}, dfa_(dfa), num_of_bdd_variables_(num_of_variables), id_(Automaton::next_id++) { }
+        : type_(type), is_counter_cached_{false}, dfa_(dfa), num_of_bdd_variables_(num_of_variables), id_(Automaton::next_id++) {
+  DFAProfileSize(dfa_);
+}
 
 Automaton::Automaton(const Automaton& other)
         : type_(other.type_), is_counter_cached_{false}, dfa_(nullptr), num_of_bdd_variables_(other.num_of_bdd_variables_), id_(Automaton::next_id++) {
@@ -251,26 +262,61 @@ Automaton_ptr Automaton::Concat(Automaton_ptr other_automaton) {
   return concat_auto;
 }
 
+/**
+ * Checks if a cycle is reachable from the initial state without going through the sink state
+ */
 bool Automaton::isCyclic() {
   bool result = false;
-  std::map<int, bool> is_discovered;
-  std::map<int, bool> is_stack_member;
-  int sink_state = GetSinkState();
-  is_discovered[sink_state] = true; // avoid sink state
-
-  result = isCyclic(this->dfa_->s, is_discovered, is_stack_member);
+  const auto& graph = GetTransitionGraph();
+  const auto& is_in_cycle = GetCycleStates();
+  const int sink_state = GetSinkState();
+  if (sink_state != this->dfa_->s) {
+    std::vector<bool> is_discovered(this->dfa_->ns, false);
+    std::vector<int> states { this->dfa_->s };
+    is_discovered[this->dfa_->s] = true;
+    while (not states.empty() and not result) {
+      const int state = states.back();
+      states.pop_back();
+      result = is_in_cycle[state];
+      for (int i = graph.successor_offsets[state]; i < graph.successor_offsets[state + 1]; ++i) {
+        const int next_state = graph.successors[i];
+        if (next_state != sink_state and not is_discovered[next_state]) {
+          is_discovered[next_state] = true;
+          states.push_back(next_state);
+        }
+      }
+    }
+  }
   DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->isCyclic() ? " << std::boolalpha << result;
   return result;
 }
 
 bool Automaton::isInCycle(int state) {
-  std::map<int, bool> is_stack_member;
-  return isStateReachableFrom(state, state, is_stack_member);
+  return GetCycleStates()[state];
 }
 
+/**
+ * Sink states other than the start state are not walked through
+ */
 bool Automaton::isStateReachableFrom(int search_state, int from_state) {
-  std::map<int, bool> is_stack_member;
-  return isStateReachableFrom(search_state, from_state, is_stack_member);
+  const auto& graph = GetTransitionGraph();
+  std::vector<bool> is_discovered(this->dfa_->ns, false);
+  std::vector<int> states { from_state };
+  is_discovered[from_state] = true;
+  while (not states.empty()) {
+    const int state = states.back();
+    states.pop_back();
+    for (int i = graph.successor_offsets[state]; i < graph.successor_offsets[state + 1]; ++i) {
+      const int next_state = graph.successors[i];
+      if (next_state == search_state) {
+        return true;
+      } else if (not is_discovered[next_state] and not IsSinkState(next_state)) {
+        is_discovered[next_state] = true;
+        states.push_back(next_state);
+      }
+    }
+  }
+  return false;
 }
 
 BigInteger Automaton::Count(const unsigned long bound) {
@@ -304,23 +350,31 @@ BigInteger Automaton::CountByMatrixMultiplication(unsigned long bound) {
   return result;
 }
 
+/**
+ * Counts in process with the linear recurrence of the symbolic counter,
+ * the artificial self-loop of the count matrix is flipped on a copy when the
+ * requested semantics differs from the cached counter
+ */
 BigInteger Automaton::SymbolicCount(int bound, bool count_less_than_or_equal_to_bound) {
-  std::stringstream cmd;
-  std::string str_result;
-  std::string tmp_math_file = Option::Theory::TMP_PATH + "/math_script.m";
-  std::ofstream out_file(tmp_math_file.c_str());
+  if (not is_counter_cached_) {
+    SetSymbolicCounter();
+  }
 
-  generateMatrixScript(bound, out_file, count_less_than_or_equal_to_bound);
-//  generateGFScript(bound, out_file, count_less_than_or_equal_to_bound);
-  cmd << "math -script " << tmp_math_file;
-  try {
-    DVLOG(VLOG_LEVEL) << "run_cmd(`" << cmd.str() << "`)";
-    str_result = Util::Cmd::run_cmd(cmd.str());
-  } catch (std::string& e) {
-    LOG(ERROR) << e;
+  BigInteger result;
+  if (count_less_than_or_equal_to_bound != count_bound_exact_) {
+    result = counter_.CountByRecurrence(bound);
+  } else {
+    SymbolicCounter counter = counter_;
+    Eigen::SparseMatrix<BigInteger> count_matrix = counter.get_transition_count_matrix();
+    const int artificial_state = count_matrix.cols() - 1;
+    count_matrix.coeffRef(artificial_state, artificial_state) = count_less_than_or_equal_to_bound ? 1 : 0;
+    counter.set_transition_count_matrix(count_matrix);
+    counter.set_initialization_vector(count_matrix.innerVector(artificial_state));
+    result = counter.CountByRecurrence(bound);
   }
 
-  return BigInteger (str_result);
+  DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->SymbolicCount(" << bound << ", " << count_less_than_or_equal_to_bound << ") : " << result;
+  return result;
 }
 
 BigInteger Automaton::SymbolicCount(double bound, bool count_less_than_or_equal_to_bound) {
@@ -328,8 +382,6 @@ BigInteger Automaton::SymbolicCount(double bound, bool count_less_than_or_equal_
 }
 
 std::map<std::string,std::vector<std::string>> Automaton::GetModelsWithinBound(int num_models, int bound) {
-	//inspectAuto(false,true);
-
 	if(bound == -1 and num_models == -1) {
 		LOG(FATAL) << "both bound and num_models cant be -1";
 	} else if(bound == -1) {
@@ -337,321 +389,353 @@ std::map<std::string,std::vector<std::string>> Automaton::GetModelsWithinBound(i
 		bound = counter.GetMinBound(num_models);
 	}
 
-//	LOG(INFO) << "bound : " << bound;
-//	LOG(INFO) << "models: " << num_models;
-
-	// compute BFS for unweighted graph (dfa)
-	std::queue<int> states_to_process;
-	std::vector<int> distances(this->dfa_->ns,INT_MAX);
-	std::set<int> final_states;
-
-	std::vector<int> shortest_accepting_path(this->dfa_->ns,INT_MAX);
-	for(int start_state = 0; start_state < this->dfa_->ns; start_state++) {
-		distances[start_state] = 0;
-		states_to_process.push(start_state);
-
-		while(not states_to_process.empty()) {
-			int s = states_to_process.front();
-			states_to_process.pop();
-			// mark final states for later
-			if(this->dfa_->f[s] == 1) {
-				final_states.insert(s);
-			}
-
-			for(auto iter : getNextStates(s)) {
-				if(distances[iter] == INT_MAX) {
-					states_to_process.push(iter);
-					distances[iter] = distances[s] + 1;
-				}
-			}
-		}
-
-		int shortest = INT_MAX;
-		for(auto final : final_states) {
-			if(distances[final] < shortest) {
-				shortest = distances[final];
-			}
-		}
-		shortest_accepting_path[start_state] = shortest;
-
-
-		distances = std::vector<int>(this->dfa_->ns,INT_MAX);
+	auto formula = this->GetFormula();
+	if(formula == nullptr) {
+		LOG(FATAL) << "Formula not set!";
 	}
 
-//	for(int i = 0; i < this->dfa_->ns; i++) {
-//		LOG(INFO) << "shortest path for state " << i << " = " << shortest_accepting_path[i];
-//	}
-//
-//	LOG(INFO) << "Done computing shortest paths to final state";
-
-	// assume num_tracks > 1; Otherwise, juse call normal version
-	int models_so_far = 0;
-	int num_variables = this->num_of_bdd_variables_;
-
-	std::vector<std::pair<int,std::vector<char>>> next_states;
-
-	// cache the process for finding next transitions from a state
-	std::vector<std::vector<std::pair<int,std::vector<char>>>> next_states_matrix(this->dfa_->ns);
-	for(int i = 0; i < this->dfa_->ns; i++) {
-		int current_state = i;
-		std::vector<std::pair<int,std::vector<char>>> inner_next_states;
-		std::vector<unsigned> nodes;
-		std::vector<std::vector<char>> transition_stack;
-		std::vector<char> current_transition;
-		int sink = GetSinkState();
-
-		unsigned p, l, r, index; // BDD traversal variables
-		p = this->dfa_->q[current_state];
-		nodes.push_back(p);
-		transition_stack.push_back(std::vector<char>());
-		while (not nodes.empty()) {
-			p = nodes.back();
-			nodes.pop_back();
-			current_transition = transition_stack.back();
-			transition_stack.pop_back();
-			LOAD_lri(&this->dfa_->bddm->node_table[p], l, r, index);
-			if (index == BDD_LEAF_INDEX) {
-				int to_state = l;
-				// if to_state is sink state, ignore
-				if(to_state == sink) {
-					continue;
-				}
-
-				while (current_transition.size() < (unsigned) num_of_bdd_variables_) {
-					current_transition.push_back('X');
-				}
-				// put loops first, other states at back
-				if(to_state != current_state) {
-					next_states_matrix[i].push_back(std::make_pair(to_state, current_transition));
-				} else {
-					next_states_matrix[i].insert(next_states_matrix[i].begin(),std::make_pair(to_state,current_transition));
-				}
+	std::set<std::string> printable_models;
+	ForEachModelWithinBound(bound, [&](const std::string& model) {
+		printable_models.insert(model);
+		// quit early if we have enough models
+		return num_models == -1 or printable_models.size() < static_cast<std::size_t>(num_models);
+	});
 
-			} else {
-				while (current_transition.size() < index) {
-					unsigned i = current_transition.size();
-					current_transition.push_back('X');
-				}
-				std::vector<char> left = current_transition;
-				left.push_back('0');
-				std::vector<char> right = current_transition;
-				right.push_back('1');
-				transition_stack.push_back(right);
-				nodes.push_back(r);
-				transition_stack.push_back(left);
-				nodes.push_back(l);
-			}
-		}
+	std::map<std::string,std::vector<std::string>> variable_values;
+	for(auto& variable : formula->GetVariables()) {
+		variable_values[variable] = std::vector<std::string>();
 	}
 
+	// should be only 1 track, so should have a variable
+	std::string var_name = formula->GetVariableAtIndex(0);
+	variable_values[var_name].assign(printable_models.begin(), printable_models.end());
+	return variable_values;
+}
 
-	int start = this->dfa_->s;
-	int sink = GetSinkState();
-	bool get_more_models = true;
-	std::vector<char> characters;
-	std::stack<std::pair<int,std::vector<char>>> models_to_process;
-	// since we're not expanding dont-care characters ('X') yet, the models we find are unfinished
-	std::set<std::vector<char>> unfinished_models;
-
-	models_to_process.push(std::make_pair(start,characters));
-
-	// BLASTOFF!
-	while(not models_to_process.empty() and get_more_models) {
-		std::pair<int,std::vector<char>> current_model = models_to_process.top();
-		models_to_process.pop();
-
-		int current_state = current_model.first;
-		int length = current_model.second.size() / num_variables;
-
-		if(shortest_accepting_path[current_state] + length > bound) {
-			continue;
+/**
+ * Streams the models of length at most bound (exactly bound if counting is bound exact), the
+ * don't care bits of each accepting path are expanded one assignment at a time
+ * @param bound
+ * @param callback called with each model, enumeration stops when it returns false
+ */
+void Automaton::ForEachModelWithinBound(int bound, ModelCallback callback) {
+	auto shortest_accepting_path = GetShortestAcceptingPaths();
+	const int num_variables = this->num_of_bdd_variables_;
+
+	std::vector<char> bits;
+	std::vector<std::size_t> dont_cares;
+	std::string model;
+	ForEachAcceptingPathWithinBound(shortest_accepting_path, bound, true, false,
+			[&](const std::vector<char>& path, int length) {
+		if(count_bound_exact_ and length != bound) {
+			return true;
+		}
+		bits = path;
+		dont_cares.clear();
+		for(std::size_t k = 0; k < bits.size(); k++) {
+			if(bits[k] == 'X') {
+				bits[k] = '0';
+				dont_cares.push_back(k);
+			}
 		}
 
-		// check if its final state; if so, record the model
-		if(this->dfa_->f[current_state] == 1) {
-			if((count_bound_exact_ and length == bound) or (not count_bound_exact_ and length <= bound)) {
-
-				int num_x = 0;
-				for(int k = 0; k < current_model.second.size(); k++) {
-					if(current_model.second[k] == 'X') {
-						num_x++;
+		while(true) {
+			model.clear();
+			for(int k = 0; k < length; k++) {
+				unsigned char c = 0;
+				for(int j = 0; j < num_variables; j++) {
+					if(bits[k*num_variables + j] == '1') {
+						c |= 1;
+					}
+					if(j != 7) {
+						c <<= 1;
 					}
 				}
-
-				unfinished_models.insert(current_model.second);
-				// set finish condition if necessary
-				if(num_models != -1 and models_so_far >= num_models) {
-					get_more_models = false;
-					continue;
-				}
+				model += c;
 			}
-		}
-
-		for(auto iter : next_states_matrix[current_state]) {
-		// next_state is in first position
-			int to_state = iter.first;
-			// if the current length + shortest path to final state from to_state + 1 (for transition from current -> to_state)
-			// is greater than bound, ignore
-			if(to_state == sink || length + shortest_accepting_path[to_state]+1 > bound) {
-				continue;
+			if(not callback(model)) {
+				return false;
 			}
 
-			if(to_state != sink and (length < bound or bound == -1)) {
-				std::vector<char> transition = iter.second;
-
-				// transition is in second position
-				characters = current_model.second;
-				for(int k = 0; k < num_variables; k++) {
-					// since tracks are interleaved, track i's characters don't lie in order in the transition we got
-					characters.push_back(transition[k]);
-				}
-
-
-				models_to_process.push(std::make_pair(to_state,characters));
+			// next assignment of the don't care bits, counting up from the last one
+			auto it = dont_cares.rbegin();
+			while(it != dont_cares.rend() and bits[*it] == '1') {
+				bits[*it] = '0';
+				++it;
 			}
+			if(it == dont_cares.rend()) {
+				return true;
+			}
+			bits[*it] = '1';
 		}
-	}
-
-	//LOG(INFO) << "Got unfinished";
-	std::vector<std::vector<bool>> finished_models;
-	for(auto iter : unfinished_models) {
-		std::vector<std::vector<bool>> models;
-		models.push_back(std::vector<bool>());
-
-		for(int k = 0; k < iter.size(); k++) {
+	});
+}
 
-			// if a character is X (dont care), duplicate transition, one for 1, one for 0
-			if(iter[k] == 'X') {
-				// dont add both transitions for X if we are at the desired number of models
-				if(models.size() + finished_models.size() >= num_models) {
-					for(int i = 0; i < models.size(); i++) {
-						models[i].push_back(0);
-					}
-				} else {
-					std::vector<std::vector<bool>> temp_models;
-					for(int i = 0; i < models.size(); i++) {
-						// dont add both transitions for X if we are at the desired number of models
-						if(models.size() + temp_models.size() + finished_models.size() < num_models) {
-							std::vector<bool> m = models[i];
-							m.push_back(1);
-							temp_models.push_back(m);
-						}
-						models[i].push_back(0);
-					}
-					models.insert(models.end(),temp_models.begin(),temp_models.end());
-				}
-			} else {
-				for(int i = 0; i < models.size(); i++) {
-					if(iter[k] == '0') {
-						models[i].push_back(0);
-					} else {
-						models[i].push_back(1);
-					}
-				}
+/**
+ * Computes the length of the shortest path from each state to an accepting state with a single
+ * breadth first search from all accepting states over the predecessors
+ * @return shortest path lengths, INT_MAX for states that cannot reach an accepting state
+ */
+std::vector<int> Automaton::GetShortestAcceptingPaths() {
+	const auto& graph = GetTransitionGraph();
+	const int num_states = this->dfa_->ns;
+	std::vector<int> shortest_accepting_path(num_states, INT_MAX);
+	std::vector<int> states_to_process;
+	states_to_process.reserve(num_states);
+	for(int s = 0; s < num_states; s++) {
+		if(this->dfa_->f[s] == 1) {
+			shortest_accepting_path[s] = 0;
+			states_to_process.push_back(s);
+		}
+	}
+	for(std::size_t next = 0; next < states_to_process.size(); next++) {
+		int s = states_to_process[next];
+		for(int p = graph.predecessor_offsets[s]; p < graph.predecessor_offsets[s + 1]; p++) {
+			int from_state = graph.predecessors[p];
+			if(shortest_accepting_path[from_state] == INT_MAX) {
+				shortest_accepting_path[from_state] = shortest_accepting_path[s] + 1;
+				states_to_process.push_back(from_state);
 			}
 		}
+	}
+	return shortest_accepting_path;
+}
 
-//		for(auto i2 : models) {
-//			std::string s;
-//			for(int k = 0; k < i2.size(); k++) {
-//				if(i2[k]) s+= '1';
-//				else s+='0';
-//			}
-//			LOG(INFO) << s;
-//		}
-//		std::cin.get();
-
-		finished_models.insert(finished_models.end(),models.begin(),models.end());
+/**
+ * Walks the accepting paths of length at most bound depth first, a branch is cut as soon as it
+ * cannot reach an accepting state within the bound. Paths are streamed, nothing is materialized.
+ * @param shortest_accepting_path
+ * @param bound
+ * @param extend_accepting_paths if false, paths are not extended beyond an accepting state
+ * @param expand_accepting_transitions if true, a transition into an accepting state is followed once
+ *        for each assignment of its don't care bits
+ * @param callback
+ */
+void Automaton::ForEachAcceptingPathWithinBound(const std::vector<int>& shortest_accepting_path, int bound, bool extend_accepting_paths,
+                                                bool expand_accepting_transitions, AcceptingPathCallback callback) {
+	const auto& graph = GetTransitionGraph();
+	const int start = this->dfa_->s;
+	const int num_variables = this->num_of_bdd_variables_;
+	if(shortest_accepting_path[start] > bound) {
+		return;
+	}
+	if(this->dfa_->f[start] == 1 and (not callback(std::vector<char>(), 0) or not extend_accepting_paths)) {
+		return;
 	}
 
-	//LOG(INFO) << "Got finished models";
+	struct PathState {
+		int state;
+		int transition; // next transition to follow
+		// next assignment of the don't care bits of that transition, empty before the first one
+		std::vector<char> assignment;
+	};
+	std::vector<char> path;
+	std::vector<int> dont_cares;
+	std::vector<PathState> path_states;
+	path_states.push_back(PathState { start, graph.successor_offsets[start], std::vector<char>() });
+	while(not path_states.empty()) {
+		const int length = path_states.size() - 1;
+		PathState& current = path_states.back();
+		const int t = current.transition;
+		if(t == graph.successor_offsets[current.state + 1]) {
+			path_states.pop_back();
+			path.resize(path.size() - ((length > 0) ? num_variables : 0));
+			continue;
+		}
 
-	std::set<std::string> printable_models;
-	for(auto iter : finished_models) {
-		// quit early if we have enough models
-		if(printable_models.size() >= num_models) {
-			break;
+		const int to_state = graph.successors[t];
+		if(shortest_accepting_path[to_state] == INT_MAX or length + 1 + shortest_accepting_path[to_state] > bound) {
+			current.transition++;
+			continue;
 		}
-		std::string model;
-		int length = iter.size() / num_variables;
-		for(int k = 0; k < length; k++) {
-			unsigned char c = 0;
-
-			// var_per_track-1 since we dont' care about the last bit, which is used for lambda
-			for(int j = 0; j < num_variables; j++) {
-				int index = (k*num_variables + j);
-				if(iter[index]) {
-					c |= 1;
-				} else {
-					c |= 0;
-				}
-				if(j != 7) {
-					c <<= 1;
+		auto first_bit = graph.bits.begin() + t * num_variables;
+		path.insert(path.end(), first_bit, first_bit + num_variables);
+		if(expand_accepting_transitions and this->dfa_->f[to_state] == 1) {
+			dont_cares.clear();
+			for(int k = 0; k < num_variables; k++) {
+				if(first_bit[k] == 'X') {
+					dont_cares.push_back(path.size() - num_variables + k);
 				}
 			}
-
-//			char c_arr[4];
-//			charToAscii(c_arr,c);
-//			model += c_arr;
-			model += c;
+			if(current.assignment.empty()) {
+				current.assignment.assign(dont_cares.size(), '0');
+			}
+			for(unsigned k = 0; k < dont_cares.size(); k++) {
+				path[dont_cares[k]] = current.assignment[k];
+			}
+			// count up like a binary number, the transition is done when the assignment wraps around
+			int k = (int) dont_cares.size() - 1;
+			for(; k >= 0 and current.assignment[k] == '1'; k--) {
+				current.assignment[k] = '0';
+			}
+			if(k >= 0) {
+				current.assignment[k] = '1';
+			} else {
+				current.transition++;
+				current.assignment.clear();
+			}
+		} else {
+			current.transition++;
 		}
-		printable_models.insert(model);
-	}
 
-	auto formula = this->GetFormula();
-	if(formula == nullptr) {
-		LOG(FATAL) << "Formula not set!";
-	}
-	auto var_coeffs = formula->GetVariableCoefficientMap();
-	std::map<std::string,std::vector<std::string>> variable_values;
-	for(auto iter : var_coeffs) {
-		variable_values[iter.first] = std::vector<std::string>();
-	}
-
-	// should be only 1 track, so should have a variable
-	std::string var_name = formula->GetVariableAtIndex(0);
-
-	for(auto iter : printable_models) {
-		variable_values[var_name].push_back(iter);
+		if(this->dfa_->f[to_state] == 1) {
+			if(not callback(path, length + 1)) {
+				return;
+			}
+			if(not extend_accepting_paths) {
+				path.resize(path.size() - num_variables);
+				continue;
+			}
+		}
+		path_states.push_back(PathState { to_state, graph.successor_offsets[to_state], std::vector<char>() });
 	}
-
-	return variable_values;
 }
 
 void Automaton::SetCountBoundExact(bool value) {
 	count_bound_exact_ = value;
 }
 
-bool Automaton::isCyclic(int state, std::map<int, bool>& is_discovered, std::map<int, bool>& is_stack_member) {
-  if (not is_discovered[state]) {
-    is_discovered[state] = true;
-    is_stack_member[state] = true;
-    for (auto next_state : getNextStates(state)) {
-      if ((not is_discovered[next_state]) and isCyclic(next_state, is_discovered, is_stack_member)) {
-        return true;
-      } else if (is_stack_member[next_state]) {
-        return true;
+/**
+ * Walks the bdd of each state once, a transition is recorded for each path to a leaf
+ */
+const TransitionGraph& Automaton::GetTransitionGraph() {
+  if (transition_graph_) {
+    return *transition_graph_;
+  }
+  const int num_of_states = this->dfa_->ns;
+  const int num_of_variables = this->num_of_bdd_variables_;
+  std::unique_ptr<TransitionGraph> graph(new TransitionGraph());
+  graph->successor_offsets.reserve(num_of_states + 1);
+  graph->successor_offsets.push_back(0);
+  std::vector<int> num_of_predecessors(num_of_states, 0);
+
+  std::vector<int> loop_successors, other_successors;
+  std::vector<char> loop_bits, other_bits;
+  // bdd node with the length of the transition prefix leading to it and the last bit of that prefix
+  std::vector<std::pair<unsigned, std::pair<int, char>>> nodes;
+  std::vector<char> transition;
+  unsigned l, r, index; // BDD traversal variables
+  for (int s = 0; s < num_of_states; ++s) {
+    loop_successors.clear();
+    other_successors.clear();
+    loop_bits.clear();
+    other_bits.clear();
+    nodes.push_back(std::make_pair(this->dfa_->q[s], std::make_pair(0, 'X')));
+    while (not nodes.empty()) {
+      auto current = nodes.back();
+      nodes.pop_back();
+      // the prefix up to the parent is shared, only the branch bit differs
+      transition.resize(current.second.first);
+      if (current.second.first > 0) {
+        transition.back() = current.second.second;
+      }
+      LOAD_lri(&this->dfa_->bddm->node_table[current.first], l, r, index);
+      if (index == BDD_LEAF_INDEX) {
+        transition.resize(num_of_variables, 'X');
+        // put loops first, other states at back
+        auto& successors = ((int) l == s) ? loop_successors : other_successors;
+        auto& bits = ((int) l == s) ? loop_bits : other_bits;
+        successors.push_back(l);
+        bits.insert(bits.end(), transition.begin(), transition.end());
+        ++num_of_predecessors[l];
+      } else {
+        transition.resize(index, 'X');
+        nodes.push_back(std::make_pair(r, std::make_pair(index + 1, '1')));
+        nodes.push_back(std::make_pair(l, std::make_pair(index + 1, '0')));
       }
     }
+    graph->successors.insert(graph->successors.end(), loop_successors.begin(), loop_successors.end());
+    graph->successors.insert(graph->successors.end(), other_successors.begin(), other_successors.end());
+    graph->bits.insert(graph->bits.end(), loop_bits.begin(), loop_bits.end());
+    graph->bits.insert(graph->bits.end(), other_bits.begin(), other_bits.end());
+    graph->successor_offsets.push_back(graph->successors.size());
   }
-  is_stack_member[state] = false;
-  return false;
+
+  graph->predecessor_offsets.assign(num_of_states + 1, 0);
+  for (int s = 0; s < num_of_states; ++s) {
+    graph->predecessor_offsets[s + 1] = graph->predecessor_offsets[s] + num_of_predecessors[s];
+  }
+  graph->predecessors.resize(graph->successors.size());
+  std::vector<int> positions(graph->predecessor_offsets.begin(), graph->predecessor_offsets.end() - 1);
+  for (int s = 0; s < num_of_states; ++s) {
+    for (int i = graph->successor_offsets[s]; i < graph->successor_offsets[s + 1]; ++i) {
+      graph->predecessors[positions[graph->successors[i]]++] = s;
+    }
+  }
+
+  transition_graph_ = std::move(graph);
+  return *transition_graph_;
 }
 
-bool Automaton::isStateReachableFrom(int search_state, int from_state, std::map<int, bool>& is_stack_member) {
-  is_stack_member[from_state] = true;
+/**
+ * Iterative Tarjan's algorithm, a state is on a cycle if its component has more than one state
+ * or it has a self loop
+ */
+const std::vector<bool>& Automaton::GetCycleStates() {
+  GetTransitionGraph();
+  auto& graph = *transition_graph_;
+  if (not graph.is_in_cycle.empty() or this->dfa_->ns == 0) {
+    return graph.is_in_cycle;
+  }
+  const int num_of_states = this->dfa_->ns;
+  graph.is_in_cycle.assign(num_of_states, false);
+  std::vector<int> order(num_of_states, -1);
+  std::vector<int> low(num_of_states, 0);
+  std::vector<bool> is_stack_member(num_of_states, false);
+  std::vector<int> component_stack;
+  std::vector<std::pair<int, int>> call_stack; // state and the position of its next successor
+  int next_order = 0;
+
+  for (int root = 0; root < num_of_states; ++root) {
+    if (order[root] != -1) {
+      continue;
+    }
+    order[root] = low[root] = next_order++;
+    component_stack.push_back(root);
+    is_stack_member[root] = true;
+    call_stack.push_back(std::make_pair(root, graph.successor_offsets[root]));
+    while (not call_stack.empty()) {
+      const int state = call_stack.back().first;
+      const int position = call_stack.back().second;
+      if (position < graph.successor_offsets[state + 1]) {
+        ++call_stack.back().second;
+        const int next_state = graph.successors[position];
+        if (order[next_state] == -1) {
+          order[next_state] = low[next_state] = next_order++;
+          component_stack.push_back(next_state);
+          is_stack_member[next_state] = true;
+          call_stack.push_back(std::make_pair(next_state, graph.successor_offsets[next_state]));
+        } else if (is_stack_member[next_state]) {
+          low[state] = std::min(low[state], order[next_state]);
+        }
+        continue;
+      }
 
-  for (auto next_state : getNextStates(from_state)) {
-    if (next_state == search_state) {
-      return true;
-    } else if ((not is_stack_member[next_state]) and (not IsSinkState(next_state)) and
-      isStateReachableFrom(search_state, next_state, is_stack_member)) {
-      return true;
+      call_stack.pop_back();
+      if (not call_stack.empty()) {
+        const int parent_state = call_stack.back().first;
+        low[parent_state] = std::min(low[parent_state], low[state]);
+      }
+      if (low[state] == order[state]) {  // head of a component
+        // self loops come first
+        const bool has_self_loop = graph.successor_offsets[state + 1] > graph.successor_offsets[state]
+            and graph.successors[graph.successor_offsets[state]] == state;
+        const bool is_cycle = has_self_loop or component_stack.back() != state;
+        int component_state = -1;
+        do {
+          component_state = component_stack.back();
+          component_stack.pop_back();
+          is_stack_member[component_state] = false;
+          graph.is_in_cycle[component_state] = is_cycle;
+        } while (component_state != state);
+      }
     }
   }
+  return graph.is_in_cycle;
+}
 
-  is_stack_member[from_state] = false;
-  return false;
+void Automaton::InvalidateTransitionGraph() {
+  transition_graph_.reset();
 }
 
 /**
@@ -872,13 +956,20 @@ std::ostream& operator<<(std::ostream& os, const Automaton& automaton) {
 }
 
 void Automaton::CleanUp() {
-	for(auto &it : bdd_variable_indices) {
-		delete[] it.second;
-		it.second = nullptr;
-	}
 	bdd_variable_indices.clear();
 }
 
+std::recursive_mutex& Automaton::GetMonaMutex() {
+  static std::recursive_mutex mona_mutex;
+  return mona_mutex;
+}
+
+void Automaton::DFAProfileSize(const DFA_ptr dfa) {
+  if (dfa != nullptr and Util::Profiler::IsActive()) {
+    Util::Profiler::AddAutomaton(dfa->ns, bdd_size(dfa->bddm));
+  }
+}
+
 bool Automaton::DFAIsMinimizedEmtpy(const DFA_ptr minimized_dfa) {
     return (minimized_dfa->ns == 1 && minimized_dfa->f[minimized_dfa->s] == -1)? true : false;
 }
@@ -959,6 +1050,67 @@ bool Automaton::DFAIsEqual(const DFA_ptr dfa1, const DFA_ptr dfa2) {
   return result;
 }
 
+bool Automaton::DFAIsIntersectionEmpty(const DFA_ptr dfa1, const DFA_ptr dfa2, const std::size_t max_num_of_states) {
+  unsigned l1, r1, index1, l2, r2, index2; // BDD traversal variables
+  const int sink_state1 = DFAGetSinkState(dfa1);
+  const int sink_state2 = DFAGetSinkState(dfa2);
+  std::unordered_set<unsigned long> visited_states;
+  std::stack<std::pair<int, int>> states;
+  std::unordered_set<unsigned long> visited_nodes;
+  std::stack<std::pair<unsigned, unsigned>> nodes;
+
+  // product states with a sink state reject everything
+  auto add_state = [&](const int s1, const int s2) {
+    if (s1 == sink_state1 or s2 == sink_state2) {
+      return;
+    }
+    if (visited_states.insert((unsigned long) s1 * (unsigned long) dfa2->ns + s2).second) {
+      states.push(std::make_pair(s1, s2));
+    }
+  };
+
+  add_state(dfa1->s, dfa2->s);
+  while (not states.empty()) {
+    if (visited_states.size() > max_num_of_states) {
+      return false;
+    }
+    const int s1 = states.top().first;
+    const int s2 = states.top().second;
+    states.pop();
+    // the product state is rejecting only if one of the states is rejecting, as in dfaProduct
+    if (dfa1->f[s1] != -1 and dfa2->f[s2] != -1) {
+      return false;
+    }
+
+    // walks the two bdds together, a variable tested in only one of them is tested in that one only
+    visited_nodes.clear();
+    nodes.push(std::make_pair(dfa1->q[s1], dfa2->q[s2]));
+    while (not nodes.empty()) {
+      const unsigned p1 = nodes.top().first;
+      const unsigned p2 = nodes.top().second;
+      nodes.pop();
+      if (not visited_nodes.insert(((unsigned long) p1 << 32) | p2).second) {
+        continue;
+      }
+      LOAD_lri(&dfa1->bddm->node_table[p1], l1, r1, index1);
+      LOAD_lri(&dfa2->bddm->node_table[p2], l2, r2, index2);
+      if (index1 == BDD_LEAF_INDEX and index2 == BDD_LEAF_INDEX) {
+        add_state(l1, l2);
+      } else if (index1 == index2) {
+        nodes.push(std::make_pair(l1, l2));
+        nodes.push(std::make_pair(r1, r2));
+      } else if (index1 < index2) {
+        nodes.push(std::make_pair(l1, p2));
+        nodes.push(std::make_pair(r1, p2));
+      } else {
+        nodes.push(std::make_pair(p1, l2));
+        nodes.push(std::make_pair(p1, r2));
+      }
+    }
+  }
+  return true;
+}
+
 int Automaton::DFAGetInitialState(const DFA_ptr dfa) {
   return dfa->s;
 }
@@ -1017,20 +1169,34 @@ DFA_ptr Automaton::DFAMakeEmpty(const int number_of_bdd_variables) {
 }
 
 DFA_ptr Automaton::DFAComplement(const DFA_ptr dfa) {
+  Util::Profiler::ScopedOperation operation("complement");
   DFA_ptr complement_dfa = dfaCopy(dfa);
   dfaNegation(complement_dfa);
   return complement_dfa;
 }
 
 DFA_ptr Automaton::DFAUnion(const DFA_ptr dfa1, const DFA_ptr dfa2) {
+  Util::Profiler::ScopedOperation operation("union");
   DFA_ptr union_dfa = dfaProduct(dfa1, dfa2, dfaOR);
+  DFAProfileSize(union_dfa);
   DFA_ptr minimized_dfa = dfaMinimize(union_dfa);
   dfaFree(union_dfa);
   return minimized_dfa;
 }
 
+/**
+ * An empty intersection is detected on the fly before the product is built, the search gives up
+ * after a number of product states linear in the sizes of the dfas so that it stays cheap when
+ * the intersection is not empty. The minimized empty dfa has a single state without any bdd node,
+ * it does not depend on the number of bdd variables.
+ */
 DFA_ptr Automaton::DFAIntersect(const DFA_ptr dfa1, const DFA_ptr dfa2) {
+  Util::Profiler::ScopedOperation operation("intersect");
+  if (DFAIsIntersectionEmpty(dfa1, dfa2, 2 * (dfa1->ns + dfa2->ns))) {
+    return DFAMakePhi(0);
+  }
   DFA_ptr intersect_dfa = dfaProduct(dfa1, dfa2, dfaAND);
+  DFAProfileSize(intersect_dfa);
   DFA_ptr minimized_dfa = dfaMinimize(intersect_dfa);
   dfaFree(intersect_dfa);
   return minimized_dfa;
@@ -1044,6 +1210,7 @@ DFA_ptr Automaton::DFADifference(const DFA_ptr dfa1, DFA_ptr dfa2) {
 }
 
 DFA_ptr Automaton::DFAProjectAway(const DFA_ptr dfa, const int index) {
+  Util::Profiler::ScopedOperation operation("project");
   DFA_ptr projected_dfa = dfaProject(dfa, (unsigned)index);
   DFA_ptr minimized_dfa = dfaMinimize(projected_dfa);
   dfaFree(projected_dfa);
@@ -1051,6 +1218,7 @@ DFA_ptr Automaton::DFAProjectAway(const DFA_ptr dfa, const int index) {
 }
 
 DFA_ptr Automaton::DFAProjectAway(const DFA_ptr dfa, std::vector<int> map, const std::vector<int> indices) {
+  Util::Profiler::ScopedOperation operation("project");
 	DFA_ptr temp,result_dfa = dfa;
 	int flag = 0;
 
@@ -1189,6 +1357,7 @@ std::set<std::string> Automaton::DFAGetTransitionsFromTo(DFA_ptr dfa, const int
 }
 
 DFA_ptr Automaton::DFAConcat(const DFA_ptr dfa1, const DFA_ptr dfa2, const int number_of_bdd_variables) {
+  Util::Profiler::ScopedOperation operation("concat");
   if (DFAIsMinimizedEmtpy(dfa1) or DFAIsMinimizedEmtpy(dfa2)) {
 		return DFAMakeEmpty(number_of_bdd_variables);
 	} else if (DFAIsMinimizedOnlyAcceptingEmptyInput(dfa1)) {
@@ -1214,139 +1383,54 @@ DFA_ptr Automaton::DFAConcat(const DFA_ptr dfa1, const DFA_ptr dfa2, const int n
 		dfaFree(any_input_other_than_empty);
 	}
 
-  paths state_paths = nullptr, pp = nullptr;
-	trace_descr tp = nullptr;
-
-	std::map<std::string, int> exceptions_left_auto;
-	std::map<std::string, int> exceptions_right_auto;
-
   int left_sink = DFAGetSinkState(left_dfa);
   int right_sink = DFAGetSinkState(right_dfa);
-  int to_state = -1;
 
   int num_of_states = left_dfa->ns + right_dfa->ns;
   int new_sink = num_of_states;
   num_of_states++;
 
   int state_shift_amount = left_dfa->ns;
-  int tmp_num_of_variables = number_of_bdd_variables+1;
-  char* statuses = new char[num_of_states+1];
-  int* indices = GetBddVariableIndices(number_of_bdd_variables);
-	int* concat_indices = GetBddVariableIndices(tmp_num_of_variables);
-
-  dfaSetup(num_of_states, tmp_num_of_variables, concat_indices);
-
-  for (int i = 0; i < left_dfa->ns; i++) {
-		state_paths = pp = make_paths(left_dfa->bddm, left_dfa->q[i]);
-		while (pp) {
-			if (left_sink && pp->to == (unsigned)left_sink) {
-				pp = pp->next;
-				continue;
-			}
-			to_state = pp->to;
-			std::string current_exception = "";
-			for (int j = 0; j < number_of_bdd_variables; j++) {
-				for (tp = pp->trace; tp && (tp->index != (unsigned)indices[j]); tp = tp->next);
-				if (tp) {
-					if (tp->value) {
-						current_exception.push_back('1');
-					} else {
-						current_exception.push_back('0');
-					}
-				} else {
-					current_exception.push_back('X');
-				}
-			}
-
-      
-			current_exception.push_back('0'); 
-			current_exception.push_back('\0');
-			exceptions_left_auto[current_exception] = to_state;
-			
-      if(DFAIsAcceptingState(left_dfa,to_state)) {
-        current_exception[current_exception.size()-2] = '1';
-        exceptions_left_auto[current_exception] = state_shift_amount; // to initial state of right_dfa
-      }
-      
-      tp = nullptr;
-			pp = pp->next;
-		}
-
-    dfaAllocExceptions(exceptions_left_auto.size());
-    for (auto entry : exceptions_left_auto) {
-      dfaStoreException(entry.second, const_cast<char*>(entry.first.data()));
+  DFATransformer transformer(num_of_states);
+
+  // transitions on the original symbols have the extra bit 0, transitions to an accepting state
+  // also move to the initial state of the right dfa with the extra bit 1
+  transformer.SetSource(left_dfa);
+  transformer.SetLeafMap([&](const int to_state) {
+    if (left_sink && to_state == left_sink) {
+      return transformer.MakeLeaf(new_sink);
     }
-    dfaStoreState(new_sink);
-    statuses[i] = '-';
-    exceptions_left_auto.clear();
-
-		kill_paths(state_paths);
-		state_paths = pp = nullptr;
-	}
+    const int extra_bit_target = DFAIsAcceptingState(left_dfa, to_state) ? state_shift_amount : new_sink;
+    return transformer.MakeNode(number_of_bdd_variables, transformer.MakeLeaf(to_state),
+                                transformer.MakeLeaf(extra_bit_target));
+  });
+  for (int i = 0; i < left_dfa->ns; i++) {
+    transformer.SetState(i, transformer.Transform(i), -1);
+  }
 
   // right auto
-  for (int i = 0; i < right_dfa->ns; i++) {
-		state_paths = pp = make_paths(right_dfa->bddm, right_dfa->q[i]);
-		while (pp) {
-			if (right_sink && pp->to == (unsigned)right_sink) {
-				pp = pp->next;
-				continue;
-			}
-			to_state = pp->to;
-			std::string current_exception = "";
-			for (int j = 0; j < number_of_bdd_variables; j++) {
-				for (tp = pp->trace; tp && (tp->index != (unsigned)indices[j]); tp = tp->next);
-				if (tp) {
-					if (tp->value) {
-						current_exception.push_back('1');
-					} else {
-						current_exception.push_back('0');
-					}
-				} else {
-					current_exception.push_back('X');
-				}
-			}
-
-      
-			current_exception.push_back('0'); 
-			current_exception.push_back('\0');
-			exceptions_right_auto[current_exception] = to_state + state_shift_amount;
-      
-      tp = nullptr;
-			pp = pp->next;
-		}
-
-    dfaAllocExceptions(exceptions_right_auto.size());
-    for (auto entry : exceptions_right_auto) {
-      dfaStoreException(entry.second, const_cast<char*>(entry.first.data()));
+  transformer.SetSource(right_dfa);
+  transformer.SetLeafMap([&](const int to_state) {
+    if (right_sink && to_state == right_sink) {
+      return transformer.MakeLeaf(new_sink);
     }
-    dfaStoreState(new_sink);
-
-    if(DFAIsAcceptingState(right_dfa,i)) {
-      statuses[i+state_shift_amount] = '+';
-    } else {
-      statuses[i+state_shift_amount] = '-';
-    }
-    exceptions_right_auto.clear();
-
-		kill_paths(state_paths);
-		state_paths = pp = nullptr;
-	}
+    return transformer.MakeNode(number_of_bdd_variables, transformer.MakeLeaf(to_state + state_shift_amount),
+                                transformer.MakeLeaf(new_sink));
+  });
+  for (int i = 0; i < right_dfa->ns; i++) {
+    transformer.SetState(i + state_shift_amount, transformer.Transform(i),
+                         DFAIsAcceptingState(right_dfa, i) ? 1 : -1);
+  }
 
   // new sink
-  dfaAllocExceptions(0);
-  dfaStoreState(new_sink);
-  statuses[new_sink] = '-';
+  transformer.SetState(new_sink, transformer.MakeLeaf(new_sink), -1);
 
-  statuses[num_of_states]='\0';
-	DFA_ptr concat_dfa = dfaBuild(statuses);
+	DFA_ptr concat_dfa = transformer.Build(left_dfa->s);
 	DFA_ptr tmp_dfa = dfaMinimize(concat_dfa);
   dfaFree(concat_dfa);
   concat_dfa = dfaProject(tmp_dfa, (unsigned) number_of_bdd_variables);
   dfaFree(tmp_dfa); tmp_dfa = nullptr;
 
-	delete[] statuses; statuses = nullptr;
-
 	if (left_hand_side_accepts_emtpy_input) {
 		tmp_dfa = concat_dfa;
 		concat_dfa = DFAUnion(tmp_dfa,dfa2);
@@ -1651,10 +1735,10 @@ int* Automaton::GetBddVariableIndices(const int number_of_bdd_variables) {
   auto it = bdd_variable_indices.find(number_of_bdd_variables);
   if (it != bdd_variable_indices.end())
   {
-    return it->second;
+    return it->second.get();
   }
   int* indices = CreateBddVariableIndices(number_of_bdd_variables);
-  bdd_variable_indices[number_of_bdd_variables] = indices;
+  bdd_variable_indices[number_of_bdd_variables].reset(indices);
   return indices;
 }
 
@@ -1747,6 +1831,7 @@ void Automaton::Minimize() {
   DFA_ptr tmp = this->dfa_;
   this->dfa_ = dfaMinimize(tmp);
   dfaFree(tmp);
+  InvalidateTransitionGraph();
   DVLOG(VLOG_LEVEL) << this->id_ << " = [" << this->id_ << "]->minimize()";
 }
 
@@ -1754,6 +1839,7 @@ void Automaton::ProjectAway(unsigned index) {
   DFA_ptr tmp = this->dfa_;
   this->dfa_ = dfaProject(tmp, index);
   dfaFree(tmp);
+  InvalidateTransitionGraph();
 
   if (index < (unsigned)(this->num_of_bdd_variables_ - 1)) {
     int* indices_map = new int[this->num_of_bdd_variables_];
@@ -1773,13 +1859,8 @@ void Automaton::ProjectAway(unsigned index) {
 }
 
 bool Automaton::hasIncomingTransition(int state) {
-	LOG(FATAL) << "implement me!";
-//  for (int i = 0; i < this->dfa_->ns; i++) {
-//    if (hasNextState(i, state)) {
-//      return true;
-//    }
-//  }
-//  return false;
+  const auto& graph = GetTransitionGraph();
+  return graph.predecessor_offsets[state + 1] > graph.predecessor_offsets[state];
 }
 
 /**
@@ -1898,24 +1979,9 @@ int Automaton::getNextState(int state, std::vector<char>& exception) {
  * @return vector of states that are 1 walk away
  */
 std::set<int> Automaton::getNextStates(int state) {
-  unsigned p, l, r, index; // BDD traversal variables
-  std::set<int> next_states;
-  std::stack<unsigned> nodes;
-
-  p = this->dfa_->q[state];
-  nodes.push(p);
-  while (not nodes.empty()) {
-    p = nodes.top();
-    nodes.pop();
-    LOAD_lri(&this->dfa_->bddm->node_table[p], l, r, index);
-    if (index == BDD_LEAF_INDEX) {
-      next_states.insert(l);
-    } else {
-      nodes.push(l);
-      nodes.push(r);
-    }
-  }
-  return next_states;
+  const auto& graph = GetTransitionGraph();
+  return std::set<int>(graph.successors.begin() + graph.successor_offsets[state],
+                       graph.successors.begin() + graph.successor_offsets[state + 1]);
 }
 
 /**
@@ -1990,28 +2056,41 @@ std::set<int> Automaton::getStatesReachableBy(int walk) {
   return getStatesReachableBy(walk, walk);
 }
 
+/**
+ * Walks are followed one length at a time, the states at a length are kept as a set
+ */
 std::set<int> Automaton::getStatesReachableBy(int min_walk, int max_walk) {
   std::set<int> states;
-
-  std::stack<std::pair<int, int>> state_stack;
-  int sink_state = GetSinkState();
-  if (sink_state != this->dfa_->s) {
-    state_stack.push(std::make_pair(this->dfa_->s, 0));
+  const int sink_state = GetSinkState();
+  if (sink_state == this->dfa_->s) {
+    return states;
   }
-  while (not state_stack.empty()) {
-    auto current = state_stack.top(); state_stack.pop();
 
-    if (current.second >= min_walk and current.second <= max_walk) {
-      states.insert(current.first);
+  const auto& graph = GetTransitionGraph();
+  const int num_of_states = this->dfa_->ns;
+  std::vector<int> current_states { this->dfa_->s }, next_states;
+  std::vector<bool> is_next_state(num_of_states, false);
+  for (int walk = 0; walk <= max_walk and not current_states.empty(); ++walk) {
+    if (walk >= min_walk) {
+      states.insert(current_states.begin(), current_states.end());
     }
-
-    if (current.second < max_walk) {
-      for (auto next_state : getNextStates(current.first)) {
-        if (sink_state != next_state) {
-          state_stack.push(std::make_pair(next_state, current.second + 1));
+    if (walk == max_walk) {
+      break;
+    }
+    next_states.clear();
+    for (int state : current_states) {
+      for (int i = graph.successor_offsets[state]; i < graph.successor_offsets[state + 1]; ++i) {
+        const int next_state = graph.successors[i];
+        if (next_state != sink_state and not is_next_state[next_state]) {
+          is_next_state[next_state] = true;
+          next_states.push_back(next_state);
         }
       }
     }
+    for (int state : next_states) {
+      is_next_state[state] = false;
+    }
+    current_states.swap(next_states);
   }
   return states;
 }
@@ -2019,51 +2098,94 @@ std::set<int> Automaton::getStatesReachableBy(int min_walk, int max_walk) {
 void Automaton::SetSymbolicCounter() {
   std::vector<Eigen::Triplet<BigInteger>> entries;
   const int sink_state = GetSinkState();
-  unsigned left, right, index;
+  // BDD nodes are shared among states, path weights of a node are computed once
+  BddTransitionWeights transition_weights;
   for (int s = 0; s < this->dfa_->ns; ++s) {
     if (sink_state != s) {
-      // Node is a pair<sbdd_node_id, bdd_depth>
-      Node current_bdd_node {dfa_->q[s], 0}, left_node, right_node;
-      std::stack<Node> bdd_node_stack;
-      bdd_node_stack.push(current_bdd_node);
-      while (not bdd_node_stack.empty()) {
-        current_bdd_node = bdd_node_stack.top(); bdd_node_stack.pop();
-        LOAD_lri(&dfa_->bddm->node_table[current_bdd_node.first], left, right, index);
-        if (index == BDD_LEAF_INDEX) {
-          if (sink_state != left) {
-            const int exponent = num_of_bdd_variables_ - current_bdd_node.second;
-            if (exponent == 0) {
-              entries.push_back(Eigen::Triplet<BigInteger>(s, left, 1));
-            } else if (exponent < 31) {
-              entries.push_back(Eigen::Triplet<BigInteger>(s, left, static_cast<int>(std::pow(2, exponent))));
-            } else {
-              entries.push_back(Eigen::Triplet<BigInteger>(s, left, boost::multiprecision::pow(boost::multiprecision::cpp_int(2), exponent)));
-            }
-          }
+      for (auto& target_weight : GetBddTransitionWeights(dfa_->q[s], sink_state, transition_weights)) {
+        entries.push_back(Eigen::Triplet<BigInteger>(s, target_weight.first, target_weight.second));
+      }
+
+      // combine all accepting states into one artifical accepting state
+      if (IsAcceptingState(s)) {
+        entries.push_back(Eigen::Triplet<BigInteger>(s, this->dfa_->ns, 1));
+      }
+    }
+  }
+  Eigen::SparseMatrix<BigInteger> count_matrix (this->dfa_->ns + 1, this->dfa_->ns + 1);
+  count_matrix.setFromTriplets(entries.begin(), entries.end());
+  decide_counting_schema(count_matrix);
+  count_matrix.makeCompressed();
+  count_matrix.finalize();
+  counter_.set_transition_count_matrix(count_matrix);
+  counter_.set_initialization_vector(count_matrix.innerVector(count_matrix.cols()-1));
+  is_counter_cached_ = true;
+}
+
+/**
+ * Computes, for the bdd rooted at the given node, the number of full variable assignments leading to each non-sink
+ * target state. A leaf contributes 2^n (n = number of bdd variables) for its target and an internal node halves the
+ * merged weights of its children, which gives 2^(n - depth) for each path without tracking depths. Results are
+ * memoized per bdd node in the given cache so that subgraphs shared between states are traversed only once.
+ * @param root bdd node id
+ * @param sink_state
+ * @param transition_weights cache of weights computed so far, keyed by bdd node id
+ * @return weights sorted by target state
+ */
+const Automaton::TargetWeights& Automaton::GetBddTransitionWeights(unsigned root, int sink_state,
+                                                                   BddTransitionWeights& transition_weights) {
+  auto it = transition_weights.find(root);
+  if (it != transition_weights.end()) {
+    return it->second;
+  }
+
+  const BigInteger leaf_weight = boost::multiprecision::pow(BigInteger(2), num_of_bdd_variables_);
+  unsigned left, right, index;
+  // Node is a pair<sbdd_node_id, is_expanded>
+  std::stack<Node> bdd_node_stack;
+  bdd_node_stack.push(std::make_pair(root, 0));
+  while (not bdd_node_stack.empty()) {
+    Node& current_bdd_node = bdd_node_stack.top();
+    const unsigned node_id = current_bdd_node.first;
+    if (transition_weights.find(node_id) != transition_weights.end()) {
+      bdd_node_stack.pop();
+      continue;
+    }
+    LOAD_lri(&dfa_->bddm->node_table[node_id], left, right, index);
+    if (index == BDD_LEAF_INDEX) {
+      TargetWeights& weights = transition_weights[node_id];
+      if (sink_state != static_cast<int>(left)) {
+        weights.push_back(std::make_pair(static_cast<int>(left), leaf_weight));
+      }
+      bdd_node_stack.pop();
+    } else if (current_bdd_node.second == 0) {
+      current_bdd_node.second = 1;
+      // push after updating the top, pushing may invalidate the reference
+      bdd_node_stack.push(std::make_pair(left, 0));
+      bdd_node_stack.push(std::make_pair(right, 0));
+    } else {
+      bdd_node_stack.pop();
+      const TargetWeights& left_weights = transition_weights[left];
+      const TargetWeights& right_weights = transition_weights[right];
+      TargetWeights weights;
+      weights.reserve(left_weights.size() + right_weights.size());
+      auto l = left_weights.begin(), r = right_weights.begin();
+      while (l != left_weights.end() or r != right_weights.end()) {
+        if (r == right_weights.end() or (l != left_weights.end() and l->first < r->first)) {
+          weights.push_back(std::make_pair(l->first, l->second >> 1));
+          ++l;
+        } else if (l == left_weights.end() or r->first < l->first) {
+          weights.push_back(std::make_pair(r->first, r->second >> 1));
+          ++r;
         } else {
-          left_node.first = left;
-          left_node.second = current_bdd_node.second + 1;
-          right_node.first = right;
-          right_node.second = current_bdd_node.second + 1;
-          bdd_node_stack.push(left_node);
-          bdd_node_stack.push(right_node);
+          weights.push_back(std::make_pair(l->first, (l->second + r->second) >> 1));
+          ++l; ++r;
         }
       }
-
-      // combine all accepting states into one artifical accepting state
-      if (IsAcceptingState(s)) {
-        entries.push_back(Eigen::Triplet<BigInteger>(s, this->dfa_->ns, 1));
-      }
+      transition_weights[node_id] = std::move(weights);
     }
   }
-  Eigen::SparseMatrix<BigInteger> count_matrix (this->dfa_->ns + 1, this->dfa_->ns + 1);
-  count_matrix.setFromTriplets(entries.begin(), entries.end());
-  decide_counting_schema(count_matrix);
-  count_matrix.makeCompressed();
-  count_matrix.finalize();
-  counter_.set_transition_count_matrix(count_matrix);
-  counter_.set_initialization_vector(count_matrix.innerVector(count_matrix.cols()-1));
-  is_counter_cached_ = true;
+  return transition_weights[root];
 }
 
 /**
@@ -2745,6 +2867,117 @@ DFA_ptr Automaton::importDFA(std::string file_name) {
   return dfaImport(&*file_name.begin(), &names, orders);
 }
 
+void Automaton::GetDFAImage(DFAImage& image) const {
+  std::lock_guard<std::recursive_mutex> lock(GetMonaMutex());
+  CHECK(dfa_ != nullptr);
+  image.num_of_states = dfa_->ns;
+  image.initial_state = dfa_->s;
+  image.finals.assign(dfa_->f, dfa_->f + dfa_->ns);
+  image.roots.clear();
+  image.nodes.clear();
+
+  unsigned l, r, index; // BDD traversal variables
+  std::unordered_map<unsigned, std::uint32_t> node_ids;
+  // a node is numbered after its children, second is true once the children are pushed
+  std::stack<std::pair<unsigned, bool>> nodes;
+  for (int s = 0; s < dfa_->ns; ++s) {
+    nodes.push(std::make_pair(dfa_->q[s], false));
+    while (not nodes.empty()) {
+      auto current = nodes.top();
+      nodes.pop();
+      if (node_ids.find(current.first) != node_ids.end()) {
+        continue;
+      }
+      LOAD_lri(&dfa_->bddm->node_table[current.first], l, r, index);
+      if (index == BDD_LEAF_INDEX) {
+        node_ids[current.first] = image.nodes.size() / 3;
+        image.nodes.insert(image.nodes.end(), { index, l, 0 });
+      } else if (current.second) {
+        node_ids[current.first] = image.nodes.size() / 3;
+        image.nodes.insert(image.nodes.end(), { index, node_ids[l], node_ids[r] });
+      } else {
+        nodes.push(std::make_pair(current.first, true));
+        nodes.push(std::make_pair(l, false));
+        nodes.push(std::make_pair(r, false));
+      }
+    }
+    image.roots.push_back(node_ids[dfa_->q[s]]);
+  }
+}
+
+void Automaton::SetDFAImage(const DFAImage& image) {
+  std::lock_guard<std::recursive_mutex> lock(GetMonaMutex());
+  const std::size_t num_of_states = image.num_of_states;
+  const std::size_t num_of_nodes = image.nodes.size() / 3;
+  CHECK(num_of_states > 0 and image.finals.size() == num_of_states and image.roots.size() == num_of_states)
+      << "invalid dfa image";
+  CHECK(image.initial_state >= 0 and (std::size_t) image.initial_state < num_of_states) << "invalid dfa image";
+  CHECK_EQ(0, image.nodes.size() % 3) << "invalid dfa image";
+
+  DFA_ptr dfa = dfaMake(num_of_states);
+  bdd_manager* bddm = dfa->bddm;
+  // bdd nodes may move as the node table grows, nodes are kept as root handles
+  std::vector<unsigned> handles(num_of_nodes);
+  for (std::size_t i = 0; i < num_of_nodes; ++i) {
+    const std::uint32_t index = image.nodes[3 * i];
+    const std::uint32_t low = image.nodes[3 * i + 1];
+    const std::uint32_t high = image.nodes[3 * i + 2];
+    if (index == BDD_LEAF_INDEX) {
+      CHECK_LT(low, num_of_states) << "invalid dfa image";
+      bdd_find_leaf_hashed_add_root(bddm, low);
+    } else {
+      CHECK(low < i and high < i and low != high) << "invalid dfa image";
+      // variables are ordered on every path, leaves have the largest index
+      CHECK(index < image.nodes[3 * low] and index < image.nodes[3 * high]) << "invalid dfa image";
+      bdd_find_node_hashed_add_root(bddm, BDD_ROOT(bddm, handles[low]), BDD_ROOT(bddm, handles[high]), index);
+    }
+    handles[i] = BDD_LAST_HANDLE(bddm);
+  }
+  for (std::size_t s = 0; s < num_of_states; ++s) {
+    CHECK_LT(image.roots[s], num_of_nodes) << "invalid dfa image";
+    dfa->q[s] = BDD_ROOT(bddm, handles[image.roots[s]]);
+    dfa->f[s] = image.finals[s];
+  }
+  dfa->s = image.initial_state;
+
+  if (dfa_ != nullptr) {
+    dfaFree(dfa_);
+  }
+  dfa_ = dfa;
+  InvalidateTransitionGraph();
+}
+
+void Automaton::ReadMappedFile(const std::string& file_name, std::function<void(std::istream&)> reader) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd == -1) {
+    LOG(FATAL)<< "cannot open file: " << file_name;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1 or file_stat.st_size == 0) {
+    close(fd);
+    LOG(FATAL)<< "cannot read file: " << file_name;
+  }
+  const std::size_t size = file_stat.st_size;
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(FATAL)<< "cannot map file: " << file_name;
+  }
+
+  // unmaps the file also when the reader throws, e.g. on a truncated file
+  struct Mapping {
+    void* data;
+    std::size_t size;
+    ~Mapping() {
+      munmap(data, size);
+    }
+  } mapping { data, size };
+
+  Util::MemoryInputBuffer buffer(static_cast<const char*>(mapping.data), mapping.size);
+  std::istream in(&buffer);
+  reader(in);
+}
+
 int Automaton::inspectAuto(bool print_sink, bool force_mona_format) {
   std::stringstream file_name;
   file_name << "./output/inspect_auto_" << name_counter++ << ".dot";
@@ -3448,25 +3681,21 @@ void Automaton::getLowerUpperCaseCharsPrePost(char* transitions, int var, char**
 	*pSize = indexInResult;
 }
 
+/**
+ * Characters are the first 8 bits of a symbol, the case of a letter is its bit 2. Transitions are
+ * read symbol by symbol from the bdds, the extra bit is 0 for the symbols that are kept and 1 for
+ * the converted ones.
+ */
 DFA* Automaton::dfaPrePostToLowerUpperCaseHelper(DFA* M, int var, int* oldIndices, boolean lowerCase, boolean preImage){
+	CHECK_GE(var, 8) << "case conversion needs 8 bit characters";
 	DFA *result;
-	paths state_paths, pp;
-	trace_descr tp;
-	int i, j, n, k;
-	char *exeps;
-	int *to_states;
 	int sink;
-	long max_exeps;
-	char *statuces;
 	int len;
 	int ns = M->ns;
 
 	bool has_sink = true;
 
 	len = var + 1;
-	int* indices = allocateArbitraryIndex(len);
-
-	max_exeps = 1 << len; //maybe exponential
 
 	sink = find_sink(M);
 	if(sink < 0) {
@@ -3475,86 +3704,56 @@ DFA* Automaton::dfaPrePostToLowerUpperCaseHelper(DFA* M, int var, int* oldIndice
 		ns++;
 	}
 
-	char* symbol = (char *) malloc((len + 1) * sizeof(char));//len+1 since we need extra bit
-	exeps = (char *) malloc(max_exeps * (len + 1) * sizeof(char));
-	to_states = (int *) malloc(max_exeps * sizeof(int));
-	statuces = (char *) malloc((ns + 1) * sizeof(char));
-	int numOfChars = 1 << len;
-	char** charachters = (char**) malloc(numOfChars * (sizeof (char*)));
-	int size = 0;
-
-
-	dfaSetup(ns, len, indices);
-	for (i = 0; i < M->ns; i++) {
-		state_paths = pp = make_paths(M->bddm, M->q[i]);
-		k = 0;
-		while (pp) {
-			if (pp->to != sink) {
-				for (j = 0; j < var; j++) {
-					//the following for loop can be avoided if the indices are in order
-					for (tp = pp->trace; tp && (tp->index != indices[j]); tp
-							= tp->next)
-						;
-					if (tp) {
-						if (tp->value)
-							symbol[j] = '1';
-						else
-							symbol[j] = '0';
-					} else
-						symbol[j] = 'X';
-				}
-				symbol[var] = '\0';
-				// convert symbol into a list of chars where we replace each capital letter with small letter
-				getLowerUpperCaseCharsPrePost(symbol, var, charachters, &size, lowerCase, preImage);
-				for (n = 0; n < size; n++)
-				{
-//						printf("%s, ", charachters[n]);
-					to_states[k] = pp->to;
-					for (j = 0; j < len; j++)
-						exeps[k * (len + 1) + j] = charachters[n][j];
-					exeps[k * (len + 1) + len] = '\0';
-					free(charachters[n]);
-					k++;
-				}
-//					printf("\n");
+	std::vector<int> symbol_indices(var), indices(len);
+	for (int j = 0; j < len; j++) {
+		indices[j] = j;
+		if (j < var) {
+			symbol_indices[j] = j;
+		}
+	}
+	const unsigned long num_of_symbols = 1UL << var;
+	const unsigned long case_bit = 1UL << (var - 3);
+	const unsigned long first_letter = lowerCase ? 'A' : 'a';
+	const unsigned long last_letter = lowerCase ? 'Z' : 'z';
+
+	DFATransformer transformer(ns);
+	transformer.SetSource(M);
+	const DFATransformer::Node sink_leaf = transformer.MakeLeaf(sink);
+	// symbol s with extra bit b is at 2s + b
+	std::vector<DFATransformer::Node> targets(2 * num_of_symbols);
+	for (int i = 0; i < M->ns; i++) {
+		std::fill(targets.begin(), targets.end(), sink_leaf);
+		for (unsigned long symbol = 0; symbol < num_of_symbols; symbol++) {
+			const int to_state = transformer.GetNextState(i, symbol_indices, symbol);
+			if (to_state == sink) {
+				continue;
+			}
+			const DFATransformer::Node to_leaf = transformer.MakeLeaf(to_state);
+			const unsigned long character = symbol >> (var - 8);
+			if (character < first_letter or character > last_letter) {
+				targets[2 * symbol] = to_leaf;
+				continue;
+			}
+			// extrabit should be 1 since we may already have same small letter originally with 0
+			targets[2 * (symbol ^ case_bit) + 1] = to_leaf;
+			if (preImage) {
+				targets[2 * symbol + 1] = to_leaf;
 			}
-			pp = pp->next;
 		}
-		kill_paths(state_paths);
-
-		// if accept state create a self loop on lambda
-		dfaAllocExceptions(k);
-		for (k--; k >= 0; k--)
-			dfaStoreException(to_states[k], exeps + k * (len + 1));
-		dfaStoreState(sink);
-
-		if (M->f[i] == 1)
-			statuces[i] = '+';
-		else
-			statuces[i] = '-';
+		transformer.SetState(i, transformer.MakeTable(indices, targets), (M->f[i] == 1) ? 1 : -1);
 	}
 
 	// create artificial sink if original dfa did not have one
 	if(not has_sink) {
-		dfaAllocExceptions(0);
-		dfaStoreState(sink);
-		statuces[sink] = '-';
+		transformer.SetState(sink, sink_leaf, -1);
 	}
 
-	statuces[ns] = '\0';
-	DFA* tmpM = dfaBuild(statuces);
+	DFA* tmpM = transformer.Build(M->s);
 	result = dfaProject(tmpM, ((unsigned)var));
 	dfaFree(tmpM);
 	tmpM = dfaMinimize(result);
 	dfaFree(result);result = NULL;
 
-	free(exeps);
-	free(symbol);
-	free(to_states);
-	free(statuces);
-	free(indices);
-	free(charachters);
-
 	return tmpM;
 }
 
@@ -3581,10 +3780,6 @@ DFA* Automaton::dfaPreToUpperCase(DFA* M, int var, int* indices){
 
 DFA_ptr Automaton::DFAExtendExtrabit(DFA_ptr M, int var) {
 	DFA_ptr result_dfa = nullptr,temp_dfa = nullptr;
-	trace_descr tp;
-	paths state_paths, pp;
-	std::vector<std::pair<std::vector<char>,int>> state_exeps;
-	int nvar = var+1;
 	int sink = find_sink(M);
 	int num_states = M->ns;
 
@@ -3596,61 +3791,28 @@ DFA_ptr Automaton::DFAExtendExtrabit(DFA_ptr M, int var) {
 		has_sink = false;
 	}
 
-	int *indices = GetBddVariableIndices(nvar);
-	char* statuses = new char[num_states+1];
-
-	dfaSetup(num_states,nvar,indices);
-
-	for(int i = 0; i < M->ns; i++) {
-		state_paths = pp = make_paths(M->bddm, M->q[i]);
-		while(pp) {
-			if(pp->to != sink) {
-				std::vector<char> curr(nvar,'X');
-				for(unsigned j = 0; j < var; j++) {
-					for(tp = pp->trace; tp && (tp->index != indices[j]); tp = tp->next);
-					if(tp) {
-						if(tp->value) curr[j] = '1';
-						else curr[j] = '0';
-					}
-					else
-						curr[j] = 'X';
-				}
-				// add new bit, set to 0
-				curr[var] = '0';
-				//curr[var+1] = '0';
-				curr.push_back('\0');
-				state_exeps.push_back(std::make_pair(curr,pp->to));
-			}
-			pp = pp->next;
-		}
-		kill_paths(state_paths);
-
-		dfaAllocExceptions(state_exeps.size());
-		for(unsigned k = 0; k < state_exeps.size(); ++k) {
-			dfaStoreException(state_exeps[k].second,&state_exeps[k].first[0]);
+	// add new bit, set to 0
+	DFATransformer transformer(num_states);
+	transformer.SetSource(M);
+	transformer.SetLeafMap([&](const int to_state) {
+		if(to_state == sink) {
+			return transformer.MakeLeaf(sink);
 		}
-		dfaStoreState(sink);
-		state_exeps.clear();
+		return transformer.MakeNode(var, transformer.MakeLeaf(to_state), transformer.MakeLeaf(sink));
+	});
 
-		if(M->f[i] == 1) {
-			statuses[i] = '+';
-		} else {
-			statuses[i] = '-';
-		}
+	for(int i = 0; i < M->ns; i++) {
+		transformer.SetState(i, transformer.Transform(i), (M->f[i] == 1) ? 1 : -1);
 	}
 
 	// if necessary, create new sink state
 	if(not has_sink) {
-		dfaAllocExceptions(0);
-		dfaStoreState(sink);
-		statuses[sink] = '-';
+		transformer.SetState(sink, transformer.MakeLeaf(sink), -1);
 	}
 
-	statuses[num_states] = '\0';
-	temp_dfa = dfaBuild(statuses);
+	temp_dfa = transformer.Build(M->s);
 	result_dfa = dfaMinimize(temp_dfa);
 	dfaFree(temp_dfa);
-	delete[] statuses;
 	return result_dfa;
 }
 
@@ -3979,6 +4141,7 @@ DFA_ptr Automaton::dfa_star_M_star(DFA *M, int var, int *indices) {
 }
 
 DFA_ptr Automaton::dfa_general_replace_extrabit(DFA* M1, DFA* M2, DFA* M3, int var, int* indices){
+  Util::Profiler::ScopedOperation operation("replace");
 	DFA_ptr result;
 	DFA_ptr M1_bar;
 	DFA_ptr M2_bar;
@@ -4170,6 +4333,8 @@ DFA_ptr Automaton::dfa_replace_step1_duplicate(DFA *M, int var, int *indices) {
 	free(to_states);
 	//printf("FREE STATUCES\n");
 	free(statuces);
+	free(sharp1);
+	free(sharp0);
 	//dfaFree(tmpM);
 		result = dfaMinimize(temp);
 		dfaFree(temp);
@@ -4378,6 +4543,8 @@ DFA_ptr Automaton::dfa_replace_step2_match_compliment(DFA *M, int var, int *indi
 	free(to_states);
 	//printf("FREE STATUCES\n");
 	free(statuces);
+	free(sharp1);
+	free(sharp0);
 	dfaFree(M_neg);
 	dfaFree(M_tneg);
 	//dfaFree(M_e);
@@ -4401,7 +4568,9 @@ DFA_ptr Automaton::dfa_replace_step3_general_replace(DFA *M, DFA* Mr, int var, i
   }
 
 
-  tmp = DFAIntersect(Mr, dfaDot(var, indices));
+  DFA_ptr dot_dfa = dfaDot(var, indices);
+  tmp = DFAIntersect(Mr, dot_dfa);
+  dfaFree(dot_dfa);
   if(!check_emptiness(tmp, var, indices)){
     result1 = dfa_replace_M_dot(M, tmp, var, indices);
     if(result){
@@ -4442,7 +4611,7 @@ DFA_ptr Automaton::dfa_replace_delete(DFA *M, int var, int *oldindices)
   DFA *tmpM2 = NULL;
   DFA *tmpM1 = NULL;
   int aux=0;
-  struct int_list_type **pairs=NULL;
+  MatchClosures pairs;
   int maxCount;
 
   paths state_paths, pp;
@@ -4456,12 +4625,9 @@ DFA_ptr Automaton::dfa_replace_delete(DFA *M, int var, int *oldindices)
   int sink;
   int *indices=oldindices;
   char *auxbit=NULL;
-  struct int_type *tmp=NULL;
 
-  //printf("Start get match exclude\n");
-  pairs = get_match_exclude_self(M, var, indices); //for deletion, exclude self state from the closure
-  //printf("End get match exclude\n");
-  maxCount = get_maxcount(pairs, M->ns);
+  pairs = get_match(M, var, indices);
+  maxCount = get_maxcount(pairs);
   if(maxCount>0){ //Need auxiliary bits when there exist some outgoing edges
     //printf("Deletion [insert auxiliary bits]!\n");
     aux = get_hsig(maxCount);
@@ -4484,7 +4650,7 @@ DFA_ptr Automaton::dfa_replace_delete(DFA *M, int var, int *oldindices)
   //pairs[i] is the list of all reachable states by \sharp1 \bar \sharp0 from i
 
 
-  dfaSetup(M->ns, len, indices);
+  dfaSetup(ns, len, indices);
   exeps=(char *)malloc(max_exeps*(len+1)*sizeof(char)); //plus 1 for \0 end of the string
   to_states=(int *)malloc(max_exeps*sizeof(int));
   statuces=(char *)malloc((ns+1)*sizeof(char));
@@ -4516,10 +4682,10 @@ DFA_ptr Automaton::dfa_replace_delete(DFA *M, int var, int *oldindices)
 	  }
 	  exeps[k*(len+1)+len]='\0';
 	  k++;
-	  if(pairs[pp->to]!=NULL && pairs[pp->to]->count>0){ //need to add extra edges to states in reachable closure
+	  if(pairs.counts[pp->to]>0){ //need to add extra edges to states in reachable closure
 	    o=k-1; //the original path
-	    for(z=0, tmp=pairs[pp->to]->head;z<pairs[pp->to]->count; z++, tmp = tmp->next){
-	      to_states[k]=tmp->value;
+	    for(z=0; z<pairs.counts[pp->to]; z++){
+	      to_states[k]=pairs.states[pairs.offsets[pp->to]+z];
 	      for (j = 0; j < var; j++) exeps[k*(len+1)+j]=exeps[o*(len+1)+j];
 	      set_bitvalue(auxbit, aux, z+1); // aux = 3, z=4, auxbit 001
 	      for (j = var; j < len; j++) { //set to xxxxxxxx100
@@ -4571,11 +4737,11 @@ DFA_ptr Automaton::dfa_replace_delete(DFA *M, int var, int *oldindices)
   //printf("FREE STATUCES\n");
   free(statuces);
 
-  if(maxCount>0) free(auxbit);
+  if(maxCount>0){
+    free(auxbit);
+    free(indices);
+  }
 
-  for(i=0; i<M->ns; i++)
-    free_ilt(pairs[i]);
-  free(pairs);
   result = dfaMinimize(tmpM2);	//MUST BE CAREFUL FOR INDICES..INDICES MAY NOT MATCH!!
     dfaFree(tmpM2);
     return result;
@@ -4589,7 +4755,7 @@ DFA * Automaton::dfa_replace_M_dot(DFA *M, DFA* Mr, int var, int *oldindices)
   DFA *result = NULL;
   DFA *tmpM = NULL;
   int aux=0;
-  struct int_list_type **pairs=NULL;
+  MatchClosures pairs;
   int maxCount = 0;
 
   paths state_paths, pp;
@@ -4603,7 +4769,6 @@ DFA * Automaton::dfa_replace_M_dot(DFA *M, DFA* Mr, int var, int *oldindices)
   int sink;
   int *indices=oldindices;
   char *auxbit=NULL;
-  struct int_type *tmp=NULL;
 
   //Get from Mr
   int nc;
@@ -4612,7 +4777,7 @@ DFA * Automaton::dfa_replace_M_dot(DFA *M, DFA* Mr, int var, int *oldindices)
   set_accepted_chars(Mr, apath, numchars, var, indices);
 
   pairs = get_match(M, var, indices);
-  maxCount = get_maxcount(pairs, M->ns);
+  maxCount = get_maxcount(pairs);
 
   if(maxCount>0){ //Need auxiliary bits when there exist some outgoing edges
     aux = get_hsig(maxCount);
@@ -4678,12 +4843,12 @@ DFA * Automaton::dfa_replace_M_dot(DFA *M, DFA* Mr, int var, int *oldindices)
       pp = pp->next;
     }//end while
 
-    if(pairs[i]!=NULL && pairs[i]->count>0){ //need to add extra edges to states in reachable closure
+    if(pairs.counts[i]>0){ //need to add extra edges to states in reachable closure
 
-      for(z=0, tmp=pairs[i]->head;z< pairs[i]->count; z++, tmp = tmp->next){
+      for(z=0; z< pairs.counts[i]; z++){
 	set_bitvalue(auxbit, aux, z+1); // aux = 3, z=4, auxbit 001
 	for(nc = 0; nc<numchars; nc++){
-	  to_states[k]=tmp->value;
+	  to_states[k]=pairs.states[pairs.offsets[i]+z];
 	  for (j = 0; j < var; j++) exeps[k*(len+1)+j]=apath[nc][j];
 	  for (j = var; j < len; j++) { //set to xxxxxxxx100
 	    exeps[k*(len+1)+j]=auxbit[len-j-1];
@@ -4722,7 +4887,9 @@ DFA * Automaton::dfa_replace_M_dot(DFA *M, DFA* Mr, int var, int *oldindices)
   for(i=0; i<aux; i++){
     j=len-i;
     tmpM =dfaProject(result, (unsigned) j);
+    dfaFree(result);
     result = dfaMinimize(tmpM);
+    dfaFree(tmpM);
   }
   free(exeps);
   //printf("FREE ToState\n");
@@ -4738,11 +4905,9 @@ DFA * Automaton::dfa_replace_M_dot(DFA *M, DFA* Mr, int var, int *oldindices)
     free(indices);
   }
 
-  for(i=0; i<M->ns; i++)
-    free_ilt(pairs[i]);
-  free(pairs);
-
-  return dfaMinimize(result);
+  tmpM = dfaMinimize(result);
+  dfaFree(result);
+  return tmpM;
 
 }// End dfa_replace_M_dot
 
@@ -4753,7 +4918,7 @@ DFA_ptr Automaton::dfa_replace_M_arbitrary(DFA *M, DFA *Mr, int var, int *oldind
   DFA *result = NULL;
   DFA *tmpM = NULL;
   int aux=0;
-  struct int_list_type **pairs=NULL;
+  MatchClosures pairs;
   int maxCount, numberOfSharp;
 
 
@@ -4771,7 +4936,6 @@ DFA_ptr Automaton::dfa_replace_M_arbitrary(DFA *M, DFA *Mr, int var, int *oldind
   int ns, sink;
   int *indices=oldindices;
   char *auxbit=NULL;
-  struct int_type *tmp=NULL;
 
   int extrastates = Mr->ns; //duplicate states for each sharp pair
 
@@ -4787,8 +4951,8 @@ DFA_ptr Automaton::dfa_replace_M_arbitrary(DFA *M, DFA *Mr, int var, int *oldind
 
   pairs = get_match(M, var, indices);
 
-  maxCount = get_maxcount(pairs, M->ns);
-  numberOfSharp = get_number_of_sharp1_state(pairs, M->ns);
+  maxCount = get_maxcount(pairs);
+  numberOfSharp = get_number_of_sharp1_state(pairs);
 
 
   if(maxCount>0){ //Need auxiliary bits when there exist some outgoing edges
@@ -4862,7 +5026,7 @@ DFA_ptr Automaton::dfa_replace_M_arbitrary(DFA *M, DFA *Mr, int var, int *oldind
       pp = pp->next;
     }//end while
 
-    if(pairs[i]!=NULL && pairs[i]->count>0){ //need to add extra edges to states in reachable closure
+    if(pairs.counts[i]>0){ //need to add extra edges to states in reachable closure
       startStates[s]=i; //pairs[startStates[s]] is the destination that later we shall use for region s
       for(o=0; o<numOfOut[Mr->s]; o++){
 	to_states[k]=M->ns+s*(extrastates)+toOfOut[Mr->s][o]; // go to the next state of intial state of  Mr
@@ -4896,8 +5060,8 @@ DFA_ptr Automaton::dfa_replace_M_arbitrary(DFA *M, DFA *Mr, int var, int *oldind
 
   //Add replace states
   for(n=0;n<numberOfSharp; n++){
-    assert((pairs[startStates[n]]!=NULL) && (pairs[startStates[n]]->count > 0));
-    numsharp2 = pairs[startStates[n]]->count;
+    assert(pairs.counts[startStates[n]] > 0);
+    numsharp2 = pairs.counts[startStates[n]];
     for(i=0; i<Mr->ns; i++){ //internal M (exclude the first and the last char)
       if(numOfOutFinal[i]==0){
 	dfaAllocExceptions(numOfOut[i]);
@@ -4910,8 +5074,8 @@ DFA_ptr Automaton::dfa_replace_M_arbitrary(DFA *M, DFA *Mr, int var, int *oldind
 	for(o =0; o<numOfOut[i]; o++){
 	  dfaStoreException(M->ns+n*(extrastates)+toOfOut[i][o], binOfOut[i][o]);
 	  if(Mr->f[toOfOut[i][o]]==1){ //add auxiliary back edges
-	    for(z=0, tmp=pairs[startStates[n]]->head;z< numsharp2; z++, tmp = tmp->next){
-	      aux_to_states[z]=tmp->value;
+	    for(z=0; z< numsharp2; z++){
+	      aux_to_states[z]=pairs.states[pairs.offsets[startStates[n]]+z];
 	      for (j = 0; j < var; j++) auxexeps[z*(len+1)+j]=binOfOut[i][o][j];
 	      set_bitvalue(auxbit, aux, z+1); // aux = 3, z=4, auxbit 001
 	      for (j = var; j < len; j++) { //set to xxxxxxxx100
@@ -4943,11 +5107,14 @@ DFA_ptr Automaton::dfa_replace_M_arbitrary(DFA *M, DFA *Mr, int var, int *oldind
   for(i=0; i<aux; i++){
     j=len-i;
 
-    tmpM =dfaProject(dfaMinimize(result), (unsigned) j);
-
+    tmpM = dfaMinimize(result);
     dfaFree(result);
-    result = dfaMinimize(tmpM);
+    result = dfaProject(tmpM, (unsigned) j);
     dfaFree(tmpM);
+
+    tmpM = dfaMinimize(result);
+    dfaFree(result);
+    result = tmpM;
   }
   free(exeps);
   //printf("FREE ToState\n");
@@ -4965,9 +5132,6 @@ DFA_ptr Automaton::dfa_replace_M_arbitrary(DFA *M, DFA *Mr, int var, int *oldind
     free(startStates);
   }
 
-  for(i=0; i<M->ns; i++)
-    free_ilt(pairs[i]);
-
   for(i=0; i<Mr->ns; i++){
     free(binOfOut[i]);
     free(toOfOut[i]);
@@ -4980,243 +5144,19 @@ DFA_ptr Automaton::dfa_replace_M_arbitrary(DFA *M, DFA *Mr, int var, int *oldind
   free(numOfOut);
   free(numOfOutFinal);
 
-  free(pairs);
-
-  return dfaMinimize(result);
-
-}
-
-struct int_list_type **Automaton::get_match_exclude_self(DFA *M, int var, int *indices) {
-	int i, next;
-	struct int_list_type **result;
-	result = (struct int_list_type **) malloc((M->ns)
-			* sizeof(struct int_list_type *));
-	for (i = 0; i < M->ns; i++) {
-		//printf("Start exist sharp1\n");
-		next = exist_sharp1_path(M, i, var);
-		//printf("End exist sharp1: state[%d]\n", next);
-		if (next > -1) //result[i]= remove_value(reachable_closure(M, next, var, indices), i);
-			result[i] = reachable_closure(M, next, var, indices);
-		else
-			result[i] = new_ilt();
-	}
-	return result;
-}
-
-int Automaton::exist_sharp1_path(DFA *M, int start, int var) {
-	paths state_paths, pp;
-	trace_descr tp;
-	int j, sink;
-	int finalflag = 1;
-	int *indices = allocateAscIIIndexWithExtraBit(var);
-	char *sharp1 = getSharp1WithExtraBit(var);
-	//printf("Get Sharp1 %s\n", sharp1);
-	sink = find_sink(M);
-	//assert(sink>-1);
-	//printf("Find sink in sharp1: %d\n", sink);
-	//assert(start < M->ns);
-
-	if (start == sink){
-        free(indices);
-        free(sharp1);
-		return -1;
-    }
-	else {
-		state_paths = pp = make_paths(M->bddm, M->q[start]);
-
-		while (pp) {
-			if (pp->to != sink) {
-				//find the path that may contain 111111111
-				for (j = 0; j < var + 1; j++) {
-					//the following for loop can be avoided if the indices are in order
-					for (tp = pp->trace; tp && (tp->index != j); tp = tp->next)
-						;
-					if (tp) {
-						if (tp->value) {
-							//printf("TP value true\n");
-							if (sharp1[j] == '0')
-								finalflag = 0;
-						} else {
-							if (sharp1[j] == '1')
-								finalflag = 0;
-						}
-					}
-				}
-				if (finalflag != 0) {
-					free(indices);
-                    free(sharp1);
-                    int toState = pp->to;
-                    kill_paths(state_paths);
-					return toState;
-				}
-			}
-			pp = pp->next;
-			finalflag = 1;
-		}
-        kill_paths(state_paths);
-	}
-	free(indices);
-    free(sharp1);
-	return -1;
-}
-
-//set less significant bit less priority
-//the extra bit has the less priority
-int* Automaton::allocateAscIIIndexWithExtraBit(int length) {
-	int i;
-	int* indices;
-	indices = (int *) malloc((length + 1) * sizeof(int));
-	for (i = 0; i <= length; i++)
-		indices[i] = i;
-	return indices;
-}
-
-//reachable states from \bar* sharp0;
-struct int_list_type * Automaton::reachable_closure(DFA *M, int start, int var,
-		int *indices) {
-
-	paths state_paths, pp;
-	trace_descr tp;
-	int j, sink, current;
-	struct int_list_type *worklist = NULL;
-	struct int_list_type *finallist = NULL;
-	int finalflag = 1;
-	char *sharp0 = getSharp0WithExtraBit(var);
-	int *visited = (int *) malloc(M->ns * sizeof(int));
-	for (j = 0; j < M->ns; j++)
-		visited[j] = 0;
-
-	sink = find_sink(M);
-	//assert(sink>-1);
-
-	worklist = enqueue(worklist, start);
-
-	while (worklist->count > 0) {
-		current = dequeue(worklist);
-		visited[current] = 1;
-		//assert(current!=-1);
-		state_paths = pp = make_paths(M->bddm, M->q[current]);
-		while (pp) {
-			if (pp->to != sink) {
-				//find the path that may contain 111111101
-				for (j = 0; j < var + 1; j++) {
-					//the following for loop can be avoided if the indices are in order
-					for (tp = pp->trace; tp && (tp->index != j); tp = tp->next)
-						;
-
-					if (tp) {
-						if (tp->value) {
-							if (sharp0[j] == '0')
-								finalflag = 0;
-						} else {
-							if (sharp0[j] == '1')
-								finalflag = 0;
-						}
-					}
-				}
-				if (finalflag != 0)
-					finallist = enqueue(finallist, pp->to);
-
-				for (tp = pp->trace; tp && (tp->index != var); tp = tp->next)
-					;
-				if (((tp && tp->value) || !tp) && (visited[pp->to] == 0)
-						&& (finalflag == 0))
-					worklist = enqueue(worklist, pp->to);
-			}
-			pp = pp->next;
-			finalflag = 1;
-		}
-        kill_paths(state_paths);
-	}
-    free_ilt(worklist);
-    free(visited);
-    free(sharp0);
-	return finallist;
-}
-
-//no duplicate
-struct int_list_type * Automaton::enqueue(struct int_list_type *list, int value) {
-	if (!check_value(list, value))
-		list = add_data(list, new_it(value));
-	return list;
-}
-
-int Automaton::dequeue(struct int_list_type *list){
-	struct int_type *data = NULL;
-	int i;
-	if ((list == NULL) || (list->count == 0))
-		return -1;
-	else
-		data = list->head;
-	if (list->count == 1) {
-		list->count = 0;
-		list->head = list->tail = NULL;
-	} else {
-		list->head = list->head->next;
-		list->count--;
-	}
-	i = data->value;
-	free(data);
-	return i;
-}
-
-void Automaton::free_ilt(struct int_list_type *list) {
-	int tmp = dequeue(list);
-	while (tmp != -1)
-		tmp = dequeue(list);
-	free(list);
-}
-
-struct int_type * Automaton::new_it(int i) {
-	struct int_type *tmp;
-	tmp = (struct int_type *) malloc(sizeof(struct int_type));
-	tmp->value = i;
-	tmp->next = NULL;
-	return tmp;
-}
-
-struct int_list_type * Automaton::new_ilt() {
-	struct int_list_type *tmp;
-	tmp = (struct int_list_type *) malloc(sizeof(struct int_list_type));
-	tmp->count = 0;
-	tmp->head = tmp->tail = NULL;
-	return tmp;
-}
-
-struct int_list_type * Automaton::add_data(struct int_list_type *list, struct int_type *data) {
-	if (data == NULL)
-		return list;
-
-	if (list == NULL)
-		list = new_ilt();
-	if (list->count > 0) {
-		list->tail->next = data;
-		list->tail = list->tail->next;
-		list->count++;
-	} else {
-		list->head = list->tail = data;
-		list->count = 1;
-	}
-	return list;
-}
+  tmpM = dfaMinimize(result);
+  dfaFree(result);
+  return tmpM;
 
-int Automaton::check_value(struct int_list_type *list, int value) {
-	struct int_type *tmp = NULL;
-	if (list != NULL)
-		for (tmp = list->head; tmp != NULL; tmp = tmp->next)
-			if (tmp->value == value)
-				return 1;
-	return 0;
 }
 
-//return the max pairs[i]->count
-int Automaton::get_maxcount(struct int_list_type **pairs, int size) {
-	int i;
+//return the largest closure
+int Automaton::get_maxcount(const MatchClosures& pairs) {
 	int result = 0;
-	for (i = 0; i < size; i++) {
-		if (pairs[i] != NULL)
-			if (result < pairs[i]->count)
-				result = pairs[i]->count;
+	for (const int count : pairs.counts) {
+		if (result < count) {
+			result = count;
+		}
 	}
 	return result;
 }
@@ -5257,8 +5197,12 @@ DFA * Automaton::dfaDot(int var, int *indices){
    dfaSetup(3,var,indices);
 
    dfaAllocExceptions(2);
-   dfaStoreException(2, getSharp1(var));
-   dfaStoreException(2, getSharp0(var));
+   char *sharp1 = getSharp1(var);
+   dfaStoreException(2, sharp1);
+   free(sharp1);
+   char *sharp0 = getSharp0(var);
+   dfaStoreException(2, sharp0);
+   free(sharp0);
    dfaStoreState(1);
    dfaAllocExceptions(0);
    dfaStoreState(2);
@@ -5311,26 +5255,107 @@ void Automaton::set_accepted_chars(DFA* M,char** apath, int numchars, int var, i
   //assert(k==numchars); // the number of added apaths shall be equal to numchars
 }
 
-struct int_list_type ** Automaton::get_match(DFA *M, int var, int *indices) {
-	int i, next;
-	struct int_list_type **result;
-	result = (struct int_list_type **) malloc((M->ns)
-			* sizeof(struct int_list_type *));
-	for (i = 0; i < M->ns; i++) {
-		next = exist_sharp1_path(M, i, var);
-		if (next > -1)
-			result[i] = reachable_closure(M, next, var, indices);//result[i]= reachable_closure(M, next, var, indices);
-		else
-			result[i] = new_ilt();
+MatchClosures Automaton::get_match(DFA *M, int var, int *indices) {
+	paths state_paths, pp;
+	trace_descr tp;
+	const int sink = find_sink(M);
+	// reserved symbols over the char bits and the extra bit, bdd variable j is bit j
+	const std::string sharp1(var + 1, '1');
+	const std::string sharp0 = std::string(var - 1, '1') + "00";
+	auto is_on_path = [var](trace_descr tp, const std::string& symbol) {
+		for (; tp; tp = tp->next) {
+			if ((int) tp->index <= var and symbol[tp->index] != (tp->value ? '1' : '0')) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// paths of each state are walked once; the sharp1 target, and the sharp0 and bar edges in path order
+	std::vector<int> sharp1_targets(M->ns, -1);
+	std::vector<int> edge_offsets(M->ns + 1, 0);
+	std::vector<int> edge_targets;
+	std::vector<bool> is_sharp0_edge;
+	for (int i = 0; i < M->ns; i++) {
+		if (i != sink) {
+			state_paths = pp = make_paths(M->bddm, M->q[i]);
+			while (pp) {
+				if (pp->to != sink) {
+					if (sharp1_targets[i] < 0 and is_on_path(pp->trace, sharp1)) {
+						sharp1_targets[i] = pp->to;
+					}
+					if (is_on_path(pp->trace, sharp0)) {
+						edge_targets.push_back(pp->to);
+						is_sharp0_edge.push_back(true);
+					} else {
+						for (tp = pp->trace; tp && (tp->index != var); tp = tp->next)
+							;
+						if (!tp || tp->value) {
+							edge_targets.push_back(pp->to);
+							is_sharp0_edge.push_back(false);
+						}
+					}
+				}
+				pp = pp->next;
+			}
+			kill_paths(state_paths);
+		}
+		edge_offsets[i + 1] = edge_targets.size();
+	}
+
+	// closures of the sharp1 targets, reachable states from \bar* sharp0
+	MatchClosures result;
+	result.offsets.assign(M->ns, 0);
+	result.counts.assign(M->ns, 0);
+	std::vector<int> closure_offsets(M->ns, -1);
+	std::vector<int> closure_counts(M->ns, 0);
+	std::vector<bool> is_visited(M->ns, false);
+	std::vector<bool> is_in_closure(M->ns, false);
+	std::vector<int> worklist;
+	for (int i = 0; i < M->ns; i++) {
+		const int start = sharp1_targets[i];
+		if (start < 0) {
+			continue;
+		}
+		if (closure_offsets[start] < 0) {
+			const int offset = result.states.size();
+			worklist.assign(1, start);
+			is_visited[start] = true;
+			for (std::size_t w = 0; w < worklist.size(); w++) {
+				const int current = worklist[w];
+				for (int e = edge_offsets[current]; e < edge_offsets[current + 1]; e++) {
+					const int to = edge_targets[e];
+					if (is_sharp0_edge[e]) {
+						if (not is_in_closure[to]) {
+							is_in_closure[to] = true;
+							result.states.push_back(to);
+						}
+					} else if (not is_visited[to]) {
+						is_visited[to] = true;
+						worklist.push_back(to);
+					}
+				}
+			}
+			closure_offsets[start] = offset;
+			closure_counts[start] = result.states.size() - offset;
+			// only the marks of this closure are cleared
+			for (const int state : worklist) {
+				is_visited[state] = false;
+			}
+			for (std::size_t k = offset; k < result.states.size(); k++) {
+				is_in_closure[result.states[k]] = false;
+			}
+		}
+		result.offsets[i] = closure_offsets[start];
+		result.counts[i] = closure_counts[start];
 	}
 	return result;
 }
 
-int Automaton::get_number_of_sharp1_state(struct int_list_type **pairs, int size) {
-	int i;
+int Automaton::get_number_of_sharp1_state(const MatchClosures& pairs) {
 	int result = 0;
-	for (i = 0; i < size; i++)
-		if (pairs[i] != NULL && pairs[i]->count > 0)
+	for (const int count : pairs.counts)
+		if (count > 0)
 			result++;
 
 	return result;
@@ -5749,7 +5774,9 @@ DFA * Automaton::dfa_insert_everywhere(DFA *M, DFA* Mr, int var, int *indices)
   DFA *result = NULL;
   DFA *tmp = NULL;
 
-  tmp = DFAIntersect(Mr, dfaDot(var, indices));
+  DFA_ptr dot_dfa = dfaDot(var, indices);
+  tmp = DFAIntersect(Mr, dot_dfa);
+  dfaFree(dot_dfa);
   if(!check_emptiness(tmp, var, indices)){
     result = dfa_insert_M_dot(M, tmp, var, indices);
   }
@@ -10,20 +10,25 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <random>
 #include <ctime>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <stack>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <queue>
@@ -38,6 +43,7 @@
 #include "../utils/Math.h"
 #include "../utils/RegularExpression.h"
 #include "../boost/multiprecision/cpp_int.hpp"
+#include "../cereal/types/vector.hpp"
 #include "../Eigen/SparseCore"
 #include "Graph.h"
 #include "GraphNode.h"
@@ -55,6 +61,55 @@ using DFA_ptr = DFA*;
 using Node = std::pair<int ,int>; // pair.first = node id, pair.second node data
 using BigInteger = boost::multiprecision::cpp_int;
 using NextState = std::pair<int, std::vector<bool>>;
+/**
+ * Called with the transition bits of an accepting path ('0', '1' or 'X' for don't care,
+ * num_of_bdd_variables chars per transition) and the length of the path, returns false to stop
+ */
+using AcceptingPathCallback = std::function<bool(const std::vector<char>&, int)>;
+/**
+ * Called with each decoded model of a single track automaton, returns false to stop
+ */
+using ModelCallback = std::function<bool(const std::string&)>;
+
+/**
+ * Transition graph of a dfa in compressed sparse row layout, shared by the graph queries and the
+ * path enumeration. The transitions of state s go to successors[successor_offsets[s]] ..
+ * successors[successor_offsets[s + 1] - 1], self loops first, and transition t has the bits
+ * bits[t * num_of_bdd_variables] .. bits[(t + 1) * num_of_bdd_variables - 1] ('0', '1' or 'X' for
+ * don't care). A state reaches the same successor by more than one transition when their bits
+ * differ. Predecessors are kept the same way, one entry per transition. Transitions from and to
+ * sink states are kept.
+ */
+struct TransitionGraph {
+  std::vector<int> successor_offsets;
+  std::vector<int> successors;
+  std::vector<char> bits;
+  std::vector<int> predecessor_offsets;
+  std::vector<int> predecessors;
+  /**
+   * is_in_cycle[s] is set if s is on a cycle, self loops included, empty until cycles are needed
+   */
+  std::vector<bool> is_in_cycle;
+};
+
+/**
+ * Flat image of a dfa used by the binary automaton format, all fields are fixed width so that
+ * the arrays can be read in place. Bdd nodes are numbered children first, node i is
+ * (bdd variable index, low, high) at nodes[3 * i] .. nodes[3 * i + 2]; a leaf has the index
+ * BDD_LEAF_INDEX and its target state in place of low. roots[s] is the node of state s.
+ */
+struct DFAImage {
+  std::int32_t num_of_states = 0;
+  std::int32_t initial_state = 0;
+  std::vector<std::int32_t> finals;
+  std::vector<std::uint32_t> roots;
+  std::vector<std::uint32_t> nodes;
+
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar(num_of_states, initial_state, finals, roots, nodes);
+  }
+};
 
 // for toDotAscii from libstranger
 typedef struct CharPair_ {
@@ -62,15 +117,16 @@ typedef struct CharPair_ {
 	unsigned char last;
 } CharPair, *pCharPair;
 
-struct int_type{
-		int value;
-		struct int_type	*next;
-};
-
-struct int_list_type{
-		int count;
-		struct	int_type	*head;
-		struct	int_type	*tail;
+/**
+ * Match closures of a dfa with the replace extra bit; the states reachable from state s by
+ * sharp1 bar* sharp0 are states[offsets[s]] .. states[offsets[s] + counts[s] - 1] in discovery
+ * order. A closure is computed once per sharp1 target, states that move to the same target by
+ * sharp1 share its range.
+ */
+struct MatchClosures {
+  std::vector<int> offsets;
+  std::vector<int> counts;
+  std::vector<int> states;
 };
 
 class Automaton {
@@ -210,6 +266,7 @@ public:
   virtual BigInteger SymbolicCount(int bound, bool count_less_than_or_equal_to_bound = true);
   virtual BigInteger SymbolicCount(double bound, bool count_less_than_or_equal_to_bound = true);
   virtual std::map<std::string,std::vector<std::string>> GetModelsWithinBound(int num_models, int bound);
+  void ForEachModelWithinBound(int bound, ModelCallback callback);
   SymbolicCounter GetSymbolicCounter();
   static void SetCountBoundExact(bool value);
 
@@ -238,10 +295,87 @@ public:
 
   friend std::ostream& operator<<(std::ostream& os, const Automaton& automaton);
 
+  /**
+   * Frees the bdd variable indices cached by the calling thread
+   */
   static void CleanUp();
 
+  /**
+   * MONA keeps the state of dfa construction and bdd operations in globals, automata
+   * operations of different threads must hold this lock
+   * @return process wide lock for MONA
+   */
+  static std::recursive_mutex& GetMonaMutex();
+
+  /**
+   * Version of the binary automaton format, loading other versions fails
+   */
+  static const std::uint32_t BINARY_FORMAT_VERSION = 1;
+
+  /**
+   * Binary automaton format: the format version, the automaton type, the number of bdd
+   * variables, the dfa image and the symbolic counter when it is cached. Subclasses append
+   * their own fields.
+   */
+  template <class Archive>
+  void save(Archive& ar) const {
+    std::uint32_t version = BINARY_FORMAT_VERSION;
+    ar(version);
+    ar(static_cast<int>(type_));
+    ar(num_of_bdd_variables_);
+    DFAImage image;
+    GetDFAImage(image);
+    ar(image);
+    ar(is_counter_cached_);
+    if (is_counter_cached_) {
+      counter_.save(ar);
+    }
+  }
+
+  template <class Archive>
+  void load(Archive& ar) {
+    std::uint32_t version = 0;
+    ar(version);
+    CHECK_EQ(BINARY_FORMAT_VERSION, version) << "unsupported automaton format version";
+    int type = 0;
+    ar(type);
+    CHECK_EQ(static_cast<int>(type_), type) << "automaton type does not match";
+    ar(num_of_bdd_variables_);
+    DFAImage image;
+    ar(image);
+    SetDFAImage(image);
+    ar(is_counter_cached_);
+    if (is_counter_cached_) {
+      counter_.load(ar);
+    }
+  }
+
 protected:
 
+  /**
+   * @param image image of the dfa with its bdd node table
+   */
+  void GetDFAImage(DFAImage& image) const;
+
+  /**
+   * Replaces the dfa with the one rebuilt from the image
+   * @param image
+   */
+  void SetDFAImage(const DFAImage& image);
+
+  /**
+   * Maps a file into memory and passes a stream that reads the mapped bytes in place to the reader
+   * @param file_name
+   * @param reader
+   */
+  static void ReadMappedFile(const std::string& file_name, std::function<void(std::istream&)> reader);
+
+  /**
+   * Records the number of states and bdd nodes of a dfa in the active profile
+   * @param dfa
+   */
+  static void DFAProfileSize(const DFA_ptr dfa);
+
   /**
    * Checks if a minimized dfa accepts nothing
    * @param dfa
@@ -303,6 +437,16 @@ protected:
    */
   static bool DFAIsEqual(const DFA_ptr dfa1, const DFA_ptr dfa2);
 
+  /**
+   * Searches the product of the given two dfas on the fly for a state that is not rejecting,
+   * without building the product
+   * @param dfa1
+   * @param dfa2
+   * @param max_num_of_states the search gives up once it visits more product states
+   * @return true if the intersection of the two languages is empty, false if it is not or the search gave up
+   */
+  static bool DFAIsIntersectionEmpty(const DFA_ptr dfa1, const DFA_ptr dfa2, const std::size_t max_num_of_states);
+
   /**
    * Gets the initial state of the given dfa
    * @param dfa
@@ -498,14 +642,35 @@ protected:
   bool getAnAcceptingWord(NextState& state, std::map<int, bool>& is_stack_member, std::vector<bool>& path, std::function<bool(unsigned& index)> next_node_heuristic = nullptr);
   
 
+  std::vector<int> GetShortestAcceptingPaths();
+  void ForEachAcceptingPathWithinBound(const std::vector<int>& shortest_accepting_path, int bound, bool extend_accepting_paths,
+                                       bool expand_accepting_transitions, AcceptingPathCallback callback);
+
+  using TargetWeights = std::vector<std::pair<int, BigInteger>>;
+  using BddTransitionWeights = std::unordered_map<unsigned, TargetWeights>;
   virtual void SetSymbolicCounter();
+  const TargetWeights& GetBddTransitionWeights(unsigned root, int sink_state, BddTransitionWeights& transition_weights);
   virtual void decide_counting_schema(Eigen::SparseMatrix<BigInteger>& mm);
   void generateGFScript(int bound, std::ostream& out = std::cout, bool count_less_than_or_equal_to_bound = true);
   void generateMatrixScript(int bound, std::ostream& out = std::cout, bool count_less_than_or_equal_to_bound = true);
 
 
-  bool isCyclic(int state, std::map<int, bool>& is_discovered, std::map<int, bool>& is_stack_member);
-  bool isStateReachableFrom(int search_state, int from_state, std::map<int, bool>& is_stack_member);
+  /**
+   * Transition graph of the dfa, built on first use and kept until the dfa is replaced
+   * @return
+   */
+  const TransitionGraph& GetTransitionGraph();
+
+  /**
+   * Finds the strongly connected components of the transition graph once
+   * @return for each state, true if the state is on a cycle
+   */
+  const std::vector<bool>& GetCycleStates();
+
+  /**
+   * Drops the transition graph, called whenever dfa_ is replaced
+   */
+  void InvalidateTransitionGraph();
 
   /*
    * Operations from LIBSTRANGER
@@ -588,21 +753,7 @@ protected:
   static DFA *dfa_replace_M_dot(DFA *M, DFA* Mr, int var, int *oldindices);
   static DFA *dfa_replace_M_arbitrary(DFA *M, DFA *Mr, int var, int *oldindices);
 
-  static struct int_list_type **get_match_exclude_self(DFA *M, int var, int *indices);
-  static int exist_sharp1_path(DFA *M, int start, int var);
-  static int* allocateAscIIIndexWithExtraBit(int length);
-  static struct int_list_type *reachable_closure(DFA *M, int start, int var,int *indices);
-
-  // list stuff
-  static struct int_list_type * enqueue(struct int_list_type *list, int value);
-  static int dequeue(struct int_list_type *list);
-  static void free_ilt(struct int_list_type *list);
-  static struct int_type *new_it(int i);
-  static struct int_list_type *new_ilt();
-  static struct int_list_type *add_data(struct int_list_type *list, struct int_type *data);
-  static int check_value(struct int_list_type *list, int value);
-
-  static int get_maxcount(struct int_list_type **pairs, int size);
+  static int get_maxcount(const MatchClosures& pairs);
   static int get_hsig(int i);
   static void set_bitvalue(char *bit, int length, int value);
   static int* allocateArbitraryIndex(int length);
@@ -610,8 +761,15 @@ protected:
 
   static int count_accepted_chars(DFA* M);
   static void set_accepted_chars(DFA* M,char** apath, int numchars, int var, int* indices);
-  static struct int_list_type **get_match(DFA *M, int var, int *indices);
-  static int get_number_of_sharp1_state(struct int_list_type **pairs, int size);
+  /**
+   * Walks the paths of each state once, then finds the closure of each sharp1 target breadth first
+   * @param M dfa with the extra bit at index var
+   * @param var
+   * @param indices
+   * @return states reachable from each state by sharp1 bar* sharp0
+   */
+  static MatchClosures get_match(DFA *M, int var, int *indices);
+  static int get_number_of_sharp1_state(const MatchClosures& pairs);
   static void initial_out_info(DFA* M, int* num, int* final, char*** bin, int** to, int var, int aux, int* indices);
   static DFA* dfa_pre_replace_str(DFA* M1, DFA* M2, char *str, int var, int* indices);
   static DFA *dfa_construct_string(char *reg, int var, int *indices);
@@ -620,18 +778,18 @@ protected:
   static DFA *dfa_insert_M_arbitrary(DFA *M, DFA *Mr, int var, int *indices);
   static DFA *dfa_insert_everywhere(DFA *M, DFA* Mr, int var, int *indices);
 
-  static unsigned long next_id;
+  static std::atomic<unsigned long> next_id;
 
   /**
-   * Bdd variable indices cache used in MONA dfa manipulation
+   * Bdd variable indices cache used in MONA dfa manipulation, kept per thread
    */
-  static std::unordered_map<int, int*> bdd_variable_indices;
+  static thread_local std::unordered_map<int, std::unique_ptr<int[]>> bdd_variable_indices;
 
   /**
    * Automaton id used for debuggin purposes
    */
   unsigned long id_;
-  static int next_state;
+  static thread_local int next_state;
 
   const Automaton::Type type_; // TODO remove type
 
@@ -653,11 +811,16 @@ protected:
    */
   SymbolicCounter counter_;
 
-  static bool count_bound_exact_;
+  /**
+   * Cached transition graph of dfa_, nullptr until it is needed
+   */
+  std::unique_ptr<TransitionGraph> transition_graph_;
+
+  static thread_local bool count_bound_exact_;
 private:
   char* getAnExample(bool accepting=true); // MONA version
   // for debugging
-  static int name_counter;
+  static thread_local int name_counter;
   static const int VLOG_LEVEL;
 };
 
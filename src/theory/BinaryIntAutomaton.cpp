@@ -10,6 +10,8 @@
 
 #include "BinaryIntAutomaton.h"
 
+#include <fstream>
+
 namespace Vlab {
 namespace Theory {
 
@@ -51,6 +53,26 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::clone() const {
   return cloned_auto;
 }
 
+void BinaryIntAutomaton::SaveToFile(const std::string& file_name) const {
+  std::ofstream out(file_name, std::ios::binary);
+  if (not out.good()) {
+    LOG(FATAL)<< "cannot open file: " << file_name;
+  }
+  cereal::BinaryOutputArchive ar(out);
+  save(ar);
+}
+
+BinaryIntAutomaton_ptr BinaryIntAutomaton::LoadFromFile(const std::string& file_name) {
+  // deleted when the reader throws, e.g. on a truncated file
+  std::unique_ptr<BinaryIntAutomaton> binary_auto (new BinaryIntAutomaton(false));
+  ReadMappedFile(file_name, [&binary_auto](std::istream& in) {
+    cereal::BinaryInputArchive ar(in);
+    binary_auto->load(ar);
+  });
+  DVLOG(VLOG_LEVEL) << binary_auto->id_ << " = BinaryIntAutomaton::LoadFromFile(" << file_name << ")";
+  return binary_auto.release();
+}
+
 // What about natural number parameter?
 BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeAutomaton(DFA_ptr dfa, Formula_ptr formula, const int number_of_variables) {
 	auto bin_auto = new BinaryIntAutomaton(dfa,number_of_variables, not Vlab::Option::Solver::USE_SIGNED_INTEGERS);
@@ -508,7 +530,7 @@ SemilinearSet_ptr BinaryIntAutomaton::GetSemilinearSet() {
   SemilinearSet_ptr semilinear_set = nullptr, current_set = nullptr, tmp_set = nullptr;
   BinaryIntAutomaton_ptr subject_auto = nullptr, tmp_1_auto = nullptr, tmp_2_auto = nullptr, diff_auto = nullptr;
   std::vector<SemilinearSet_ptr> semilinears;
-  std::string var_name = this->formula_->GetVariableCoefficientMap().begin()->first;
+  std::string var_name = this->formula_->GetVariableAtIndex(0);
   int current_state = this->dfa_->s, sink_state = this->GetSinkState();
   std::vector<int> constants, bases;
   bool is_cyclic = false;
@@ -744,9 +766,8 @@ std::map<std::string, int> BinaryIntAutomaton::GetAnAcceptingIntForEachVar() {
 
   int var_index;
   std::string var_name;
-  for (auto& var_entry : formula_->GetVariableCoefficientMap()) {
-    var_name = var_entry.first;
-    var_index = formula_->GetVariableIndex(var_name);;
+  for (var_index = 0; var_index < formula_->GetNumberOfVariables(); ++var_index) {
+    var_name = formula_->GetVariableAtIndex(var_index);
     if (var_name.length() > 10) {
       var_name = var_name.substr(0, 10);
     }
@@ -814,40 +835,11 @@ void BinaryIntAutomaton::decide_counting_schema(Eigen::SparseMatrix<BigInteger>&
   }
 }
 
+/**
+ * Bound is the number of bits, sign bit is handled by the symbolic counter
+ */
 BigInteger BinaryIntAutomaton::SymbolicCount(double bound, bool count_less_than_or_equal_to_bound) {
-  std::stringstream cmd;
-  std::string str_result;
-  std::string tmp_result_file = Option::Theory::TMP_PATH + "/arith_result.dot";
-  std::string math_script_path = Option::Theory::SCRIPT_PATH + "/count.m";
-
-  std::ofstream outfile(tmp_result_file.c_str());
-  if (!outfile.good()) {
-    std::cout << "cannot open file: " << tmp_result_file << std::endl;
-    exit(2);
-  }
-
-  this->ToDot(outfile, false);
-
-  cmd << "math -script " << math_script_path << " " << tmp_result_file << " ";
-
-  if (not is_natural_number_) {
-    ++bound;  // consider sign bit
-  }
-
-  if (std::floor(bound) == bound) {
-    cmd << static_cast<int>(bound);
-  } else {
-    cmd << bound;
-  }
-
-  try {
-    DVLOG(VLOG_LEVEL) << "run_cmd(`" << cmd.str() << "`)";
-    str_result = Util::Cmd::run_cmd(cmd.str());
-  } catch (std::string& e) {
-    LOG(ERROR)<< e;
-  }
-
-  return BigInteger(str_result);
+  return Automaton::SymbolicCount(static_cast<int>(bound), count_less_than_or_equal_to_bound);
 }
 
 std::map<std::string,std::vector<std::string>> BinaryIntAutomaton::GetModelsWithinBound(int num_models, int bound) {
@@ -870,272 +862,88 @@ std::map<std::string,std::vector<std::string>> BinaryIntAutomaton::GetModelsWith
 //	LOG(INFO) << "num_models : " << num_models;
 //	LOG(INFO) << "bound      : " << bound;
 
-  // compute BFS for unweighted graph (dfa)
-  std::queue<int> states_to_process;
-  std::vector<int> distances(this->dfa_->ns,INT_MAX);
-  std::set<int> final_states;
-
-  std::vector<int> shortest_accepting_path(this->dfa_->ns,INT_MAX);
-  for(int start_state = 0; start_state < this->dfa_->ns; start_state++) {
-  	distances[start_state] = 0;
-		states_to_process.push(start_state);
-
-		while(not states_to_process.empty()) {
-			int s = states_to_process.front();
-			states_to_process.pop();
-			// mark final states for later
-			if(this->dfa_->f[s] == 1) {
-				final_states.insert(s);
-			}
+  // if transition is to a final state, unroll the 'X'
+  // must do this now because of leading zeros or ones causes issues later
+  // TODO: Will, think of better way to handle this
+  auto shortest_accepting_path = GetShortestAcceptingPaths();
 
-			for(auto iter : getNextStates(s)) {
-				if(distances[iter] == INT_MAX) {
-					states_to_process.push(iter);
-					distances[iter] = distances[s] + 1;
-				}
-			}
-		}
-
-		int shortest = INT_MAX;
-		for(auto final : final_states) {
-			if(distances[final] < shortest) {
-				shortest = distances[final];
-			}
-		}
-		shortest_accepting_path[start_state] = shortest;
-
-
-		distances = std::vector<int>(this->dfa_->ns,INT_MAX);
-  }
-
-//  for(int i = 0; i < this->dfa_->ns; i++) {
-//  	LOG(INFO) << "shortest path for state " << i << " = " << shortest_accepting_path[i];
-//  }
-//
-//  LOG(INFO) << "Done computing shortest paths to final state";
-
-  // assume num_tracks > 1; Otherwise, juse call normal version
   int models_so_far = 0;
   int num_variables = this->num_of_bdd_variables_;
   int var_per_track = num_variables / num_tracks;
 
-  std::vector<std::pair<int,std::vector<char>>> next_states;
-
-  // cache the process for finding next transitions from a state
-  std::vector<std::vector<std::pair<int,std::vector<char>>>> next_states_matrix(this->dfa_->ns);
-  for(int i = 0; i < this->dfa_->ns; i++) {
-  	int current_state = i;
-  	std::vector<std::pair<int,std::vector<char>>> inner_next_states;
-		std::vector<unsigned> nodes;
-		std::vector<std::vector<char>> transition_stack;
-		std::vector<char> current_transition;
-		int sink = GetSinkState();
-
-		unsigned p, l, r, index; // BDD traversal variables
-		p = this->dfa_->q[current_state];
-		nodes.push_back(p);
-		transition_stack.push_back(std::vector<char>());
-		while (not nodes.empty()) {
-			p = nodes.back();
-			nodes.pop_back();
-			current_transition = transition_stack.back();
-			transition_stack.pop_back();
-			LOAD_lri(&this->dfa_->bddm->node_table[p], l, r, index);
-			if (index == BDD_LEAF_INDEX) {
-				int to_state = l;
-				// if to_state is sink state, ignore
-				if(to_state == sink) {
-					continue;
-				}
-
-				while (current_transition.size() < (unsigned) num_of_bdd_variables_) {
-					current_transition.push_back('X');
-				}
-
-				// if transition is to a final state, unroll the 'X'
-				// must do this now because of leading zeros or ones causes issues later
-				// TODO: Will, think of better way to handle this
-				if(this->dfa_->f[to_state] == 1) {
-					std::vector<std::vector<char>> models;
-					models.push_back(std::vector<char>());
-					for(int k = 0; k < current_transition.size(); k++) {
-						if(current_transition[k] == 'X') {
-							std::vector<std::vector<char>> temp_models;
-							for(int j = 0; j < models.size(); j++) {
-								std::vector<char> m = models[j];
-								m.push_back('0');
-								temp_models.push_back(m);
-								models[j].push_back('1');
-							}
-							models.insert(models.end(),temp_models.begin(),temp_models.end());
-						} else {
-							for(int j = 0; j < models.size(); j++) {
-								models[j].push_back(current_transition[k]);
-							}
-						}
-					}
-					// put loops first, other states at back
-					for(int k = 0; k < models.size(); k++) {
-						if(to_state != current_state) {
-							next_states_matrix[i].push_back(std::make_pair(to_state, models[k]));
-						} else {
-							next_states_matrix[i].insert(next_states_matrix[i].begin(),std::make_pair(to_state,models[k]));
-						}
-					}
-
-				} else {
-					// put loops first, other states at back
-					if(to_state != current_state) {
-						next_states_matrix[i].push_back(std::make_pair(to_state, current_transition));
-					} else {
-						next_states_matrix[i].insert(next_states_matrix[i].begin(),std::make_pair(to_state,current_transition));
-					}
-				}
-			} else {
-				while (current_transition.size() < index) {
-					unsigned i = current_transition.size();
-					current_transition.push_back('X');
-				}
-				std::vector<char> left = current_transition;
-				left.push_back('0');
-				std::vector<char> right = current_transition;
-				right.push_back('1');
-				transition_stack.push_back(right);
-				nodes.push_back(r);
-				transition_stack.push_back(left);
-				nodes.push_back(l);
-			}
-		}
-  }
-
-  //LOG(INFO) << "Done precomputing transition matrix";
-
-
-  int start = this->dfa_->s;
-	int sink = GetSinkState();
-	bool get_more_models = true;
 	// since we're not expanding dont-care characters ('X') yet, the models we find are unfinished
 	std::set<std::vector<std::vector<char>>> unfinished_models;
 	std::set<std::vector<std::vector<bool>>> finished_models;
-	std::stack<std::pair<int,std::vector<std::vector<char>>>> models_to_process;
-	std::vector<std::vector<char>> track_characters(num_tracks,std::vector<char>());
-	models_to_process.push(std::make_pair(start,track_characters));
-	int num_loops = 0;
-	while(not models_to_process.empty() and get_more_models) {
-		std::pair<int,std::vector<std::vector<char>>> current_model = models_to_process.top();
-		models_to_process.pop();
-
-		int current_state = current_model.first;
-		int length = current_model.second[0].size() / var_per_track;
-
-		if(shortest_accepting_path[current_state] + length > bound) {
-			continue;
+	std::vector<std::vector<char>> track_characters(num_tracks);
+	ForEachAcceptingPathWithinBound(shortest_accepting_path, bound, true, true,
+			[&](const std::vector<char>& path, int length) {
+		if(count_bound_exact_ and length != bound) {
+			return true;
 		}
 
-
-
-		for(auto iter : next_states_matrix[current_state]) {
-		// next_state is in first position
-			int to_state = iter.first;
-			// if the current length + shortest path to final state from to_state + 1 (for transition from current -> to_state)
-			// is greater than bound, ignore
-			if(to_state == sink || length + shortest_accepting_path[to_state]+1 > bound) {
-				continue;
-			}
-
-
-			if(to_state != sink and (length < bound or bound == -1)) {
-				std::vector<char> transition = iter.second;
-
-				// transition is in second position
-				track_characters = current_model.second;
-				for(int i = 0; i < num_tracks; i++) {
-					for(int k = 0; k < var_per_track; k++) {
-						// since tracks are interleaved, track i's characters don't lie in order in the transition we got
-						// however, this is a binaryint, so each var should only take 1 bit, so this isn't really needed
-						track_characters[i].push_back(transition[i+num_tracks*k]);
-					}
+		for(int i = 0; i < num_tracks; i++) {
+			track_characters[i].clear();
+		}
+		for(int step = 0; step < length; step++) {
+			for(int i = 0; i < num_tracks; i++) {
+				for(int k = 0; k < var_per_track; k++) {
+					// since tracks are interleaved, track i's characters don't lie in order in the transition we got
+					// however, this is a binaryint, so each var should only take 1 bit, so this isn't really needed
+					track_characters[i].push_back(path[step * num_variables + i + num_tracks * k]);
 				}
-
-				models_to_process.push(std::make_pair(to_state,track_characters));
 			}
 		}
 
-		// check if its final state
 		// since we can have any number of leading zeros or ones, first truncate
 		// all leading zeros or ones (except for one) and add the transition if we haven't
 		// seen it yet
-		if(this->dfa_->f[current_state] == 1) {
-			if((count_bound_exact_ and length == bound) or (not count_bound_exact_ and length <= bound)) {
-//				LOG(INFO) << "Length: " << length;
-
-				// for each track, truncate leading zeros or ones (except for one)
-				// in dfa representation, we read backwards (0101 = 5, instead of 3) so leading zeros
-				// or ones are at the end of the transition
-				if(is_natural_number_) {
-					// for unsigned, just get rid of leading 0s
-					for(int i = 0; i < num_tracks; i++) {
-						int pos = current_model.second[i].size()-1;
-						while(current_model.second[i].back() == '0' and pos > 0) {
-							current_model.second[i].pop_back();
-							pos--;
-						}
-					}
+		// in dfa representation, we read backwards (0101 = 5, instead of 3) so leading zeros
+		// or ones are at the end of the transition
+		if(is_natural_number_) {
+			// for unsigned, just get rid of leading 0s
+			for(int i = 0; i < num_tracks; i++) {
+				while(track_characters[i].size() > 1 and track_characters[i].back() == '0') {
+					track_characters[i].pop_back();
 				}
-				else {
-					// for signed, we need to get rid of most leading 0s and 1s
-					for(int i = 0; i < num_tracks; i++) {
-						char last_char = current_model.second[i].back();
-						int pos = current_model.second[i].size()-2;
-						while(pos >= 0 and current_model.second[i][pos] == last_char and last_char != 'X') {
-							current_model.second[i].pop_back();
-							pos--;
-						}
-					}
+			}
+		}
+		else {
+			// for signed, we need to get rid of most leading 0s and 1s
+			for(int i = 0; i < num_tracks; i++) {
+				if(track_characters[i].empty()) {
+					continue;
 				}
-
-				// if we haven't seen the truncated version, add it
-				if(unfinished_models.find(current_model.second) == unfinished_models.end()) {
-					int max_x = 0;
-					// each track can have differing number of x's
-					// find the max number of x's in all tracks
-					for(int i = 0; i < num_tracks; i++) {
-						int num_x = 0;
-						for(int k = 0; k < current_model.second[i].size(); k++) {
-							if(current_model.second[i][k] == 'X') {
-								num_x++;
-							}
-						}
-						if(num_x > max_x) {
-							max_x = num_x;
-						}
-					}
-
-					// for each 'X', there are 2 possible transitions
-					models_so_far += (1 << max_x);
-					unfinished_models.insert(current_model.second);
-
-//					std::string s1,s2;
-//					for(int k = 0; k < current_model.second[0].size(); k++) {
-//						s1 += current_model.second[0][k];
-//					}
-//					for(int k = 0; k < current_model.second[1].size(); k++) {
-//						s2 += current_model.second[1][k];
-//					}
-//					LOG(INFO) << "ADDED:";
-//					LOG(INFO) << "  s1: " << s1;
-//					LOG(INFO) << "  s2: " << s2;
-//					LOG(INFO) << "";
-//					std::cin.get();
-
-					// set finish condition if necessary
-					if(num_models != -1 and models_so_far >= num_models) {
-						get_more_models = false;
-					}
+				char last_char = track_characters[i].back();
+				int pos = track_characters[i].size()-2;
+				while(pos >= 0 and track_characters[i][pos] == last_char and last_char != 'X') {
+					track_characters[i].pop_back();
+					pos--;
 				}
 			}
 		}
-	}
+
+		// if we haven't seen the truncated version, add it
+		if(unfinished_models.find(track_characters) != unfinished_models.end()) {
+			return true;
+		}
+		int max_x = 0;
+		// each track can have differing number of x's
+		// find the max number of x's in all tracks
+		for(int i = 0; i < num_tracks; i++) {
+			int num_x = std::count(track_characters[i].begin(), track_characters[i].end(), 'X');
+			if(num_x > max_x) {
+				max_x = num_x;
+			}
+		}
+		unfinished_models.insert(track_characters);
+
+		// for each 'X', there are 2 possible transitions
+		if(num_models != -1 and (max_x >= 30 or models_so_far + (1 << max_x) >= num_models)) {
+			return false;
+		}
+		models_so_far += (1 << max_x);
+		return true;
+	});
 
 	//LOG(INFO) << "Got unfinished models";
 
@@ -1283,7 +1091,22 @@ std::map<std::string,std::vector<std::string>> BinaryIntAutomaton::GetModelsWith
 //	LOG(INFO) << "num_models: " << unfinished_models.size();
 //	LOG(INFO) << "num finished_models: " << finished_models.size();
 //
-	LOG(INFO) << "Number of models: " << printable_models.size();
+	DVLOG(VLOG_LEVEL) << "Number of models: " << printable_models.size();
+
+	if(formula_ == nullptr) {
+		LOG(FATAL) << "Formula not set!";
+	}
+	// values of the same model are at the same position of each variable's vector
+	std::map<std::string,std::vector<std::string>> variable_values;
+	for(auto& variable : formula_->GetVariables()) {
+		variable_values[variable] = std::vector<std::string>();
+	}
+	for(auto& model : printable_models) {
+		for(int i = 0; i < num_tracks; i++) {
+			variable_values[formula_->GetVariableAtIndex(i)].push_back(std::to_string(model[i]));
+		}
+	}
+	return variable_values;
 }
 
 BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeBoolean(ArithmeticFormula_ptr formula) {
@@ -1379,9 +1202,13 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntEquality(ArithmeticFormula_ptr
     return equality_auto;
   }
 
-  auto coeffs_map = formula->GetVariableCoefficientMap();
-  auto coeffs = formula->GetCoefficients();
+  const auto& coeffs = formula->GetCoefficients();
   auto boolean_variables = formula->GetBooleans();
+  // coefficients of the boolean variables, looked up once instead of once per transition
+  std::map<std::string, int> coeffs_map;
+  for (auto& it : boolean_variables) {
+    coeffs_map[it.first] = formula->HasVariable(it.first) ? formula->GetVariableCoefficient(it.first) : 0;
+  }
   int min = 0, max = 0, num_of_zero_coefficient = 0;
   for (int coeff : coeffs) {
     if (coeff > 0) {
@@ -1400,6 +1227,27 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntEquality(ArithmeticFormula_ptr
     min = constant;
   }
 
+  if (boolean_variables.empty() and Option::Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION) {
+    const bool is_equality = (ArithmeticFormula::Type::EQ == formula->GetType());
+    auto transition = [](const CarryState& state, const int sum, CarryState& next_state) {
+      const int result = state.carry + sum;
+      if (result & 1) {
+        return false;
+      }
+      next_state.carry = result / 2;
+      next_state.flag = (next_state.carry == state.carry);
+      return true;
+    };
+    auto is_accepting = [is_equality](const CarryState& state) {
+      return state.flag == is_equality;
+    };
+    auto equality_dfa = MakeCarryDFA(formula, min, max, CarryState {constant, false}, transition, is_accepting, not is_equality);
+    auto equality_auto = new BinaryIntAutomaton(equality_dfa, formula, false);
+    CHECK_EQ(false, equality_auto->IsInitialStateAccepting());
+    DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeIntEquality(" << *formula << ")";
+    return equality_auto;
+  }
+
   const int num_of_states = 2 * (max - min + 2);
   const int sink_state = num_of_states - 2;
   const int shifted_initial_state = num_of_states - 1;
@@ -1563,9 +1411,13 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberEquality(ArithmeticF
     return equality_auto;
   }
 
-  auto coeffs_map = formula->GetVariableCoefficientMap();
-	auto coeffs = formula->GetCoefficients();
+  const auto& coeffs = formula->GetCoefficients();
 	auto boolean_variables = formula->GetBooleans();
+  // coefficients of the boolean variables, looked up once instead of once per transition
+  std::map<std::string, int> coeffs_map;
+  for (auto& it : boolean_variables) {
+    coeffs_map[it.first] = formula->HasVariable(it.first) ? formula->GetVariableCoefficient(it.first) : 0;
+  }
   int min = 0, max = 0, num_of_zero_coefficient = 0;
   for (int coeff : coeffs) {
     if (coeff > 0) {
@@ -1584,6 +1436,27 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberEquality(ArithmeticF
     min = constant;
   }
 
+  if (boolean_variables.empty() and Option::Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION) {
+    const bool is_equality = (ArithmeticFormula::Type::EQ == formula->GetType());
+    auto transition = [](const CarryState& state, const int sum, CarryState& next_state) {
+      const int result = state.carry + sum;
+      if (result & 1) {
+        return false;
+      }
+      next_state.carry = result / 2;
+      next_state.flag = false;
+      return true;
+    };
+    auto is_accepting = [is_equality](const CarryState& state) {
+      return (state.carry == 0) == is_equality;
+    };
+    auto equality_dfa = MakeCarryDFA(formula, min, max, CarryState {constant, false}, transition, is_accepting, not is_equality);
+    auto equality_auto = new BinaryIntAutomaton(equality_dfa, formula, true);
+    CHECK_EQ(false, equality_auto->IsInitialStateAccepting());
+    DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeNaturalNumberEquality(" << *formula << ")";
+    return equality_auto;
+  }
+
   const int num_of_states = max - min + 3;
   const int sink_state = num_of_states - 2;
   const int shifted_initial_state = num_of_states - 1;
@@ -1736,9 +1609,13 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeLessThan(ArithmeticFormula_ptr fo
 BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntLessThan(ArithmeticFormula_ptr formula) {
   formula->Simplify();
 
-  auto coeffs_map = formula->GetVariableCoefficientMap();
 	auto boolean_variables = formula->GetBooleans();
-  auto coeffs = formula->GetCoefficients();
+  const auto& coeffs = formula->GetCoefficients();
+  // coefficients of the boolean variables, looked up once instead of once per transition
+  std::map<std::string, int> coeffs_map;
+  for (auto& it : boolean_variables) {
+    coeffs_map[it.first] = formula->HasVariable(it.first) ? formula->GetVariableCoefficient(it.first) : 0;
+  }
   int min = 0, max = 0, num_of_zero_coefficient = 0;
   for (int coeff : coeffs) {
     if (coeff > 0) {
@@ -1757,6 +1634,31 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntLessThan(ArithmeticFormula_ptr
     min = constant;
   }
 
+  if (boolean_variables.empty() and Option::Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION) {
+    auto transition = [](const CarryState& state, const int sum, CarryState& next_state) {
+      int result = state.carry + sum;
+      const int target = (result >= 0) ? result / 2 : (result - 1) / 2;
+      // the symbol is accepting if it is the sign bit, i.e. repeating it reaches a fixed carry with result bit 1
+      int label1 = state.carry, label2 = target;
+      while (label1 != label2) {
+        label1 = label2;
+        result = label1 + sum;
+        label2 = (result >= 0) ? result / 2 : (result - 1) / 2;
+      }
+      next_state.carry = target;
+      next_state.flag = (result & 1);
+      return true;
+    };
+    auto is_accepting = [](const CarryState& state) {
+      return state.flag;
+    };
+    auto less_than_dfa = MakeCarryDFA(formula, min, max, CarryState {constant, false}, transition, is_accepting, false);
+    auto less_than_auto = new BinaryIntAutomaton(less_than_dfa, formula, false);
+    CHECK_EQ(false, less_than_auto->IsInitialStateAccepting());
+    DVLOG(VLOG_LEVEL) << less_than_auto->id_ << " = MakeIntLessThan(" << *formula << ")";
+    return less_than_auto;
+  }
+
   const int num_of_states = 2 * (max - min + 1);
 
   unsigned max_states_allowed = 0x80000000;
@@ -1896,9 +1798,13 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntLessThan(ArithmeticFormula_ptr
 BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticFormula_ptr formula) {
   formula->Simplify();
 
-  auto coeffs_map = formula->GetVariableCoefficientMap();
 	auto boolean_variables = formula->GetBooleans();
-  auto coeffs = formula->GetCoefficients();
+  const auto& coeffs = formula->GetCoefficients();
+  // coefficients of the boolean variables, looked up once instead of once per transition
+  std::map<std::string, int> coeffs_map;
+  for (auto& it : boolean_variables) {
+    coeffs_map[it.first] = formula->HasVariable(it.first) ? formula->GetVariableCoefficient(it.first) : 0;
+  }
   int min = 0, max = 0, num_of_zero_coefficient = 0;
   for (int coeff : coeffs) {
     if (coeff > 0) {
@@ -1917,6 +1823,23 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticF
     min = constant;
   }
 
+  if (boolean_variables.empty() and Option::Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION) {
+    auto transition = [](const CarryState& state, const int sum, CarryState& next_state) {
+      const int result = state.carry + sum;
+      next_state.carry = (result >= 0) ? result / 2 : (result - 1) / 2;
+      next_state.flag = false;
+      return true;
+    };
+    auto is_accepting = [](const CarryState& state) {
+      return state.carry < 0;
+    };
+    auto less_than_dfa = MakeCarryDFA(formula, min, max, CarryState {constant, false}, transition, is_accepting, false);
+    auto less_than_auto = new BinaryIntAutomaton(less_than_dfa, formula, true);
+    CHECK_EQ(false, less_than_auto->IsInitialStateAccepting());
+    DVLOG(VLOG_LEVEL) << less_than_auto->id_ << " = MakeNaturalNumberLessThan(" << *formula << ")";
+    return less_than_auto;
+  }
+
   const int num_of_states = max - min + 2;
   const int shifted_initial_state = num_of_states - 1;
 
@@ -1989,7 +1912,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticF
         to_state = shifted_initial_state;
         is_initial_state_in_cycle = true;
       }
-      if (current_state == 0 and is_initial_state_in_cycle) { // save transition for shifted initial start
+      if (current_state == 0) { // save transition for shifted initial start, used if the initial state is in a cycle
         transitions_from_initial_state[current_exception] = to_state;
       }
       dfaStoreException(to_state, &current_exception[0]);
@@ -2051,6 +1974,112 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticF
   return less_than_auto;
 }
 
+/**
+ * The bdd node of a variable only depends on the sum of the coefficients of the preceding variables
+ * set to 1, nodes are shared among the sums instead of enumerating the 2^n assignments. Nodes are
+ * referred to by their root handles while building as the bdd table may be resized.
+ * State 0 is a non-accepting copy of the initial carry state and state 1 is the sink state.
+ */
+DFA_ptr BinaryIntAutomaton::MakeCarryDFA(ArithmeticFormula_ptr formula, const int min_carry, const int max_carry,
+                                         const CarryState initial_state, const CarryTransition& transition,
+                                         const CarryStatus& is_accepting, const bool is_sink_accepting) {
+  const auto& coeffs = formula->GetCoefficients();
+  const int num_of_carry_states = 2 * (max_carry - min_carry + 1);
+  const int num_of_states = num_of_carry_states + 2;
+  const int sink_state = 1;
+
+  unsigned max_states_allowed = 0x80000000;
+  unsigned mona_check = 8 * num_of_states;
+  CHECK_LE(mona_check, max_states_allowed);  // otherwise, MONA infinite loops
+
+  std::vector<int> active_variables;
+  long min_sum = 0, max_sum = 0;
+  for (int i = 0; i < (int)coeffs.size(); ++i) {
+    if (coeffs[i] > 0) {
+      max_sum += coeffs[i];
+    } else if (coeffs[i] < 0) {
+      min_sum += coeffs[i];
+    }
+    if (coeffs[i] != 0) {
+      active_variables.push_back(i);
+    }
+  }
+  const long sum_range = max_sum - min_sum + 1;
+
+  DFA_ptr carry_dfa = dfaMake(num_of_states);
+  bdd_manager* bddm = carry_dfa->bddm;
+
+  std::vector<int> state_indices(num_of_carry_states, -1);
+  std::vector<CarryState> carry_states;  // carry state of dfa state i + 2
+  auto get_state = [&](const CarryState& state) {
+    CHECK(state.carry >= min_carry and state.carry <= max_carry);
+    int& index = state_indices[2 * (state.carry - min_carry) + state.flag];
+    if (index == -1) {
+      index = carry_states.size() + 2;
+      carry_states.push_back(state);
+    }
+    return index;
+  };
+
+  std::unordered_map<long, unsigned> node_handles;  // (variable level, sum) to bdd root handle
+  std::function<unsigned(const CarryState&, const std::size_t, const int)> make_bdd =
+      [&](const CarryState& state, const std::size_t level, const int sum) {
+    const long key = level * sum_range + (sum - min_sum);
+    auto it = node_handles.find(key);
+    if (it != node_handles.end()) {
+      return it->second;
+    }
+    unsigned handle = 0;
+    if (level == active_variables.size()) {
+      CarryState next_state;
+      const int to_state = transition(state, sum, next_state) ? get_state(next_state) : sink_state;
+      bdd_find_leaf_hashed_add_root(bddm, to_state);
+      handle = BDD_LAST_HANDLE(bddm);
+    } else {
+      const int variable = active_variables[level];
+      const unsigned low = make_bdd(state, level + 1, sum);
+      const unsigned high = make_bdd(state, level + 1, sum + coeffs[variable]);
+      if (BDD_ROOT(bddm, low) == BDD_ROOT(bddm, high)) {
+        handle = low;
+      } else {
+        bdd_find_node_hashed_add_root(bddm, BDD_ROOT(bddm, low), BDD_ROOT(bddm, high), variable);
+        handle = BDD_LAST_HANDLE(bddm);
+      }
+    }
+    node_handles[key] = handle;
+    return handle;
+  };
+
+  std::vector<unsigned> state_handles;
+  bdd_find_leaf_hashed_add_root(bddm, sink_state);
+  const unsigned sink_handle = BDD_LAST_HANDLE(bddm);
+  get_state(initial_state);
+  // carry states are added while expanding
+  for (std::size_t i = 0; i < carry_states.size(); ++i) {
+    const CarryState state = carry_states[i];
+    node_handles.clear();
+    state_handles.push_back(make_bdd(state, 0, 0));
+  }
+
+  for (int s = 0; s < num_of_states; ++s) {
+    if (s == 0) {
+      carry_dfa->q[s] = BDD_ROOT(bddm, state_handles[0]);
+      carry_dfa->f[s] = -1;
+    } else if (s == sink_state or s - 2 >= (int)carry_states.size()) {
+      carry_dfa->q[s] = BDD_ROOT(bddm, sink_handle);
+      carry_dfa->f[s] = (s == sink_state and is_sink_accepting) ? 1 : -1;
+    } else {
+      carry_dfa->q[s] = BDD_ROOT(bddm, state_handles[s - 2]);
+      carry_dfa->f[s] = is_accepting(carry_states[s - 2]) ? 1 : -1;
+    }
+  }
+  carry_dfa->s = 0;
+
+  auto minimized_dfa = dfaMinimize(carry_dfa);
+  dfaFree(carry_dfa);
+  return minimized_dfa;
+}
+
 BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeLessThanOrEqual(ArithmeticFormula_ptr formula, bool is_natural_number) {
   auto less_than_formula = formula->clone();
   less_than_formula->SetConstant(less_than_formula->GetConstant() - 1);
@@ -2255,72 +2284,42 @@ bool BinaryIntAutomaton::is_accepting_binary_state(BinaryState_ptr binary_state,
   return false;
 }
 
+/**
+ * Marks the states that are on a cycle and reachable from the initial state without going through the sink state
+ */
 bool BinaryIntAutomaton::GetCycleStatus(std::map<int, bool>& cycle_status) {
-  std::map<int, int> disc;
-  std::map<int, int> low;
-  std::map<int, bool> is_stack_member;
-  std::vector<int> st;
-  std::vector<bool> path;
-  int time = 0;
+  const auto& graph = GetTransitionGraph();
+  const auto& is_in_cycle = GetCycleStates();
   int sink_state = GetSinkState();
+  int excluded_state = -1;
 
   if (sink_state > 0) {
-    disc[sink_state] = 0;  // avoid exploring sink state
-    is_stack_member[sink_state] = false;  // avoid looping to sink state
+    excluded_state = sink_state;  // avoid exploring sink state
     cycle_status[sink_state] = true;
   }
-  GetCycleStatus(this->dfa_->s, disc, low, st, is_stack_member, cycle_status, time);
-  DVLOG(VLOG_LEVEL) << cycle_status[-2] << " = [" << this->id_ << "]->getCycleStatus(<constants>)";
-  return cycle_status[-2];  // -2 is to keep if it is cyclic at all or not
-}
-
-void BinaryIntAutomaton::GetCycleStatus(int state, std::map<int, int>& disc, std::map<int, int>& low,
-                                        std::vector<int>& st, std::map<int, bool>& is_stack_member,
-                                        std::map<int, bool>& cycle_status, int& time) {
-  int next_state = 0;
-  std::vector<char> exception = { '0' };
-  int l, r;
-//  std::cout << "visiting: " << state << std::endl;
-  disc[state] = low[state] = time;
-  time++;
-  st.push_back(state);
-  is_stack_member[state] = true;
-
-  l = getNextState(state, exception);
-  exception[0] = '1';
-  r = getNextState(state, exception);
-
-  for (int b = 0; b < 2; b++) {
-    next_state = (b == 0) ? l : r;
-    if (disc.find(next_state) == disc.end()) {
-      GetCycleStatus(next_state, disc, low, st, is_stack_member, cycle_status, time);
-      low[state] = std::min(low[state], low[next_state]);
-    } else if (is_stack_member[next_state]) {
-      low[state] = std::min(low[state], disc[next_state]);
-    }
-  }
-
-  if (low[state] == disc[state]) {  // head of SCC
-    int current_state = st.back();
-
-    while (current_state != state) {
-      st.pop_back();
-      is_stack_member[current_state] = false;
-      cycle_status[current_state] = true;
+  std::vector<bool> is_discovered(this->dfa_->ns, false);
+  std::vector<int> states;
+  if (this->dfa_->s != excluded_state) {
+    is_discovered[this->dfa_->s] = true;
+    states.push_back(this->dfa_->s);
+  }
+  while (not states.empty()) {
+    int state = states.back();
+    states.pop_back();
+    if (is_in_cycle[state]) {
+      cycle_status[state] = true;
       cycle_status[-2] = true;
-      current_state = st.back();
     }
-
-    is_stack_member[current_state] = false;
-    st.pop_back();
-
-    if (current_state == l or current_state == r) {
-      cycle_status[current_state] = true;
-      cycle_status[-2] = true;
+    for (int i = graph.successor_offsets[state]; i < graph.successor_offsets[state + 1]; ++i) {
+      int next_state = graph.successors[i];
+      if (next_state != excluded_state and not is_discovered[next_state]) {
+        is_discovered[next_state] = true;
+        states.push_back(next_state);
+      }
     }
   }
-
-  return;
+  DVLOG(VLOG_LEVEL) << cycle_status[-2] << " = [" << this->id_ << "]->getCycleStatus(<constants>)";
+  return cycle_status[-2];  // -2 is to keep if it is cyclic at all or not
 }
 
 void BinaryIntAutomaton::GetConstants(std::map<int, bool>& cycle_status, std::vector<int>& constants) {
@@ -2594,8 +2593,8 @@ void BinaryIntAutomaton::add_print_label(std::ostream& out) {
   out << "  style = invis;\n  center = true;\n  margin = 0;\n";
   out << "  node[shape=plaintext];\n";
   out << " \"\"[label=\"";
-  for (auto& el : formula_->GetVariableCoefficientMap()) {
-    out << el.first << "\n";
+  for (auto& variable : formula_->GetVariables()) {
+    out << variable << "\n";
   }
   out << "\"]\n";
   out << " }";
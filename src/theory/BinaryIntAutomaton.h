@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -54,6 +55,47 @@ public:
   virtual ~BinaryIntAutomaton();
 
   virtual BinaryIntAutomaton_ptr clone() const;
+
+  /**
+   * Binary automaton format, the automaton followed by the number domain and the formula
+   */
+  template <class Archive>
+  void save(Archive& ar) const {
+    Automaton::save(ar);
+    ar(is_natural_number_);
+    bool has_formula = (formula_ != nullptr);
+    ar(has_formula);
+    if (has_formula) {
+      formula_->save(ar);
+    }
+  }
+
+  template <class Archive>
+  void load(Archive& ar) {
+    Automaton::load(ar);
+    ar(is_natural_number_);
+    bool has_formula = false;
+    ar(has_formula);
+    delete formula_;
+    formula_ = nullptr;
+    if (has_formula) {
+      formula_ = new ArithmeticFormula();
+      formula_->load(ar);
+    }
+  }
+
+  /**
+   * Writes the automaton in the binary automaton format
+   * @param file_name
+   */
+  void SaveToFile(const std::string& file_name) const;
+
+  /**
+   * Loads an automaton written by SaveToFile, the file is read in place from memory
+   * @param file_name
+   * @return
+   */
+  static BinaryIntAutomaton_ptr LoadFromFile(const std::string& file_name);
   // What about natural number parameter?
   virtual BinaryIntAutomaton_ptr MakeAutomaton(DFA_ptr dfa, Formula_ptr formula, const int number_of_variables);
 
@@ -114,8 +156,6 @@ protected:
   void decide_counting_schema(Eigen::SparseMatrix<BigInteger>& count_matrix) override;
 
   bool GetCycleStatus(std::map<int, bool>& cycle_status);
-  void GetCycleStatus(int state, std::map<int, int>& disc, std::map<int, int>& low, std::vector<int>& st,
-            std::map<int, bool>& is_stack_member, std::map<int, bool>& cycle_status, int& time);
 //  bool getConstants(std::vector<int>& constants);
 //  bool getConstants(int state, std::map<int, int>& disc, std::map<int, int>& low, std::vector<int>& st,
 //          std::map<int, bool>& is_stack_member, std::vector<bool>& path, std::vector<int>& constants, int& time);
@@ -134,6 +174,34 @@ protected:
     StateIndices(): i{-1}, ir{-1}, s{0}, sr{0} {}
   };
 
+  struct CarryState {
+    int carry;
+    bool flag; // accepting clone for integers
+  };
+
+  /**
+   * Sets the next state of a carry state on the symbols whose variables set to 1 have coefficients
+   * adding up to the sum, returns false if these symbols lead to the sink state
+   */
+  using CarryTransition = std::function<bool(const CarryState& state, const int sum, CarryState& next_state)>;
+  using CarryStatus = std::function<bool(const CarryState& state)>;
+
+  /**
+   * Builds the transition bdd of each carry state directly, one variable at a time, without
+   * enumerating the assignments of the variables
+   * @param formula
+   * @param min_carry
+   * @param max_carry
+   * @param initial_state
+   * @param transition
+   * @param is_accepting
+   * @param is_sink_accepting
+   * @return minimized dfa whose initial state is not accepting
+   */
+  static DFA_ptr MakeCarryDFA(ArithmeticFormula_ptr formula, const int min_carry, const int max_carry,
+                              const CarryState initial_state, const CarryTransition& transition,
+                              const CarryStatus& is_accepting, const bool is_sink_accepting);
+
   bool is_natural_number_;
   ArithmeticFormula_ptr formula_;
 private:
@@ -10,7 +10,7 @@
 namespace Vlab {
 namespace Theory {
 
-int DAGraph::name_counter = 0;
+thread_local int DAGraph::name_counter = 0;
 
 DAGraph::DAGraph() :
       graph (nullptr), startNode (nullptr), sinkNode (nullptr) {
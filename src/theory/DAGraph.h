@@ -64,7 +64,7 @@ protected:
 
 private:
   void findSCCs(int u, int *disc, int *low, std::stack<int> *st, bool *is_stack_member, int& time);
-  static int name_counter;
+  static thread_local int name_counter;
 };
 
 } /* namespace Theory */
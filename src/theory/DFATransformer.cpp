@@ -0,0 +1,226 @@
+/*
+ * DFATransformer.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "DFATransformer.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "Automaton.h"
+
+namespace Vlab {
+namespace Theory {
+
+DFATransformer::DFATransformer(const int num_of_states)
+    : num_of_states_ { num_of_states },
+      source_ { nullptr },
+      transitions_(num_of_states, -1),
+      statuses_(num_of_states, -1) {
+  CHECK_GT(num_of_states_, 0);
+}
+
+DFATransformer::~DFATransformer() {
+}
+
+DFATransformer::Node DFATransformer::MakeLeaf(const int state) {
+  CHECK(state >= 0 and state < num_of_states_) << "invalid state: " << state;
+  return AddNode( { BDD_LEAF_INDEX, state, state });
+}
+
+DFATransformer::Node DFATransformer::MakeNode(const int index, const Node low, const Node high) {
+  if (low == high) {
+    return low;
+  }
+  CHECK(index >= 0 and (unsigned) index < nodes_[low].index and (unsigned) index < nodes_[high].index)
+      << "variables are not in order at index: " << index;
+  return AddNode( { (unsigned) index, low, high });
+}
+
+DFATransformer::Node DFATransformer::MakePath(const std::vector<int>& indices, const std::vector<bool>& values,
+                                              const Node target, const Node otherwise) {
+  CHECK_EQ(indices.size(), values.size());
+  Node node = target;
+  for (int i = indices.size() - 1; i >= 0; --i) {
+    node = values[i] ? MakeNode(indices[i], otherwise, node) : MakeNode(indices[i], node, otherwise);
+  }
+  return node;
+}
+
+DFATransformer::Node DFATransformer::MakeTable(const std::vector<int>& indices, const std::vector<Node>& targets) {
+  CHECK_EQ((std::size_t) 1 << indices.size(), targets.size());
+  // halves the table bottom up, symbols that differ only in the last variable are next to each other
+  std::vector<Node> nodes = targets;
+  for (int i = indices.size() - 1; i >= 0; --i) {
+    const std::size_t size = nodes.size() / 2;
+    for (std::size_t j = 0; j < size; ++j) {
+      nodes[j] = MakeNode(indices[i], nodes[2 * j], nodes[2 * j + 1]);
+    }
+    nodes.resize(size);
+  }
+  return nodes[0];
+}
+
+DFATransformer::Node DFATransformer::Override(const Node base, const Node overlay, const int none_state) {
+  std::unordered_map<std::pair<Node, Node>, Node, NodePairHash> computed;
+  return Override(base, overlay, none_state, computed);
+}
+
+void DFATransformer::SetSource(const DFA_ptr source) {
+  source_ = source;
+  transformed_nodes_.clear();
+}
+
+void DFATransformer::SetIndexMap(const std::vector<int>& index_map) {
+  index_map_ = index_map;
+  transformed_nodes_.clear();
+}
+
+void DFATransformer::SetLeafMap(std::function<Node(const int)> leaf_map) {
+  leaf_map_ = leaf_map;
+  transformed_nodes_.clear();
+}
+
+DFATransformer::Node DFATransformer::Transform(const int source_state) {
+  CHECK(source_ != nullptr and source_state >= 0 and source_state < source_->ns) << "invalid source state: " << source_state;
+  return TransformNode(source_->q[source_state]);
+}
+
+int DFATransformer::GetNextState(const int source_state, const std::vector<int>& indices, const unsigned long symbol) const {
+  CHECK(source_ != nullptr and source_state >= 0 and source_state < source_->ns) << "invalid source state: " << source_state;
+  unsigned p, l, r, index; // BDD traversal variables
+  p = source_->q[source_state];
+  LOAD_lri(&source_->bddm->node_table[p], l, r, index);
+  // variables are visited in increasing order along a path
+  for (std::size_t i = 0; i < indices.size() and index != BDD_LEAF_INDEX; ++i) {
+    if (index != (unsigned) indices[i]) {
+      continue;
+    }
+    p = ((symbol >> (indices.size() - i - 1)) & 1UL) ? r : l;
+    LOAD_lri(&source_->bddm->node_table[p], l, r, index);
+  }
+  CHECK_EQ(BDD_LEAF_INDEX, index) << "symbol does not cover the variables of the source dfa";
+  return l;
+}
+
+void DFATransformer::SetState(const int state, const Node transitions, const int status) {
+  CHECK(state >= 0 and state < num_of_states_) << "invalid state: " << state;
+  transitions_[state] = transitions;
+  statuses_[state] = status;
+}
+
+DFA_ptr DFATransformer::Build(const int initial_state) {
+  CHECK(initial_state >= 0 and initial_state < num_of_states_) << "invalid initial state: " << initial_state;
+  std::lock_guard<std::recursive_mutex> lock(Automaton::GetMonaMutex());
+
+  // only the nodes reachable from the states are added to the bdd manager
+  std::vector<bool> is_used(nodes_.size(), false);
+  for (int s = 0; s < num_of_states_; ++s) {
+    CHECK_GE(transitions_[s], 0) << "transitions of state " << s << " are not set";
+    is_used[transitions_[s]] = true;
+  }
+  for (int i = nodes_.size() - 1; i >= 0; --i) {
+    if (is_used[i] and not IsLeaf(i)) {
+      is_used[nodes_[i].low] = true;
+      is_used[nodes_[i].high] = true;
+    }
+  }
+
+  DFA_ptr dfa = dfaMake(num_of_states_);
+  bdd_manager* bddm = dfa->bddm;
+  // bdd nodes may move as the node table grows, nodes are kept as root handles
+  std::vector<unsigned> handles(nodes_.size());
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    if (not is_used[i]) {
+      continue;
+    }
+    const NodeEntry& entry = nodes_[i];
+    if (entry.index == BDD_LEAF_INDEX) {
+      bdd_find_leaf_hashed_add_root(bddm, entry.low);
+    } else {
+      bdd_find_node_hashed_add_root(bddm, BDD_ROOT(bddm, handles[entry.low]), BDD_ROOT(bddm, handles[entry.high]),
+                                    entry.index);
+    }
+    handles[i] = BDD_LAST_HANDLE(bddm);
+  }
+  for (int s = 0; s < num_of_states_; ++s) {
+    dfa->q[s] = BDD_ROOT(bddm, handles[transitions_[s]]);
+    dfa->f[s] = statuses_[s];
+  }
+  dfa->s = initial_state;
+  return dfa;
+}
+
+DFATransformer::Node DFATransformer::AddNode(const NodeEntry& entry) {
+  auto it = node_ids_.find(entry);
+  if (it != node_ids_.end()) {
+    return it->second;
+  }
+  const Node node = nodes_.size();
+  nodes_.push_back(entry);
+  node_ids_[entry] = node;
+  return node;
+}
+
+bool DFATransformer::IsLeaf(const Node node) const {
+  return nodes_[node].index == BDD_LEAF_INDEX;
+}
+
+DFATransformer::Node DFATransformer::TransformNode(const unsigned p) {
+  auto it = transformed_nodes_.find(p);
+  if (it != transformed_nodes_.end()) {
+    return it->second;
+  }
+  unsigned l, r, index; // BDD traversal variables
+  LOAD_lri(&source_->bddm->node_table[p], l, r, index);
+  Node node = -1;
+  if (index == BDD_LEAF_INDEX) {
+    node = leaf_map_ ? leaf_map_(l) : MakeLeaf(l);
+  } else {
+    const int mapped_index = index < index_map_.size() ? index_map_[index] : index;
+    if (mapped_index == RESTRICT_TO_0) {
+      node = TransformNode(l);
+    } else if (mapped_index == RESTRICT_TO_1) {
+      node = TransformNode(r);
+    } else {
+      const Node low = TransformNode(l);
+      const Node high = TransformNode(r);
+      node = MakeNode(mapped_index, low, high);
+    }
+  }
+  transformed_nodes_[p] = node;
+  return node;
+}
+
+DFATransformer::Node DFATransformer::Override(const Node base, const Node overlay, const int none_state,
+                                              std::unordered_map<std::pair<Node, Node>, Node, NodePairHash>& computed) {
+  if (IsLeaf(overlay)) {
+    return (nodes_[overlay].low == none_state) ? base : overlay;
+  }
+  auto key = std::make_pair(base, overlay);
+  auto it = computed.find(key);
+  if (it != computed.end()) {
+    return it->second;
+  }
+  // entries are copied, the node table may grow in the recursive calls
+  const NodeEntry base_entry = nodes_[base];
+  const NodeEntry overlay_entry = nodes_[overlay];
+  const unsigned index = std::min(base_entry.index, overlay_entry.index);
+  const bool is_base_split = base_entry.index == index;
+  const bool is_overlay_split = overlay_entry.index == index;
+  const Node low = Override(is_base_split ? base_entry.low : base, is_overlay_split ? overlay_entry.low : overlay,
+                            none_state, computed);
+  const Node high = Override(is_base_split ? base_entry.high : base, is_overlay_split ? overlay_entry.high : overlay,
+                             none_state, computed);
+  const Node node = MakeNode(index, low, high);
+  computed[key] = node;
+  return node;
+}
+
+} /* namespace Theory */
+} /* namespace Vlab */
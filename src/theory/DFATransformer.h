@@ -0,0 +1,179 @@
+/*
+ * DFATransformer.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_THEORY_DFATRANSFORMER_H_
+#define SRC_THEORY_DFATRANSFORMER_H_
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+#include <mona/bdd.h>
+#include <mona/dfa.h>
+
+namespace Vlab {
+namespace Theory {
+
+using DFA_ptr = DFA*;
+
+/**
+ * Builds a dfa by rewriting the transition bdds of a source dfa node by node, instead of
+ * enumerating the paths of the bdds and rebuilding them from exception strings. Source variables
+ * can be renamed, fixed to a value or interleaved with new variables, and targets can be mapped
+ * to new states or to small bdds over new variables. Rewritten nodes are memoized, nodes that
+ * the source states share are rewritten once. Result bdds are reduced and hash consed, they are
+ * added to a mona bdd manager only when the dfa is built.
+ */
+class DFATransformer {
+public:
+  /**
+   * Node of the result bdds, children of a node are created before the node
+   */
+  using Node = int;
+
+  /**
+   * Index map entries that keep only the transitions where the source variable has the value
+   */
+  static const int RESTRICT_TO_0 = -1;
+  static const int RESTRICT_TO_1 = -2;
+
+  /**
+   * @param num_of_states number of states of the result
+   */
+  DFATransformer(const int num_of_states);
+  ~DFATransformer();
+
+  Node MakeLeaf(const int state);
+  /**
+   * @param index variable of the node, smaller than the variables of its children
+   * @param low
+   * @param high
+   * @return low when both children are the same
+   */
+  Node MakeNode(const int index, const Node low, const Node high);
+  /**
+   * @param indices variables of the path in increasing order
+   * @param values
+   * @param target node reached when the variables have the values
+   * @param otherwise node reached otherwise
+   * @return
+   */
+  Node MakePath(const std::vector<int>& indices, const std::vector<bool>& values, const Node target, const Node otherwise);
+  /**
+   * @param indices variables of the symbols in increasing order, the first one is the most significant bit
+   * @param targets 2^(number of indices) nodes, one per symbol
+   * @return
+   */
+  Node MakeTable(const std::vector<int>& indices, const std::vector<Node>& targets);
+  /**
+   * @param base
+   * @param overlay
+   * @param none_state
+   * @return transitions of overlay where it does not move to none_state, transitions of base elsewhere
+   */
+  Node Override(const Node base, const Node overlay, const int none_state);
+
+  /**
+   * Transitions of several source dfas can be combined in one result
+   * @param source dfa whose transitions are rewritten, not owned
+   */
+  void SetSource(const DFA_ptr source);
+  /**
+   * Source variable i becomes result variable index_map[i], variables past the end of the map keep their
+   * index. Kept variables must stay in order and before the variables of the leaf map.
+   * @param index_map
+   */
+  void SetIndexMap(const std::vector<int>& index_map);
+  /**
+   * @param leaf_map node that replaces a transition to a source state, default is the leaf of the same state
+   */
+  void SetLeafMap(std::function<Node(const int)> leaf_map);
+  /**
+   * @param source_state
+   * @return rewritten transitions of the source state
+   */
+  Node Transform(const int source_state);
+
+  /**
+   * @param source_state
+   * @param indices variables of the symbol, the first one is the most significant bit
+   * @param symbol
+   * @return next state of the source state on the symbol
+   */
+  int GetNextState(const int source_state, const std::vector<int>& indices, const unsigned long symbol) const;
+
+  /**
+   * @param state
+   * @param transitions
+   * @param status 1 for accepting, -1 for rejecting and 0 for don't care states
+   */
+  void SetState(const int state, const Node transitions, const int status);
+
+  /**
+   * Transitions of all states must be set
+   * @param initial_state
+   * @return a new dfa, owned by the caller
+   */
+  DFA_ptr Build(const int initial_state = 0);
+
+protected:
+  struct NodeEntry {
+    unsigned index;
+    int low;
+    int high;
+    bool operator==(const NodeEntry& other) const {
+      return index == other.index and low == other.low and high == other.high;
+    }
+  };
+
+  struct NodeEntryHash {
+    std::size_t operator()(const NodeEntry& entry) const {
+      std::size_t seed = std::hash<unsigned>()(entry.index);
+      seed ^= std::hash<int>()(entry.low) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      seed ^= std::hash<int>()(entry.high) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      return seed;
+    }
+  };
+
+  struct NodePairHash {
+    std::size_t operator()(const std::pair<Node, Node>& nodes) const {
+      return std::hash<long long>()(((long long) nodes.first << 32) ^ (unsigned) nodes.second);
+    }
+  };
+
+  Node AddNode(const NodeEntry& entry);
+  bool IsLeaf(const Node node) const;
+  Node TransformNode(const unsigned p);
+  Node Override(const Node base, const Node overlay, const int none_state,
+                std::unordered_map<std::pair<Node, Node>, Node, NodePairHash>& computed);
+
+  const int num_of_states_;
+
+  std::vector<NodeEntry> nodes_;
+  std::unordered_map<NodeEntry, Node, NodeEntryHash> node_ids_;
+
+  DFA_ptr source_;
+  std::vector<int> index_map_;
+  std::function<Node(const int)> leaf_map_;
+  /**
+   * Rewritten source nodes, cleared when the source, the index map or the leaf map changes
+   */
+  std::unordered_map<unsigned, Node> transformed_nodes_;
+
+  std::vector<Node> transitions_;
+  std::vector<int> statuses_;
+};
+
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* SRC_THEORY_DFATRANSFORMER_H_ */
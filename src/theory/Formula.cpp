@@ -7,33 +7,37 @@
 
 #include "Formula.h"
 
+#include <algorithm>
+#include <iterator>
 
 namespace Vlab {
 namespace Theory {
 
-Formula::Formula() {
+Formula::Formula()
+    : layout_ { GetEmptyLayout() } {
 }
 
 Formula::~Formula() {
 }
 
-Formula::Formula(const Formula& other) {
-	this->variable_coefficient_map_ = other.variable_coefficient_map_;
+Formula::Formula(const Formula& other)
+    : layout_ { other.layout_ },
+      coefficients_ { other.coefficients_ } {
 }
 
-int Formula::GetVariableIndex(std::string variable_name) const {
-	auto it = variable_coefficient_map_.find(variable_name);
-	if (it != variable_coefficient_map_.end()) {
-		return std::distance(variable_coefficient_map_.begin(), it);
+int Formula::GetVariableIndex(const std::string& variable_name) const {
+	auto it = layout_->indices.find(variable_name);
+	if (it != layout_->indices.end()) {
+		return it->second;
 	}
 	LOG(FATAL)<< "Variable '" << variable_name << "' is not in formula: " << str();
 	return -1;
 }
 
 int Formula::GetVariableIndex(const std::size_t param_index) const {
-  for (auto it = variable_coefficient_map_.begin(); it != variable_coefficient_map_.end(); ++it) {
-    if (it->second == param_index) {
-      return std::distance(variable_coefficient_map_.begin(), it);
+  for (std::size_t i = 0; i < coefficients_.size(); ++i) {
+    if (coefficients_[i] == static_cast<int>(param_index)) {
+      return i;
     }
   }
 
@@ -41,75 +45,159 @@ int Formula::GetVariableIndex(const std::size_t param_index) const {
   return -1;
 }
 
-int Formula::GetVariableCoefficient(std::string variable_name) const {
-	auto it = variable_coefficient_map_.find(variable_name);
-	if (it == variable_coefficient_map_.end()) {
-		LOG(FATAL)<< "Variable '" << variable_name << "' is not in formula: " << str();
-	}
-	return it->second;
+bool Formula::HasVariable(const std::string& variable_name) const {
+	return layout_->indices.find(variable_name) != layout_->indices.end();
 }
 
-void Formula::SetVariableCoefficient(std::string variable_name, int coeff) {
-	auto it = variable_coefficient_map_.find(variable_name);
-	if (it == variable_coefficient_map_.end()) {
-		LOG(FATAL)<< "Variable '" << variable_name << "' is not in formula: " << str();
-	}
-	it->second = coeff;
+int Formula::GetVariableCoefficient(const std::string& variable_name) const {
+	return coefficients_[GetVariableIndex(variable_name)];
+}
+
+void Formula::SetVariableCoefficient(const std::string& variable_name, int coeff) {
+	coefficients_[GetVariableIndex(variable_name)] = coeff;
 }
 
-std::string Formula::GetVariableAtIndex(const std::size_t index) const {
-	if (index >= variable_coefficient_map_.size()) {
+const std::string& Formula::GetVariableAtIndex(const std::size_t index) const {
+	if (index >= layout_->variables.size()) {
 		LOG(FATAL) << "Index out of range : " << index;
 	}
-	auto it = variable_coefficient_map_.begin();
-	std::advance(it, index);
-	return it->first;
+	return layout_->variables[index];
 }
 
 int Formula::GetNumberOfVariables() const {
-	return variable_coefficient_map_.size();
+	return layout_->variables.size();
 }
 
-std::map<std::string,int> Formula::GetVariableCoefficientMap() const {
-	return variable_coefficient_map_;
+const std::vector<std::string>& Formula::GetVariables() const {
+	return layout_->variables;
 }
 
-void Formula::SetVariableCoefficientMap(std::map<std::string, int>& coefficient_map) {
-	variable_coefficient_map_ = coefficient_map;
+const std::vector<int>& Formula::GetCoefficients() const {
+	return coefficients_;
 }
 
-void Formula::AddVariable(std::string name, int coefficient) {
-	if (variable_coefficient_map_.find(name) != variable_coefficient_map_.end()) {
-		LOG(FATAL)<< "Variable has already been added! : " << name;
+std::map<std::string,int> Formula::GetVariableCoefficientMap() const {
+	std::map<std::string, int> coefficient_map;
+	for (std::size_t i = 0; i < coefficients_.size(); ++i) {
+		coefficient_map.emplace_hint(coefficient_map.end(), layout_->variables[i], coefficients_[i]);
 	}
-	variable_coefficient_map_[name] = coefficient;
+	return coefficient_map;
 }
 
-void Formula::RemoveVariable(std::string var_name) {
-	variable_coefficient_map_.erase(var_name);
+void Formula::SetVariableCoefficientMap(const std::map<std::string, int>& coefficient_map) {
+	std::vector<std::string> variables;
+	coefficients_.clear();
+	variables.reserve(coefficient_map.size());
+	coefficients_.reserve(coefficient_map.size());
+	for (const auto& el : coefficient_map) {
+		variables.push_back(el.first);
+		coefficients_.push_back(el.second);
+	}
+	SetVariables(std::move(variables));
 }
 
-std::vector<int> Formula::GetCoefficients() const {
-	std::vector<int> coefficients;
-	for (const auto& el : variable_coefficient_map_) {
-		coefficients.push_back(el.second);
+void Formula::AddVariable(const std::string& name, int coefficient) {
+	if (HasVariable(name)) {
+		LOG(FATAL)<< "Variable has already been added! : " << name;
 	}
-	return coefficients;
+	std::vector<std::string> variables = layout_->variables;
+	auto it = std::lower_bound(variables.begin(), variables.end(), name);
+	const auto index = std::distance(variables.begin(), it);
+	variables.insert(it, name);
+	coefficients_.insert(coefficients_.begin() + index, coefficient);
+	SetVariables(std::move(variables));
+}
+
+void Formula::RemoveVariable(const std::string& var_name) {
+	auto it = layout_->indices.find(var_name);
+	if (it == layout_->indices.end()) {
+		return;
+	}
+	const int index = it->second;
+	std::vector<std::string> variables = layout_->variables;
+	variables.erase(variables.begin() + index);
+	coefficients_.erase(coefficients_.begin() + index);
+	SetVariables(std::move(variables));
 }
 
 void Formula::ResetCoefficients(int value) {
-	for (auto& el : variable_coefficient_map_) {
-		el.second = value;
-	}
+	std::fill(coefficients_.begin(), coefficients_.end(), value);
 }
 
 bool Formula::Simplify() {
-	if (variable_coefficient_map_.size() == 0) {
+	if (coefficients_.size() == 0) {
 		return true;
 	}
 
 	return true;
 }
 
+std::vector<int> Formula::MergeLayout(const Formula& other) {
+	const auto& other_variables = other.layout_->variables;
+	std::vector<int> index_map(other_variables.size());
+	if (layout_ == other.layout_) {
+		for (std::size_t i = 0; i < index_map.size(); ++i) {
+			index_map[i] = i;
+		}
+		return index_map;
+	}
+
+	// both layouts are sorted, merges them in one pass
+	const auto& variables = layout_->variables;
+	std::vector<std::string> merged_variables;
+	std::vector<int> merged_coefficients;
+	merged_variables.reserve(variables.size() + other_variables.size());
+	merged_coefficients.reserve(variables.size() + other_variables.size());
+	std::size_t i = 0, j = 0;
+	while (i < variables.size() or j < other_variables.size()) {
+		if (j == other_variables.size() or (i < variables.size() and variables[i] < other_variables[j])) {
+			merged_variables.push_back(variables[i]);
+			merged_coefficients.push_back(coefficients_[i]);
+			++i;
+		} else {
+			const bool is_shared = i < variables.size() and variables[i] == other_variables[j];
+			index_map[j] = merged_variables.size();
+			merged_variables.push_back(other_variables[j]);
+			merged_coefficients.push_back(is_shared ? coefficients_[i] : 0);
+			if (is_shared) {
+				++i;
+			}
+			++j;
+		}
+	}
+
+	coefficients_ = std::move(merged_coefficients);
+	if (merged_variables.size() == variables.size()) {
+		// other variables are already in this formula
+	} else if (merged_variables.size() == other_variables.size()) {
+		// variables of this formula are in the other formula, shares its layout
+		layout_ = other.layout_;
+	} else {
+		SetVariables(std::move(merged_variables));
+	}
+	return index_map;
+}
+
+void Formula::SetVariables(std::vector<std::string>&& variables) {
+	if (variables.empty()) {
+		layout_ = GetEmptyLayout();
+		return;
+	} else if (variables == layout_->variables) {
+		return;
+	}
+	auto layout = std::make_shared<VariableLayout>();
+	layout->variables = std::move(variables);
+	layout->indices.reserve(layout->variables.size());
+	for (std::size_t i = 0; i < layout->variables.size(); ++i) {
+		layout->indices.emplace(layout->variables[i], i);
+	}
+	layout_ = std::move(layout);
+}
+
+const Formula::VariableLayout_ptr& Formula::GetEmptyLayout() {
+	static const VariableLayout_ptr empty_layout = std::make_shared<VariableLayout>();
+	return empty_layout;
+}
+
 } /* namespace Theory */
 } /* namespace Vlab */
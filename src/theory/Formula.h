@@ -12,13 +12,17 @@
 #include <cstdlib>
 #include <locale>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
 #include <glog/logging.h>
 
+#include "../cereal/types/map.hpp"
+#include "../cereal/types/string.hpp"
 #include "../smt/ast.h"
 #include "../utils/Math.h"
 
@@ -42,24 +46,67 @@ public:
 	virtual Formula_ptr Complement() = 0;
 
 	virtual void MergeVariables(Formula_ptr) = 0;
-	int GetVariableIndex(std::string) const;
+	int GetVariableIndex(const std::string&) const;
 	int GetVariableIndex(const std::size_t param_index) const;
-	int GetVariableCoefficient(std::string) const;
-	void SetVariableCoefficient(std::string, int);
-	std::string GetVariableAtIndex(const std::size_t index) const;
+	bool HasVariable(const std::string&) const;
+	int GetVariableCoefficient(const std::string&) const;
+	void SetVariableCoefficient(const std::string&, int);
+	const std::string& GetVariableAtIndex(const std::size_t index) const;
 	int GetNumberOfVariables() const;
+	/**
+	 * @return variable names in index order, sorted by name
+	 */
+	const std::vector<std::string>& GetVariables() const;
+	/**
+	 * @return coefficients in index order
+	 */
+	const std::vector<int>& GetCoefficients() const;
 	std::map<std::string,int> GetVariableCoefficientMap() const;
-	void SetVariableCoefficientMap(std::map<std::string, int>& coefficient_map);
-	void AddVariable(std::string,int);
-	void RemoveVariable(std::string);
-	std::vector<int> GetCoefficients() const;
+	void SetVariableCoefficientMap(const std::map<std::string, int>& coefficient_map);
+	void AddVariable(const std::string&, int);
+	void RemoveVariable(const std::string&);
 	virtual void ResetCoefficients(int coeff = 0);
 
 	virtual bool UpdateMixedConstraintRelations() = 0;
 	virtual bool Simplify();
 
+	template <class Archive>
+	void save(Archive& ar) const {
+		ar(GetVariableCoefficientMap());
+	}
+
+	template <class Archive>
+	void load(Archive& ar) {
+		std::map<std::string, int> coefficient_map;
+		ar(coefficient_map);
+		SetVariableCoefficientMap(coefficient_map);
+	}
+
 protected:
-	std::map<std::string,int> variable_coefficient_map_;
+	/**
+	 * Sorted variable names and their indices. Layouts are immutable and shared by the copies of a
+	 * formula and by the formulas merged into it, a formula makes its own layout when it changes
+	 * its variables.
+	 */
+	struct VariableLayout {
+		std::vector<std::string> variables;
+		std::unordered_map<std::string, int> indices;
+	};
+	using VariableLayout_ptr = std::shared_ptr<const VariableLayout>;
+
+	/**
+	 * Adds the variables of the other formula with coefficient 0
+	 * @param other
+	 * @return index of each variable of the other formula in this formula
+	 */
+	std::vector<int> MergeLayout(const Formula& other);
+	void SetVariables(std::vector<std::string>&& variables);
+
+	VariableLayout_ptr layout_;
+	std::vector<int> coefficients_;
+
+private:
+	static const VariableLayout_ptr& GetEmptyLayout();
 };
 
 } /* namespace Theory */
@@ -10,7 +10,7 @@
 namespace Vlab {
 namespace Theory {
 
-int Graph::name_counter = 0;
+thread_local int Graph::name_counter = 0;
 
 Graph::Graph() :
       startNode (nullptr), sinkNode (nullptr) {
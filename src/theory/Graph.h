@@ -71,7 +71,7 @@ protected:
   GraphNodeMap nodes;
 
 private:
-  static int name_counter;
+  static thread_local int name_counter;
 };
 
 } /* namespace Theory */
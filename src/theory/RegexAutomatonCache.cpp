@@ -0,0 +1,227 @@
+/*
+ * RegexAutomatonCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "RegexAutomatonCache.h"
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+
+#include "StringAutomaton.h"
+
+namespace Vlab {
+namespace Theory {
+
+RegexAutomatonCache::RegexAutomatonCache()
+    : capacity_ { 0 }, num_of_states_ { 0 }, num_of_hits_ { 0 }, num_of_misses_ { 0 } {
+}
+
+RegexAutomatonCache::~RegexAutomatonCache() {
+  // runs at exit, the MONA lock may already be destroyed
+  for (auto& entry : entries_) {
+    delete entry.regex_auto;
+  }
+}
+
+StringAutomaton_ptr RegexAutomatonCache::Get(const std::string& key) {
+  std::lock_guard<std::recursive_mutex> lock(Automaton::GetMonaMutex());
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    ++num_of_misses_;
+    return nullptr;
+  }
+  ++num_of_hits_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->regex_auto->clone();
+}
+
+void RegexAutomatonCache::Put(const std::string& key, const StringAutomaton_ptr regex_auto) {
+  std::lock_guard<std::recursive_mutex> lock(Automaton::GetMonaMutex());
+  const std::size_t num_of_states = regex_auto->getDFA()->ns;
+  if (num_of_states > capacity_ or index_.find(key) != index_.end()) {
+    return;
+  }
+  Evict(num_of_states);
+  entries_.push_front(Entry { key, regex_auto->clone(), num_of_states });
+  index_[key] = entries_.begin();
+  num_of_states_ += num_of_states;
+}
+
+void RegexAutomatonCache::SetCapacity(const std::size_t num_of_states) {
+  std::lock_guard<std::recursive_mutex> lock(Automaton::GetMonaMutex());
+  capacity_ = num_of_states;
+  Evict(0);
+}
+
+void RegexAutomatonCache::Clear() {
+  std::lock_guard<std::recursive_mutex> lock(Automaton::GetMonaMutex());
+  for (auto& entry : entries_) {
+    delete entry.regex_auto;
+  }
+  entries_.clear();
+  index_.clear();
+  num_of_states_ = 0;
+}
+
+std::size_t RegexAutomatonCache::GetNumOfHits() const {
+  std::lock_guard<std::recursive_mutex> lock(Automaton::GetMonaMutex());
+  return num_of_hits_;
+}
+
+std::size_t RegexAutomatonCache::GetNumOfMisses() const {
+  std::lock_guard<std::recursive_mutex> lock(Automaton::GetMonaMutex());
+  return num_of_misses_;
+}
+
+std::string RegexAutomatonCache::GetKey(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables,
+                                        std::unordered_map<Util::RegularExpression_ptr, std::string>& keys) {
+  return std::to_string(number_of_bdd_variables) + "/" + GetCanonicalForm(regular_expression, keys);
+}
+
+/**
+ * Every form starts with a tag and carries its own length or arity so that forms of
+ * operands can be concatenated without separators
+ */
+std::string RegexAutomatonCache::GetCanonicalForm(Util::RegularExpression_ptr regular_expression,
+                                                  std::unordered_map<Util::RegularExpression_ptr, std::string>& keys) {
+  auto it = keys.find(regular_expression);
+  if (it != keys.end()) {
+    return it->second;
+  }
+
+  std::stringstream form;
+  switch (regular_expression->type()) {
+    case Util::RegularExpression::Type::UNION:
+    case Util::RegularExpression::Type::INTERSECTION: {
+      std::vector<Util::RegularExpression_ptr> operands;
+      CollectOperands(regular_expression, regular_expression->type(), operands);
+      std::vector<std::string> operand_forms;
+      for (auto operand : operands) {
+        operand_forms.push_back(GetCanonicalForm(operand, keys));
+      }
+      std::sort(operand_forms.begin(), operand_forms.end());
+      operand_forms.erase(std::unique(operand_forms.begin(), operand_forms.end()), operand_forms.end());
+      if (operand_forms.size() == 1) {
+        form << operand_forms[0];
+      } else {
+        form << ((Util::RegularExpression::Type::UNION == regular_expression->type()) ? 'U' : 'I') << operand_forms.size() << ':';
+        for (auto& operand_form : operand_forms) {
+          form << operand_form;
+        }
+      }
+      break;
+    }
+    case Util::RegularExpression::Type::CONCATENATION: {
+      std::vector<Util::RegularExpression_ptr> operands;
+      CollectOperands(regular_expression, Util::RegularExpression::Type::CONCATENATION, operands);
+      std::vector<std::string> operand_forms;
+      std::string literal;
+      auto add_literal = [&operand_forms, &literal]() {
+        if (not literal.empty()) {
+          operand_forms.push_back("S" + std::to_string(literal.size()) + ":" + literal);
+          literal.clear();
+        }
+      };
+      for (auto operand : operands) {
+        if (Util::RegularExpression::Type::CHAR == operand->type()) {
+          literal += operand->get_character();
+        } else if (Util::RegularExpression::Type::STRING == operand->type()) {
+          literal += operand->get_string();
+        } else {
+          add_literal();
+          operand_forms.push_back(GetCanonicalForm(operand, keys));
+        }
+      }
+      add_literal();
+      if (operand_forms.empty()) {
+        form << "S0:";
+      } else if (operand_forms.size() == 1) {
+        form << operand_forms[0];
+      } else {
+        form << 'C' << operand_forms.size() << ':';
+        for (auto& operand_form : operand_forms) {
+          form << operand_form;
+        }
+      }
+      break;
+    }
+    case Util::RegularExpression::Type::OPTIONAL:
+      form << 'O' << GetCanonicalForm(regular_expression->get_expr1(), keys);
+      break;
+    case Util::RegularExpression::Type::REPEAT_STAR:
+      form << '*' << GetCanonicalForm(regular_expression->get_expr1(), keys);
+      break;
+    case Util::RegularExpression::Type::REPEAT_PLUS:
+      form << '+' << GetCanonicalForm(regular_expression->get_expr1(), keys);
+      break;
+    case Util::RegularExpression::Type::REPEAT_MIN:
+      form << 'M' << regular_expression->get_min() << ':' << GetCanonicalForm(regular_expression->get_expr1(), keys);
+      break;
+    case Util::RegularExpression::Type::REPEAT_MINMAX:
+      form << 'R' << regular_expression->get_min() << ',' << regular_expression->get_max() << ':'
+           << GetCanonicalForm(regular_expression->get_expr1(), keys);
+      break;
+    case Util::RegularExpression::Type::COMPLEMENT:
+      form << '~' << GetCanonicalForm(regular_expression->get_expr1(), keys);
+      break;
+    case Util::RegularExpression::Type::CHAR:
+      form << "S1:" << regular_expression->get_character();
+      break;
+    case Util::RegularExpression::Type::STRING: {
+      std::string value = regular_expression->get_string();
+      form << 'S' << value.size() << ':' << value;
+      break;
+    }
+    case Util::RegularExpression::Type::CHAR_RANGE:
+      form << '[' << regular_expression->get_from_character() << regular_expression->get_to_character();
+      break;
+    case Util::RegularExpression::Type::ANYCHAR:
+      form << '.';
+      break;
+    case Util::RegularExpression::Type::EMPTY:
+      form << '#';
+      break;
+    case Util::RegularExpression::Type::ANYSTRING:
+      form << '@';
+      break;
+    default: {
+      std::string value = regular_expression->str();
+      form << 'X' << value.size() << ':' << value;
+      break;
+    }
+  }
+
+  std::string canonical_form = form.str();
+  keys[regular_expression] = canonical_form;
+  return canonical_form;
+}
+
+void RegexAutomatonCache::CollectOperands(Util::RegularExpression_ptr regular_expression,
+                                          const Util::RegularExpression::Type type,
+                                          std::vector<Util::RegularExpression_ptr>& operands) {
+  if (type == regular_expression->type()) {
+    CollectOperands(regular_expression->get_expr1(), type, operands);
+    CollectOperands(regular_expression->get_expr2(), type, operands);
+  } else {
+    operands.push_back(regular_expression);
+  }
+}
+
+void RegexAutomatonCache::Evict(const std::size_t num_of_states) {
+  while (not entries_.empty() and num_of_states_ + num_of_states > capacity_) {
+    auto& entry = entries_.back();
+    num_of_states_ -= entry.num_of_states;
+    index_.erase(entry.key);
+    delete entry.regex_auto;
+    entries_.pop_back();
+  }
+}
+
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,99 @@
+/*
+ * RegexAutomatonCache.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_THEORY_REGEXAUTOMATONCACHE_H_
+#define SRC_THEORY_REGEXAUTOMATONCACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "../utils/RegularExpression.h"
+
+namespace Vlab {
+namespace Theory {
+
+class StringAutomaton;
+using StringAutomaton_ptr = StringAutomaton*;
+
+/**
+ * Process wide cache of regular expression automata, bounded by the total number of dfa states
+ * and evicting the least recently used automata first. Operations hold the MONA lock as entries
+ * are cloned and freed.
+ */
+class RegexAutomatonCache {
+public:
+  RegexAutomatonCache();
+  ~RegexAutomatonCache();
+
+  /**
+   * @param key
+   * @return a copy of the cached automaton, nullptr on a miss
+   */
+  StringAutomaton_ptr Get(const std::string& key);
+
+  /**
+   * Stores a copy of the automaton, automata larger than the capacity are not stored
+   * @param key
+   * @param regex_auto
+   */
+  void Put(const std::string& key, const StringAutomaton_ptr regex_auto);
+
+  /**
+   * Sets the maximum total number of dfa states, 0 disables the cache
+   * @param num_of_states
+   */
+  void SetCapacity(const std::size_t num_of_states);
+  void Clear();
+
+  std::size_t GetNumOfHits() const;
+  std::size_t GetNumOfMisses() const;
+
+  /**
+   * Canonical form of a regular expression, concatenations are flattened with adjacent
+   * literals merged, operands of unions and intersections are flattened and sorted.
+   * Regular expressions with the same key denote the same language.
+   * @param regular_expression
+   * @param number_of_bdd_variables
+   * @param keys canonical forms of already visited sub-expressions
+   * @return canonical form
+   */
+  static std::string GetKey(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables,
+                            std::unordered_map<Util::RegularExpression_ptr, std::string>& keys);
+
+protected:
+  static std::string GetCanonicalForm(Util::RegularExpression_ptr regular_expression,
+                                      std::unordered_map<Util::RegularExpression_ptr, std::string>& keys);
+  static void CollectOperands(Util::RegularExpression_ptr regular_expression, const Util::RegularExpression::Type type,
+                              std::vector<Util::RegularExpression_ptr>& operands);
+  void Evict(const std::size_t num_of_states);
+
+  struct Entry {
+    std::string key;
+    StringAutomaton_ptr regex_auto;
+    std::size_t num_of_states;
+  };
+
+  std::size_t capacity_;
+  std::size_t num_of_states_;
+  std::size_t num_of_hits_;
+  std::size_t num_of_misses_;
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* SRC_THEORY_REGEXAUTOMATONCACHE_H_ */
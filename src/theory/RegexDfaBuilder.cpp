@@ -0,0 +1,284 @@
+/*
+ * RegexDfaBuilder.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "RegexDfaBuilder.h"
+
+#include <algorithm>
+
+namespace Vlab {
+namespace Theory {
+
+RegexDfaBuilder::RegexDfaBuilder(const int number_of_bdd_variables)
+    : number_of_bdd_variables_ { number_of_bdd_variables },
+      alphabet_size_ { 1UL << number_of_bdd_variables },
+      nfa_accepting_state_ { -1 },
+      closure_mark_ { 0 } {
+  CHECK(number_of_bdd_variables_ > 0 and number_of_bdd_variables_ <= MAX_NUM_OF_BDD_VARIABLES);
+}
+
+RegexDfaBuilder::~RegexDfaBuilder() {
+}
+
+bool RegexDfaBuilder::IsSupported(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables) {
+  if (number_of_bdd_variables <= 0 or number_of_bdd_variables > MAX_NUM_OF_BDD_VARIABLES) {
+    return false;
+  }
+  switch (regular_expression->type()) {
+    case Util::RegularExpression::Type::UNION:
+    case Util::RegularExpression::Type::CONCATENATION:
+      return IsSupported(regular_expression->get_expr1(), number_of_bdd_variables)
+          and IsSupported(regular_expression->get_expr2(), number_of_bdd_variables);
+    case Util::RegularExpression::Type::OPTIONAL:
+    case Util::RegularExpression::Type::REPEAT_STAR:
+    case Util::RegularExpression::Type::REPEAT_PLUS:
+      return IsSupported(regular_expression->get_expr1(), number_of_bdd_variables);
+    case Util::RegularExpression::Type::CHAR_RANGE: {
+      // ranges are built over the unsigned values of the characters, as in StringAutomaton::MakeCharRange
+      const char from = regular_expression->get_from_character();
+      const char to = regular_expression->get_to_character();
+      const unsigned long alphabet_size = 1UL << number_of_bdd_variables;
+      return from >= 0 and to >= 0 and (unsigned long) std::max(from, to) < alphabet_size;
+    }
+    case Util::RegularExpression::Type::CHAR:
+    case Util::RegularExpression::Type::ANYCHAR:
+    case Util::RegularExpression::Type::EMPTY:
+    case Util::RegularExpression::Type::STRING:
+    case Util::RegularExpression::Type::ANYSTRING:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool RegexDfaBuilder::Build(Util::RegularExpression_ptr regular_expression, const std::size_t max_num_of_states) {
+  nfa_states_.clear();
+  dfa_state_ids_.clear();
+  dfa_states_.clear();
+  transitions_.clear();
+  is_accepting_.clear();
+
+  auto fragment = AddFragment(regular_expression);
+  nfa_accepting_state_ = fragment.second;
+  closure_marks_.assign(nfa_states_.size(), -1);
+  closure_mark_ = 0;
+
+  GetDfaState(GetClosure( { fragment.first }));
+  std::vector<std::vector<int>> moves(alphabet_size_);
+  for (std::size_t dfa_state = 0; dfa_state < dfa_states_.size(); ++dfa_state) {
+    if (dfa_states_.size() > max_num_of_states) {
+      return false;
+    }
+    for (auto& move : moves) {
+      move.clear();
+    }
+    for (int nfa_state : dfa_states_[dfa_state]) {
+      for (auto& edge : nfa_states_[nfa_state].edges) {
+        for (unsigned long symbol = 0; symbol < alphabet_size_; ++symbol) {
+          if (edge.first[symbol]) {
+            moves[symbol].push_back(edge.second);
+          }
+        }
+      }
+    }
+
+    // symbols of a character class move to the same set, its closure is computed once
+    std::map<std::vector<int>, int> next_states;
+    for (unsigned long symbol = 0; symbol < alphabet_size_; ++symbol) {
+      auto& move = moves[symbol];
+      if (move.empty()) {
+        continue;
+      }
+      std::sort(move.begin(), move.end());
+      move.erase(std::unique(move.begin(), move.end()), move.end());
+      auto it = next_states.find(move);
+      int next_state = -1;
+      if (it == next_states.end()) {
+        next_state = GetDfaState(GetClosure(move));
+        next_states[move] = next_state;
+      } else {
+        next_state = it->second;
+      }
+      transitions_[dfa_state].push_back(std::make_pair(symbol, next_state));
+    }
+  }
+
+  // sink state
+  transitions_.push_back(std::vector<std::pair<unsigned long, int>>());
+  is_accepting_.push_back(false);
+  return true;
+}
+
+int RegexDfaBuilder::GetNumOfStates() const {
+  return transitions_.size();
+}
+
+int RegexDfaBuilder::GetSinkState() const {
+  return transitions_.size() - 1;
+}
+
+bool RegexDfaBuilder::IsAcceptingState(const int state) const {
+  return is_accepting_[state];
+}
+
+const std::vector<std::pair<unsigned long, int>>& RegexDfaBuilder::GetTransitions(const int state) const {
+  return transitions_[state];
+}
+
+std::pair<int, int> RegexDfaBuilder::AddFragment(Util::RegularExpression_ptr regular_expression) {
+  switch (regular_expression->type()) {
+    case Util::RegularExpression::Type::UNION: {
+      auto fragment1 = AddFragment(regular_expression->get_expr1());
+      auto fragment2 = AddFragment(regular_expression->get_expr2());
+      int start = AddNfaState();
+      int accept = AddNfaState();
+      nfa_states_[start].epsilons.push_back(fragment1.first);
+      nfa_states_[start].epsilons.push_back(fragment2.first);
+      nfa_states_[fragment1.second].epsilons.push_back(accept);
+      nfa_states_[fragment2.second].epsilons.push_back(accept);
+      return std::make_pair(start, accept);
+    }
+    case Util::RegularExpression::Type::CONCATENATION: {
+      auto fragment1 = AddFragment(regular_expression->get_expr1());
+      auto fragment2 = AddFragment(regular_expression->get_expr2());
+      nfa_states_[fragment1.second].epsilons.push_back(fragment2.first);
+      return std::make_pair(fragment1.first, fragment2.second);
+    }
+    case Util::RegularExpression::Type::OPTIONAL:
+    case Util::RegularExpression::Type::REPEAT_STAR:
+    case Util::RegularExpression::Type::REPEAT_PLUS: {
+      auto fragment = AddFragment(regular_expression->get_expr1());
+      int start = AddNfaState();
+      int accept = AddNfaState();
+      nfa_states_[start].epsilons.push_back(fragment.first);
+      nfa_states_[fragment.second].epsilons.push_back(accept);
+      if (Util::RegularExpression::Type::REPEAT_PLUS != regular_expression->type()) {
+        nfa_states_[start].epsilons.push_back(accept);
+      }
+      if (Util::RegularExpression::Type::OPTIONAL != regular_expression->type()) {
+        nfa_states_[fragment.second].epsilons.push_back(fragment.first);
+      }
+      return std::make_pair(start, accept);
+    }
+    case Util::RegularExpression::Type::CHAR: {
+      Symbols symbols;
+      symbols.set(GetSymbol(regular_expression->get_character()));
+      return AddSymbolsFragment(symbols);
+    }
+    case Util::RegularExpression::Type::CHAR_RANGE: {
+      unsigned long from = (unsigned long) regular_expression->get_from_character();
+      unsigned long to = (unsigned long) regular_expression->get_to_character();
+      if (from > to) {
+        std::swap(from, to);
+      }
+      Symbols symbols;
+      for (unsigned long symbol = from; symbol <= to; ++symbol) {
+        symbols.set(symbol);
+      }
+      return AddSymbolsFragment(symbols);
+    }
+    case Util::RegularExpression::Type::ANYCHAR: {
+      Symbols symbols;
+      for (unsigned long symbol = 0; symbol < alphabet_size_; ++symbol) {
+        symbols.set(symbol);
+      }
+      return AddSymbolsFragment(symbols);
+    }
+    case Util::RegularExpression::Type::EMPTY: {
+      int start = AddNfaState();
+      int accept = AddNfaState();
+      return std::make_pair(start, accept);
+    }
+    case Util::RegularExpression::Type::STRING: {
+      int start = AddNfaState();
+      int accept = start;
+      for (char c : regular_expression->get_string()) {
+        Symbols symbols;
+        symbols.set(GetSymbol(c));
+        int next = AddNfaState();
+        nfa_states_[accept].edges.push_back(std::make_pair(symbols, next));
+        accept = next;
+      }
+      return std::make_pair(start, accept);
+    }
+    case Util::RegularExpression::Type::ANYSTRING: {
+      Symbols symbols;
+      for (unsigned long symbol = 0; symbol < alphabet_size_; ++symbol) {
+        symbols.set(symbol);
+      }
+      int state = AddNfaState();
+      nfa_states_[state].edges.push_back(std::make_pair(symbols, state));
+      return std::make_pair(state, state);
+    }
+    default:
+      LOG(FATAL)<< "Unsupported regular expression" << *regular_expression;
+      break;
+  }
+  return std::make_pair(-1, -1);
+}
+
+std::pair<int, int> RegexDfaBuilder::AddSymbolsFragment(const Symbols& symbols) {
+  int start = AddNfaState();
+  int accept = AddNfaState();
+  nfa_states_[start].edges.push_back(std::make_pair(symbols, accept));
+  return std::make_pair(start, accept);
+}
+
+int RegexDfaBuilder::AddNfaState() {
+  nfa_states_.push_back(NfaState());
+  return nfa_states_.size() - 1;
+}
+
+/**
+ * Characters are encoded with their lowest bits, as in Automaton::GetBinaryStringMSB
+ */
+unsigned long RegexDfaBuilder::GetSymbol(const char c) const {
+  return ((unsigned long) c) & (alphabet_size_ - 1);
+}
+
+std::vector<int> RegexDfaBuilder::GetClosure(std::vector<int> nfa_states) {
+  ++closure_mark_;
+  std::vector<int> closure;
+  for (int nfa_state : nfa_states) {
+    if (closure_marks_[nfa_state] != closure_mark_) {
+      closure_marks_[nfa_state] = closure_mark_;
+      closure.push_back(nfa_state);
+    }
+  }
+  for (std::size_t i = 0; i < closure.size(); ++i) {
+    for (int next_state : nfa_states_[closure[i]].epsilons) {
+      if (closure_marks_[next_state] != closure_mark_) {
+        closure_marks_[next_state] = closure_mark_;
+        closure.push_back(next_state);
+      }
+    }
+  }
+  // states with only epsilon moves do not change the language of the set, dropping them lets
+  // branches that end in the same states share a dfa state
+  closure.erase(std::remove_if(closure.begin(), closure.end(), [this](int nfa_state) {
+    return nfa_states_[nfa_state].edges.empty() and nfa_state != nfa_accepting_state_;
+  }), closure.end());
+  std::sort(closure.begin(), closure.end());
+  return closure;
+}
+
+int RegexDfaBuilder::GetDfaState(std::vector<int> nfa_states) {
+  auto it = dfa_state_ids_.find(nfa_states);
+  if (it != dfa_state_ids_.end()) {
+    return it->second;
+  }
+  const int dfa_state = dfa_states_.size();
+  is_accepting_.push_back(std::binary_search(nfa_states.begin(), nfa_states.end(), nfa_accepting_state_));
+  transitions_.push_back(std::vector<std::pair<unsigned long, int>>());
+  dfa_state_ids_[nfa_states] = dfa_state;
+  dfa_states_.push_back(std::move(nfa_states));
+  return dfa_state;
+}
+
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,109 @@
+/*
+ * RegexDfaBuilder.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_THEORY_REGEXDFABUILDER_H_
+#define SRC_THEORY_REGEXDFABUILDER_H_
+
+#include <bitset>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "../utils/RegularExpression.h"
+
+namespace Vlab {
+namespace Theory {
+
+/**
+ * Compiles a regular expression into a deterministic transition table in one pass, without
+ * building an automaton per sub-expression. The expression is translated into an nfa whose
+ * edges are labelled with character sets, so that a character class or an alternation of
+ * characters is a single edge, and the nfa is determinized with the subset construction.
+ * Alternations of strings share their prefixes in the resulting table as in a trie.
+ * The table is not minimized, callers minimize it once.
+ */
+class RegexDfaBuilder {
+public:
+  /**
+   * Largest alphabet the builder supports, 2^number_of_bdd_variables symbols
+   */
+  static const int MAX_NUM_OF_BDD_VARIABLES = 8;
+
+  RegexDfaBuilder(const int number_of_bdd_variables);
+  ~RegexDfaBuilder();
+
+  /**
+   * Unions, concatenations, optionals, stars and pluses over characters, character ranges,
+   * strings, any char, any string and the empty language are supported
+   * @param regular_expression
+   * @param number_of_bdd_variables
+   * @return true if the builder can compile the regular expression
+   */
+  static bool IsSupported(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables);
+
+  /**
+   * @param regular_expression a supported regular expression
+   * @param max_num_of_states the construction is abandoned once the table grows larger
+   * @return true if the table is built within the state limit
+   */
+  bool Build(Util::RegularExpression_ptr regular_expression, const std::size_t max_num_of_states);
+
+  /**
+   * @return number of states including the sink state, state 0 is the initial state
+   */
+  int GetNumOfStates() const;
+  int GetSinkState() const;
+  bool IsAcceptingState(const int state) const;
+
+  /**
+   * @param state
+   * @return (symbol, next state) pairs ordered by symbol, symbols that are not listed lead to the sink state
+   */
+  const std::vector<std::pair<unsigned long, int>>& GetTransitions(const int state) const;
+
+protected:
+  using Symbols = std::bitset<(1 << MAX_NUM_OF_BDD_VARIABLES)>;
+
+  struct NfaState {
+    std::vector<std::pair<Symbols, int>> edges;
+    std::vector<int> epsilons;
+  };
+
+  /**
+   * Thompson construction, every fragment has a single start and a single accepting state
+   * @param regular_expression
+   * @return start and accepting states of the fragment
+   */
+  std::pair<int, int> AddFragment(Util::RegularExpression_ptr regular_expression);
+  std::pair<int, int> AddSymbolsFragment(const Symbols& symbols);
+  int AddNfaState();
+  unsigned long GetSymbol(const char c) const;
+  std::vector<int> GetClosure(std::vector<int> nfa_states);
+  int GetDfaState(std::vector<int> nfa_states);
+
+  const int number_of_bdd_variables_;
+  const unsigned long alphabet_size_;
+  std::vector<NfaState> nfa_states_;
+  int nfa_accepting_state_;
+  std::vector<int> closure_marks_;
+  int closure_mark_;
+
+  std::map<std::vector<int>, int> dfa_state_ids_;
+  std::vector<std::vector<int>> dfa_states_;
+  std::vector<std::vector<std::pair<unsigned long, int>>> transitions_;
+  std::vector<bool> is_accepting_;
+};
+
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* SRC_THEORY_REGEXDFABUILDER_H_ */
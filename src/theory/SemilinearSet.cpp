@@ -191,6 +191,44 @@ void SemilinearSet::clear() {
   periodic_constants.clear();
 }
 
+bool SemilinearSet::IsMember(const BigInteger& value) {
+  for (auto c : constants) {
+    if (value == c) {
+      return true;
+    }
+  }
+  for (auto r : periodic_constants) {
+    BigInteger first = C + r;
+    if (value == first) {
+      return true;
+    } else if (R > 0 and value > first and ((value - first) % R) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+BigInteger SemilinearSet::CountValuesUpTo(const BigInteger& max_value) {
+  BigInteger count = 0;
+  for (auto c : constants) {
+    if (c <= max_value) {
+      ++count;
+    }
+  }
+  for (auto r : periodic_constants) {
+    BigInteger first = C + r;
+    if (first > max_value) {
+      continue;
+    }
+    if (R > 0) {
+      count += (max_value - first) / R + 1; // first + k * R <= max_value, k >= 0
+    } else {
+      ++count;
+    }
+  }
+  return count;
+}
+
 std::ostream& operator<<(std::ostream& os, const SemilinearSet& semilinear_set) {
   return os << semilinear_set.str();
 }
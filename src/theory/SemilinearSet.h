@@ -53,6 +53,21 @@ public:
   bool has_constants();
   void clear();
 
+  /**
+   * Checks membership without enumerating the set
+   * @param value
+   * @return
+   */
+  bool IsMember(const BigInteger& value);
+
+  /**
+   * Counts members that are less than or equal to the given value in closed form,
+   * linear in the number of constants and periodic constants
+   * @param max_value
+   * @return
+   */
+  BigInteger CountValuesUpTo(const BigInteger& max_value);
+
   friend std::ostream& operator<<(std::ostream& os, const SemilinearSet& semilinear_set);
 protected:
   int C;
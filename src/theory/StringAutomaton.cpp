@@ -7,17 +7,18 @@
 
 #include "StringAutomaton.h"
 
+#include <fstream>
+
+#include "DFATransformer.h"
+
 namespace Vlab {
 namespace Theory {
 
 const int StringAutomaton::VLOG_LEVEL = 8;
-bool StringAutomaton::debug = false;
+thread_local bool StringAutomaton::debug = false;
 
-StringAutomaton::TransitionTable StringAutomaton::TRANSITION_TABLE;
-StringAutomaton::RegexAutoCache StringAutomaton::REGEX_AUTO_CACHE;
+thread_local StringAutomaton::TransitionTable StringAutomaton::TRANSITION_TABLE;
 
-int StringAutomaton::num_hits = 0;
-int StringAutomaton::num_misses = 0;
 
 StringAutomaton::StringAutomaton(const DFA_ptr dfa, const int number_of_bdd_variables)
 		:	Automaton(Automaton::Type::MULTITRACK, dfa, number_of_bdd_variables),
@@ -38,97 +39,66 @@ StringAutomaton::StringAutomaton(const DFA_ptr dfa, const int i_track, const int
 			num_tracks_(number_of_tracks),
 			formula_(new StringFormula()) {
 	DFA_ptr M = dfa, temp = nullptr, result = nullptr;
-	trace_descr tp;
-	paths state_paths, pp;
-	std::vector<std::pair<std::vector<char>,int>> state_exeps;
 	int sink;
-	char* statuses;
-	int* mindices;
 	bool has_sink = true;
 	int num_states = M->ns+1; // lambda state
 	int lambda_state = num_states-1;
 	int var = VAR_PER_TRACK;
 	int len = (num_tracks_ * var)+1; // extrabit for nondeterminism
-	mindices = GetBddVariableIndices(len);
-	int *indices = GetBddVariableIndices(in_num_vars);
 	sink = find_sink(M);
 	if(sink < 0) {
 		has_sink = false;
 		sink = num_states;
 		num_states++;
 	}
-	statuses = new char[num_states+1];
 	// begin dfa building process
 	// old transitions end in '0'
 	// new transitions end in '1' (lambda transitions)
+	DFATransformer transformer(num_states);
+	transformer.SetSource(M);
+	std::vector<int> index_map(in_num_vars);
+	for(int j = 0; j < in_num_vars; j++) {
+		index_map[j] = i_track+num_tracks_*j;
+	}
+	transformer.SetIndexMap(index_map);
+	const DFATransformer::Node sink_leaf = transformer.MakeLeaf(sink);
+	transformer.SetLeafMap([&](const int to_state) {
+		if(to_state == sink) {
+			return sink_leaf;
+		}
+		// old transition, end with '0'
+		DFATransformer::Node node = transformer.MakeNode(len-1, transformer.MakeLeaf(to_state), sink_leaf);
+		// if default_num_Var, make default_num_var+1 index '0' for non-lambda
+		if(in_num_vars == DEFAULT_NUM_OF_VARIABLES) {
+			node = transformer.MakeNode(i_track+num_tracks_*(DEFAULT_NUM_OF_VARIABLES), node, sink_leaf);
+		}
+		return node;
+	});
 
-	dfaSetup(num_states, len, mindices);
-	for(unsigned i = 0; i < M->ns; i++) {
-		state_paths = pp = make_paths(M->bddm, M->q[i]);
+	// lambda transition, all bits of the track and the extra bit are '1'
+	std::vector<int> lambda_indices;
+	for(int k = 0; k < var; k++) {
+		lambda_indices.push_back(i_track+num_tracks_*k);
+	}
+	lambda_indices.push_back(len-1);
+	const DFATransformer::Node lambda_transition = transformer.MakePath(lambda_indices,
+			std::vector<bool>(lambda_indices.size(), true), transformer.MakeLeaf(lambda_state), sink_leaf);
 
+	for(int i = 0; i < M->ns; i++) {
+		DFATransformer::Node transitions = transformer.Transform(i);
 		// if state is final, add lambda transition to lambda state
 		if(M->f[i] == 1) {
-			std::vector<char> curr(len,'X');
-			for(int k = 0; k < var; k++) {
-				curr[i_track+num_tracks_*k] = '1';
-			}
-			curr[len-1] = '1'; // new transition, end with '1'
-			curr.push_back('\0');
-			state_exeps.push_back(std::make_pair(curr,lambda_state));
+			transitions = transformer.Override(transitions, lambda_transition, sink);
 		}
-
-		while(pp) {
-			if(pp->to != sink) {
-				std::vector<char> curr(len,'X');
-				for(unsigned j = 0; j < in_num_vars; j++) {
-					for(tp = pp->trace; tp && (tp->index != indices[j]); tp = tp->next);
-					if(tp) {
-						if(tp->value) curr[i_track+num_tracks_*j] = '1';
-						else curr[i_track+num_tracks_*j] = '0';
-					}
-					else
-						curr[i_track+num_tracks_*j] = 'X';
-				}
-				// if default_num_Var, make default_num_var+1 index '0' for non-lambda
-				if(in_num_vars == DEFAULT_NUM_OF_VARIABLES) {
-					curr[i_track+num_tracks_*(DEFAULT_NUM_OF_VARIABLES)] = '0';
-				}
-				curr[len-1] = '0'; // old transition, end with '0'
-				curr.push_back('\0');
-				state_exeps.push_back(std::make_pair(curr,pp->to));
-			}
-			pp = pp->next;
-		}
-		kill_paths(state_paths);
-
-		dfaAllocExceptions(state_exeps.size());
-		for(unsigned k = 0; k < state_exeps.size(); ++k) {
-			dfaStoreException(state_exeps[k].second,&state_exeps[k].first[0]);
-		}
-		dfaStoreState(sink);
-		state_exeps.clear();
-
-		statuses[i] = '-';
+		transformer.SetState(i, transitions, -1);
 	}
 	// lambda state, loop de loop
-	dfaAllocExceptions(1);
-	std::vector<char> str(len,'X');
-	for(int i = 0; i < var; i++) {
-		str[i_track+num_tracks_*i] = '1';
-	}
-	str[len-1] = '1';
-	str.push_back('\0');
-	dfaStoreException(lambda_state,&str[0]);
-	dfaStoreState(sink);
-	statuses[lambda_state] = '+';
+	transformer.SetState(lambda_state, lambda_transition, 1);
 	// extra sink state, if needed
 	if(!has_sink) {
-		dfaAllocExceptions(0);
-		dfaStoreState(sink);
-		statuses[sink] = '-';
+		transformer.SetState(sink, sink_leaf, -1);
 	}
-	statuses[num_states] = '\0';
-	result = dfaBuild(statuses);
+	result = transformer.Build(M->s);
 	temp = dfaMinimize(result);
 	dfaFree(result);
 	// project away the extra bit
@@ -138,7 +108,6 @@ StringAutomaton::StringAutomaton(const DFA_ptr dfa, const int i_track, const int
 	dfaFree(result);
 	result = temp;
 
-	delete[] statuses;
 	this->dfa_ = result;
 }
 
@@ -178,6 +147,26 @@ StringAutomaton_ptr StringAutomaton::clone() const {
 	return result_auto;
 }
 
+void StringAutomaton::SaveToFile(const std::string& file_name) const {
+  std::ofstream out(file_name, std::ios::binary);
+  if (not out.good()) {
+    LOG(FATAL)<< "cannot open file: " << file_name;
+  }
+  cereal::BinaryOutputArchive ar(out);
+  save(ar);
+}
+
+StringAutomaton_ptr StringAutomaton::LoadFromFile(const std::string& file_name) {
+  // deleted when the reader throws, e.g. on a truncated file
+  std::unique_ptr<StringAutomaton> string_auto (new StringAutomaton(nullptr, DEFAULT_NUM_OF_VARIABLES));
+  ReadMappedFile(file_name, [&string_auto](std::istream& in) {
+    cereal::BinaryInputArchive ar(in);
+    string_auto->load(ar);
+  });
+  DVLOG(VLOG_LEVEL) << string_auto->id_ << " = StringAutomaton::LoadFromFile(" << file_name << ")";
+  return string_auto.release();
+}
+
 StringAutomaton_ptr StringAutomaton::MakePhi(const int number_of_bdd_variables) {
   DFA_ptr non_accepting_string_dfa = Automaton::DFAMakePhi(number_of_bdd_variables);
   StringAutomaton_ptr non_accepting_string_auto = new StringAutomaton(non_accepting_string_dfa, number_of_bdd_variables);
@@ -210,7 +199,7 @@ StringAutomaton_ptr StringAutomaton::MakeEmptyString(const int number_of_bdd_var
 
 StringAutomaton_ptr StringAutomaton::MakeString(const std::string str, const int number_of_bdd_variables) {
   if (str.empty()) {
-    return StringAutomaton::MakeEmptyString();
+    return StringAutomaton::MakeEmptyString(number_of_bdd_variables);
   }
 
   const int str_length = str.length();
@@ -319,67 +308,95 @@ StringAutomaton_ptr StringAutomaton::MakeRegexAuto(const std::string regex, cons
 }
 
 StringAutomaton_ptr StringAutomaton::MakeRegexAuto(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables) {
-  
-  // std::string regex_string = regular_expression->str();
-  // if(REGEX_AUTO_CACHE.find(regex_string) != REGEX_AUTO_CACHE.end()) {
-  //   num_hits++;
-  //   return REGEX_AUTO_CACHE[regex_string]->clone();
-  // }
-  // num_misses++;
-  
+  std::unordered_map<Util::RegularExpression_ptr, std::string> keys;
+  return StringAutomaton::MakeRegexAuto(regular_expression, number_of_bdd_variables, keys);
+}
+
+/**
+ * Automata of composite sub-expressions are looked up in the regex cache before they are built,
+ * literals are cheaper to build than to copy
+ */
+StringAutomaton_ptr StringAutomaton::MakeRegexAuto(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables,
+                                                   std::unordered_map<Util::RegularExpression_ptr, std::string>& keys) {
+  std::string key;
+  switch (regular_expression->type()) {
+    case Util::RegularExpression::Type::CHAR:
+    case Util::RegularExpression::Type::CHAR_RANGE:
+    case Util::RegularExpression::Type::ANYCHAR:
+    case Util::RegularExpression::Type::EMPTY:
+    case Util::RegularExpression::Type::STRING:
+    case Util::RegularExpression::Type::ANYSTRING:
+      break;
+    default: {
+      key = RegexAutomatonCache::GetKey(regular_expression, number_of_bdd_variables, keys);
+      StringAutomaton_ptr cached_auto = GetRegexAutoCache().Get(key);
+      if (cached_auto != nullptr) {
+        return cached_auto;
+      }
+      if (Option::Theory::USE_DIRECT_REGEX_CONSTRUCTION) {
+        StringAutomaton_ptr direct_auto = StringAutomaton::MakeRegexAutoDirect(regular_expression, number_of_bdd_variables);
+        if (direct_auto != nullptr) {
+          GetRegexAutoCache().Put(key, direct_auto);
+          return direct_auto;
+        }
+      }
+      break;
+    }
+  }
+
   StringAutomaton_ptr regex_auto = nullptr;
   StringAutomaton_ptr regex_expr1_auto = nullptr;
   StringAutomaton_ptr regex_expr2_auto = nullptr;
 
   switch (regular_expression->type()) {
   case Util::RegularExpression::Type::UNION:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
-    regex_expr2_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr2(), number_of_bdd_variables);
+    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables, keys);
+    regex_expr2_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr2(), number_of_bdd_variables, keys);
     regex_auto = regex_expr1_auto->Union(regex_expr2_auto);
     delete regex_expr1_auto;
     delete regex_expr2_auto;
     break;
   case Util::RegularExpression::Type::CONCATENATION:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
-    regex_expr2_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr2(), number_of_bdd_variables);
+    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables, keys);
+    regex_expr2_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr2(), number_of_bdd_variables, keys);
     regex_auto = regex_expr1_auto->Concat(regex_expr2_auto);
     delete regex_expr1_auto;
     delete regex_expr2_auto;
     break;
   case Util::RegularExpression::Type::INTERSECTION:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
-    regex_expr2_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr2(), number_of_bdd_variables);
+    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables, keys);
+    regex_expr2_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr2(), number_of_bdd_variables, keys);
     regex_auto = regex_expr1_auto->Intersect(regex_expr2_auto);
     delete regex_expr1_auto;
     delete regex_expr2_auto;
     break;
   case Util::RegularExpression::Type::OPTIONAL:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
+    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables, keys);
     regex_auto = regex_expr1_auto->Optional();
     delete regex_expr1_auto;
     break;
   case Util::RegularExpression::Type::REPEAT_STAR:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
+    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables, keys);
     regex_auto = regex_expr1_auto->KleeneClosure();
     delete regex_expr1_auto;
     break;
   case Util::RegularExpression::Type::REPEAT_PLUS:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
+    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables, keys);
     regex_auto = regex_expr1_auto->Closure();
     delete regex_expr1_auto;
     break;
   case Util::RegularExpression::Type::REPEAT_MIN:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
+    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables, keys);
     regex_auto = regex_expr1_auto->Repeat(regular_expression->get_min());
     delete regex_expr1_auto;
     break;
   case Util::RegularExpression::Type::REPEAT_MINMAX:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
+    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables, keys);
     regex_auto = regex_expr1_auto->Repeat(regular_expression->get_min(), regular_expression->get_max());
     delete regex_expr1_auto;
     break;
   case Util::RegularExpression::Type::COMPLEMENT:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
+    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables, keys);
     regex_auto = regex_expr1_auto->Complement();
     delete regex_expr1_auto;
     break;
@@ -412,11 +429,71 @@ StringAutomaton_ptr StringAutomaton::MakeRegexAuto(Util::RegularExpression_ptr r
     break;
   }
 
-  // REGEX_AUTO_CACHE[regex_string] = regex_auto->clone();
+  if (not key.empty()) {
+    GetRegexAutoCache().Put(key, regex_auto);
+  }
 
   return regex_auto;
 }
 
+/**
+ * Minimal dfas are unique, the result is the same dfa that combining the automata of the
+ * sub-expressions produces
+ */
+StringAutomaton_ptr StringAutomaton::MakeRegexAutoDirect(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables) {
+  if (not RegexDfaBuilder::IsSupported(regular_expression, number_of_bdd_variables)) {
+    return nullptr;
+  }
+  RegexDfaBuilder dfa_builder(number_of_bdd_variables);
+  if (not dfa_builder.Build(regular_expression, DIRECT_REGEX_MAX_NUM_OF_STATES)) {
+    DVLOG(VLOG_LEVEL) << "direct regex construction exceeds the state limit: " << *regular_expression;
+    return nullptr;
+  }
+
+  const int number_of_states = dfa_builder.GetNumOfStates();
+  const int sink_state = dfa_builder.GetSinkState();
+  char* statuses = new char[number_of_states + 1];
+  std::vector<std::string> symbols;
+  for (unsigned long symbol = 0; symbol < (1UL << number_of_bdd_variables); ++symbol) {
+    symbols.push_back(GetBinaryStringMSB(symbol, number_of_bdd_variables));
+  }
+
+  dfaSetup(number_of_states, number_of_bdd_variables, GetBddVariableIndices(number_of_bdd_variables));
+  for (int state = 0; state < number_of_states; ++state) {
+    auto& transitions = dfa_builder.GetTransitions(state);
+    dfaAllocExceptions(transitions.size());
+    for (auto& transition : transitions) {
+      dfaStoreException(transition.second, const_cast<char*>(symbols[transition.first].data()));
+    }
+    dfaStoreState(sink_state);
+    statuses[state] = dfa_builder.IsAcceptingState(state) ? '+' : '-';
+  }
+  statuses[number_of_states] = '\0';
+
+  DFA_ptr temp_dfa = dfaBuild(statuses);
+  DFA_ptr result_dfa = dfaMinimize(temp_dfa);
+  dfaFree(temp_dfa);
+  delete[] statuses;
+  StringAutomaton_ptr regex_auto = new StringAutomaton(result_dfa, number_of_bdd_variables);
+
+  DVLOG(VLOG_LEVEL) << regex_auto->id_ << " = MakeRegexAutoDirect(" << *regular_expression << ")";
+
+  return regex_auto;
+}
+
+StringAutomaton_ptr StringAutomaton::MakeString(const std::string str, const StringEncoding& encoding) {
+  return StringAutomaton::MakeString(encoding.Encode(str), encoding.GetNumOfBddVariables());
+}
+
+StringAutomaton_ptr StringAutomaton::MakeRegexAuto(const std::string regex, const StringEncoding& encoding) {
+  Util::RegularExpression regular_expression (regex);
+  Util::RegularExpression_ptr encoded_regular_expression = encoding.Encode(&regular_expression);
+  StringAutomaton_ptr regex_auto = StringAutomaton::MakeRegexAuto(encoded_regular_expression, encoding.GetNumOfBddVariables());
+  delete encoded_regular_expression;
+  DVLOG(VLOG_LEVEL) << regex_auto->id_ << " = MakeRegexAuto(" << regex << ", " << encoding.GetAlphabetSize() << " codes)";
+  return regex_auto;
+}
+
 StringAutomaton_ptr StringAutomaton::MakeAnyStringLengthEqualTo(const int length, const int number_of_bdd_variables) {
   DFA_ptr length_dfa = Automaton::DFAMakeAcceptingAnyWithInRange(length, length, number_of_bdd_variables);
   StringAutomaton_ptr length_auto = new StringAutomaton(length_dfa, number_of_bdd_variables);
@@ -523,10 +600,9 @@ StringAutomaton_ptr StringAutomaton::MakeBegins(StringFormula_ptr formula) {
 	TransitionVector tv;
 
   
-  auto coeff_map = formula->GetVariableCoefficientMap();
 	int num_vars = 0;
-	for(auto it : coeff_map) {
-		if(it.second != 0) {
+	for(int coeff : formula->GetCoefficients()) {
+		if(coeff != 0) {
 			num_vars++;
 		}
 	}
@@ -637,10 +713,9 @@ StringAutomaton_ptr StringAutomaton::MakeNotBegins(StringFormula_ptr formula) {
 	std::string left_data,right_data;
 	TransitionVector tv;
   
-  auto coeff_map = formula->GetVariableCoefficientMap();
 	int num_vars = 0;
-	for(auto it : coeff_map) {
-		if(it.second != 0) {
+	for(int coeff : formula->GetCoefficients()) {
+		if(coeff != 0) {
 			num_vars++;
 		}
 	}
@@ -824,10 +899,9 @@ StringAutomaton_ptr StringAutomaton::MakeEquality(StringFormula_ptr formula) {
 
   StringAutomaton_ptr equality_auto = nullptr;
 
-  auto coeff_map = formula->GetVariableCoefficientMap();
 	int num_vars = 0;
-	for(auto it : coeff_map) {
-		if(it.second != 0) {
+	for(int coeff : formula->GetCoefficients()) {
+		if(coeff != 0) {
 			num_vars++;
 		}
 	}
@@ -908,10 +982,9 @@ StringAutomaton_ptr StringAutomaton::MakeEquality(StringFormula_ptr formula) {
 StringAutomaton_ptr StringAutomaton::MakeNotEquality(	StringFormula_ptr formula) {
 	StringAutomaton_ptr not_equality_auto = nullptr;
 
-	auto coeff_map = formula->GetVariableCoefficientMap();
 	int num_vars = 0;
-	for(auto it : coeff_map) {
-		if(it.second != 0) {
+	for(int coeff : formula->GetCoefficients()) {
+		if(coeff != 0) {
 			num_vars++;
 		}
 	}
@@ -981,14 +1054,11 @@ StringAutomaton_ptr StringAutomaton::MakeLessThan(StringFormula_ptr formula) {
 	StringAutomaton_ptr result_auto = nullptr, temp_auto = nullptr;
 	StringAutomaton_ptr constant_string_auto = nullptr;
 	DFA_ptr temp_dfa = nullptr, result_dfa = nullptr, temp2_dfa = nullptr;
-	std::map<std::string,int> trackmap = formula->GetVariableCoefficientMap();
-
-	auto coeff_map = formula->GetVariableCoefficientMap();
 	int num_tracks = formula->GetNumberOfVariables();
 	int left_track = -1, right_track = -1;
 	int num_vars = 0;
-	for(auto it : coeff_map) {
-		if(it.second != 0) {
+	for(int coeff : formula->GetCoefficients()) {
+		if(coeff != 0) {
 			num_vars++;
 		}
 	}
@@ -1042,12 +1112,11 @@ StringAutomaton_ptr StringAutomaton::MakeLessThanOrEqual(StringFormula_ptr formu
 	StringAutomaton_ptr result_auto = nullptr, temp_auto = nullptr;
 	StringAutomaton_ptr constant_string_auto = nullptr;
 	DFA_ptr temp_dfa = nullptr, result_dfa = nullptr, temp2_dfa = nullptr;
-	auto coeff_map = formula->GetVariableCoefficientMap();
 	int num_tracks = formula->GetNumberOfVariables();
 	int left_track = -1, right_track = -1;
 	int num_vars = 0;
-	for(auto it : coeff_map) {
-		if(it.second != 0) {
+	for(int coeff : formula->GetCoefficients()) {
+		if(coeff != 0) {
 			num_vars++;
 		}
 	}
@@ -1103,12 +1172,11 @@ StringAutomaton_ptr StringAutomaton::MakeGreaterThan(StringFormula_ptr formula)
 	StringAutomaton_ptr result_auto = nullptr, temp_auto = nullptr;
 	StringAutomaton_ptr constant_string_auto = nullptr;
 	DFA_ptr temp_dfa = nullptr, result_dfa = nullptr, temp2_dfa = nullptr;
-	auto coeff_map = formula->GetVariableCoefficientMap();
 	int num_tracks = formula->GetNumberOfVariables();
 	int left_track = -1, right_track = -1;
 	int num_vars = 0;
-	for(auto it : coeff_map) {
-		if(it.second != 0) {
+	for(int coeff : formula->GetCoefficients()) {
+		if(coeff != 0) {
 			num_vars++;
 		}
 	}
@@ -1164,12 +1232,11 @@ StringAutomaton_ptr StringAutomaton::MakeGreaterThanOrEqual(StringFormula_ptr fo
 	StringAutomaton_ptr result_auto = nullptr, temp_auto = nullptr;
 	StringAutomaton_ptr constant_string_auto = nullptr;
 	DFA_ptr temp_dfa = nullptr, result_dfa = nullptr, temp2_dfa = nullptr;
-	auto coeff_map = formula->GetVariableCoefficientMap();
 	int num_tracks = formula->GetNumberOfVariables();
 	int left_track = -1, right_track = -1;
 	int num_vars = 0;
-	for(auto it : coeff_map) {
-		if(it.second != 0) {
+	for(int coeff : formula->GetCoefficients()) {
+		if(coeff != 0) {
 			num_vars++;
 		}
 	}
@@ -1466,7 +1533,7 @@ StringAutomaton_ptr StringAutomaton::Optional() {
 	CHECK_EQ(this->num_tracks_,1);
 	StringAutomaton_ptr optional_auto = nullptr, empty_string = nullptr;
 
-	empty_string = StringAutomaton::MakeEmptyString();
+	empty_string = StringAutomaton::MakeEmptyString(num_of_bdd_variables_);
 	optional_auto = this->Union(empty_string);
 	delete empty_string;
 
@@ -1492,7 +1559,7 @@ StringAutomaton_ptr StringAutomaton::Closure() {
 		ns++;
 	}
 
-  int var = DEFAULT_NUM_OF_VARIABLES;
+  int var = num_of_bdd_variables_;
 
   int len = var + 1; //one extra bit
   int *indices = GetBddVariableIndices(len);
@@ -1599,7 +1666,7 @@ StringAutomaton_ptr StringAutomaton::KleeneClosure() {
   StringAutomaton_ptr kleene_closure_auto = nullptr, closure_auto = nullptr, empty_string = nullptr;
 
   closure_auto = this->Closure();
-  empty_string = StringAutomaton::MakeEmptyString();
+  empty_string = StringAutomaton::MakeEmptyString(num_of_bdd_variables_);
   kleene_closure_auto = closure_auto->Union(empty_string);
   delete closure_auto;
   delete empty_string;
@@ -1621,7 +1688,7 @@ StringAutomaton_ptr StringAutomaton::Repeat(unsigned min) {
     repeated_auto = this->Closure();
   } else {
     StringAutomaton_ptr closure_auto = this->Closure();
-    StringAutomaton_ptr range_auto = StringAutomaton::MakeAnyStringLengthGreaterThanOrEqualTo(min);
+    StringAutomaton_ptr range_auto = StringAutomaton::MakeAnyStringLengthGreaterThanOrEqualTo(min, num_of_bdd_variables_);
     repeated_auto = closure_auto->Intersect(range_auto);
     delete range_auto; range_auto = nullptr;
     delete closure_auto; closure_auto = nullptr;
@@ -1654,9 +1721,9 @@ StringAutomaton_ptr StringAutomaton::Repeat(unsigned min, unsigned max) {
   if(min < 0) {
     LOG(FATAL) << "Invalid range for re.loop; min must be at least 0";
   } else if(min > max) {
-    return StringAutomaton::MakePhi();  
+    return StringAutomaton::MakePhi(num_of_bdd_variables_);  
   } else {
-    repeated_auto = StringAutomaton::MakeEmptyString();
+    repeated_auto = StringAutomaton::MakeEmptyString(num_of_bdd_variables_);
     
     for(int i = 0; i < min; i++) {
       temp_auto = repeated_auto->Concat(this);
@@ -1715,7 +1782,7 @@ StringAutomaton_ptr StringAutomaton::Suffixes() {
 	CHECK_EQ(this->num_tracks_,1);
   StringAutomaton_ptr suffixes_auto = nullptr;
   if (this->IsEmptyLanguage()) {
-    suffixes_auto = StringAutomaton::MakePhi();
+    suffixes_auto = StringAutomaton::MakePhi(num_of_bdd_variables_);
     DVLOG(VLOG_LEVEL) << suffixes_auto->id_ << " = [" << this->id_ << "]->suffixes()";
     return suffixes_auto;
   }
@@ -2690,7 +2757,7 @@ StringAutomaton_ptr StringAutomaton::Contains(StringAutomaton_ptr search_auto) {
   StringAutomaton_ptr contains_auto = nullptr, any_string_auto = nullptr,
           tmp_auto_1 = nullptr, tmp_auto_2 = nullptr;
 
-  any_string_auto = StringAutomaton::MakeAnyString();
+  any_string_auto = StringAutomaton::MakeAnyString(num_of_bdd_variables_);
   tmp_auto_1 = any_string_auto->Concat(search_auto);
   tmp_auto_2 = tmp_auto_1->Concat(any_string_auto);
 
@@ -2708,7 +2775,7 @@ StringAutomaton_ptr StringAutomaton::Begins(StringAutomaton_ptr search_auto) {
   StringAutomaton_ptr begins_auto = nullptr, any_string_auto = nullptr,
           tmp_auto_1 = nullptr;
 
-  any_string_auto = StringAutomaton::MakeAnyString();
+  any_string_auto = StringAutomaton::MakeAnyString(num_of_bdd_variables_);
   tmp_auto_1 = search_auto->Concat(any_string_auto);
 
   begins_auto = this->Intersect(tmp_auto_1);
@@ -2724,7 +2791,7 @@ StringAutomaton_ptr StringAutomaton::Ends(StringAutomaton_ptr search_auto) {
   StringAutomaton_ptr ends_auto = nullptr, any_string_auto = nullptr,
           tmp_auto_1 = nullptr;
 
-  any_string_auto = StringAutomaton::MakeAnyString();
+  any_string_auto = StringAutomaton::MakeAnyString(num_of_bdd_variables_);
   tmp_auto_1 = any_string_auto->Concat(search_auto);
 
   ends_auto = this->Intersect(tmp_auto_1);
@@ -2900,8 +2967,7 @@ UnaryAutomaton_ptr StringAutomaton::ToUnaryAutomaton() {
   DFA_ptr unary_dfa = nullptr, tmp_dfa = nullptr;
 
   int sink_state = this->GetSinkState(),
-          number_of_variables = num_of_bdd_variables_ + 1, // one extra bit
-          to_state = 0;
+          number_of_variables = num_of_bdd_variables_ + 1; // one extra bit
   bool has_sink = true;
   int original_num_states = dfa_->ns;
   if(sink_state < 0) {
@@ -2909,81 +2975,25 @@ UnaryAutomaton_ptr StringAutomaton::ToUnaryAutomaton() {
     sink_state = 0;
   }
 
-  int* indices = GetBddVariableIndices(number_of_variables);
-  char* statuses = new char[original_num_states + 1];
-  std::map<std::vector<char>*, int> exceptions;
-  std::vector<char>* current_exception = nullptr;
-
-  paths state_paths = nullptr, pp = nullptr;
-  trace_descr tp = nullptr;
-
-
-  dfaSetup(original_num_states, number_of_variables, indices);
+  // transitions keep their symbols with the extra bit '1', everything else goes to the sink state
+  DFATransformer transformer(original_num_states);
+  transformer.SetSource(dfa_);
+  const DFATransformer::Node sink_leaf = transformer.MakeLeaf(sink_state);
+  transformer.SetLeafMap([&](const int to_state) {
+    if (has_sink and to_state == sink_state) {
+      return sink_leaf;
+    }
+    return transformer.MakeNode(number_of_variables - 1, sink_leaf, transformer.MakeLeaf(to_state));
+  });
 
   for (int i = 0; i < original_num_states; i++) {
-
     if(i == sink_state && has_sink) {
-      dfaAllocExceptions(0);
-      dfaStoreState(sink_state);
-      statuses[sink_state] = '-';
+      transformer.SetState(sink_state, sink_leaf, -1);
       continue;
     }
-
-    state_paths = pp = make_paths(dfa_->bddm, dfa_->q[i]);
-    while (pp) {
-      if (!has_sink || pp->to != (unsigned)sink_state) {
-        to_state = pp->to;
-        current_exception = new std::vector<char>();
-        for (int j = 0; j < number_of_variables - 1; j++) {
-          //the following for loop can be avoided if the indices are in order
-          for (tp = pp->trace; tp && (tp->index != (unsigned)indices[j]); tp= tp->next);
-
-          if (tp) {
-            if (tp->value){
-              current_exception->push_back('1');
-            } else{
-              current_exception->push_back('0');
-            }
-          } else {
-            current_exception->push_back('X');
-          }
-        }
-
-        current_exception->push_back('1');
-        current_exception->push_back('\0');
-        exceptions[current_exception] = to_state;
-      }
-      current_exception = nullptr;
-      tp = nullptr;
-      pp = pp->next;
-    }
-
-    dfaAllocExceptions(exceptions.size());
-    for (auto it = exceptions.begin(); it != exceptions.end();) {
-      dfaStoreException(it->second, &*it->first->begin());
-      current_exception = it->first;
-      it = exceptions.erase(it);
-      delete current_exception;
-    }
-    dfaStoreState(sink_state);
-    current_exception = nullptr;
-    exceptions.clear();
-
-    if (dfa_->f[i] == 1) {
-      statuses[i] = '+';
-    } else if (dfa_->f[i] == -1) {
-      statuses[i] = '-';
-    } else {
-      statuses[i] = '0';
-    }
-
-    kill_paths(state_paths);
-    state_paths = pp = nullptr;
+    transformer.SetState(i, transformer.Transform(i), dfa_->f[i]);
   }
-  statuses[this->dfa_->ns] = '\0';
-  unary_dfa = dfaBuild(statuses);
-  //delete[] indices; indices = nullptr;
-  delete[] statuses; statuses = nullptr;
+  unary_dfa = transformer.Build(dfa_->s);
 
   for (int i = 0; i < number_of_variables - 1; i++) { // project away all bits
     tmp_dfa = unary_dfa;
@@ -3993,6 +4003,56 @@ void StringAutomaton::SetSymbolicCounter() {
 
 }
 
+/**
+ * Codes are few, the bdd of each state is evaluated per code instead of per path
+ */
+SymbolicCounter StringAutomaton::GetSymbolicCounter(const StringEncoding& encoding) {
+  CHECK_EQ(1, num_tracks_);
+  CHECK_EQ(encoding.GetNumOfBddVariables(), num_of_bdd_variables_);
+  if (encoding.IsIdentity()) {
+    return GetSymbolicCounter();
+  }
+
+  std::vector<Eigen::Triplet<BigInteger>> entries;
+  const int sink_state = GetSinkState();
+  for (int s = 0; s < this->dfa_->ns; ++s) {
+    if (sink_state == s) {
+      continue;
+    }
+    std::map<int, BigInteger> target_weights;
+    for (unsigned long code = 0; code < (unsigned long) encoding.GetAlphabetSize(); ++code) {
+      unsigned left, right, index;
+      LOAD_lri(&this->dfa_->bddm->node_table[this->dfa_->q[s]], left, right, index);
+      while (index != BDD_LEAF_INDEX) {
+        // bdd variable i is bit i of the code from the most significant bit
+        const unsigned node = ((code >> (num_of_bdd_variables_ - 1 - index)) & 1) ? right : left;
+        LOAD_lri(&this->dfa_->bddm->node_table[node], left, right, index);
+      }
+      if (sink_state != static_cast<int>(left)) {
+        target_weights[left] += encoding.GetWeight(code);
+      }
+    }
+    for (auto& target_weight : target_weights) {
+      entries.push_back(Eigen::Triplet<BigInteger>(s, target_weight.first, target_weight.second));
+    }
+    if (IsAcceptingState(s)) {
+      entries.push_back(Eigen::Triplet<BigInteger>(s, this->dfa_->ns, 1));
+    }
+  }
+
+  Eigen::SparseMatrix<BigInteger> count_matrix (this->dfa_->ns + 1, this->dfa_->ns + 1);
+  count_matrix.setFromTriplets(entries.begin(), entries.end());
+  count_matrix.insert(this->dfa_->ns, this->dfa_->ns) = count_bound_exact_ ? 0 : 1;
+  count_matrix.makeCompressed();
+  count_matrix.finalize();
+
+  SymbolicCounter counter;
+  counter.set_type(SymbolicCounter::Type::STRING);
+  counter.set_transition_count_matrix(count_matrix);
+  counter.set_initialization_vector(count_matrix.innerVector(count_matrix.cols()-1));
+  return counter;
+}
+
 std::vector<std::string> StringAutomaton::GetAnAcceptingStringForEachTrack() {
 	LOG(FATAL) << "IMPLEMENT ME";
 //  std::vector<std::string> strings(num_tracks_, "");
@@ -4037,188 +4097,54 @@ std::map<std::string,std::vector<std::string>> StringAutomaton::GetModelsWithinB
 		bound = counter.GetMinBound(num_models);
 	}
 
-  // compute BFS for unweighted graph (dfa)
-  std::queue<int> states_to_process;
-  std::vector<int> distances(this->dfa_->ns,INT_MAX);
-  std::set<int> final_states;
-
-  std::vector<int> shortest_accepting_path(this->dfa_->ns,INT_MAX);
-  for(int start_state = 0; start_state < this->dfa_->ns; start_state++) {
-  	distances[start_state] = 0;
-		states_to_process.push(start_state);
-
-		while(not states_to_process.empty()) {
-			int s = states_to_process.front();
-			states_to_process.pop();
-			// mark final states for later
-			if(this->dfa_->f[s] == 1) {
-				final_states.insert(s);
-			}
-
-			for(auto iter : getNextStates(s)) {
-				if(distances[iter] == INT_MAX) {
-					states_to_process.push(iter);
-					distances[iter] = distances[s] + 1;
-				}
-			}
-		}
-
-		int shortest = INT_MAX;
-		for(auto final : final_states) {
-			distances[final]--; // account for lambda/lambda transition
-			if(distances[final] < shortest) {
-				shortest = distances[final];
-			}
-		}
-		shortest_accepting_path[start_state] = shortest;
-
-
-		distances = std::vector<int>(this->dfa_->ns,INT_MAX);
-  }
+  auto shortest_accepting_path = GetShortestAcceptingPaths();
 
-//  for(int i = 0; i < this->dfa_->ns; i++) {
-//  	LOG(INFO) << "shortest path for state " << i << " = " << shortest_accepting_path[i];
-//  }
-//
-  //LOG(INFO) << "Done computing shortest paths to final state";
-
-  // assume num_tracks > 1; Otherwise, juse call normal version
   int models_so_far = 0;
   int num_tracks = this->num_tracks_;
-  int var_per_track = this->num_of_bdd_variables_ / num_tracks;
-
-  std::vector<std::pair<int,std::vector<char>>> next_states;
-
-
-  // cache the process for finding next transitions from a state
-  std::vector<std::vector<std::pair<int,std::vector<char>>>> next_states_matrix(this->dfa_->ns);
-  for(int i = 0; i < this->dfa_->ns; i++) {
-  	int current_state = i;
-  	std::vector<std::pair<int,std::vector<char>>> inner_next_states;
-		std::vector<unsigned> nodes;
-		std::vector<std::vector<char>> transition_stack;
-		std::vector<char> current_transition;
-		int sink = GetSinkState();
-
-		unsigned p, l, r, index; // BDD traversal variables
-		p = this->dfa_->q[current_state];
-		nodes.push_back(p);
-		transition_stack.push_back(std::vector<char>());
-		while (not nodes.empty()) {
-			p = nodes.back();
-			nodes.pop_back();
-			current_transition = transition_stack.back();
-			transition_stack.pop_back();
-			LOAD_lri(&this->dfa_->bddm->node_table[p], l, r, index);
-			if (index == BDD_LEAF_INDEX) {
-				int to_state = l;
-				// if to_state is sink state, ignore
-				if(to_state == sink) {
-					continue;
-				}
-
-				while (current_transition.size() < (unsigned) num_of_bdd_variables_) {
-					current_transition.push_back('X');
-				}
-				// put loops first, other states at back
-				if(to_state != current_state) {
-					next_states_matrix[i].push_back(std::make_pair(to_state, current_transition));
-				} else {
-					next_states_matrix[i].insert(next_states_matrix[i].begin(),std::make_pair(to_state,current_transition));
-				}
-
-			} else {
-				while (current_transition.size() < index) {
-					unsigned i = current_transition.size();
-					current_transition.push_back('X');
-				}
-				std::vector<char> left = current_transition;
-				left.push_back('0');
-				std::vector<char> right = current_transition;
-				right.push_back('1');
-				transition_stack.push_back(right);
-				nodes.push_back(r);
-				transition_stack.push_back(left);
-				nodes.push_back(l);
-			}
-		}
-  }
+  int num_variables = this->num_of_bdd_variables_;
+  int var_per_track = num_variables / num_tracks;
 
-
-  int start = this->dfa_->s;
-  int sink = GetSinkState();
-  bool get_more_models = true;
   // since we're not expanding dont-care characters ('X') yet, the models we find are unfinished
 	std::set<std::vector<std::vector<char>>> unfinished_models;
 	std::set<std::vector<std::vector<bool>>> finished_models;
-	std::stack<std::pair<int,std::vector<std::vector<char>>>> models_to_process;
-  std::vector<std::vector<char>> track_characters(num_tracks,std::vector<char>());
-  models_to_process.push(std::make_pair(start,track_characters));
-  int num_loops = 0;
-  while(not models_to_process.empty() and get_more_models) {
-    std::pair<int,std::vector<std::vector<char>>> current_model = models_to_process.top();
-    models_to_process.pop();
-
-    int current_state = current_model.first;
-    int length = current_model.second[0].size() / var_per_track;
-
-    if(shortest_accepting_path[current_state] + length > bound) {
-    	continue;
+  std::vector<std::vector<char>> track_characters(num_tracks);
+  // since we're assuming we have lambda transitions, transitions to final states must be all lambda transitions
+  // therefore paths are not extended beyond final states, the lambda transition into the final state is not
+  // part of the model and is accounted for by the extra 1 on the bound
+  ForEachAcceptingPathWithinBound(shortest_accepting_path, bound + 1, false, false,
+      [&](const std::vector<char>& path, int path_length) {
+    int length = path_length - 1;
+    if(length < 0 or (count_bound_exact_ and length != bound)) {
+      return true;
     }
 
-    for(auto iter : next_states_matrix[current_state]) {
-    // next_state is in first position
-      int to_state = iter.first;
-      // if the current length + shortest path to final state from to_state + 1 (for transition from current -> to_state)
-			// is greater than bound, ignore
-      if(to_state == sink || length + shortest_accepting_path[to_state]+1 > bound) {
-      	continue;
+    for(int i = 0; i < num_tracks; i++) {
+      track_characters[i].clear();
+    }
+    for(int step = 0; step < length; step++) {
+      for(int i = 0; i < num_tracks; i++) {
+        for(int k = 0; k < var_per_track; k++) {
+          // since tracks are interleaved, track i's characters don't lie in order in the transition we got
+          track_characters[i].push_back(path[step * num_variables + i + num_tracks * k]);
+        }
       }
+    }
 
-      // check if its final state
-      // since we're assuming we have lambda transitions, transitions to final states must be all lambda transitions
-      // therefor, if to_state is a final state, and the current_length is <= bound, then we record the previous track_characters
-      // and don't new transitions!
-      if(this->dfa_->f[to_state] == 1) {
-        if((count_bound_exact_ and length == bound) or (not count_bound_exact_ and length <= bound)) {
-
-          int max_x = 0;
-          // each track can have differing number of x's
-          // find the max number of x's in all tracks
-          for(int i = 0; i < num_tracks; i++) {
-            int num_x = 0;
-            for(int k = 0; k < current_model.second[i].size(); k++) {
-              if(current_model.second[i][k] == 'X') {
-                num_x++;
-              }
-            }
-            max_x += num_x;
-          }
-
-          // for each 'X', there are 2 possible transitions
-          models_so_far += (1 << max_x);
-          unfinished_models.insert(current_model.second);
-          // set finish condition if necessary
-          if(num_models != -1 and models_so_far >= num_models) {
-            get_more_models = false;
-          }
-        }
-      } else if(to_state != sink and (length < bound or bound == -1)) {
-        std::vector<char> transition = iter.second;
-
-        // transition is in second position
-        track_characters = current_model.second;
-        for(int i = 0; i < num_tracks; i++) {
-          for(int k = 0; k < var_per_track; k++) {
-            // since tracks are interleaved, track i's characters don't lie in order in the transition we got
-            track_characters[i].push_back(transition[i+num_tracks*k]);
-          }
-        }
+    int max_x = 0;
+    // each track can have differing number of x's
+    // find the max number of x's in all tracks
+    for(int i = 0; i < num_tracks; i++) {
+      max_x += std::count(track_characters[i].begin(), track_characters[i].end(), 'X');
+    }
 
-        models_to_process.push(std::make_pair(to_state,track_characters));
-      }
+    unfinished_models.insert(track_characters);
+    // for each 'X', there are 2 possible transitions
+    if(num_models != -1 and (max_x >= 30 or models_so_far + (1 << max_x) >= num_models)) {
+      return false;
     }
-  }
+    models_so_far += (1 << max_x);
+    return true;
+  });
 
 
   // unfinished_models contain 'X' (dont care) in transitions
@@ -4354,7 +4280,6 @@ std::map<std::string,std::vector<std::string>> StringAutomaton::GetModelsWithinB
   if(formula == nullptr) {
   	LOG(FATAL) << "Formula not set!";
   }
-  auto var_coeffs = formula->GetVariableCoefficientMap();
   std::map<std::string,std::vector<std::string>> variable_values;
 //  for(auto iter : var_coeffs) {
 //  	variable_values[iter.first] = std::vector<std::string>();
@@ -5596,9 +5521,6 @@ DFA_ptr StringAutomaton::PrependLambda(DFA_ptr dfa, int var) {
     LOG(FATAL) << "mismatched incoming var";
   }
   DFA_ptr M = dfa, temp = nullptr, result = nullptr;
-  trace_descr tp;
-  paths state_paths, pp;
-  std::vector<std::pair<std::vector<char>,int>> state_exeps;
   int num_states = M->ns+1;
   int sink = Automaton::find_sink(M);
   bool has_sink = true;
@@ -5611,106 +5533,39 @@ DFA_ptr StringAutomaton::PrependLambda(DFA_ptr dfa, int var) {
     sink++; // +1 for new state
   }
 
-  char* statuses;
-  int* mindices;
   int len = VAR_PER_TRACK; // 1 more than default_num_var
 
-  mindices = GetBddVariableIndices(len);
-  statuses = new char[num_states+1];
-
-  // begin dfa building process
-  dfaSetup(num_states, len, mindices);
-
-  // setup for initial state
-  state_paths = pp = make_paths(M->bddm, M->q[0]);
-  while(pp) {
-    if(pp->to != sink-1) {
-      std::vector<char> curr(len,'0');
-      for(unsigned j = 0; j < var; j++) {
-        for(tp = pp->trace; tp && (tp->index != mindices[j]); tp = tp->next);
-        if(tp) {
-          if(tp->value) curr[j] = '1';
-          else curr[j] = '0';
-        }
-        else
-          curr[j] = 'X';
-      }
-      curr.push_back('\0');
-      state_exeps.push_back(std::make_pair(curr,pp->to+1));
-    }
-    pp = pp->next;
-  }
-  kill_paths(state_paths);
-
-  // add lambda loop to self
-  std::vector<char> str(len,'1');
-  str.push_back('\0');
-  state_exeps.push_back(std::make_pair(str,0));
-  dfaAllocExceptions(state_exeps.size());
-  for(unsigned k = 0; k < state_exeps.size(); ++k) {
-    dfaStoreException(state_exeps[k].second,&state_exeps[k].first[0]);
-  }
-  dfaStoreState(sink);
+  // begin dfa building process, states are shifted by one and transitions end with '0'
+  DFATransformer transformer(num_states);
+  transformer.SetSource(M);
+  const DFATransformer::Node sink_leaf = transformer.MakeLeaf(sink);
+  transformer.SetLeafMap([&](const int to_state) {
+    return transformer.MakeNode(var, transformer.MakeLeaf(to_state+1), sink_leaf);
+  });
 
-  state_exeps.clear();
-  if(M->f[0] == 1) {
-    statuses[0] = '+';
-  } else {
-    statuses[0] = '-';
+  // setup for initial state, add lambda loop to self
+  std::vector<int> lambda_indices(len);
+  for(int j = 0; j < len; j++) {
+    lambda_indices[j] = j;
   }
+  DFATransformer::Node lambda_loop = transformer.MakePath(lambda_indices, std::vector<bool>(len, true),
+      transformer.MakeLeaf(0), sink_leaf);
+  transformer.SetState(0, transformer.Override(transformer.Transform(M->s), lambda_loop, sink),
+      (M->f[M->s] == 1) ? 1 : -1);
 
   // rest of states (shift 1)
-  for(unsigned i = 0; i < M->ns; i++) {
-    state_paths = pp = make_paths(M->bddm, M->q[i]);
-
-    while(pp) {
-      if(pp->to != sink-1) {
-        std::vector<char> curr(len,'0');
-        for(unsigned j = 0; j < var; j++) {
-          for(tp = pp->trace; tp && (tp->index != mindices[j]); tp = tp->next);
-          if(tp) {
-            if(tp->value) curr[j] = '1';
-            else curr[j] = '0';
-          }
-          else
-            curr[j] = 'X';
-        }
-        curr.push_back('\0');
-        state_exeps.push_back(std::make_pair(curr,pp->to+1));
-      }
-      pp = pp->next;
-    }
-    kill_paths(state_paths);
-
-    dfaAllocExceptions(state_exeps.size());
-    for(unsigned k = 0; k < state_exeps.size(); ++k) {
-      dfaStoreException(state_exeps[k].second,&state_exeps[k].first[0]);
-    }
-    dfaStoreState(sink);
-    state_exeps.clear();
-
-    if(M->f[i] == 1) {
-      statuses[i+1] = '+';
-    } else if(M->f[i] == -1) {
-      statuses[i+1] = '-';
-    } else {
-      statuses[i+1] = '0';
-    }
+  for(int i = 0; i < M->ns; i++) {
+    transformer.SetState(i+1, transformer.Transform(i), M->f[i]);
   }
 
   if(!has_sink) {
-    dfaAllocExceptions(0);
-    dfaStoreState(sink);
-    statuses[sink] = '-';
+    transformer.SetState(sink, sink_leaf, -1);
   }
 
-  statuses[num_states] = '\0';
-  temp = dfaBuild(statuses);
+  temp = transformer.Build(0);
   result = dfaMinimize(temp);
   dfaFree(temp);
 
-  delete[] statuses;
-
   return result;
 }
 
@@ -6058,8 +5913,6 @@ StringAutomaton_ptr StringAutomaton::ChangeIndicesMap(StringFormula_ptr new_form
 
 //  auto start = std::chrono::steady_clock::now();
   StringAutomaton_ptr unmapped_auto = nullptr;
-	auto old_coeff_map = this->formula_->GetVariableCoefficientMap();
-	auto new_coeff_map = new_formula->GetVariableCoefficientMap();
 	int old_num_tracks = this->num_tracks_;
 	int new_num_tracks = new_formula->GetNumberOfVariables();
 
@@ -6106,10 +5959,10 @@ StringAutomaton_ptr StringAutomaton::ChangeIndicesMap(StringFormula_ptr new_form
 
   bool replace = false;
 
-	for(auto iter : old_coeff_map) {
+	const auto& old_variables = unmapped_auto->formula_->GetVariables();
+	for(int old_index = 0; old_index < old_variables.size(); old_index++) {
 
-		int old_index = unmapped_auto->formula_->GetVariableIndex(iter.first);
-		int new_index = new_formula->GetVariableIndex(iter.first);
+		int new_index = new_formula->GetVariableIndex(old_variables[old_index]);
 
 
 
@@ -6138,11 +5991,22 @@ StringAutomaton_ptr StringAutomaton::ChangeIndicesMap(StringFormula_ptr new_form
 }
 
 void StringAutomaton::PrintRegexCacheStatistics() {
+  auto num_hits = GetRegexAutoCache().GetNumOfHits();
+  auto num_misses = GetRegexAutoCache().GetNumOfMisses();
   LOG(INFO) << "hits:      " << num_hits;
   LOG(INFO) << "misses:    " << num_misses;
   LOG(INFO) << "hit ratio: " << num_hits / float(num_hits+num_misses);
 }
 
+RegexAutomatonCache& StringAutomaton::GetRegexAutoCache() {
+  static RegexAutomatonCache regex_auto_cache;
+  static std::once_flag capacity_flag;
+  std::call_once(capacity_flag, []() {
+    regex_auto_cache.SetCapacity(Option::Theory::REGEX_CACHE_SIZE);
+  });
+  return regex_auto_cache;
+}
+
 bool StringAutomaton::HasExceptionToValidStateFrom(int state, std::vector<char>& exception) {
 	int sink_state = this->GetSinkState();
 	return (sink_state != this->getNextState(state, exception));
@@ -6821,7 +6685,7 @@ void StringAutomaton::AddPrintLabel(std::ostream& out) {
 	out << "  node[shape=plaintext];\n";
 	out << " \"\"[label=\"";
 	if (formula_) {
-		out << formula_->GetVariableCoefficientMap().begin()->first << "\n";
+		out << formula_->GetVariableAtIndex(0) << "\n";
 	} else {
 		out << "str term" << "\n";
 	}
@@ -16,6 +16,7 @@
 #include <sstream>
 #include <stack>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -27,6 +28,9 @@
 #include "Graph.h"
 #include "GraphNode.h"
 #include "IntAutomaton.h"
+#include "RegexAutomatonCache.h"
+#include "RegexDfaBuilder.h"
+#include "StringEncoding.h"
 #include "StringFormula.h"
 
 namespace Vlab {
@@ -38,7 +42,6 @@ using StringAutomaton_ptr = StringAutomaton*;
 class StringAutomaton: public Automaton {
 	using TransitionVector = std::vector<std::pair<std::string,std::string>>;
 	using TransitionTable = std::map<std::pair<int,StringFormula::Type>,TransitionVector>;
-  using RegexAutoCache = std::map<std::string,StringAutomaton_ptr>;
 
 public:
 	StringAutomaton(const DFA_ptr, const int number_of_bdd_variables);
@@ -50,6 +53,47 @@ public:
 
   virtual StringAutomaton_ptr clone() const;
 
+  /**
+   * Binary automaton format, the automaton followed by the number of tracks and the formula
+   */
+  template <class Archive>
+  void save(Archive& ar) const {
+    Automaton::save(ar);
+    ar(num_tracks_);
+    bool has_formula = (formula_ != nullptr);
+    ar(has_formula);
+    if (has_formula) {
+      formula_->save(ar);
+    }
+  }
+
+  template <class Archive>
+  void load(Archive& ar) {
+    Automaton::load(ar);
+    ar(num_tracks_);
+    bool has_formula = false;
+    ar(has_formula);
+    delete formula_;
+    formula_ = nullptr;
+    if (has_formula) {
+      formula_ = new StringFormula();
+      formula_->load(ar);
+    }
+  }
+
+  /**
+   * Writes the automaton in the binary automaton format
+   * @param file_name
+   */
+  void SaveToFile(const std::string& file_name) const;
+
+  /**
+   * Loads an automaton written by SaveToFile, the file is read in place from memory
+   * @param file_name
+   * @return
+   */
+  static StringAutomaton_ptr LoadFromFile(const std::string& file_name);
+
   /**
    * Generates a string automaton that does not recognize any string
    * @param number_of_bdd_variables
@@ -120,6 +164,23 @@ public:
    */
   static StringAutomaton_ptr MakeRegexAuto(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables = StringAutomaton::DEFAULT_NUM_OF_VARIABLES);
 
+  /**
+   * Generates a string automaton over the codes of the encoding that recognizes the encoded string
+   * @param str
+   * @param encoding
+   * @return
+   */
+  static StringAutomaton_ptr MakeString(const std::string str, const StringEncoding& encoding);
+
+  /**
+   * Generates a string automaton over the codes of the encoding that accepts the encoded strings of
+   * the regular expression, characters of the regular expression are expected to be added to the encoding
+   * @param regex_string
+   * @param encoding
+   * @return
+   */
+  static StringAutomaton_ptr MakeRegexAuto(const std::string regex_string, const StringEncoding& encoding);
+
   /**
    * Generates a string automaton that accepts any string with the given length
    * @param length
@@ -285,6 +346,14 @@ public:
   StringAutomaton_ptr ProjectAwayVariable(std::string var_name);
   StringAutomaton_ptr ProjectKTrack(int track);
   void SetSymbolicCounter() override;
+  using Automaton::GetSymbolicCounter;
+  /**
+   * Counter of a single track automaton built with the encoding, a transition on a code counts
+   * as many times as the number of characters the code stands for
+   * @param encoding
+   * @return counter over the full alphabet
+   */
+  SymbolicCounter GetSymbolicCounter(const StringEncoding& encoding);
   std::vector<std::string> GetAnAcceptingStringForEachTrack();
   std::map<std::string,std::vector<std::string>> GetModelsWithinBound(int num_models, int bound) override;
 	int GetNumTracks() const;
@@ -324,7 +393,25 @@ public:
 
   static void PrintRegexCacheStatistics();
 
+  /**
+   * Regex automata and automata of their sub-expressions are reused across drivers and threads,
+   * the capacity is Option::Theory::REGEX_CACHE_SIZE dfa states
+   * @return process wide regex automata cache
+   */
+  static RegexAutomatonCache& GetRegexAutoCache();
+
 protected:
+  static StringAutomaton_ptr MakeRegexAuto(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables,
+                                           std::unordered_map<Util::RegularExpression_ptr, std::string>& keys);
+  /**
+   * Compiles the regular expression into a single dfa and minimizes it once
+   * @param regular_expression
+   * @param number_of_bdd_variables
+   * @return regex automaton, nullptr if the regular expression is not supported by RegexDfaBuilder
+   * or its dfa grows larger than DIRECT_REGEX_MAX_NUM_OF_STATES before minimization
+   */
+  static StringAutomaton_ptr MakeRegexAutoDirect(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables);
+
   bool HasExceptionToValidStateFrom(int state, std::vector<char>& exception);
   std::vector<int> GetAcceptingStates();
 
@@ -339,13 +426,11 @@ protected:
 
   int num_tracks_;
   StringFormula_ptr formula_;
-  static TransitionTable TRANSITION_TABLE;
-  static RegexAutoCache REGEX_AUTO_CACHE;
+  static thread_local TransitionTable TRANSITION_TABLE;
   static const int VAR_PER_TRACK = 9;
   static const int DEFAULT_NUM_OF_VARIABLES = 8;
-  static bool debug;
-  static int num_hits;
-  static int num_misses;
+  static const int DIRECT_REGEX_MAX_NUM_OF_STATES = 1 << 14;
+  static thread_local bool debug;
 
 private:
   StringAutomaton();
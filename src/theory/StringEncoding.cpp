@@ -7,16 +7,224 @@
 
 #include "StringEncoding.h"
 
+#include <utility>
+
 namespace Vlab {
 namespace Theory {
 
-StringEncoding::StringEncoding() {
-  // TODO Auto-generated constructor stub
-
+StringEncoding::StringEncoding()
+    : alphabet_size_ { ALPHABET_SIZE },
+      number_of_bdd_variables_ { 8 },
+      codes_(ALPHABET_SIZE),
+      interval_starts_(ALPHABET_SIZE) {
+  for (int i = 0; i < number_of_bdd_variables_; ++i) {
+    bdd_variable_indices_.push_back(i);
+  }
+  for (int c = 0; c < ALPHABET_SIZE; ++c) {
+    codes_[c] = c;
+    interval_starts_[c] = c;
+  }
+  boundaries_.set(0);
+  boundaries_.set(ALPHABET_SIZE);
 }
 
 StringEncoding::~StringEncoding() {
-  // TODO Auto-generated destructor stub
+}
+
+void StringEncoding::AddString(const std::string& str) {
+  for (char c : str) {
+    AddCharacter(c);
+  }
+}
+
+void StringEncoding::AddCharacter(const char c) {
+  AddRange(c, c);
+}
+
+void StringEncoding::AddRange(const char from, const char to) {
+  unsigned char from_char = from;
+  unsigned char to_char = to;
+  if (from_char > to_char) {
+    std::swap(from_char, to_char);
+  }
+  boundaries_.set(from_char);
+  boundaries_.set(to_char + 1);
+}
+
+void StringEncoding::AddRegex(Util::RegularExpression_ptr regular_expression) {
+  switch (regular_expression->type()) {
+    case Util::RegularExpression::Type::UNION:
+    case Util::RegularExpression::Type::CONCATENATION:
+    case Util::RegularExpression::Type::INTERSECTION:
+      AddRegex(regular_expression->get_expr1());
+      AddRegex(regular_expression->get_expr2());
+      break;
+    case Util::RegularExpression::Type::OPTIONAL:
+    case Util::RegularExpression::Type::REPEAT_STAR:
+    case Util::RegularExpression::Type::REPEAT_PLUS:
+    case Util::RegularExpression::Type::REPEAT_MIN:
+    case Util::RegularExpression::Type::REPEAT_MINMAX:
+    case Util::RegularExpression::Type::COMPLEMENT:
+      AddRegex(regular_expression->get_expr1());
+      break;
+    case Util::RegularExpression::Type::CHAR:
+      AddCharacter(regular_expression->get_character());
+      break;
+    case Util::RegularExpression::Type::CHAR_RANGE:
+      AddRange(regular_expression->get_from_character(), regular_expression->get_to_character());
+      break;
+    case Util::RegularExpression::Type::STRING:
+      AddString(regular_expression->get_string());
+      break;
+    case Util::RegularExpression::Type::ANYCHAR:
+    case Util::RegularExpression::Type::EMPTY:
+    case Util::RegularExpression::Type::ANYSTRING:
+      break;
+    default:
+      LOG(FATAL)<< "Unsupported regular expression" << *regular_expression;
+      break;
+  }
+}
+
+/**
+ * The widest intervals are split until the intervals fill all codes of the bdd variables, so that
+ * every code stands for at least one character and any string over the codes decodes
+ */
+void StringEncoding::Compact() {
+  int num_of_intervals = boundaries_.count() - 1;
+  int number_of_bdd_variables = 1;
+  while ((1 << number_of_bdd_variables) < num_of_intervals) {
+    ++number_of_bdd_variables;
+  }
+  // codes are stored as characters of regular expressions, they have to stay below 128
+  const bool is_identity = (number_of_bdd_variables >= 8);
+
+  while (not is_identity and num_of_intervals < (1 << number_of_bdd_variables)) {
+    int widest_start = 0, widest_size = 0, start = 0;
+    for (int c = 1; c <= ALPHABET_SIZE; ++c) {
+      if (boundaries_[c]) {
+        if (c - start > widest_size) {
+          widest_start = start;
+          widest_size = c - start;
+        }
+        start = c;
+      }
+    }
+    boundaries_.set(widest_start + widest_size / 2);
+    ++num_of_intervals;
+  }
+
+  alphabet_size_ = is_identity ? ALPHABET_SIZE : num_of_intervals;
+  number_of_bdd_variables_ = is_identity ? 8 : number_of_bdd_variables;
+  bdd_variable_indices_.resize(number_of_bdd_variables_);
+  for (int i = 0; i < number_of_bdd_variables_; ++i) {
+    bdd_variable_indices_[i] = i;
+  }
+  interval_starts_.clear();
+  for (int c = 0; c < ALPHABET_SIZE; ++c) {
+    if (is_identity or boundaries_[c]) {
+      interval_starts_.push_back(c);
+    }
+    codes_[c] = interval_starts_.size() - 1;
+  }
+}
+
+bool StringEncoding::IsIdentity() const {
+  return alphabet_size_ == ALPHABET_SIZE;
+}
+
+int StringEncoding::GetAlphabetSize() const {
+  return alphabet_size_;
+}
+
+int StringEncoding::GetNumOfBddVariables() const {
+  return number_of_bdd_variables_;
+}
+
+const int* StringEncoding::GetBddVariableIndices() const {
+  return bdd_variable_indices_.data();
+}
+
+unsigned long StringEncoding::Encode(const char c) const {
+  return codes_[(unsigned char) c];
+}
+
+std::string StringEncoding::Encode(const std::string& str) const {
+  std::string codes;
+  codes.reserve(str.size());
+  for (char c : str) {
+    codes.push_back((char) Encode(c));
+  }
+  return codes;
+}
+
+Util::RegularExpression_ptr StringEncoding::Encode(Util::RegularExpression_ptr regular_expression) const {
+  if (IsIdentity()) {
+    return regular_expression->clone();
+  }
+  switch (regular_expression->type()) {
+    case Util::RegularExpression::Type::UNION:
+      return Util::RegularExpression::makeUnion(Encode(regular_expression->get_expr1()), Encode(regular_expression->get_expr2()));
+    case Util::RegularExpression::Type::CONCATENATION:
+      return Util::RegularExpression::makeConcatenation(Encode(regular_expression->get_expr1()), Encode(regular_expression->get_expr2()));
+    case Util::RegularExpression::Type::INTERSECTION:
+      return Util::RegularExpression::makeIntersection(Encode(regular_expression->get_expr1()), Encode(regular_expression->get_expr2()));
+    case Util::RegularExpression::Type::OPTIONAL:
+      return Util::RegularExpression::makeOptional(Encode(regular_expression->get_expr1()));
+    case Util::RegularExpression::Type::REPEAT_STAR:
+      return Util::RegularExpression::makeRepeatStar(Encode(regular_expression->get_expr1()));
+    case Util::RegularExpression::Type::REPEAT_PLUS:
+      return Util::RegularExpression::makeRepeatPlus(Encode(regular_expression->get_expr1()));
+    case Util::RegularExpression::Type::REPEAT_MIN:
+      return Util::RegularExpression::makeRepeat(Encode(regular_expression->get_expr1()), regular_expression->get_min());
+    case Util::RegularExpression::Type::REPEAT_MINMAX:
+      return Util::RegularExpression::makeRepeat(Encode(regular_expression->get_expr1()), regular_expression->get_min(),
+                                                 regular_expression->get_max());
+    case Util::RegularExpression::Type::COMPLEMENT:
+      return Util::RegularExpression::makeComplement(Encode(regular_expression->get_expr1()));
+    case Util::RegularExpression::Type::CHAR:
+      return Util::RegularExpression::makeChar((char) Encode(regular_expression->get_character()));
+    case Util::RegularExpression::Type::CHAR_RANGE: {
+      unsigned long from = Encode(regular_expression->get_from_character());
+      unsigned long to = Encode(regular_expression->get_to_character());
+      if (from > to) {
+        std::swap(from, to);
+      }
+      return Util::RegularExpression::makeCharRange((char) from, (char) to);
+    }
+    case Util::RegularExpression::Type::ANYCHAR:
+      return Util::RegularExpression::makeAnyChar();
+    case Util::RegularExpression::Type::EMPTY:
+      return Util::RegularExpression::makeEmpty();
+    case Util::RegularExpression::Type::STRING:
+      return Util::RegularExpression::makeString(Encode(regular_expression->get_string()));
+    case Util::RegularExpression::Type::ANYSTRING:
+      return Util::RegularExpression::makeAnyString();
+    default:
+      LOG(FATAL)<< "Unsupported regular expression" << *regular_expression;
+      break;
+  }
+  return nullptr;
+}
+
+char StringEncoding::Decode(const unsigned long code) const {
+  CHECK_LT(code, (unsigned long) alphabet_size_) << "invalid code";
+  return (char) interval_starts_[code];
+}
+
+std::string StringEncoding::Decode(const std::string& codes) const {
+  std::string str;
+  str.reserve(codes.size());
+  for (char code : codes) {
+    str.push_back(Decode((unsigned char) code));
+  }
+  return str;
+}
+
+unsigned long StringEncoding::GetWeight(const unsigned long code) const {
+  CHECK_LT(code, (unsigned long) alphabet_size_) << "invalid code";
+  const int next_start = (code + 1 < (unsigned long) alphabet_size_) ? interval_starts_[code + 1] : ALPHABET_SIZE;
+  return next_start - interval_starts_[code];
 }
 
 } /* namespace Theory */
@@ -8,25 +8,111 @@
 #ifndef SRC_THEORY_STRINGENCODING_H_
 #define SRC_THEORY_STRINGENCODING_H_
 
+#include <bitset>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "../utils/RegularExpression.h"
+
 namespace Vlab {
 namespace Theory {
 
 /**
- * TODO add an encoding class for all types
- * 1- can be added a base encoding
- * 2- encoding describes how we map alphabet used in automata to bdd transitions
+ * Maps the 256 characters to the codes used as automata symbols.
+ *
+ * The identity encoding uses the character values as codes with 8 bdd variables. A compact
+ * encoding splits the characters into intervals at the characters and ranges that the
+ * constraints mention, so that each mentioned character gets its own code and each run of
+ * characters that no constraint tells apart shares a single "other" code. Codes follow the
+ * character order, a character range maps to a range of codes and comparisons are kept.
+ * The intervals fill all codes of the bdd variables, a code stands for as many characters as
+ * its interval has and counting weights the codes with their interval sizes to count over the
+ * full alphabet. All automata that are combined must be built with the same encoding.
  */
 class StringEncoding {
  public:
+  static const int ALPHABET_SIZE = 256;
+
+  /**
+   * Identity encoding
+   */
   StringEncoding();
-  StringEncoding(int alphabet_size);
+  ~StringEncoding();
+
+  /**
+   * Characters of the string get their own codes
+   * @param str
+   */
+  void AddString(const std::string& str);
+  void AddCharacter(const char c);
+  /**
+   * Characters of the range share codes only with each other
+   * @param from
+   * @param to
+   */
+  void AddRange(const char from, const char to);
+  /**
+   * Adds the characters and ranges of the regular expression
+   * @param regular_expression
+   */
+  void AddRegex(Util::RegularExpression_ptr regular_expression);
+
+  /**
+   * Switches to the compact encoding of the characters added so far, stays the identity
+   * encoding if the compact one does not need fewer bdd variables
+   */
+  void Compact();
+
+  bool IsIdentity() const;
+  /**
+   * @return number of codes, 2^(number of bdd variables)
+   */
+  int GetAlphabetSize() const;
+  int GetNumOfBddVariables() const;
+  const int* GetBddVariableIndices() const;
+
+  unsigned long Encode(const char c) const;
+  /**
+   * @param str
+   * @return string of the codes of the characters
+   */
+  std::string Encode(const std::string& str) const;
+  /**
+   * @param regular_expression
+   * @return a new regular expression over the codes, owned by the caller
+   */
+  Util::RegularExpression_ptr Encode(Util::RegularExpression_ptr regular_expression) const;
+
+  /**
+   * @param code
+   * @return smallest character of the code
+   */
+  char Decode(const unsigned long code) const;
+  std::string Decode(const std::string& codes) const;
+
+  /**
+   * @param code
+   * @return number of characters the code stands for
+   */
+  unsigned long GetWeight(const unsigned long code) const;
+
  private:
   int alphabet_size_;
   int number_of_bdd_variables_;
-  int* bdd_variable_indices_;
+  std::vector<int> bdd_variable_indices_;
 
+  /**
+   * boundaries_[c] is set if an interval starts at character c
+   */
+  std::bitset<ALPHABET_SIZE + 1> boundaries_;
+  std::vector<unsigned char> codes_;
+  std::vector<int> interval_starts_;
 };
 
+using StringEncoding_ptr = StringEncoding*;
+
 } /* namespace Theory */
 } /* namespace Vlab */
 
@@ -38,16 +38,16 @@ StringFormula_ptr StringFormula::clone() const {
 std::string StringFormula::str() const {
   std::stringstream ss;
 
-  for (auto& el : variable_coefficient_map_) {
-    const int coefficient = el.second;
+  for (std::size_t i = 0; i < coefficients_.size(); ++i) {
+    const int coefficient = coefficients_[i];
     if (coefficient > 0) {
       ss << "(";
       ss << coefficient;
       ss << ",";
-      ss << el.first;
+      ss << layout_->variables[i];
       ss << ") ";
     } else if (type_ == Type::INTERSECT or type_ == Type::UNION) {
-      ss << el.first << " " ;
+      ss << layout_->variables[i] << " " ;
     }
   }
 
@@ -193,8 +193,8 @@ void StringFormula::SetConstant(std::string constant) {
 }
 
 bool StringFormula::IsConstant() const {
-  for (const auto& el : variable_coefficient_map_) {
-    if (el.second != 0) {
+  for (const int coefficient : coefficients_) {
+    if (coefficient != 0) {
       return false;
     }
   }
@@ -250,10 +250,10 @@ bool StringFormula::UpdateMixedConstraintRelations() {
 
 int StringFormula::CountOnes(unsigned long n) const {
   int ones = 0;
-  for (const auto& el : variable_coefficient_map_) {
-    if (el.second != 0) {
+  for (const int coefficient : coefficients_) {
+    if (coefficient != 0) {
       if (n & 1) {
-        ones += el.second;
+        ones += coefficient;
       }
       n >>= 1;
     }
@@ -265,11 +265,7 @@ void StringFormula::MergeVariables(Formula_ptr other) {
   if(other == nullptr) {
     return;
   }
-  for (auto& el : other->GetVariableCoefficientMap()) {
-    if (variable_coefficient_map_.find(el.first) == variable_coefficient_map_.end()) {
-      variable_coefficient_map_[el.first] = 0;
-    }
-  }
+  MergeLayout(*other);
 }
 
 bool StringFormula::GetVarNamesIfEqualityOfTwoVars(std::string &v1, std::string &v2) {
@@ -279,13 +275,13 @@ bool StringFormula::GetVarNamesIfEqualityOfTwoVars(std::string &v1, std::string
   v1.clear();
   v2.clear();
   int active_vars = 0;
-  for (auto& el : variable_coefficient_map_) {
-    if (el.second != 0) {
+  for (std::size_t i = 0; i < coefficients_.size(); ++i) {
+    if (coefficients_[i] != 0) {
       ++active_vars;
-      if (el.second == 1) {
-        v1 = el.first;
-      } else if (el.second == -1) {
-        v2 = el.first;
+      if (coefficients_[i] == 1) {
+        v1 = layout_->variables[i];
+      } else if (coefficients_[i] == -1) {
+        v2 = layout_->variables[i];
       }
       if (active_vars > 2) {
         return false;
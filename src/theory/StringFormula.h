@@ -67,6 +67,28 @@ class StringFormula : public Formula {
   int CountOnes(unsigned long n) const;
   virtual void MergeVariables(Formula_ptr);
 
+  /**
+   * Relations to mixed terms refer to the syntax tree and are not saved
+   */
+  template <class Archive>
+  void save(Archive& ar) const {
+    Formula::save(ar);
+    ar(static_cast<int>(type_));
+    ar(constant_);
+    ar(regex_constant_);
+  }
+
+  template <class Archive>
+  void load(Archive& ar) {
+    Formula::load(ar);
+    int type = 0;
+    ar(type);
+    type_ = static_cast<Type>(type);
+    ar(constant_);
+    ar(regex_constant_);
+    mixed_terms_.clear();
+  }
+
   friend std::ostream& operator<<(std::ostream& os, const StringFormula& formula);
 
 protected:
@@ -12,7 +12,20 @@ namespace Theory {
 
 const int SymbolicCounter::VLOG_LEVEL = 9;
 
-SymbolicCounter::SymbolicCounter() : type_(SymbolicCounter::Type::STRING), bound_(0) {
+const unsigned long SymbolicCounter::SQUARING_MIN_POWER = 64;
+
+const unsigned long SymbolicCounter::RECURRENCE_MAX_CACHED_TERMS = 1 << 14;
+
+const uint64_t SymbolicCounter::RECURRENCE_PRIME_LIMIT = 1ul << 31;
+
+const uint64_t SymbolicCounter::MODULAR_PRIME_LIMIT = 1ul << 28;
+
+const unsigned SymbolicCounter::MODULAR_MAX_PENDING_PRODUCTS = 255;
+
+
+SymbolicCounter::SymbolicCounter()
+    : type_(SymbolicCounter::Type::STRING), bound_(0), is_recurrence_cached_(false),
+      is_compressed_rows_cached_(false), is_compressed_rows_native_(false) {
 
 }
 
@@ -49,16 +62,101 @@ Eigen::SparseMatrix<BigInteger> SymbolicCounter::get_transition_count_matrix() c
 
 void SymbolicCounter::set_transition_count_matrix(const Eigen::SparseMatrix<BigInteger>& transition_count_matrix) {
   transition_count_matrix_ = transition_count_matrix;
+  is_recurrence_cached_ = false;
+  recurrence_.clear();
+  recurrence_terms_.clear();
+  is_compressed_rows_cached_ = false;
+  row_offsets_.clear();
+  column_indices_.clear();
+  values_.clear();
 }
 
 BigInteger SymbolicCounter::Count(const unsigned long bound) {
+  if (SymbolicCounter::Type::UNARYINT == type_) {
+    return CountUnary(bound);
+  }
+
+  const auto method = Option::Theory::COUNTING_METHOD;
+  if (Option::CountingMethod::RECURRENCE == method) {
+    return CountByRecurrence(bound);
+  } else if (Option::CountingMethod::MODULAR == method) {
+    return CountByModularArithmetic(bound);
+  } else if (Option::CountingMethod::AUTO == method and IsRecurrenceCheaper(bound)) {
+    return CountByRecurrence(bound);
+  }
+
+  const unsigned long power = PrepareCount(bound);
+  bool use_squaring = false;
+  switch (method) {
+    case Option::CountingMethod::ITERATION:
+      use_squaring = false;
+      break;
+    case Option::CountingMethod::SQUARING:
+      use_squaring = true;
+      break;
+    default:
+      use_squaring = IsSquaringCheaper(power);
+      break;
+  }
+  Advance(power, use_squaring);
+  return FinishCount(bound);
+}
+
+/**
+ * Counting with matrix exponentiation by successive squaring
+ */
+BigInteger SymbolicCounter::CountbyMatrixMultiplication(const unsigned long bound) {
+  if (SymbolicCounter::Type::UNARYINT == type_) {
+    return CountUnary(bound);
+  }
+  const unsigned long power = PrepareCount(bound);
+  Advance(power, true);
+  return FinishCount(bound);
+}
+
+BigInteger SymbolicCounter::CountByRecurrence(const unsigned long bound) {
+  if (SymbolicCounter::Type::UNARYINT == type_) {
+    return CountUnary(bound);
+  }
+  if (not is_recurrence_cached_) {
+    DeriveRecurrence();
+  }
+
+  unsigned long power = bound;
+  if (SymbolicCounter::Type::BINARYINT == type_) {
+    ++power; // handle sign bit
+  }
+
+  BigInteger result = EvaluateRecurrence(power);
+  DVLOG(VLOG_LEVEL) << "Count(" << bound << ") = " << result << " with recurrence of order " << recurrence_.size();
+  return result;
+}
+
+std::vector<BigInteger> SymbolicCounter::CountRange(const std::vector<unsigned long>& bounds) {
+  std::vector<std::size_t> order(bounds.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&bounds](const std::size_t i, const std::size_t j) {
+    return bounds[i] < bounds[j];
+  });
+
+  // the cached vector only moves forward on increasing bounds, at most one reset for the smallest one
+  std::vector<BigInteger> results(bounds.size());
+  for (std::size_t k = 0; k < order.size(); ++k) {
+    const std::size_t i = order[k];
+    if (k > 0 and bounds[order[k - 1]] == bounds[i]) {
+      results[i] = results[order[k - 1]];
+    } else {
+      results[i] = Count(bounds[i]);
+    }
+  }
+  return results;
+}
+
+unsigned long SymbolicCounter::PrepareCount(const unsigned long bound) {
   unsigned long power = bound;
 
   if (SymbolicCounter::Type::BINARYINT == type_) {
     ++power; // handle sign bit
-  } else if (SymbolicCounter::Type::UNARYINT == type_) {
-    unsigned long base = 1;
-    power = (base << bound) - 1;
   }
 
   if (power >= bound_) {
@@ -66,65 +164,540 @@ BigInteger SymbolicCounter::Count(const unsigned long bound) {
   } else {
     initialization_vector_ = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
   }
+  return power;
+}
 
+void SymbolicCounter::Advance(unsigned long power, const bool use_squaring) {
+  if (not use_squaring) {
+    AdvanceNative(power);
+    while (power > 0) {
+      initialization_vector_ = transition_count_matrix_ * initialization_vector_;
+      --power;
+    }
+    return;
+  }
+
+  // M^p * v, matrix powers commute so the vector can absorb the odd factors as we go
+  Eigen::SparseMatrix<BigInteger> base = transition_count_matrix_;
   while (power > 0) {
-    initialization_vector_ = transition_count_matrix_ * initialization_vector_;
+    if (power & 1) {
+      initialization_vector_ = base * initialization_vector_;
+    }
+    power >>= 1;
+    if (power > 0) {
+      // conservative product, the pruning product copies coefficients with memcpy which breaks BigInteger
+      base = base * base;
+    }
+  }
+}
+
+template <>
+bool SymbolicCounter::MultiplyNative<uint64_t>(const std::vector<uint64_t>& current, std::vector<uint64_t>& next) const {
+#ifdef __SIZEOF_INT128__
+  // each product fits in 128 bits, a row sum stays below 2^128 as long as it stays below 2^64 before the add
+  const std::size_t number_of_states = next.size();
+  for (std::size_t row = 0; row < number_of_states; ++row) {
+    unsigned __int128 sum = 0;
+    for (std::size_t k = row_offsets_[row]; k < row_offsets_[row + 1]; ++k) {
+      sum += static_cast<unsigned __int128>(values_[k]) * current[column_indices_[k]];
+      if (sum >> 64) {
+        return false;
+      }
+    }
+    next[row] = static_cast<uint64_t>(sum);
+  }
+  return true;
+#else
+  const std::size_t number_of_states = next.size();
+  for (std::size_t row = 0; row < number_of_states; ++row) {
+    uint64_t sum = 0, product = 0;
+    for (std::size_t k = row_offsets_[row]; k < row_offsets_[row + 1]; ++k) {
+      if (__builtin_mul_overflow(values_[k], current[column_indices_[k]], &product) or __builtin_add_overflow(sum, product, &sum)) {
+        return false;
+      }
+    }
+    next[row] = sum;
+  }
+  return true;
+#endif
+}
+
+#ifdef __SIZEOF_INT128__
+template <>
+bool SymbolicCounter::MultiplyNative<unsigned __int128>(const std::vector<unsigned __int128>& current, std::vector<unsigned __int128>& next) const {
+  const std::size_t number_of_states = next.size();
+  for (std::size_t row = 0; row < number_of_states; ++row) {
+    unsigned __int128 sum = 0, product = 0;
+    for (std::size_t k = row_offsets_[row]; k < row_offsets_[row + 1]; ++k) {
+      if (__builtin_mul_overflow(static_cast<unsigned __int128>(values_[k]), current[column_indices_[k]], &product)
+          or __builtin_add_overflow(sum, product, &sum)) {
+        return false;
+      }
+    }
+    next[row] = sum;
+  }
+  return true;
+}
+#endif
+
+void SymbolicCounter::AdvanceNative(unsigned long& power) {
+  if (power == 0) {
+    return;
+  }
+  if (not is_compressed_rows_cached_) {
+    SetCompressedRows();
+  }
+  if (not is_compressed_rows_native_) {
+    return;
+  }
+
+  if (not AdvanceInWords<uint64_t>(power)) {
+#ifdef __SIZEOF_INT128__
+    AdvanceInWords<unsigned __int128>(power);
+#endif
+  }
+}
+
+template <class Word>
+bool SymbolicCounter::AdvanceInWords(unsigned long& power) {
+  const std::size_t number_of_states = row_offsets_.size() - 1;
+  const BigInteger max_word = std::numeric_limits<Word>::max();
+  std::vector<Word> current(number_of_states, 0), next(number_of_states, 0);
+  for (Eigen::SparseVector<BigInteger>::InnerIterator it(initialization_vector_); it; ++it) {
+    if (it.value() > max_word) {
+      return false;
+    }
+    current[it.index()] = it.value().template convert_to<Word>();
+  }
+
+  const unsigned long total_steps = power;
+  bool is_fitting = true;
+  while (power > 0) {
+    is_fitting = MultiplyNative(current, next);
+    if (not is_fitting) {
+      break;
+    }
+    current.swap(next);
     --power;
   }
 
+  if (power < total_steps) {
+    Eigen::SparseVector<BigInteger> result(initialization_vector_.size());
+    for (std::size_t i = 0; i < number_of_states; ++i) {
+      if (current[i] != 0) {
+        result.insert(i) = BigInteger(current[i]);
+      }
+    }
+    initialization_vector_ = result;
+  }
+  DVLOG(VLOG_LEVEL) << (total_steps - power) << " of " << total_steps << " steps in " << 8 * sizeof(Word) << "-bit words";
+  return is_fitting;
+}
+
+void SymbolicCounter::SetCompressedRows() {
+  Eigen::SparseMatrix<BigInteger, Eigen::RowMajor> rows = transition_count_matrix_;
+  const BigInteger max_word = std::numeric_limits<uint64_t>::max();
+  row_offsets_.assign(1, 0);
+  column_indices_.clear();
+  values_.clear();
+  is_compressed_rows_native_ = true;
+  for (long row = 0; row < rows.outerSize(); ++row) {
+    for (Eigen::SparseMatrix<BigInteger, Eigen::RowMajor>::InnerIterator it(rows, row); it; ++it) {
+      if (it.value() == 0) {
+        continue;
+      } else if (it.value() < 0 or it.value() > max_word) {
+        is_compressed_rows_native_ = false;
+        continue;
+      }
+      column_indices_.push_back(it.col());
+      values_.push_back(it.value().convert_to<uint64_t>());
+    }
+    row_offsets_.push_back(column_indices_.size());
+  }
+  is_compressed_rows_cached_ = true;
+}
+
+BigInteger SymbolicCounter::CountByModularArithmetic(const unsigned long bound) {
+  if (SymbolicCounter::Type::UNARYINT == type_) {
+    return CountUnary(bound);
+  }
+  if (not is_compressed_rows_cached_) {
+    SetCompressedRows();
+  }
+  if (not is_compressed_rows_native_) {
+    return CountbyMatrixMultiplication(bound);
+  }
+
+  unsigned long power = bound;
+  if (SymbolicCounter::Type::BINARYINT == type_) {
+    ++power; // handle sign bit
+  }
+
+  // the count is at most (max row sum)^p * max(v), entries are non-negative
+  const std::size_t number_of_states = row_offsets_.size() - 1;
+  const Eigen::SparseVector<BigInteger> start_vector = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
+  BigInteger max_row_sum = 1, max_start_value = 1;
+  for (std::size_t row = 0; row < number_of_states; ++row) {
+    BigInteger row_sum = 0;
+    for (std::size_t k = row_offsets_[row]; k < row_offsets_[row + 1]; ++k) {
+      row_sum += values_[k];
+    }
+    max_row_sum = std::max(max_row_sum, row_sum);
+  }
+  for (Eigen::SparseVector<BigInteger>::InnerIterator it(start_vector); it; ++it) {
+    max_start_value = std::max(max_start_value, it.value());
+  }
+  unsigned long row_sum_bits = boost::multiprecision::msb(max_row_sum);
+  if (max_row_sum != (BigInteger(1) << row_sum_bits)) {
+    ++row_sum_bits; // ceil(log2(max row sum))
+  }
+  const unsigned long count_bits = power * row_sum_bits + boost::multiprecision::msb(max_start_value) + 1;
+
+  std::vector<uint64_t> primes;
+  unsigned long prime_bits = 0;
+  uint64_t prime = MODULAR_PRIME_LIMIT;
+  while (prime_bits < count_bits) {
+    prime = Util::Math::previous_prime(prime);
+    CHECK_NE(0, prime) << "ran out of primes for modular counting";
+    primes.push_back(prime);
+    prime_bits += 27; // primes are in (2^27, 2^28), their product exceeds 2^count_bits
+  }
+
+  // residues of a state are contiguous so the inner loop over primes vectorizes
+  const std::size_t number_of_primes = primes.size();
+  const std::size_t number_of_values = values_.size();
+  std::vector<uint64_t> values(number_of_values * number_of_primes);
+  for (std::size_t k = 0; k < number_of_values; ++k) {
+    for (std::size_t i = 0; i < number_of_primes; ++i) {
+      values[k * number_of_primes + i] = values_[k] % primes[i];
+    }
+  }
+  std::vector<uint64_t> current(number_of_states * number_of_primes, 0), next(number_of_states * number_of_primes, 0);
+  for (Eigen::SparseVector<BigInteger>::InnerIterator it(start_vector); it; ++it) {
+    for (std::size_t i = 0; i < number_of_primes; ++i) {
+      current[it.index() * number_of_primes + i] = static_cast<uint64_t>(it.value() % primes[i]);
+    }
+  }
+
+  for (unsigned long step = 0; step < power; ++step) {
+    for (std::size_t row = 0; row < number_of_states; ++row) {
+      uint64_t* sums = &next[row * number_of_primes];
+      std::fill(sums, sums + number_of_primes, 0);
+      unsigned pending = 0;
+      for (std::size_t k = row_offsets_[row]; k < row_offsets_[row + 1]; ++k) {
+        const uint64_t* lhs = &values[k * number_of_primes];
+        const uint64_t* rhs = &current[column_indices_[k] * number_of_primes];
+        for (std::size_t i = 0; i < number_of_primes; ++i) {
+          sums[i] += lhs[i] * rhs[i];
+        }
+        // products are below 2^56, reduce before the sums could overflow
+        if (++pending == MODULAR_MAX_PENDING_PRODUCTS) {
+          for (std::size_t i = 0; i < number_of_primes; ++i) {
+            sums[i] %= primes[i];
+          }
+          pending = 0;
+        }
+      }
+      for (std::size_t i = 0; i < number_of_primes; ++i) {
+        sums[i] %= primes[i];
+      }
+    }
+    current.swap(next);
+  }
+
+  // Garner style CRT over the residues of the initial state
+  BigInteger result = 0, modulus = 1;
+  for (std::size_t i = 0; i < number_of_primes; ++i) {
+    const uint64_t residue = current[i];
+    const uint64_t result_residue = static_cast<uint64_t>(result % primes[i]);
+    const uint64_t modulus_inverse = Util::Math::mod_pow(static_cast<uint64_t>(modulus % primes[i]), primes[i] - 2, primes[i]);
+    const uint64_t t = (residue + primes[i] - result_residue) % primes[i] * modulus_inverse % primes[i];
+    result += modulus * t;
+    modulus *= primes[i];
+  }
+
+  DVLOG(VLOG_LEVEL) << "Count(" << bound << ") = " << result << " with " << number_of_primes << " primes";
+  return result;
+}
+
+bool SymbolicCounter::IsSquaringCheaper(const unsigned long power) const {
+  if (power < SQUARING_MIN_POWER) {
+    return false;
+  }
+  const double iteration_cost = EstimateIterationCost(power);
+  const double squaring_cost = EstimateSquaringCost(power);
+  DVLOG(VLOG_LEVEL) << "iteration cost: " << iteration_cost << ", squaring cost: " << squaring_cost;
+  return squaring_cost < iteration_cost;
+}
+
+bool SymbolicCounter::IsRecurrenceCheaper(const unsigned long bound) const {
+  unsigned long power = bound;
+  if (SymbolicCounter::Type::BINARYINT == type_) {
+    ++power; // handle sign bit
+  }
+  const double states = transition_count_matrix_.rows();
+
+  // the cached vector is only stepped forward from the last bound
+  const unsigned long steps = (power >= bound_) ? power - bound_ : power;
+  double matrix_cost = EstimateIterationCost(steps);
+  if (IsSquaringCheaper(steps)) {
+    matrix_cost = EstimateSquaringCost(steps);
+  }
+
+  // deriving takes 2 * (#states) mat-vec steps and Berlekamp-Massey on as many terms,
+  // the order of the recurrence is at most the number of states
+  double recurrence_cost = 0;
+  double order = states;
+  double cached_terms = 2 * states;
+  if (is_recurrence_cached_) {
+    order = recurrence_.size();
+    cached_terms = recurrence_terms_.size();
+  } else {
+    recurrence_cost = EstimateIterationCost(2 * transition_count_matrix_.rows()) + 4 * states * states;
+  }
+  if (power >= cached_terms) {
+    recurrence_cost += (power - cached_terms + 1) * order;
+  }
+  DVLOG(VLOG_LEVEL) << "matrix cost: " << matrix_cost << ", recurrence cost: " << recurrence_cost;
+  return recurrence_cost < matrix_cost;
+}
+
+double SymbolicCounter::EstimateIterationCost(const unsigned long power) const {
+  const double non_zeros = std::max<double>(1, transition_count_matrix_.nonZeros());
+  return static_cast<double>(power) * non_zeros;
+}
+
+double SymbolicCounter::EstimateSquaringCost(const unsigned long power) const {
+  if (power == 0) {
+    return 0;
+  }
+  const double states = transition_count_matrix_.rows();
+  const double squarings = std::floor(std::log2(static_cast<double>(power))) + 1;
+  // powers of the count matrix fill in quickly, assume a dense product per squaring
+  return squarings * states * states * states;
+}
+
+void SymbolicCounter::DeriveRecurrence() {
+  const long number_of_terms = 2 * transition_count_matrix_.rows();
+  recurrence_terms_.clear();
+  recurrence_terms_.reserve(number_of_terms);
+  Eigen::SparseVector<BigInteger> count_vector = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
+  for (long k = 0; k < number_of_terms; ++k) {
+    recurrence_terms_.push_back(count_vector.coeff(0));
+    count_vector = transition_count_matrix_ * count_vector;
+  }
+
+  // Berlekamp-Massey modulo word sized primes, coefficients are combined with CRT until they
+  // stop changing and then checked against the exact terms; the minimal polynomial of an
+  // integer matrix is monic over integers, so is the recurrence
+  std::vector<BigInteger> residues, candidate;
+  BigInteger modulus = 1;
+  std::size_t order = 0;
+  uint64_t prime = RECURRENCE_PRIME_LIMIT;
+  while (true) {
+    prime = Util::Math::previous_prime(prime);
+    CHECK_NE(0, prime) << "ran out of primes while deriving recurrence";
+
+    std::vector<uint64_t> sequence;
+    sequence.reserve(recurrence_terms_.size());
+    for (auto& term : recurrence_terms_) {
+      sequence.push_back(static_cast<uint64_t>(term % prime));
+    }
+    std::vector<uint64_t> coefficients = Util::Math::berlekamp_massey(sequence, prime);
+    if (coefficients.size() < order) {
+      continue; // prime divides some discrepancy, skip it
+    } else if (coefficients.size() > order) {
+      order = coefficients.size();
+      residues.assign(order, 0);
+      candidate.assign(order, 0);
+      modulus = 1;
+    }
+
+    const uint64_t modulus_inverse = Util::Math::mod_pow(static_cast<uint64_t>(modulus % prime), prime - 2, prime);
+    std::vector<BigInteger> lifted(order);
+    for (std::size_t j = 0; j < order; ++j) {
+      const uint64_t residue = static_cast<uint64_t>(residues[j] % prime);
+      const uint64_t t = (coefficients[j] + prime - residue) % prime * modulus_inverse % prime;
+      residues[j] += modulus * t;
+    }
+    modulus *= prime;
+    const BigInteger half_modulus = modulus / 2;
+    for (std::size_t j = 0; j < order; ++j) {
+      lifted[j] = (residues[j] > half_modulus) ? BigInteger(residues[j] - modulus) : residues[j];
+    }
+
+    if (lifted == candidate and modulus > prime) {
+      bool is_valid = true;
+      for (std::size_t k = order; k < recurrence_terms_.size() and is_valid; ++k) {
+        BigInteger term = 0;
+        for (std::size_t j = 1; j <= order; ++j) {
+          term += lifted[j - 1] * recurrence_terms_[k - j];
+        }
+        is_valid = (term == recurrence_terms_[k]);
+      }
+      if (is_valid) {
+        break;
+      }
+    }
+    candidate = lifted;
+  }
+
+  recurrence_ = candidate;
+  is_recurrence_cached_ = true;
+  DVLOG(VLOG_LEVEL) << "recurrence of order " << order << " derived from " << number_of_terms << " terms";
+}
+
+BigInteger SymbolicCounter::EvaluateRecurrence(const unsigned long power) {
+  const std::size_t order = recurrence_.size();
+  if (power < recurrence_terms_.size()) {
+    return recurrence_terms_[power];
+  } else if (order == 0) {
+    return 0;
+  }
+
+  // a_k = c_1 * a_(k-1) + ... + c_d * a_(k-d), coefficients are small so each step is linear in the size of a_k
+  auto next_term = [this, order](const std::vector<BigInteger>& terms, const std::size_t k) {
+    BigInteger term = 0;
+    for (std::size_t j = 1; j <= order; ++j) {
+      if (recurrence_[j - 1] != 0) {
+        term += recurrence_[j - 1] * terms[k - j];
+      }
+    }
+    return term;
+  };
+
+  if (power - recurrence_terms_.size() < RECURRENCE_MAX_CACHED_TERMS) {
+    while (recurrence_terms_.size() <= power) {
+      recurrence_terms_.push_back(next_term(recurrence_terms_, recurrence_terms_.size()));
+    }
+    return recurrence_terms_[power];
+  }
+
+  // far bounds slide a window of the last d terms instead of caching all of them
+  std::vector<BigInteger> window(recurrence_terms_.end() - order, recurrence_terms_.end());
+  for (unsigned long k = recurrence_terms_.size(); k <= power; ++k) {
+    window.push_back(next_term(window, window.size()));
+    window.erase(window.begin());
+  }
+  return window.back();
+}
+
+BigInteger SymbolicCounter::FinishCount(const unsigned long bound) {
   bound_ = bound;
   if (SymbolicCounter::Type::BINARYINT == type_) {
     ++bound_; // handle sign bit
   }
 
-
   DVLOG(VLOG_LEVEL) << "Count(" << bound << ") = " << initialization_vector_.coeff(0);
   return initialization_vector_.coeff(0);
 }
 
-BigInteger SymbolicCounter::CountbyMatrixMultiplication(const unsigned long bound) {
-  LOG(FATAL) << "not fixed yet";
-  return 0;
-  //  // matrix exponentiation is off by 1 because of artificial accepting state
-//  int power = bound + 1;
-//
-//  Eigen::SparseMatrix<BigInteger> y;
-//  bool has_odds = false;
-//
-//  while (power > 1) {
-//    if (power % 2 == 0) {
-//      power = power / 2;
-//    } else {
-//      power = (power - 1) / 2;
-//      if (has_odds) {
-//        y = x * y;
-//      } else {
-//        y = x;
-//        has_odds = true;
-//      }
-//    }
-//    x = x * x;
-//  }
-//
-//  if (has_odds) {
-//    x = x * y;
-//  }
-//
-//  BigInteger result = x.coeff(this->dfa_->s, this->dfa_->ns);
-//  return result;
+BigInteger SymbolicCounter::CountUnary(const unsigned long bound) {
+  SemilinearSet semilinear_set;
+  ComputeUnarySemilinearSet(semilinear_set);
+
+  const BigInteger max_value = (BigInteger(1) << bound) - 1;
+  const int artificial_state = transition_count_matrix_.cols() - 1;
+  BigInteger result = 0;
+  if (transition_count_matrix_.coeff(artificial_state, artificial_state) == 0) {
+    // exact bound, only the value 2^bound - 1 itself
+    result = semilinear_set.IsMember(max_value) ? 1 : 0;
+  } else {
+    result = semilinear_set.CountValuesUpTo(max_value);
+  }
+
+  bound_ = bound;
+  DVLOG(VLOG_LEVEL) << "Count(" << bound << ") = " << result << " with " << semilinear_set;
+  return result;
 }
 
-int SymbolicCounter::GetMinBound(int num_models) {
+int SymbolicCounter::GetUnaryMinBound(int num_models) {
+  SemilinearSet semilinear_set;
+  ComputeUnarySemilinearSet(semilinear_set);
 
+  int largest_value = 0;
+  for (auto c : semilinear_set.get_constants()) {
+    largest_value = std::max(largest_value, c);
+  }
+  const bool is_finite = semilinear_set.get_period() == 0 or semilinear_set.get_periodic_constants().empty();
+  for (auto r : semilinear_set.get_periodic_constants()) {
+    largest_value = std::max(largest_value, semilinear_set.get_cycle_head() + r);
+  }
+
+  // an infinite set gains members with every extra bit, a finite one stops once its largest value fits
+  int min_bound = 0;
+  while (true) {
+    const BigInteger max_value = (BigInteger(1) << min_bound) - 1;
+    if (semilinear_set.CountValuesUpTo(max_value) >= num_models) {
+      break;
+    } else if (is_finite and max_value >= largest_value) {
+      break;
+    }
+    ++min_bound;
+  }
+
+  bound_ = min_bound;
+  return min_bound;
+}
+
+void SymbolicCounter::ComputeUnarySemilinearSet(SemilinearSet& semilinear_set) const {
+  semilinear_set.clear();
+  const int artificial_state = transition_count_matrix_.cols() - 1;
+  if (artificial_state <= 0) {
+    return;
+  }
+
+  // row-major copy to read successors of a state, at most one non-sink successor per state for unary
+  Eigen::SparseMatrix<BigInteger, Eigen::RowMajor> successors = transition_count_matrix_;
+  std::map<int, int> values;
+  std::vector<int> accepting_values;
+  int state = 0, value = 0;
+  while (state != -1 and values.find(state) == values.end()) {
+    values[state] = value;
+    int next_state = -1;
+    for (Eigen::SparseMatrix<BigInteger, Eigen::RowMajor>::InnerIterator it(successors, state); it; ++it) {
+      if (it.value() == 0) {
+        continue;
+      } else if (it.col() == artificial_state) {
+        accepting_values.push_back(value);
+      } else {
+        DCHECK_EQ(-1, next_state) << "unary count matrix has more than one successor for state " << state;
+        next_state = it.col();
+      }
+    }
+    state = next_state;
+    ++value;
+  }
+
+  if (state == -1) {
+    for (auto v : accepting_values) {
+      semilinear_set.add_constant(v);
+    }
+    return;
+  }
+
+  const int cycle_head = values[state];
+  semilinear_set.set_cycle_head(cycle_head);
+  semilinear_set.set_period(value - cycle_head);
+  for (auto v : accepting_values) {
+    if (v < cycle_head) {
+      semilinear_set.add_constant(v);
+    } else {
+      semilinear_set.add_periodic_constant(v - cycle_head);
+    }
+  }
+}
+
+int SymbolicCounter::GetMinBound(int num_models) {
+	if (SymbolicCounter::Type::UNARYINT == type_) {
+		return GetUnaryMinBound(num_models);
+	}
 
 	unsigned long bound = INT_MAX;
 	unsigned long power = bound;
 
 	if (SymbolicCounter::Type::BINARYINT == type_) {
 		++power; // handle sign bit
-	} else if (SymbolicCounter::Type::UNARYINT == type_) {
-		unsigned long base = 1;
-		power = (base << bound) - 1;
 	}
 
 	if (power >= bound_) {
@@ -8,13 +8,23 @@
 #ifndef SRC_THEORY_SYMBOLICCOUNTER_H_
 #define SRC_THEORY_SYMBOLICCOUNTER_H_
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <numeric>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <glog/logging.h>
 
+#include "../utils/Math.h"
 #include "../utils/Serialize.h"
+#include "options/Theory.h"
+#include "SemilinearSet.h"
 
 namespace Vlab {
 namespace Theory {
@@ -37,8 +47,46 @@ class SymbolicCounter {
   Eigen::SparseMatrix<BigInteger> get_transition_count_matrix() const;
   void set_transition_count_matrix(const Eigen::SparseMatrix<BigInteger>& transition_count_matrix);
 
+  /**
+   * Counts models within the bound, picks iteration or successive squaring
+   * based on Option::Theory::COUNTING_METHOD
+   * @param bound
+   * @return
+   */
   BigInteger Count(const unsigned long bound);
+
+  /**
+   * Counts models within the bound using matrix exponentiation by successive squaring
+   * @param bound
+   * @return
+   */
   BigInteger CountbyMatrixMultiplication(const unsigned long bound);
+
+  /**
+   * Counts models within the bound by evaluating the linear recurrence (rational generating function)
+   * of the count sequence, the recurrence is derived once and reused for later bounds
+   * @param bound
+   * @return
+   */
+  BigInteger CountByRecurrence(const unsigned long bound);
+
+  /**
+   * Counts models for each bound in one forward sweep over the sorted bounds,
+   * so the cost is that of counting the largest bound only
+   * @param bounds in any order, may contain duplicates
+   * @return counts in the order of bounds
+   */
+  std::vector<BigInteger> CountRange(const std::vector<unsigned long>& bounds);
+
+  /**
+   * Counts models within the bound by iterating modulo enough primes below MODULAR_PRIME_LIMIT
+   * to cover the largest possible count and reconstructing it with CRT. The count is bounded
+   * by (max row sum)^bound * max(initial vector), computed in a single pass over the matrix.
+   * Always starts from the initial vector and leaves the cached vector alone
+   * @param bound
+   * @return
+   */
+  BigInteger CountByModularArithmetic(const unsigned long bound);
   int GetMinBound(int num_models);
 
   template <class Archive>
@@ -62,12 +110,159 @@ class SymbolicCounter {
   std::string str() const;
   friend std::ostream& operator<<(std::ostream& os, const SymbolicCounter& sc);
 protected:
+  /**
+   * Computes the number of matrix-vector steps needed for the bound
+   * and rewinds the cached vector if the bound is smaller than the last one
+   * @param bound
+   * @return remaining number of steps from the cached vector
+   */
+  unsigned long PrepareCount(const unsigned long bound);
+
+  /**
+   * Moves the cached vector forward by the given number of steps
+   * @param power
+   * @param use_squaring
+   */
+  void Advance(unsigned long power, const bool use_squaring);
+
+  /**
+   * Moves the cached vector forward in native words while the counts fit,
+   * first in 64 bits then in 128 bits where available
+   * @param power number of steps, decremented by the number of steps taken
+   */
+  void AdvanceNative(unsigned long& power);
+
+  /**
+   * One mat-vec step over the CSR copy of the count matrix
+   * @param current
+   * @param next
+   * @return false if a count does not fit in Word, next is then incomplete
+   */
+  template <class Word>
+  bool MultiplyNative(const std::vector<Word>& current, std::vector<Word>& next) const;
+
+  /**
+   * Runs native steps from the cached vector converted to Word and writes the result back
+   * @param power number of steps, decremented by the number of steps taken
+   * @return false if the cached vector or a step did not fit in Word
+   */
+  template <class Word>
+  bool AdvanceInWords(unsigned long& power);
+
+  /**
+   * Builds the row-major (CSR) copy of the count matrix used by the native and modular kernels
+   */
+  void SetCompressedRows();
+
+  /**
+   * Estimates whether successive squaring is cheaper than iterating
+   * mat-vec products, using state count, number of non-zeros and the power
+   * @param power
+   * @return
+   */
+  bool IsSquaringCheaper(const unsigned long power) const;
+
+  /**
+   * Estimates whether deriving (unless cached) and evaluating the recurrence is cheaper than
+   * stepping the cached vector to the bound, using state count, number of non-zeros, the
+   * order of the recurrence and the bound of the cached vector
+   * @param bound
+   * @return
+   */
+  bool IsRecurrenceCheaper(const unsigned long bound) const;
+
+  /**
+   * @param power
+   * @return number of coefficient products of power mat-vec steps
+   */
+  double EstimateIterationCost(const unsigned long power) const;
+
+  /**
+   * @param power
+   * @return number of coefficient products of raising a dense count matrix to the power
+   */
+  double EstimateSquaringCost(const unsigned long power) const;
+
+  BigInteger FinishCount(const unsigned long bound);
+
+  /**
+   * Finds the shortest linear recurrence a_k = c_1 * a_(k-1) + ... + c_d * a_(k-d) of the
+   * count sequence a_k = (M^k * v)(0) with modular Berlekamp-Massey on its first 2 * (#states) terms
+   */
+  void DeriveRecurrence();
+
+  /**
+   * Computes a_power by running the recurrence forward from the cached terms,
+   * terms of nearby bounds are cached so bound sweeps only pay for new terms
+   * @param power
+   * @return
+   */
+  BigInteger EvaluateRecurrence(const unsigned long power);
+
+  /**
+   * Counts unary integers up to 2^bound - 1 in closed form using the lasso
+   * shape of the unary count matrix instead of 2^bound - 1 mat-vec steps
+   * @param bound
+   * @return
+   */
+  BigInteger CountUnary(const unsigned long bound);
+
+  /**
+   * Minimum bound for unary counters, see GetMinBound
+   * @param num_models
+   * @return
+   */
+  int GetUnaryMinBound(int num_models);
+
+  /**
+   * Walks the lasso (prefix + cycle) of a unary count matrix starting from the initial state
+   * @param semilinear_set semilinear representation of the accepted values
+   */
+  void ComputeUnarySemilinearSet(SemilinearSet& semilinear_set) const;
+
   Type type_;
   unsigned long bound_;
   Eigen::SparseVector<BigInteger> initialization_vector_;
   Eigen::SparseMatrix<BigInteger> transition_count_matrix_;
+
+  /**
+   * Recurrence coefficients c_1..c_d and the leading terms of the count sequence,
+   * derived from the matrix on demand and not serialized
+   */
+  bool is_recurrence_cached_;
+  std::vector<BigInteger> recurrence_;
+  std::vector<BigInteger> recurrence_terms_;
+
+  /**
+   * CSR copy of the count matrix, values are only valid if every entry fits in 64 bits
+   */
+  bool is_compressed_rows_cached_;
+  bool is_compressed_rows_native_;
+  std::vector<std::size_t> row_offsets_;
+  std::vector<int> column_indices_;
+  std::vector<uint64_t> values_;
 private:
   static const int VLOG_LEVEL;
+  /**
+   * Squaring is never picked automatically below that many steps
+   */
+  static const unsigned long SQUARING_MIN_POWER;
+  /**
+   * Upper limit on the number of count sequence terms cached at once for a single query
+   */
+  static const unsigned long RECURRENCE_MAX_CACHED_TERMS;
+  /**
+   * Recurrences are derived modulo primes below that value so that products fit in 64 bits
+   */
+  static const uint64_t RECURRENCE_PRIME_LIMIT;
+  /**
+   * Modular counting uses primes below that value, so 255 products and a residue fit in 64 bits
+   * and a row is reduced once in most cases. Primes near 2^64 would need about twice fewer
+   * residues, but their products need 128 bit multiplication and a reduction per product, which
+   * keeps the loop over primes from vectorizing.
+   */
+  static const uint64_t MODULAR_PRIME_LIMIT;
+  static const unsigned MODULAR_MAX_PENDING_PRODUCTS;
 };
 
 } /* namespace Theory */
@@ -367,9 +367,17 @@ void UnaryAutomaton::SetFormula(ArithmeticFormula_ptr formula) {
 	formula_ = formula;
 }
 
+/**
+ * Unary counters are counted in closed form over the lasso of the count matrix,
+ * the artificial self-loop only tells whether the bound is exact
+ */
 void UnaryAutomaton::decide_counting_schema(Eigen::SparseMatrix<BigInteger>& count_matrix) {
-  LOG(FATAL) << "Not tested";
   counter_.set_type(SymbolicCounter::Type::UNARYINT);
+  if (count_bound_exact_) {
+    count_matrix.insert(this->dfa_->ns, this->dfa_->ns) = 0;
+  } else {
+    count_matrix.insert(this->dfa_->ns, this->dfa_->ns) = 1;
+  }
 }
 
 } /* namespace Theory */
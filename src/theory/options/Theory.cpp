@@ -13,8 +13,12 @@
 namespace Vlab {
 namespace Option {
 
-std::string Theory::TMP_PATH     = ".";
-std::string Theory::SCRIPT_PATH  = ".";
+thread_local std::string Theory::TMP_PATH     = ".";
+thread_local std::string Theory::SCRIPT_PATH  = ".";
+thread_local CountingMethod Theory::COUNTING_METHOD = CountingMethod::AUTO;
+thread_local bool Theory::USE_DIRECT_REGEX_CONSTRUCTION = true;
+thread_local bool Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION = true;
+int Theory::REGEX_CACHE_SIZE = 100000;
 
 } /* namespace Option */
 } /* namespace Vlab */
@@ -16,10 +16,38 @@
 namespace Vlab {
 namespace Option {
 
+/**
+ * Strategy used by symbolic counters to raise the transition count matrix to the bound,
+ * RECURRENCE derives the linear recurrence of the counts once and evaluates it per bound,
+ * MODULAR iterates modulo word sized primes and reconstructs the count with CRT
+ */
+enum class CountingMethod : int {
+  AUTO = 0,
+  ITERATION,
+  SQUARING,
+  RECURRENCE,
+  MODULAR
+};
+
 class Theory {
 public:
-  static std::string TMP_PATH;
-  static std::string SCRIPT_PATH;
+  static thread_local std::string TMP_PATH;
+  static thread_local std::string SCRIPT_PATH;
+  static thread_local CountingMethod COUNTING_METHOD;
+  /**
+   * Compiles unions, concatenations and repetitions of characters and strings in regular
+   * expressions into a single dfa instead of combining the automata of the sub-expressions
+   */
+  static thread_local bool USE_DIRECT_REGEX_CONSTRUCTION;
+  /**
+   * Builds the transition bdds of linear arithmetic automata one variable at a time instead of
+   * enumerating the assignments of the variables
+   */
+  static thread_local bool USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION;
+  /**
+   * Total number of dfa states kept in the process wide regex automata cache, 0 disables it
+   */
+  static int REGEX_CACHE_SIZE;
 };
 
 } /* namespace Option */
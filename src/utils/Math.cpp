@@ -28,6 +28,85 @@ int lcm(int x, int y) {
   return x * y / gcd(x, y);
 }
 
+bool is_prime(uint64_t n) {
+  if (n < 2) {
+    return false;
+  } else if (n < 4) {
+    return true;
+  } else if (n % 2 == 0) {
+    return false;
+  }
+  for (uint64_t d = 3; d * d <= n; d += 2) {
+    if (n % d == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t previous_prime(uint64_t n) {
+  while (n > 2) {
+    --n;
+    if (is_prime(n)) {
+      return n;
+    }
+  }
+  return 0;
+}
+
+uint64_t mod_pow(uint64_t base, uint64_t exponent, uint64_t modulus) {
+  uint64_t result = 1 % modulus;
+  base %= modulus;
+  while (exponent > 0) {
+    if (exponent & 1) {
+      result = result * base % modulus;
+    }
+    base = base * base % modulus;
+    exponent >>= 1;
+  }
+  return result;
+}
+
+std::vector<uint64_t> berlekamp_massey(const std::vector<uint64_t>& sequence, const uint64_t prime) {
+  // connection polynomial C(x) = 1 + C_1 x + ... + C_L x^L, B is C before the last length change
+  std::vector<uint64_t> connection {1}, previous {1};
+  uint64_t previous_discrepancy = 1;
+  std::size_t length = 0, shift = 1;
+  for (std::size_t i = 0; i < sequence.size(); ++i) {
+    uint64_t discrepancy = sequence[i];
+    for (std::size_t j = 1; j <= length; ++j) {
+      discrepancy = (discrepancy + connection[j] * sequence[i - j]) % prime;
+    }
+    if (discrepancy == 0) {
+      ++shift;
+      continue;
+    }
+
+    const uint64_t factor = discrepancy * mod_pow(previous_discrepancy, prime - 2, prime) % prime;
+    std::vector<uint64_t> current = connection;
+    if (connection.size() < previous.size() + shift) {
+      connection.resize(previous.size() + shift, 0);
+    }
+    for (std::size_t j = 0; j < previous.size(); ++j) {
+      connection[j + shift] = (connection[j + shift] + prime - factor * previous[j] % prime) % prime;
+    }
+    if (2 * length <= i) {
+      length = i + 1 - length;
+      previous = current;
+      previous_discrepancy = discrepancy;
+      shift = 1;
+    } else {
+      ++shift;
+    }
+  }
+
+  std::vector<uint64_t> recurrence(length, 0);
+  for (std::size_t j = 1; j <= length and j < connection.size(); ++j) {
+    recurrence[j - 1] = (prime - connection[j]) % prime;
+  }
+  return recurrence;
+}
+
 } /* namespace Math */
 } /* namespace Util */
 } /* namespace Vlab */
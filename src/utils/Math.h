@@ -8,6 +8,7 @@
 #ifndef SRC_UTILS_MATH_H_
 #define SRC_UTILS_MATH_H_
 
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <thread>
@@ -32,6 +33,35 @@ using Matrix = std::vector<std::vector<T>>;
 int gcd(int x, int y);
 int lcm(int x, int y);
 
+/**
+ * Primality test by trial division, meant for word sized moduli
+ * @param n
+ * @return
+ */
+bool is_prime(uint64_t n);
+
+/**
+ * @param n
+ * @return largest prime less than n, 0 if there is none
+ */
+uint64_t previous_prime(uint64_t n);
+
+/**
+ * @param base
+ * @param exponent
+ * @param modulus must be less than 2^32
+ * @return base^exponent mod modulus
+ */
+uint64_t mod_pow(uint64_t base, uint64_t exponent, uint64_t modulus);
+
+/**
+ * Finds the shortest linear recurrence of a sequence over Z_prime (Berlekamp-Massey)
+ * @param sequence values already reduced modulo prime
+ * @param prime must be less than 2^32
+ * @return c_1..c_L such that s_k = c_1 * s_(k-1) + ... + c_L * s_(k-L) mod prime
+ */
+std::vector<uint64_t> berlekamp_massey(const std::vector<uint64_t>& sequence, const uint64_t prime);
+
 template <class T>
 Matrix<T> multiply_matrix(const Matrix<T>& x, const Matrix<T>& y) {
   unsigned r = x[0].size();
@@ -0,0 +1,33 @@
+/*
+ * MemoryInputBuffer.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_UTILS_MEMORYINPUTBUFFER_H_
+#define SRC_UTILS_MEMORYINPUTBUFFER_H_
+
+#include <cstddef>
+#include <streambuf>
+
+namespace Vlab {
+namespace Util {
+
+/**
+ * Input stream buffer over memory owned by the caller, reads it in place without copying
+ */
+class MemoryInputBuffer : public std::streambuf {
+public:
+  MemoryInputBuffer(const char* data, std::size_t size) {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
+} /* namespace Util */
+} /* namespace Vlab */
+
+#endif /* SRC_UTILS_MEMORYINPUTBUFFER_H_ */
@@ -0,0 +1,249 @@
+/*
+ * Profiler.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+#include <glog/logging.h>
+
+#include "../solver/options/Solver.h"
+
+namespace Vlab {
+namespace Util {
+
+thread_local Profile* Profiler::ACTIVE_PROFILE = nullptr;
+
+/**
+ * @param out
+ * @param value written as a json string, control characters are escaped
+ */
+static void WriteJsonString(std::ostream& out, const std::string& value) {
+  out << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\r':
+        out << "\\r";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if ((unsigned char) c < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char) c);
+          out << escaped;
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+static void WriteJsonTimings(std::ostream& out, const std::vector<Profile::Timing>& timings, const std::string& calls_field) {
+  out << "[";
+  for (std::size_t i = 0; i < timings.size(); ++i) {
+    out << (i == 0 ? "" : ",") << "\n    {\"name\": ";
+    WriteJsonString(out, timings[i].name);
+    out << ", \"" << calls_field << "\": " << timings[i].calls << ", \"time_ms\": " << timings[i].time_ms << "}";
+  }
+  out << (timings.empty() ? "]" : "\n  ]");
+}
+
+void Profile::TimingTable::Add(const std::string& name, const double time_ms) {
+  auto it = indices_.find(name);
+  if (it == indices_.end()) {
+    it = indices_.insert(std::make_pair(name, timings_.size())).first;
+    timings_.push_back(Timing());
+    timings_.back().name = name;
+  }
+  Timing& timing = timings_[it->second];
+  ++timing.calls;
+  timing.time_ms += time_ms;
+}
+
+const std::vector<Profile::Timing>& Profile::TimingTable::GetTimings() const {
+  return timings_;
+}
+
+void Profile::TimingTable::Clear() {
+  timings_.clear();
+  indices_.clear();
+}
+
+void Profile::AddPassTime(const std::string& name, const double time_ms) {
+  passes_.Add(name, time_ms);
+}
+
+void Profile::AddOperation(const std::string& name, const double time_ms) {
+  operations_.Add(name, time_ms);
+}
+
+void Profile::AddCountTime(const std::string& name, const double time_ms) {
+  counts_.Add(name, time_ms);
+}
+
+void Profile::AddComponent(const Component& component) {
+  components_.push_back(component);
+}
+
+void Profile::AddAutomaton(const int num_of_states, const unsigned num_of_bdd_nodes) {
+  ++num_of_automata_;
+  peak_num_of_states_ = std::max(peak_num_of_states_, num_of_states);
+  peak_num_of_bdd_nodes_ = std::max(peak_num_of_bdd_nodes_, num_of_bdd_nodes);
+}
+
+const Profile::TimingTable& Profile::GetPasses() const {
+  return passes_;
+}
+
+const Profile::TimingTable& Profile::GetOperations() const {
+  return operations_;
+}
+
+const Profile::TimingTable& Profile::GetCounts() const {
+  return counts_;
+}
+
+const std::vector<Profile::Component>& Profile::GetComponents() const {
+  return components_;
+}
+
+unsigned long Profile::GetNumOfAutomata() const {
+  return num_of_automata_;
+}
+
+int Profile::GetPeakNumOfStates() const {
+  return peak_num_of_states_;
+}
+
+unsigned Profile::GetPeakNumOfBddNodes() const {
+  return peak_num_of_bdd_nodes_;
+}
+
+void Profile::Clear() {
+  passes_.Clear();
+  operations_.Clear();
+  counts_.Clear();
+  components_.clear();
+  num_of_automata_ = 0;
+  peak_num_of_states_ = 0;
+  peak_num_of_bdd_nodes_ = 0;
+}
+
+void Profile::WriteJson(std::ostream& out) const {
+  out << "{\n  \"passes\": ";
+  WriteJsonTimings(out, passes_.GetTimings(), "calls");
+  out << ",\n  \"components\": [";
+  for (std::size_t i = 0; i < components_.size(); ++i) {
+    const Component& component = components_[i];
+    out << (i == 0 ? "" : ",") << "\n    {\"theory\": ";
+    WriteJsonString(out, component.theory);
+    out << ", \"name\": ";
+    WriteJsonString(out, component.name);
+    out << ", \"conjuncts\": " << component.num_of_conjuncts << ", \"constructed_conjuncts\": "
+        << component.num_of_constructed_conjuncts << ", \"construction_ms\": " << component.construction_ms
+        << ", \"intersection_ms\": " << component.intersection_ms << "}";
+  }
+  out << (components_.empty() ? "]" : "\n  ]");
+  out << ",\n  \"operations\": ";
+  WriteJsonTimings(out, operations_.GetTimings(), "count");
+  out << ",\n  \"automata\": {\"count\": " << num_of_automata_ << ", \"peak_states\": " << peak_num_of_states_
+      << ", \"peak_bdd_nodes\": " << peak_num_of_bdd_nodes_ << "}";
+  out << ",\n  \"counting\": ";
+  WriteJsonTimings(out, counts_.GetTimings(), "calls");
+  out << "\n}\n";
+}
+
+std::string Profile::ToJson() const {
+  std::stringstream ss;
+  WriteJson(ss);
+  return ss.str();
+}
+
+Profiler::ScopedProfile::ScopedProfile(Profile* profile)
+    : previous_ { ACTIVE_PROFILE } {
+  ACTIVE_PROFILE = profile;
+}
+
+Profiler::ScopedProfile::~ScopedProfile() {
+  ACTIVE_PROFILE = previous_;
+}
+
+Profiler::ScopedOperation::ScopedOperation(const char* name)
+    : name_ { name },
+      profile_ { ACTIVE_PROFILE } {
+  if (profile_ != nullptr) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+Profiler::ScopedOperation::~ScopedOperation() {
+  if (profile_ != nullptr) {
+    auto end = std::chrono::steady_clock::now();
+    profile_->AddOperation(name_, std::chrono::duration<double, std::milli>(end - start_).count());
+  }
+}
+
+Profile* Profiler::GetActiveProfile() {
+  return ACTIVE_PROFILE;
+}
+
+bool Profiler::IsActive() {
+  return ACTIVE_PROFILE != nullptr;
+}
+
+void Profiler::TimePass(const std::string& name, std::function<void()> pass) {
+  Profile* profile = ACTIVE_PROFILE;
+  if (profile == nullptr) {
+    pass();
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  pass();
+  auto end = std::chrono::steady_clock::now();
+  profile->AddPassTime(name, std::chrono::duration<double, std::milli>(end - start).count());
+}
+
+void Profiler::AddCountTime(const std::string& name, const double time_ms) {
+  if (ACTIVE_PROFILE != nullptr) {
+    ACTIVE_PROFILE->AddCountTime(name, time_ms);
+  }
+}
+
+void Profiler::AddComponent(const Profile::Component& component) {
+  LOG_IF(INFO, Option::Solver::REPORT_COMPONENT_TIMES) << "report " << component.theory << " component: " << component.name
+      << " conjuncts: " << component.num_of_constructed_conjuncts << "/" << component.num_of_conjuncts
+      << " construction time: " << component.construction_ms << " ms"
+      << " intersection time: " << component.intersection_ms << " ms";
+  if (ACTIVE_PROFILE != nullptr) {
+    ACTIVE_PROFILE->AddComponent(component);
+  }
+}
+
+void Profiler::AddAutomaton(const int num_of_states, const unsigned num_of_bdd_nodes) {
+  if (ACTIVE_PROFILE != nullptr) {
+    ACTIVE_PROFILE->AddAutomaton(num_of_states, num_of_bdd_nodes);
+  }
+}
+
+} /* namespace Util */
+} /* namespace Vlab */
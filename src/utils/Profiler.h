@@ -0,0 +1,160 @@
+/*
+ * Profiler.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_UTILS_PROFILER_H_
+#define SRC_UTILS_PROFILER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Vlab {
+namespace Util {
+
+/**
+ * Measurements of the solver passes, the solved components, the automata operations and counting.
+ * Measurements accumulate until the profile is cleared.
+ */
+class Profile {
+public:
+  struct Timing {
+    std::string name;
+    unsigned long calls = 0;
+    double time_ms = 0;
+  };
+
+  struct Component {
+    std::string theory;
+    std::string name;
+    std::size_t num_of_conjuncts;
+    std::size_t num_of_constructed_conjuncts;
+    double construction_ms;
+    double intersection_ms;
+  };
+
+  /**
+   * Timings keep the order of their first record
+   */
+  class TimingTable {
+  public:
+    void Add(const std::string& name, const double time_ms);
+    const std::vector<Timing>& GetTimings() const;
+    void Clear();
+  private:
+    std::vector<Timing> timings_;
+    std::unordered_map<std::string, std::size_t> indices_;
+  };
+
+  void AddPassTime(const std::string& name, const double time_ms);
+  void AddOperation(const std::string& name, const double time_ms);
+  void AddCountTime(const std::string& name, const double time_ms);
+  void AddComponent(const Component& component);
+  /**
+   * Records the size of an automaton or of an intermediate dfa of an operation
+   * @param num_of_states
+   * @param num_of_bdd_nodes
+   */
+  void AddAutomaton(const int num_of_states, const unsigned num_of_bdd_nodes);
+
+  const TimingTable& GetPasses() const;
+  const TimingTable& GetOperations() const;
+  const TimingTable& GetCounts() const;
+  const std::vector<Component>& GetComponents() const;
+  unsigned long GetNumOfAutomata() const;
+  int GetPeakNumOfStates() const;
+  unsigned GetPeakNumOfBddNodes() const;
+
+  void Clear();
+
+  /**
+   * Writes the profile as a json object with passes, components, operations, automata and counting fields
+   * @param out
+   */
+  void WriteJson(std::ostream& out) const;
+  std::string ToJson() const;
+
+protected:
+  TimingTable passes_;
+  TimingTable operations_;
+  TimingTable counts_;
+  std::vector<Component> components_;
+  unsigned long num_of_automata_ = 0;
+  int peak_num_of_states_ = 0;
+  unsigned peak_num_of_bdd_nodes_ = 0;
+};
+
+/**
+ * Records into the profile that is active on the calling thread, nothing is recorded and
+ * nothing is timed when there is no active profile.
+ */
+class Profiler {
+public:
+  /**
+   * Activates a profile on the calling thread and restores the previous one when it goes out of scope
+   */
+  class ScopedProfile {
+  public:
+    /**
+     * @param profile nullptr deactivates profiling in the scope, not owned
+     */
+    ScopedProfile(Profile* profile);
+    ~ScopedProfile();
+    ScopedProfile(const ScopedProfile&) = delete;
+    ScopedProfile& operator=(const ScopedProfile&) = delete;
+  private:
+    Profile* const previous_;
+  };
+
+  /**
+   * Times an automata operation from construction to destruction
+   */
+  class ScopedOperation {
+  public:
+    /**
+     * @param name static string, it is copied only when the operation is recorded
+     */
+    ScopedOperation(const char* name);
+    ~ScopedOperation();
+    ScopedOperation(const ScopedOperation&) = delete;
+    ScopedOperation& operator=(const ScopedOperation&) = delete;
+  private:
+    const char* name_;
+    Profile* const profile_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  static Profile* GetActiveProfile();
+  static bool IsActive();
+
+  /**
+   * Runs a solver pass and records its time, repeated runs of a pass are accumulated
+   * @param name
+   * @param pass
+   */
+  static void TimePass(const std::string& name, std::function<void()> pass);
+  static void AddCountTime(const std::string& name, const double time_ms);
+  /**
+   * Records a solved component, it is also logged when component times are reported
+   * @param component
+   */
+  static void AddComponent(const Profile::Component& component);
+  static void AddAutomaton(const int num_of_states, const unsigned num_of_bdd_nodes);
+
+private:
+  static thread_local Profile* ACTIVE_PROFILE;
+};
+
+} /* namespace Util */
+} /* namespace Vlab */
+
+#endif /* SRC_UTILS_PROFILER_H_ */
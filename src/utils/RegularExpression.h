@@ -41,6 +41,7 @@
 #include <cstdlib>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -96,7 +97,7 @@ public:
    * Syntax flag, used as a default combinations of the flag
    * Enables all except AUTOMATON and INTERVAL
    */
-  static int DEFAULT;
+  static thread_local int DEFAULT;
 
   enum class Type : int {
     NONE = 0,
@@ -196,7 +197,7 @@ private:
   RegularExpression_ptr exp2_;
   std::string string_;
   std::string input_regex_string_;
-  static bool escape_;
+  static thread_local bool escape_;
 
   static const int VLOG_LEVEL;
 };
@@ -5,12 +5,16 @@
  *      Author: baki
  */
 
+#include <cstdint>
+#include <iterator>
 #include <map>
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include "vlab_cs_ucsb_edu_DriverProxy.h"
 #include "Driver.h"
+#include "utils/MemoryInputBuffer.h"
 
 
 jfieldID getHandleField(JNIEnv *env, jobject obj)
@@ -34,6 +38,11 @@ void setHandle(JNIEnv *env, jobject obj, T *t)
     env->SetLongField(obj, getHandleField(env, obj), handle);
 }
 
+void throwJavaException(JNIEnv *env, const char* class_name, const std::string& message) {
+  jclass exception_class = env->FindClass(class_name);
+  env->ThrowNew(exception_class, message.c_str());
+}
+
 jobject newBigInteger(JNIEnv *env, jstring value) {
   jclass big_integer_class = env->FindClass("java/math/BigInteger");
   jmethodID big_integer_ctor = env->GetMethodID(big_integer_class, "<init>", "(Ljava/lang/String;)V");
@@ -41,18 +50,88 @@ jobject newBigInteger(JNIEnv *env, jstring value) {
   return big_integer;
 }
 
+jobjectArray newBigIntegerArray(JNIEnv *env, const std::vector<Vlab::Theory::BigInteger>& values) {
+  jclass big_integer_class = env->FindClass("java/math/BigInteger");
+  jobjectArray array = env->NewObjectArray(values.size(), big_integer_class, nullptr);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    std::stringstream ss;
+    ss << values[i];
+    jstring value_string = env->NewStringUTF(ss.str().c_str());
+    jobject big_integer = newBigInteger(env, value_string);
+    env->SetObjectArrayElement(array, i, big_integer);
+    env->DeleteLocalRef(big_integer);
+    env->DeleteLocalRef(value_string);
+  }
+  return array;
+}
+
+std::vector<unsigned long> getBounds(JNIEnv *env, jlongArray bounds) {
+  jsize length = env->GetArrayLength(bounds);
+  std::vector<jlong> buffer (length);
+  env->GetLongArrayRegion(bounds, 0, length, buffer.data());
+  return std::vector<unsigned long>(buffer.begin(), buffer.end());
+}
+
+/**
+ * Appends the number of 32 bit limbs of a non-negative value followed by the limbs, most
+ * significant limb first, zero has no limbs
+ */
+void appendLimbs(std::vector<jint>& encoded, const Vlab::Theory::BigInteger& value) {
+  std::vector<std::uint32_t> limbs;
+  if (value != 0) {
+    boost::multiprecision::export_bits(value, std::back_inserter(limbs), 32);
+  }
+  encoded.push_back(limbs.size());
+  for (auto limb : limbs) {
+    encoded.push_back(static_cast<jint>(limb));
+  }
+}
+
+void load_model_counter(Vlab::Solver::ModelCounter& mc, char* data, std::size_t size) {
+  Vlab::Util::MemoryInputBuffer buffer (data, size);
+  std::istream is (&buffer);
+  cereal::BinaryInputArchive ar(is);
+  mc.load(ar);
+}
+
 void load_model_counter(JNIEnv *env, Vlab::Solver::ModelCounter& mc, jbyteArray model_counter) {
   jsize length = env->GetArrayLength(model_counter);
   jbyte* buffer = env->GetByteArrayElements(model_counter, nullptr);
-  std::string bin_model_counter_str (const_cast<char*>(reinterpret_cast<char*>(buffer)), length);
-  std::stringstream is (bin_model_counter_str);
-  {
-    cereal::BinaryInputArchive ar(is);
-    mc.load(ar);
-  }
+  load_model_counter(mc, reinterpret_cast<char*>(buffer), length);
   env->ReleaseByteArrayElements(model_counter, buffer, JNI_ABORT);
 }
 
+/**
+ * Model counter kept on the native side between calls, Java holds its address as an opaque
+ * handle. The serialized form is kept once it is requested so that a direct byte buffer can
+ * view it until the handle is released; the buffer is invalid after the release.
+ * A handle is not thread safe, counting updates the caches of its counter. DriverProxy.java
+ * tracks live handles and rejects calls on released ones before they reach this side.
+ */
+struct ModelCounterHandle {
+  Vlab::Solver::ModelCounter model_counter;
+  std::string serialized_model_counter;
+};
+
+jlong newModelCounterHandle(const Vlab::Solver::ModelCounter& mc) {
+  ModelCounterHandle* handle = new ModelCounterHandle();
+  handle->model_counter = mc;
+  return reinterpret_cast<jlong>(handle);
+}
+
+ModelCounterHandle* getModelCounterHandle(jlong handle) {
+  return reinterpret_cast<ModelCounterHandle*>(handle);
+}
+
+jobject newBigInteger(JNIEnv *env, const Vlab::Theory::BigInteger& value) {
+  std::stringstream ss;
+  ss << value;
+  jstring value_string = env->NewStringUTF(ss.str().c_str());
+  jobject big_integer = newBigInteger(env, value_string);
+  env->DeleteLocalRef(value_string);
+  return big_integer;
+}
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    initABC
@@ -126,6 +205,92 @@ JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isSatisfiable
   return (jboolean)result;
 }
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    push
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_push
+  (JNIEnv *env, jobject obj, jint num_levels) {
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  abc_driver->Push(num_levels);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    pop
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_pop
+  (JNIEnv *env, jobject obj, jint num_levels) {
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  if (not abc_driver->Pop(num_levels)) {
+    throwJavaException(env, "java/lang/IllegalStateException",
+                       "cannot pop " + std::to_string(num_levels) + " assertion levels, "
+                       + std::to_string(abc_driver->GetNumOfAssertionLevels()) + " are pushed");
+  }
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    isSatisfiableIncremental
+ * Signature: (Ljava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isSatisfiableIncremental
+  (JNIEnv *env, jobject obj, jstring constraint) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  std::istringstream input_constraint;
+  const char* constraint_str = env->GetStringUTFChars(constraint, JNI_FALSE);
+  input_constraint.str(constraint_str);
+  int parse_result = abc_driver->ParseIncremental(&input_constraint);
+  env->ReleaseStringUTFChars(constraint, constraint_str);
+  if (parse_result != 0) {
+    throwJavaException(env, "java/lang/IllegalStateException", "pop without a matching push");
+    return JNI_FALSE;
+  }
+  bool result = abc_driver->CheckSat();
+  return (jboolean)result;
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    solveBatchEncoded
+ * Signature: ([Ljava/lang/String;[J[J)[I
+ */
+JNIEXPORT jintArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_solveBatchEncoded
+  (JNIEnv *env, jobject obj, jobjectArray constraints, jlongArray int_bounds, jlongArray str_bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  jsize num_of_constraints = env->GetArrayLength(constraints);
+  std::vector<std::string> constraint_strs;
+  constraint_strs.reserve(num_of_constraints);
+  for (jsize i = 0; i < num_of_constraints; ++i) {
+    jstring constraint = static_cast<jstring>(env->GetObjectArrayElement(constraints, i));
+    const char* constraint_str = env->GetStringUTFChars(constraint, JNI_FALSE);
+    constraint_strs.push_back(constraint_str);
+    env->ReleaseStringUTFChars(constraint, constraint_str);
+    env->DeleteLocalRef(constraint);
+  }
+
+  auto results = abc_driver->SolveBatch(constraint_strs, getBounds(env, int_bounds), getBounds(env, str_bounds));
+
+  // per query: satisfiability, then the int counts and the string counts as limb arrays
+  std::vector<jint> encoded;
+  for (auto& result : results) {
+    encoded.push_back(result.is_sat ? 1 : 0);
+    for (auto& count : result.int_counts) {
+      appendLimbs(encoded, count);
+    }
+    for (auto& count : result.str_counts) {
+      appendLimbs(encoded, count);
+    }
+  }
+  jintArray array = env->NewIntArray(encoded.size());
+  env->SetIntArrayRegion(array, 0, encoded.size(), encoded.data());
+  return array;
+}
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    countVariable
@@ -193,6 +358,61 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_count__JJ
   return newBigInteger(env, result_string);
 }
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countVariableRange
+ * Signature: (Ljava/lang/String;[J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countVariableRange
+  (JNIEnv *env, jobject obj, jstring var_name, jlongArray bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
+  std::string var_name_str {var_name_arr};
+  auto results = abc_driver->CountVariableRange(var_name_str, getBounds(env, bounds));
+  env->ReleaseStringUTFChars(var_name, var_name_arr);
+  return newBigIntegerArray(env, results);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countIntsRange
+ * Signature: ([J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countIntsRange
+  (JNIEnv *env, jobject obj, jlongArray bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  auto results = abc_driver->CountIntsRange(getBounds(env, bounds));
+  return newBigIntegerArray(env, results);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countStrsRange
+ * Signature: ([J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrsRange
+  (JNIEnv *env, jobject obj, jlongArray bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  auto results = abc_driver->CountStrsRange(getBounds(env, bounds));
+  return newBigIntegerArray(env, results);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countRange
+ * Signature: ([J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countRange
+  (JNIEnv *env, jobject obj, jlongArray bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  auto results = abc_driver->CountRange(getBounds(env, bounds));
+  return newBigIntegerArray(env, results);
+}
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    getModelCounterForVariable
@@ -306,6 +526,169 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_count__JJ_3B
   return newBigInteger(env, result_string);
 }
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    newModelCounterHandle
+ * Signature: ()J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_newModelCounterHandle
+  (JNIEnv *env, jobject obj) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  return newModelCounterHandle(abc_driver->GetModelCounter());
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    newModelCounterHandleForVariable
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_newModelCounterHandleForVariable
+  (JNIEnv *env, jobject obj, jstring var_name) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
+  std::string var_name_str {var_name_arr};
+  env->ReleaseStringUTFChars(var_name, var_name_arr);
+  return newModelCounterHandle(abc_driver->GetModelCounterForVariable(var_name_str));
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    loadModelCounterHandle
+ * Signature: (Ljava/nio/ByteBuffer;II)J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_loadModelCounterHandle
+  (JNIEnv *env, jobject obj, jobject model_counter, jint position, jint length) {
+
+  char* data = static_cast<char*>(env->GetDirectBufferAddress(model_counter));
+  if (data == nullptr) {
+    throwJavaException(env, "java/lang/IllegalArgumentException", "model counter must be a direct byte buffer");
+    return 0;
+  }
+  const jlong capacity = env->GetDirectBufferCapacity(model_counter);
+  if (position < 0 or length < 0 or position + static_cast<jlong>(length) > capacity) {
+    throwJavaException(env, "java/lang/IndexOutOfBoundsException", "model counter is out of the buffer bounds");
+    return 0;
+  }
+  ModelCounterHandle* handle = new ModelCounterHandle();
+  load_model_counter(handle->model_counter, data + position, length);
+  return reinterpret_cast<jlong>(handle);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    serializeModelCounterHandle
+ * Signature: (J)Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_serializeModelCounterHandle
+  (JNIEnv *env, jobject obj, jlong handle) {
+
+  ModelCounterHandle* mc_handle = getModelCounterHandle(handle);
+  if (mc_handle->serialized_model_counter.empty()) {
+    std::stringstream os;
+    {
+      cereal::BinaryOutputArchive ar(os);
+      mc_handle->model_counter.save(ar);
+    }
+    mc_handle->serialized_model_counter = os.str();
+  }
+  auto& bin_mc = mc_handle->serialized_model_counter;
+  return env->NewDirectByteBuffer(&bin_mc[0], bin_mc.size());
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countIntsWithModelCounterHandle
+ * Signature: (JJ)Ljava/math/BigInteger;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countIntsWithModelCounterHandle
+  (JNIEnv *env, jobject obj, jlong handle, jlong bound) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  Vlab::Driver::CountingContext context(*abc_driver);
+  return newBigInteger(env, getModelCounterHandle(handle)->model_counter.CountInts(bound));
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countStrsWithModelCounterHandle
+ * Signature: (JJ)Ljava/math/BigInteger;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrsWithModelCounterHandle
+  (JNIEnv *env, jobject obj, jlong handle, jlong bound) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  Vlab::Driver::CountingContext context(*abc_driver);
+  return newBigInteger(env, getModelCounterHandle(handle)->model_counter.CountStrs(bound));
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countWithModelCounterHandle
+ * Signature: (JJJ)Ljava/math/BigInteger;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countWithModelCounterHandle
+  (JNIEnv *env, jobject obj, jlong handle, jlong int_bound, jlong str_bound) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  Vlab::Driver::CountingContext context(*abc_driver);
+  return newBigInteger(env, getModelCounterHandle(handle)->model_counter.Count(int_bound, str_bound));
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countIntsRangeWithModelCounterHandle
+ * Signature: (J[J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countIntsRangeWithModelCounterHandle
+  (JNIEnv *env, jobject obj, jlong handle, jlongArray bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  Vlab::Driver::CountingContext context(*abc_driver);
+  auto results = getModelCounterHandle(handle)->model_counter.CountIntsRange(getBounds(env, bounds));
+  return newBigIntegerArray(env, results);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countStrsRangeWithModelCounterHandle
+ * Signature: (J[J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrsRangeWithModelCounterHandle
+  (JNIEnv *env, jobject obj, jlong handle, jlongArray bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  Vlab::Driver::CountingContext context(*abc_driver);
+  auto results = getModelCounterHandle(handle)->model_counter.CountStrsRange(getBounds(env, bounds));
+  return newBigIntegerArray(env, results);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countRangeWithModelCounterHandle
+ * Signature: (J[J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countRangeWithModelCounterHandle
+  (JNIEnv *env, jobject obj, jlong handle, jlongArray bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  Vlab::Driver::CountingContext context(*abc_driver);
+  auto results = getModelCounterHandle(handle)->model_counter.CountRange(getBounds(env, bounds));
+  return newBigIntegerArray(env, results);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    deleteModelCounterHandle
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_deleteModelCounterHandle
+  (JNIEnv *env, jobject obj, jlong handle) {
+
+  delete getModelCounterHandle(handle);
+}
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    printResultAutomaton
@@ -47,6 +47,38 @@ JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_setOption__ILjava_lang_
 JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isSatisfiable
   (JNIEnv *, jobject, jstring);
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    push
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_push
+  (JNIEnv *, jobject, jint);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    pop
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_pop
+  (JNIEnv *, jobject, jint);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    isSatisfiableIncremental
+ * Signature: (Ljava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isSatisfiableIncremental
+  (JNIEnv *, jobject, jstring);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    solveBatchEncoded
+ * Signature: ([Ljava/lang/String;[J[J)[I
+ */
+JNIEXPORT jintArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_solveBatchEncoded
+  (JNIEnv *, jobject, jobjectArray, jlongArray, jlongArray);
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    countVariable
@@ -79,6 +111,38 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrs__J
 JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_count__JJ
   (JNIEnv *, jobject, jlong, jlong);
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countVariableRange
+ * Signature: (Ljava/lang/String;[J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countVariableRange
+  (JNIEnv *, jobject, jstring, jlongArray);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countIntsRange
+ * Signature: ([J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countIntsRange
+  (JNIEnv *, jobject, jlongArray);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countStrsRange
+ * Signature: ([J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrsRange
+  (JNIEnv *, jobject, jlongArray);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countRange
+ * Signature: ([J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countRange
+  (JNIEnv *, jobject, jlongArray);
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    getModelCounterForVariable
@@ -127,6 +191,94 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrs__J_3B
 JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_count__JJ_3B
   (JNIEnv *, jobject, jlong, jlong, jbyteArray);
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    newModelCounterHandle
+ * Signature: ()J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_newModelCounterHandle
+  (JNIEnv *, jobject);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    newModelCounterHandleForVariable
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_newModelCounterHandleForVariable
+  (JNIEnv *, jobject, jstring);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    loadModelCounterHandle
+ * Signature: (Ljava/nio/ByteBuffer;II)J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_loadModelCounterHandle
+  (JNIEnv *, jobject, jobject, jint, jint);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    serializeModelCounterHandle
+ * Signature: (J)Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_serializeModelCounterHandle
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countIntsWithModelCounterHandle
+ * Signature: (JJ)Ljava/math/BigInteger;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countIntsWithModelCounterHandle
+  (JNIEnv *, jobject, jlong, jlong);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countStrsWithModelCounterHandle
+ * Signature: (JJ)Ljava/math/BigInteger;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrsWithModelCounterHandle
+  (JNIEnv *, jobject, jlong, jlong);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countWithModelCounterHandle
+ * Signature: (JJJ)Ljava/math/BigInteger;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countWithModelCounterHandle
+  (JNIEnv *, jobject, jlong, jlong, jlong);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countIntsRangeWithModelCounterHandle
+ * Signature: (J[J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countIntsRangeWithModelCounterHandle
+  (JNIEnv *, jobject, jlong, jlongArray);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countStrsRangeWithModelCounterHandle
+ * Signature: (J[J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrsRangeWithModelCounterHandle
+  (JNIEnv *, jobject, jlong, jlongArray);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countRangeWithModelCounterHandle
+ * Signature: (J[J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countRangeWithModelCounterHandle
+  (JNIEnv *, jobject, jlong, jlongArray);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    deleteModelCounterHandle
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_deleteModelCounterHandle
+  (JNIEnv *, jobject, jlong);
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    printResultAutomaton
@@ -0,0 +1,72 @@
+/*
+ * CountMatrixBenchmark.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ *
+ * Times the construction of the transition count matrix for multi-track
+ * automata. Usage: countmatrixbench [max number of tracks] [repetitions]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include <glog/logging.h>
+
+#include "theory/StringAutomaton.h"
+#include "theory/StringFormula.h"
+
+using namespace Vlab::Theory;
+
+/**
+ * Makes formula x0 = x1 . constant over the given number of tracks
+ */
+static StringFormula_ptr MakeEqualityFormula(int num_tracks, std::string constant) {
+  StringFormula_ptr formula = new StringFormula();
+  formula->SetType(StringFormula::Type::EQ);
+  for (int i = 0; i < num_tracks; ++i) {
+    formula->AddVariable("x" + std::to_string(i), (i < 2) ? i + 1 : 0);
+  }
+  formula->SetConstant(constant);
+  return formula;
+}
+
+static void Report(std::string label, int num_tracks, int repetitions, std::function<StringAutomaton_ptr()> make_auto) {
+  double total_ms = 0;
+  int num_of_states = 0;
+  for (int r = 0; r < repetitions; ++r) {
+    StringAutomaton_ptr string_auto = make_auto();
+    num_of_states = string_auto->getDFA()->ns;
+    auto start = std::chrono::steady_clock::now();
+    string_auto->GetSymbolicCounter();
+    auto end = std::chrono::steady_clock::now();
+    total_ms += std::chrono::duration<double, std::milli>(end - start).count();
+    delete string_auto;
+  }
+  std::cout << label << " tracks: " << num_tracks << " states: " << num_of_states
+            << " time: " << total_ms / repetitions << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  const int max_tracks = (argc > 1) ? std::atoi(argv[1]) : 6;
+  const int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+  for (int num_tracks = 2; num_tracks <= max_tracks; ++num_tracks) {
+    Report("equality", num_tracks, repetitions, [num_tracks]() {
+      return StringAutomaton::MakeEquality(MakeEqualityFormula(num_tracks, ""));
+    });
+    Report("equality-concat", num_tracks, repetitions, [num_tracks]() {
+      return StringAutomaton::MakeEquality(MakeEqualityFormula(num_tracks, "abc"));
+    });
+    Report("concat-extra-track", num_tracks, repetitions, [num_tracks]() {
+      return StringAutomaton::MakeConcatExtraTrack(0, 1, num_tracks, "abc");
+    });
+  }
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * DisjunctionBenchmark.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ *
+ * Times merging the values of an increasing number of disjuncts with a chain of unions and with
+ * the balanced union tree the solvers use, and times solving disjunctions of that many string
+ * constraints end to end. Disjuncts are solved one after another on the calling thread, the
+ * timings scale with the number of disjuncts and not with the number of cores.
+ * Usage: disjunctbench [max-disjuncts]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "interface/Driver.h"
+#include "solver/Value.h"
+#include "theory/StringAutomaton.h"
+
+using namespace Vlab;
+
+/**
+ * @param num_of_disjuncts
+ * @return values of disjuncts that each fix the variable to a different string
+ */
+static std::vector<Solver::Value_ptr> MakeValues(const int num_of_disjuncts) {
+  std::vector<Solver::Value_ptr> values;
+  for (int i = 0; i < num_of_disjuncts; ++i) {
+    values.push_back(new Solver::Value(Theory::StringAutomaton::MakeRegexAuto("(ab)*c" + std::to_string(i))));
+  }
+  return values;
+}
+
+/**
+ * @return merge time in milliseconds, the number of states of the union
+ */
+static double TimeMerge(const int num_of_disjuncts, const bool use_union_tree, int& num_of_states) {
+  auto values = MakeValues(num_of_disjuncts);
+  auto start = std::chrono::steady_clock::now();
+  Solver::Value_ptr union_value = nullptr;
+  if (use_union_tree) {
+    union_value = Solver::Value::union_all(values);
+  } else {
+    union_value = values[0];
+    for (std::size_t i = 1; i < values.size(); ++i) {
+      auto old_value = union_value;
+      union_value = union_value->union_(values[i]);
+      delete old_value;
+      delete values[i];
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  num_of_states = union_value->getStringAutomaton()->getDFA()->ns;
+  delete union_value;
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/**
+ * @return solving time in milliseconds
+ */
+static double TimeSolve(const int num_of_disjuncts, bool& is_sat) {
+  std::stringstream constraint;
+  constraint << "(declare-fun x () String)\n(declare-fun y () String)\n(assert (or";
+  for (int i = 0; i < num_of_disjuncts; ++i) {
+    constraint << " (and (str.prefixof \"p" << i << "\" x) (str.contains y \"c" << i << "\"))";
+  }
+  constraint << "))\n(check-sat)\n";
+  auto start = std::chrono::steady_clock::now();
+  Driver driver;
+  driver.Parse(&constraint);
+  driver.InitializeSolver();
+  driver.Solve();
+  is_sat = driver.is_sat();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  const int max_num_of_disjuncts = (argc > 1) ? std::atoi(argv[1]) : 512;
+
+  for (int num_of_disjuncts = 8; num_of_disjuncts <= max_num_of_disjuncts; num_of_disjuncts *= 2) {
+    int chain_states = 0, tree_states = 0;
+    double chain_ms = TimeMerge(num_of_disjuncts, false, chain_states);
+    double tree_ms = TimeMerge(num_of_disjuncts, true, tree_states);
+    bool is_sat = false;
+    double solve_ms = TimeSolve(num_of_disjuncts, is_sat);
+    std::cout << num_of_disjuncts << " disjuncts states: " << tree_states << " union chain: " << chain_ms
+              << " ms union tree: " << tree_ms << " ms solve: " << solve_ms << " ms" << (is_sat ? "" : " UNSAT");
+    if (chain_states != tree_states) {
+      std::cout << " MISMATCH chain states: " << chain_states;
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
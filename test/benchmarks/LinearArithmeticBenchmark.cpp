@@ -0,0 +1,86 @@
+/*
+ * LinearArithmeticBenchmark.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ *
+ * Times the construction of linear arithmetic automata with the symbolic (bdd per carry state)
+ * construction and with the enumeration of the variable assignments, for an increasing number
+ * of variables. The enumerating construction is skipped above max-enumerated variables.
+ * Usage: lineararithbench [max-variables] [max-enumerated-variables]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "theory/ArithmeticFormula.h"
+#include "theory/BinaryIntAutomaton.h"
+
+using namespace Vlab::Theory;
+
+/**
+ * @param num_of_variables
+ * @param type
+ * @return loop counter like constraint with small mixed coefficients
+ */
+static ArithmeticFormula_ptr MakeFormula(const int num_of_variables, const ArithmeticFormula::Type type) {
+  auto formula = new ArithmeticFormula();
+  formula->SetType(type);
+  formula->SetConstant(-10);
+  for (int i = 0; i < num_of_variables; ++i) {
+    formula->AddVariable("v" + std::to_string(100 + i), (i % 3) - 1 + (i % 2));
+  }
+  return formula;
+}
+
+/**
+ * @return construction time in milliseconds, the number of states of the automaton
+ */
+static double Time(const int num_of_variables, const ArithmeticFormula::Type type, const bool is_natural_number,
+                   const bool use_symbolic_construction, int& num_of_states) {
+  Vlab::Option::Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION = use_symbolic_construction;
+  auto start = std::chrono::steady_clock::now();
+  auto arithmetic_auto = BinaryIntAutomaton::MakeAutomaton(MakeFormula(num_of_variables, type), is_natural_number);
+  auto end = std::chrono::steady_clock::now();
+  num_of_states = arithmetic_auto->getDFA()->ns;
+  delete arithmetic_auto;
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  const int max_num_of_variables = (argc > 1) ? std::atoi(argv[1]) : 30;
+  const int max_num_of_enumerated_variables = (argc > 2) ? std::atoi(argv[2]) : 16;
+
+  std::vector<std::pair<std::string, ArithmeticFormula::Type>> types {
+    { "eq", ArithmeticFormula::Type::EQ },
+    { "lt", ArithmeticFormula::Type::LT },
+  };
+
+  for (int num_of_variables = 2; num_of_variables <= max_num_of_variables; num_of_variables += 2) {
+    for (auto& type : types) {
+      for (bool is_natural_number : { true, false }) {
+        int symbolic_states = 0, enumerated_states = 0;
+        double symbolic_ms = Time(num_of_variables, type.second, is_natural_number, true, symbolic_states);
+        std::cout << num_of_variables << " vars " << type.first << (is_natural_number ? " nat" : " int")
+                  << " states: " << symbolic_states << " symbolic: " << symbolic_ms << " ms";
+        if (num_of_variables <= max_num_of_enumerated_variables) {
+          double enumerated_ms = Time(num_of_variables, type.second, is_natural_number, false, enumerated_states);
+          std::cout << " enumerated: " << enumerated_ms << " ms";
+          if (symbolic_states != enumerated_states) {
+            std::cout << " MISMATCH enumerated states: " << enumerated_states;
+          }
+        }
+        std::cout << std::endl;
+      }
+    }
+  }
+  return 0;
+}
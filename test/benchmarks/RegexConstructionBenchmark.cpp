@@ -0,0 +1,89 @@
+/*
+ * RegexConstructionBenchmark.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ *
+ * Times regex automata construction with the direct dfa construction and with
+ * the automata of sub-expressions combined pairwise, on the regular expressions of
+ * the AppScan suite and on larger alternations and character classes.
+ * Usage: regexbench [repetitions]
+ * End to end: bench.sh appscan/cvc4 -- [--disable-direct-regex]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "theory/StringAutomaton.h"
+
+using namespace Vlab::Theory;
+
+/**
+ * @param num_of_keywords
+ * @return alternation of distinct keywords with shared prefixes
+ */
+static std::string MakeKeywordAlternation(int num_of_keywords) {
+  std::string regex = "(";
+  for (int i = 0; i < num_of_keywords; ++i) {
+    if (i > 0) {
+      regex += "|";
+    }
+    regex += "key" + std::to_string(i * 7919 % 100000);
+  }
+  return regex + ")";
+}
+
+/**
+ * @return average construction time in milliseconds, the number of states of the last automaton
+ */
+static double Time(const std::string& regex, const bool use_direct_construction, const int repetitions, int& num_of_states) {
+  Vlab::Option::Theory::USE_DIRECT_REGEX_CONSTRUCTION = use_direct_construction;
+  double total_ms = 0;
+  for (int r = 0; r < repetitions; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    StringAutomaton_ptr regex_auto = StringAutomaton::MakeRegexAuto(regex);
+    auto end = std::chrono::steady_clock::now();
+    total_ms += std::chrono::duration<double, std::milli>(end - start).count();
+    num_of_states = regex_auto->getDFA()->ns;
+    delete regex_auto;
+  }
+  return total_ms / repetitions;
+}
+
+int main(int argc, char* argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  const int repetitions = (argc > 1) ? std::atoi(argv[1]) : 5;
+  // cached automata would hide the construction
+  StringAutomaton::GetRegexAutoCache().SetCapacity(0);
+
+  std::vector<std::pair<std::string, std::string>> regexes {
+    { "appscan-cookie", "(\\?|;)(a|b|c|d|e|f|g|h|i|j|k|l|m|n)*" },
+    { "appscan-whitespace", "( |\t)*" },
+    { "class-identifier", "([a-z]|[A-Z]|_)([a-z]|[A-Z]|[0-9]|_)*" },
+    { "class-email", "([a-z]|[0-9]|\\.|_)+\\@([a-z]|[0-9])+\\.(com|org|net|edu|gov)" },
+    { "sql-keywords", ".*(select|insert|update|delete|drop|union|where|from|into|values).*" },
+    { "keywords-16", MakeKeywordAlternation(16) },
+    { "keywords-64", MakeKeywordAlternation(64) },
+    { "keywords-256", MakeKeywordAlternation(256) },
+  };
+
+  for (auto& regex : regexes) {
+    int direct_states = 0, binary_states = 0;
+    double direct_ms = Time(regex.second, true, repetitions, direct_states);
+    double binary_ms = Time(regex.second, false, repetitions, binary_states);
+    std::cout << regex.first << " states: " << direct_states << " direct: " << direct_ms << " ms"
+              << " binary: " << binary_ms << " ms";
+    if (direct_states != binary_states) {
+      std::cout << " MISMATCH binary states: " << binary_states;
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
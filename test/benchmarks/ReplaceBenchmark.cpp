@@ -0,0 +1,76 @@
+/*
+ * ReplaceBenchmark.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ *
+ * Times replace on the escaping and filtering patterns of sanitizers, with single character,
+ * character class and keyword searches over subjects of increasing size.
+ * Usage: replacebench [repetitions]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "theory/StringAutomaton.h"
+
+using namespace Vlab::Theory;
+
+struct ReplaceCase {
+  std::string name;
+  std::string subject_regex;
+  std::string search_regex;
+  std::string replace_string;
+};
+
+/**
+ * @return average replace time in milliseconds, the number of states of the last result
+ */
+static double Time(const ReplaceCase& replace_case, const int repetitions, int& num_of_states) {
+  StringAutomaton_ptr subject_auto = StringAutomaton::MakeRegexAuto(replace_case.subject_regex);
+  StringAutomaton_ptr search_auto = StringAutomaton::MakeRegexAuto(replace_case.search_regex);
+  StringAutomaton_ptr replace_auto = StringAutomaton::MakeString(replace_case.replace_string);
+  double total_ms = 0;
+  for (int r = 0; r < repetitions; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    StringAutomaton_ptr result_auto = subject_auto->Replace(search_auto, replace_auto);
+    auto end = std::chrono::steady_clock::now();
+    total_ms += std::chrono::duration<double, std::milli>(end - start).count();
+    num_of_states = result_auto->getDFA()->ns;
+    delete result_auto;
+  }
+  delete subject_auto;
+  delete search_auto;
+  delete replace_auto;
+  return total_ms / repetitions;
+}
+
+int main(int argc, char* argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  const int repetitions = (argc > 1) ? std::atoi(argv[1]) : 5;
+
+  std::vector<ReplaceCase> cases {
+    { "escape-lt-any", ".*", "<", "&lt;" },
+    { "escape-quote-any", ".*", "'", "\\'" },
+    { "strip-html-chars", ".*", "[<>\"']", "" },
+    { "strip-script-tag", ".*", "<script>", "" },
+    { "strip-script-tag-attack", ".*<script>.*", "<script>", "" },
+    { "escape-lt-markup", "(<[a-z]+>[a-z ]*</[a-z]+>)*", "<", "&lt;" },
+    { "strip-sql-keywords", ".*(select|union|drop).*", "(select|union|drop)", "" },
+    { "escape-amp-entities", "(&[a-z]+;|[a-z0-9 ])*", "&", "&amp;" },
+  };
+
+  for (auto& replace_case : cases) {
+    int num_of_states = 0;
+    double ms = Time(replace_case, repetitions, num_of_states);
+    std::cout << replace_case.name << " states: " << num_of_states << " replace: " << ms << " ms" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,45 @@
+#!/usr/bin/env bash
+#
+# Runs abc on every constraint file of the given benchmark suites and
+# prints solving and counting times reported by abc.
+#
+# usage: bench.sh [-a <abc executable>] <suite dir>... -- <abc options>
+#   e.g. bench.sh pisa/abc appscan/cvc4 -- -bs 1000 -v 0
+#
+
+ABC=abc
+SUITES=()
+
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    -a)
+      ABC="$2"
+      shift 2
+      ;;
+    --)
+      shift
+      break
+      ;;
+    *)
+      SUITES+=("$1")
+      shift
+      ;;
+  esac
+done
+
+BENCH_ROOT="$(cd "$(dirname "$0")" && pwd)"
+
+for suite in "${SUITES[@]}"; do
+  [[ -d "$suite" ]] || suite="$BENCH_ROOT/$suite"
+  total_solve=0
+  total_count=0
+  for file in "$suite"/*.smt2; do
+    report=$("$ABC" -i "$file" "$@" 2>&1 | grep "report")
+    solve=$(echo "$report" | sed -n 's/.*report is_sat: .* time: \([0-9.e+-]*\) ms.*/\1/p' | head -1)
+    count=$(echo "$report" | sed -n 's/.*report .*bound.* time: \([0-9.e+-]*\) ms.*/\1/p' | awk '{ s += $1 } END { print s + 0 }')
+    printf "%-40s solve: %12s ms  count: %12s ms\n" "$(basename "$file")" "${solve:-0}" "${count:-0}"
+    total_solve=$(awk -v a="$total_solve" -v b="${solve:-0}" 'BEGIN { print a + b }')
+    total_count=$(awk -v a="$total_count" -v b="${count:-0}" 'BEGIN { print a + b }')
+  done
+  printf "%-40s solve: %12s ms  count: %12s ms\n" "TOTAL $suite" "$total_solve" "$total_count"
+done
@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+#
+# Compares counting with mat-vec iteration, successive squaring, modular
+# arithmetic and the derived linear recurrence on the PISA and AppScan suites.
+#
+# usage: count_methods.sh [-a <abc executable>] [<string bounds>]
+#   e.g. count_methods.sh -a ../../src/abc "10,100,1000,5000"
+#
+
+ABC_ARGS=()
+if [[ "$1" == "-a" ]]; then
+  ABC_ARGS=(-a "$2")
+  shift 2
+fi
+BOUNDS="${1:-10,100,1000,5000}"
+
+BENCH_ROOT="$(cd "$(dirname "$0")" && pwd)"
+
+for method in iteration squaring recurrence modular auto; do
+  echo "== count method: $method, bounds: $BOUNDS"
+  "$BENCH_ROOT/bench.sh" "${ABC_ARGS[@]}" pisa/abc appscan/cvc4 -- -v 0 -bs "$BOUNDS" --count-method "$method"
+done
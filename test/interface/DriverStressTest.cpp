@@ -0,0 +1,134 @@
+/*
+ * DriverStressTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "DriverStressTest.h"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace Vlab {
+namespace Test {
+
+using namespace ::testing;
+
+void DriverStressTest::SetUp() {
+  for (std::string dir_name : {std::string(ABC_TEST_JPF_DIR), std::string(ABC_TEST_JPF_DIR) + "/challenge1"}) {
+    DIR* dir = opendir(dir_name.c_str());
+    ASSERT_NE(nullptr, dir) << "cannot open " << dir_name;
+    while (auto entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name.size() > 5 and name.compare(name.size() - 5, 5, ".smt2") == 0) {
+        file_names_.push_back(dir_name + "/" + name);
+      }
+    }
+    closedir(dir);
+  }
+  std::sort(file_names_.begin(), file_names_.end());
+  ASSERT_FALSE(file_names_.empty());
+}
+
+void DriverStressTest::TearDown() {
+}
+
+std::string DriverStressTest::Solve(const std::string& file_name, bool use_unsigned_integers, int num_of_count_threads) {
+  std::ifstream in(file_name);
+  Driver driver;
+  driver.set_option(use_unsigned_integers ? Option::Name::USE_UNSIGNED_INTEGERS : Option::Name::USE_SIGNED_INTEGERS);
+  driver.set_option(Option::Name::COUNT_THREADS, num_of_count_threads);
+  driver.Parse(&in);
+  driver.InitializeSolver();
+  driver.Solve();
+  if (not driver.is_sat()) {
+    return "unsat";
+  }
+  std::stringstream result;
+  result << "sat " << driver.CountStrs(10) << " " << driver.CountInts(4);
+  return result.str();
+}
+
+/**
+ * Each thread solves all constraints in its own order with its own option values,
+ * results must be the same as solving them one by one
+ */
+TEST_F(DriverStressTest, ParallelDriversMatchSequentialResults) {
+  std::vector<std::string> expected_signed, expected_unsigned;
+  for (auto& file_name : file_names_) {
+    expected_signed.push_back(Solve(file_name, false));
+    expected_unsigned.push_back(Solve(file_name, true));
+  }
+
+  const unsigned num_threads = std::max(4u, std::thread::hardware_concurrency());
+  std::vector<std::vector<std::string>> results(num_threads, std::vector<std::string>(file_names_.size()));
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < num_threads; ++t) {
+    threads.push_back(std::thread([this, t, &results]() {
+      for (std::size_t i = 0; i < file_names_.size(); ++i) {
+        std::size_t index = (i + t) % file_names_.size();
+        results[t][index] = Solve(file_names_[index], t % 2 == 1);
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (unsigned t = 0; t < num_threads; ++t) {
+    for (std::size_t i = 0; i < file_names_.size(); ++i) {
+      EXPECT_EQ((t % 2 == 1) ? expected_unsigned[i] : expected_signed[i], results[t][i])
+          << "thread " << t << " " << file_names_[i];
+    }
+  }
+}
+
+/**
+ * Components counted on separate threads must give the same counts as counting them one by one
+ */
+TEST_F(DriverStressTest, ParallelCountingMatchesSequentialCounting) {
+  for (auto& file_name : file_names_) {
+    EXPECT_EQ(Solve(file_name, false), Solve(file_name, false, 4)) << file_name;
+    EXPECT_EQ(Solve(file_name, false), Solve(file_name, false, 0)) << file_name;
+  }
+}
+
+/**
+ * A batch with every constraint twice must give the results of solving them one by one
+ */
+TEST_F(DriverStressTest, BatchMatchesSingleQueries) {
+  std::vector<std::string> constraints;
+  for (auto& file_name : file_names_) {
+    std::ifstream in(file_name);
+    std::stringstream constraint;
+    constraint << in.rdbuf();
+    constraints.push_back(constraint.str());
+  }
+  const std::size_t num_of_files = constraints.size();
+  constraints.insert(constraints.end(), constraints.begin(), constraints.begin() + num_of_files);
+
+  Driver driver;
+  auto results = driver.SolveBatch(constraints, {4}, {10});
+  ASSERT_EQ(constraints.size(), results.size());
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    std::stringstream result;
+    if (results[i].is_sat) {
+      ASSERT_EQ(1u, results[i].int_counts.size());
+      ASSERT_EQ(1u, results[i].str_counts.size());
+      result << "sat " << results[i].str_counts[0] << " " << results[i].int_counts[0];
+    } else {
+      result << "unsat";
+    }
+    EXPECT_EQ(Solve(file_names_[i % num_of_files], false), result.str()) << file_names_[i % num_of_files];
+  }
+}
+
+} /* namespace Test */
+} /* namespace Vlab */
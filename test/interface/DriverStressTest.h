@@ -0,0 +1,50 @@
+/*
+ * DriverStressTest.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef INTERFACE_DRIVERSTRESSTEST_H_
+#define INTERFACE_DRIVERSTRESSTEST_H_
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "interface/Driver.h"
+
+#ifndef ABC_TEST_JPF_DIR
+#define ABC_TEST_JPF_DIR "test/jpf"
+#endif
+
+namespace Vlab {
+namespace Test {
+
+class DriverStressTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Solves a constraint file with a new driver
+   * @param file_name
+   * @param use_unsigned_integers
+   * @param num_of_count_threads
+   * @return satisfiability result followed by the string and integer counts
+   */
+  static std::string Solve(const std::string& file_name, bool use_unsigned_integers, int num_of_count_threads = 1);
+
+  /**
+   * Constraint files of the jpf benchmark
+   */
+  std::vector<std::string> file_names_;
+};
+
+} /* namespace Test */
+} /* namespace Vlab */
+
+#endif /* INTERFACE_DRIVERSTRESSTEST_H_ */
@@ -0,0 +1,324 @@
+/*
+ * DriverTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "DriverTest.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+namespace Vlab {
+namespace Test {
+
+using namespace ::testing;
+
+void DriverTest::SetUp() {
+  result_cache_path_ = "driver_result_cache_test_" + std::to_string(getpid()) + ".bin";
+  std::remove(result_cache_path_.c_str());
+}
+
+void DriverTest::TearDown() {
+  std::remove(result_cache_path_.c_str());
+}
+
+std::string DriverTest::Solve(const std::string& constraint, int result_cache_size,
+                              const std::string& result_cache_path) {
+  std::istringstream in(constraint);
+  Driver driver;
+  // setting a cache option replaces the shared cache, files are read again
+  driver.set_option(Option::Name::RESULT_CACHE_PATH, result_cache_path);
+  driver.set_option(Option::Name::RESULT_CACHE_SIZE, result_cache_size);
+  driver.Parse(&in);
+  driver.InitializeSolver();
+  driver.Solve();
+  if (not driver.is_sat()) {
+    return "unsat";
+  }
+  std::stringstream result;
+  result << "sat " << driver.CountStrs(3) << " " << driver.CountInts(3);
+  return result.str();
+}
+
+/**
+ * Constraints that differ only in a string literal must not share a cached result
+ */
+TEST_F(DriverTest, ResultCacheKeepsStringLiterals) {
+  const std::string sat_constraint =
+      "(declare-fun x () String)\n"
+      "(assert (= x \"5\"))\n"
+      "(assert (= (str.to.int x) 5))\n"
+      "(check-sat)\n";
+  const std::string unsat_constraint =
+      "(declare-fun x () String)\n"
+      "(assert (= x \"7\"))\n"
+      "(assert (= (str.to.int x) 5))\n"
+      "(check-sat)\n";
+  const std::string expected_sat = Solve(sat_constraint);
+  ASSERT_NE("unsat", expected_sat);
+  ASSERT_EQ("unsat", Solve(unsat_constraint));
+
+  EXPECT_EQ(expected_sat, Solve(sat_constraint, 16));
+  EXPECT_EQ("unsat", Solve(unsat_constraint, 16));
+  EXPECT_EQ(expected_sat, Solve(sat_constraint, 16));
+}
+
+/**
+ * Characters of regex ranges are kept in the key
+ */
+TEST_F(DriverTest, ResultCacheKeepsRegexLiterals) {
+  const std::string sat_constraint =
+      "(declare-fun x () String)\n"
+      "(assert (str.in.re x (re.range \"a\" \"c\")))\n"
+      "(assert (= x \"b\"))\n"
+      "(check-sat)\n";
+  const std::string unsat_constraint =
+      "(declare-fun x () String)\n"
+      "(assert (str.in.re x (re.range \"a\" \"c\")))\n"
+      "(assert (= x \"z\"))\n"
+      "(check-sat)\n";
+  const std::string expected_sat = Solve(sat_constraint);
+  ASSERT_NE("unsat", expected_sat);
+  ASSERT_EQ("unsat", Solve(unsat_constraint));
+
+  EXPECT_EQ(expected_sat, Solve(sat_constraint, 16));
+  EXPECT_EQ("unsat", Solve(unsat_constraint, 16));
+}
+
+/**
+ * Renamed variables keep their types, an integer equality and a string equality have different counts
+ */
+TEST_F(DriverTest, ResultCacheKeepsVariableTypes) {
+  const std::string declarations =
+      "(declare-fun i () Int)\n"
+      "(declare-fun j () Int)\n"
+      "(declare-fun s () String)\n"
+      "(declare-fun t () String)\n";
+  const std::string int_constraint = declarations + "(assert (= i j))\n(check-sat)\n";
+  const std::string string_constraint = declarations + "(assert (= s t))\n(check-sat)\n";
+  const std::string expected_int = Solve(int_constraint);
+  const std::string expected_string = Solve(string_constraint);
+  ASSERT_NE(expected_int, expected_string);
+
+  EXPECT_EQ(expected_int, Solve(int_constraint, 16));
+  EXPECT_EQ(expected_string, Solve(string_constraint, 16));
+}
+
+/**
+ * Results stored in the cache file are read by later caches and their keys are compared in full
+ */
+TEST_F(DriverTest, ResultCacheFileKeepsLiterals) {
+  const std::string sat_constraint =
+      "(declare-fun x () String)\n"
+      "(assert (= x \"5\"))\n"
+      "(assert (= (str.to.int x) 5))\n"
+      "(check-sat)\n";
+  const std::string unsat_constraint =
+      "(declare-fun x () String)\n"
+      "(assert (= x \"7\"))\n"
+      "(assert (= (str.to.int x) 5))\n"
+      "(check-sat)\n";
+  const std::string expected_sat = Solve(sat_constraint);
+
+  EXPECT_EQ(expected_sat, Solve(sat_constraint, 16, result_cache_path_));
+  // each solve opens the file again, hits come from the stored records
+  EXPECT_EQ("unsat", Solve(unsat_constraint, 16, result_cache_path_));
+  EXPECT_EQ(expected_sat, Solve(sat_constraint, 16, result_cache_path_));
+  EXPECT_EQ("unsat", Solve(unsat_constraint, 16, result_cache_path_));
+}
+
+/**
+ * Queries of a batch that differ only in a literal must be solved separately
+ */
+TEST_F(DriverTest, BatchSolvesQueriesThatDifferInLiterals) {
+  const std::string sat_constraint =
+      "(declare-fun x () String)\n"
+      "(assert (= x \"5\"))\n"
+      "(assert (= (str.to.int x) 5))\n"
+      "(check-sat)\n";
+  const std::string unsat_constraint =
+      "(declare-fun x () String)\n"
+      "(assert (= x \"7\"))\n"
+      "(assert (= (str.to.int x) 5))\n"
+      "(check-sat)\n";
+  std::vector<std::string> constraints {sat_constraint, unsat_constraint, sat_constraint, unsat_constraint};
+  for (int result_cache_size : {0, 16}) {
+    Driver driver;
+    driver.set_option(Option::Name::RESULT_CACHE_SIZE, result_cache_size);
+    auto results = driver.SolveBatch(constraints, {3}, {3});
+    ASSERT_EQ(constraints.size(), results.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      EXPECT_EQ(i % 2 == 0, results[i].is_sat) << "query " << i << " cache size " << result_cache_size;
+    }
+    ASSERT_EQ(1u, results[0].str_counts.size());
+    EXPECT_EQ(1, results[0].str_counts[0]);
+    EXPECT_EQ(0, results[1].str_counts[0]);
+  }
+}
+
+/**
+ * Queries that extend earlier queries of a batch are solved on their assertion levels and
+ * have the results of queries solved on their own
+ */
+TEST_F(DriverTest, BatchSolvesExtendedQueriesOnEarlierQueries) {
+  const std::string prefix =
+      "(declare-fun x () String)\n"
+      "(declare-fun i () Int)\n"
+      "(assert (< (str.len x) 3))\n";
+  std::vector<std::string> constraints {
+    prefix + "(check-sat)\n",
+    prefix + "(assert (str.prefixof \"a\" x))\n(check-sat)\n",
+    prefix + "(assert (str.prefixof \"a\" x)) ; same prefix\n(assert (= i 1))\n(check-sat)\n",
+    prefix + "(assert (str.prefixof \"a\" x))\n(assert (= x \"abc\"))\n(check-sat)\n",
+    prefix + "(assert (str.prefixof \"b\" x))\n(check-sat)\n",
+    "(declare-fun x () String)\n(push 1)\n(assert (= x \"b\"))\n(check-sat)\n",
+    prefix + "(assert (str.prefixof \"a\" x))\n(check-sat)\n"
+  };
+  Driver driver;
+  auto results = driver.SolveBatch(constraints, {3}, {3});
+  ASSERT_EQ(constraints.size(), results.size());
+  for (std::size_t i = 0; i < constraints.size(); ++i) {
+    Driver single_query_driver;
+    auto expected = single_query_driver.SolveBatch({constraints[i]}, {3}, {3});
+    EXPECT_EQ(expected[0].is_sat, results[i].is_sat) << "query " << i;
+    EXPECT_EQ(expected[0].int_counts, results[i].int_counts) << "query " << i;
+    EXPECT_EQ(expected[0].str_counts, results[i].str_counts) << "query " << i;
+  }
+  EXPECT_FALSE(results[3].is_sat);
+  EXPECT_TRUE(results[4].is_sat);
+}
+
+/**
+ * Assertions and declarations of a popped level are dropped when a script is initialized
+ */
+TEST_F(DriverTest, ScriptPopDropsAssertionsAndDeclarations) {
+  EXPECT_NE("unsat", Solve(
+      "(declare-fun x () String)\n"
+      "(push 1)\n"
+      "(assert (= x \"a\"))\n"
+      "(assert (= x \"b\"))\n"
+      "(pop 1)\n"
+      "(check-sat)\n"));
+  // the string declaration after the pop replaces the popped int declaration
+  EXPECT_EQ(Solve(
+      "(declare-fun x () String)\n"
+      "(assert (= x \"a\"))\n"
+      "(check-sat)\n"), Solve(
+      "(push 1)\n"
+      "(declare-fun x () Int)\n"
+      "(pop 1)\n"
+      "(declare-fun x () String)\n"
+      "(assert (= x \"a\"))\n"
+      "(check-sat)\n"));
+}
+
+/**
+ * A script is answered at its last check-sat, later commands do not change the result
+ */
+TEST_F(DriverTest, ScriptIsSolvedAtLastCheckSat) {
+  EXPECT_NE("unsat", Solve(
+      "(declare-fun x () String)\n"
+      "(assert (= x \"a\"))\n"
+      "(check-sat)\n"
+      "(assert (= x \"b\"))\n"));
+  EXPECT_NE("unsat", Solve(
+      "(declare-fun x () String)\n"
+      "(push 1)\n"
+      "(assert (= x \"a\"))\n"
+      "(check-sat)\n"
+      "(pop 1)\n"
+      "(assert (= x \"b\"))\n"
+      "(assert (= x \"c\"))\n"));
+  EXPECT_EQ("unsat", Solve(
+      "(declare-fun x () String)\n"
+      "(assert (= x \"a\"))\n"
+      "(check-sat)\n"
+      "(assert (= x \"b\"))\n"
+      "(check-sat)\n"));
+}
+
+TEST_F(DriverTest, IncrementalPushPopCheckSat) {
+  Driver driver;
+  std::istringstream base("(declare-fun x () String)\n(assert (str.in.re x (re.+ (re.range \"a\" \"c\"))))\n");
+  ASSERT_EQ(0, driver.ParseIncremental(&base));
+  EXPECT_TRUE(driver.CheckSat());
+  const auto base_count = driver.CountStrs(3);
+
+  driver.Push();
+  EXPECT_EQ(1u, driver.GetNumOfAssertionLevels());
+  std::istringstream conflict("(assert (= x \"z\"))\n");
+  ASSERT_EQ(0, driver.ParseIncremental(&conflict));
+  EXPECT_FALSE(driver.CheckSat());
+
+  EXPECT_TRUE(driver.Pop());
+  EXPECT_EQ(0u, driver.GetNumOfAssertionLevels());
+  EXPECT_TRUE(driver.CheckSat());
+  EXPECT_EQ(base_count, driver.CountStrs(3));
+
+  driver.Push();
+  std::istringstream prefix("(assert (= x \"ab\"))\n");
+  ASSERT_EQ(0, driver.ParseIncremental(&prefix));
+  EXPECT_TRUE(driver.CheckSat());
+  EXPECT_EQ(1, driver.CountStrs(3));
+}
+
+/**
+ * Declarations of a popped level are dropped with it, a name can be declared again with another sort
+ */
+TEST_F(DriverTest, IncrementalDeclarationsFollowAssertionLevels) {
+  Driver driver;
+  driver.Push();
+  std::istringstream string_declaration("(declare-fun y () String)\n(assert (= y \"a\"))\n");
+  ASSERT_EQ(0, driver.ParseIncremental(&string_declaration));
+  EXPECT_TRUE(driver.CheckSat());
+  EXPECT_TRUE(driver.Pop());
+
+  std::istringstream int_declaration("(declare-fun y () Int)\n(assert (= y 3))\n");
+  ASSERT_EQ(0, driver.ParseIncremental(&int_declaration));
+  EXPECT_TRUE(driver.CheckSat());
+  EXPECT_EQ(1, driver.CountInts(4));
+}
+
+/**
+ * Assertions parsed after a check-sat command are part of the next check
+ */
+TEST_F(DriverTest, IncrementalAssertionsAfterCheckSatCommand) {
+  Driver driver;
+  std::istringstream first("(declare-fun x () String)\n(assert (= x \"a\"))\n(check-sat)\n");
+  ASSERT_EQ(0, driver.ParseIncremental(&first));
+  EXPECT_TRUE(driver.CheckSat());
+  std::istringstream second("(assert (= x \"b\"))\n");
+  ASSERT_EQ(0, driver.ParseIncremental(&second));
+  EXPECT_FALSE(driver.CheckSat());
+}
+
+/**
+ * Popping more levels than pushed is an error that leaves the stack as it is
+ */
+TEST_F(DriverTest, IncrementalOverPopIsAnError) {
+  Driver driver;
+  EXPECT_FALSE(driver.Pop());
+  EXPECT_TRUE(driver.Pop(0));
+
+  driver.Push(2);
+  EXPECT_EQ(2u, driver.GetNumOfAssertionLevels());
+  EXPECT_FALSE(driver.Pop(3));
+  EXPECT_EQ(2u, driver.GetNumOfAssertionLevels());
+  EXPECT_TRUE(driver.Pop(2));
+  EXPECT_EQ(0u, driver.GetNumOfAssertionLevels());
+
+  std::istringstream over_pop("(declare-fun x () String)\n(assert (= x \"a\"))\n(pop 1)\n(assert (= x \"b\"))\n");
+  EXPECT_NE(0, driver.ParseIncremental(&over_pop));
+  // commands before the pop are kept, commands after it are not parsed into the stack
+  EXPECT_TRUE(driver.CheckSat());
+}
+
+} /* namespace Test */
+} /* namespace Vlab */
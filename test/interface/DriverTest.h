@@ -0,0 +1,46 @@
+/*
+ * DriverTest.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef INTERFACE_DRIVERTEST_H_
+#define INTERFACE_DRIVERTEST_H_
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "interface/Driver.h"
+
+namespace Vlab {
+namespace Test {
+
+class DriverTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Solves a constraint with a new driver
+   * @param constraint
+   * @param result_cache_size 0 disables the result cache
+   * @param result_cache_path empty for a memory only cache
+   * @return satisfiability result followed by the string and integer counts
+   */
+  static std::string Solve(const std::string& constraint, int result_cache_size = 0,
+                           const std::string& result_cache_path = "");
+
+  /**
+   * Result cache file of the test, removed after each test
+   */
+  std::string result_cache_path_;
+};
+
+} /* namespace Test */
+} /* namespace Vlab */
+
+#endif /* INTERFACE_DRIVERTEST_H_ */
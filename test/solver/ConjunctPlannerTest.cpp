@@ -0,0 +1,109 @@
+/*
+ * ConjunctPlannerTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "ConjunctPlannerTest.h"
+
+namespace Vlab {
+namespace Test {
+
+using namespace ::testing;
+using namespace Solver;
+
+void ConjunctPlannerTest::SetUp() {
+  order_conjuncts_ = Option::Solver::ORDER_CONJUNCTS;
+  symbol_table_ = new SymbolTable();
+  symbol_table_->add_variable(new SMT::Variable("g", SMT::Variable::Type::BOOL));
+  symbol_table_->push_scope(nullptr);
+  Value true_value(true);
+  symbol_table_->set_value("g", &true_value);
+}
+
+void ConjunctPlannerTest::TearDown() {
+  Option::Solver::ORDER_CONJUNCTS = order_conjuncts_;
+  for (auto& entry : term_values_) {
+    delete entry.first;
+    delete entry.second;
+  }
+  term_values_.clear();
+  delete symbol_table_;
+}
+
+SMT::Term_ptr ConjunctPlannerTest::AddConjunct(ConjunctPlanner& planner, const std::size_t estimated_size, const bool value) {
+  auto term = new SMT::TermConstant(new SMT::Primitive(value ? "true" : "false", SMT::Primitive::Type::BOOL));
+  term_values_[term] = new Value(value);
+  planner.Add(term, "g", estimated_size);
+  return term;
+}
+
+bool ConjunctPlannerTest::Intersect(ConjunctPlanner& planner) {
+  return planner.Intersect([this](SMT::Term_ptr term) {
+    constructed_terms_.push_back(term);
+    return term_values_[term];
+  }, [this](SMT::Term_ptr term) {
+    released_terms_.push_back(term);
+  });
+}
+
+TEST_F(ConjunctPlannerTest, ConstructsSmallestFirst) {
+  Option::Solver::ORDER_CONJUNCTS = true;
+  ConjunctPlanner planner (symbol_table_);
+  auto large_term = AddConjunct(planner, 3, true);
+  auto small_term = AddConjunct(planner, 1, true);
+  auto other_large_term = AddConjunct(planner, 3, true);
+  auto medium_term = AddConjunct(planner, 2, true);
+
+  EXPECT_TRUE(Intersect(planner));
+  // conjuncts of the same size keep their order
+  EXPECT_THAT(constructed_terms_, ElementsAre(small_term, medium_term, large_term, other_large_term));
+  EXPECT_EQ(constructed_terms_, released_terms_);
+  EXPECT_EQ(4u, planner.GetNumOfConjuncts());
+  EXPECT_EQ(4u, planner.GetNumOfConstructedConjuncts());
+  EXPECT_TRUE(symbol_table_->get_value("g")->is_satisfiable());
+}
+
+TEST_F(ConjunctPlannerTest, ConstructsInAddedOrderWithoutOrdering) {
+  Option::Solver::ORDER_CONJUNCTS = false;
+  ConjunctPlanner planner (symbol_table_);
+  auto large_term = AddConjunct(planner, 3, true);
+  auto small_term = AddConjunct(planner, 1, true);
+
+  EXPECT_TRUE(Intersect(planner));
+  EXPECT_THAT(constructed_terms_, ElementsAre(large_term, small_term));
+}
+
+TEST_F(ConjunctPlannerTest, StopsAtFirstEmptyConjunct) {
+  Option::Solver::ORDER_CONJUNCTS = true;
+  ConjunctPlanner planner (symbol_table_);
+  AddConjunct(planner, 3, true);
+  auto empty_term = AddConjunct(planner, 2, false);
+  auto small_term = AddConjunct(planner, 1, true);
+
+  EXPECT_FALSE(Intersect(planner));
+  // the largest conjunct is never constructed
+  EXPECT_THAT(constructed_terms_, ElementsAre(small_term, empty_term));
+  EXPECT_EQ(constructed_terms_, released_terms_);
+  EXPECT_EQ(3u, planner.GetNumOfConjuncts());
+  EXPECT_EQ(2u, planner.GetNumOfConstructedConjuncts());
+}
+
+TEST_F(ConjunctPlannerTest, StopsAtFirstEmptyGroupValue) {
+  Option::Solver::ORDER_CONJUNCTS = true;
+  Value false_value(false);
+  symbol_table_->set_value("g", &false_value);
+  ConjunctPlanner planner (symbol_table_);
+  auto small_term = AddConjunct(planner, 1, true);
+  AddConjunct(planner, 2, true);
+
+  EXPECT_FALSE(Intersect(planner));
+  EXPECT_THAT(constructed_terms_, ElementsAre(small_term));
+  EXPECT_FALSE(symbol_table_->get_value("g")->is_satisfiable());
+}
+
+} /* namespace Test */
+} /* namespace Vlab */
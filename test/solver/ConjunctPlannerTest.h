@@ -0,0 +1,56 @@
+/*
+ * ConjunctPlannerTest.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SOLVER_CONJUNCTPLANNERTEST_H_
+#define SOLVER_CONJUNCTPLANNERTEST_H_
+
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "smt/ast.h"
+#include "solver/ConjunctPlanner.h"
+#include "solver/SymbolTable.h"
+#include "solver/Value.h"
+
+namespace Vlab {
+namespace Test {
+
+class ConjunctPlannerTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Adds a conjunct of group "g" whose value is the given bool constant
+   * @param estimated_size
+   * @param value
+   * @return term of the conjunct
+   */
+  SMT::Term_ptr AddConjunct(Solver::ConjunctPlanner& planner, const std::size_t estimated_size, const bool value);
+
+  /**
+   * Constructs and intersects the conjuncts, recording the order they are constructed in
+   * @param planner
+   * @return result of the intersection
+   */
+  bool Intersect(Solver::ConjunctPlanner& planner);
+
+  Solver::SymbolTable_ptr symbol_table_;
+  std::map<SMT::Term_ptr, Solver::Value_ptr> term_values_;
+  std::vector<SMT::Term_ptr> constructed_terms_;
+  std::vector<SMT::Term_ptr> released_terms_;
+  bool order_conjuncts_;
+};
+
+} /* namespace Test */
+} /* namespace Vlab */
+
+#endif /* SOLVER_CONJUNCTPLANNERTEST_H_ */
@@ -0,0 +1,145 @@
+/*
+ * ResultCacheTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "ResultCacheTest.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace Vlab {
+namespace Test {
+
+using namespace ::testing;
+using namespace Solver;
+
+void ResultCacheTest::SetUp() {
+  file_path_ = "result_cache_test_" + std::to_string(getpid()) + ".bin";
+  std::remove(file_path_.c_str());
+}
+
+void ResultCacheTest::TearDown() {
+  std::remove(file_path_.c_str());
+}
+
+TEST_F(ResultCacheTest, LruEvictsLeastRecentlyUsed) {
+  LruResultCache cache(2);
+  std::string value;
+  cache.Put("a", "1");
+  cache.Put("b", "2");
+  EXPECT_TRUE(cache.Get("a", value));
+  cache.Put("c", "3");
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_FALSE(cache.Get("b", value));
+  EXPECT_TRUE(cache.Get("a", value));
+  EXPECT_EQ("1", value);
+  EXPECT_TRUE(cache.Get("c", value));
+  EXPECT_EQ("3", value);
+}
+
+/**
+ * Keys that differ in a single character, or are prefixes of each other, must not share values
+ */
+TEST_F(ResultCacheTest, FileKeysAreComparedInFull) {
+  std::string value;
+  {
+    FileResultCache cache(file_path_);
+    cache.Put("x=\"5\"", "sat");
+    cache.Put("x=\"7\"", "unsat");
+    EXPECT_TRUE(cache.Get("x=\"5\"", value));
+    EXPECT_EQ("sat", value);
+    EXPECT_TRUE(cache.Get("x=\"7\"", value));
+    EXPECT_EQ("unsat", value);
+    EXPECT_FALSE(cache.Get("x=\"6\"", value));
+    EXPECT_FALSE(cache.Get("x=", value));
+  }
+
+  FileResultCache cache(file_path_);
+  EXPECT_TRUE(cache.Get("x=\"5\"", value));
+  EXPECT_EQ("sat", value);
+  EXPECT_TRUE(cache.Get("x=\"7\"", value));
+  EXPECT_EQ("unsat", value);
+  EXPECT_FALSE(cache.Get("x=\"6\"", value));
+  EXPECT_FALSE(cache.Get("x=\"5\"x", value));
+}
+
+TEST_F(ResultCacheTest, FileLaterRecordShadowsEarlierOne) {
+  std::string value;
+  {
+    FileResultCache cache(file_path_);
+    cache.Put("key", "old");
+    cache.Put("key", "new");
+    EXPECT_TRUE(cache.Get("key", value));
+    EXPECT_EQ("new", value);
+  }
+  FileResultCache cache(file_path_);
+  EXPECT_TRUE(cache.Get("key", value));
+  EXPECT_EQ("new", value);
+}
+
+/**
+ * Records written after the file is mapped are read through a new mapping
+ */
+TEST_F(ResultCacheTest, FileReadsRecordsAppendedAfterMapping) {
+  std::string value;
+  {
+    FileResultCache cache(file_path_);
+    cache.Put("first", "1");
+  }
+  FileResultCache cache(file_path_);
+  cache.Put("second", std::string(10000, 'v'));
+  EXPECT_TRUE(cache.Get("first", value));
+  EXPECT_EQ("1", value);
+  EXPECT_TRUE(cache.Get("second", value));
+  EXPECT_EQ(std::string(10000, 'v'), value);
+}
+
+TEST_F(ResultCacheTest, FileDropsIncompleteRecord) {
+  std::string value;
+  {
+    FileResultCache cache(file_path_);
+    cache.Put("complete", "1");
+  }
+  {
+    std::ofstream out(file_path_, std::ios::binary | std::ios::app);
+    out << "\x08";
+  }
+  {
+    FileResultCache cache(file_path_);
+    EXPECT_TRUE(cache.Get("complete", value));
+    EXPECT_EQ("1", value);
+    cache.Put("appended", "2");
+  }
+  FileResultCache cache(file_path_);
+  EXPECT_TRUE(cache.Get("complete", value));
+  EXPECT_EQ("1", value);
+  EXPECT_TRUE(cache.Get("appended", value));
+  EXPECT_EQ("2", value);
+}
+
+TEST_F(ResultCacheTest, TieredPromotesDiskHits) {
+  std::string value;
+  {
+    FileResultCache cache(file_path_);
+    cache.Put("key", "value");
+  }
+  std::unique_ptr<ResultCache> memory_cache(new LruResultCache(4));
+  auto memory_cache_ptr = static_cast<LruResultCache*>(memory_cache.get());
+  std::unique_ptr<ResultCache> disk_cache(new FileResultCache(file_path_));
+  TieredResultCache cache(std::move(memory_cache), std::move(disk_cache));
+  EXPECT_EQ(0u, memory_cache_ptr->size());
+  EXPECT_TRUE(cache.Get("key", value));
+  EXPECT_EQ("value", value);
+  EXPECT_EQ(1u, memory_cache_ptr->size());
+  EXPECT_FALSE(cache.Get("other", value));
+}
+
+} /* namespace Test */
+} /* namespace Vlab */
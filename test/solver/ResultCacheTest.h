@@ -0,0 +1,36 @@
+/*
+ * ResultCacheTest.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SOLVER_RESULTCACHETEST_H_
+#define SOLVER_RESULTCACHETEST_H_
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "solver/ResultCache.h"
+
+namespace Vlab {
+namespace Test {
+
+class ResultCacheTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Cache file of the test, removed after each test
+   */
+  std::string file_path_;
+};
+
+} /* namespace Test */
+} /* namespace Vlab */
+
+#endif /* SOLVER_RESULTCACHETEST_H_ */
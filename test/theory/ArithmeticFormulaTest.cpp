@@ -18,7 +18,6 @@ class PublicArithmeticFormula : public ArithmeticFormula {
  public:
   using ArithmeticFormula::type_;
   using ArithmeticFormula::constant_;
-  using ArithmeticFormula::variable_coefficient_map_;
 };
 
 using namespace ::testing;
@@ -39,28 +38,27 @@ TEST_F(ArithmeticFormulaTest, EmptyConstructor) {
 TEST_F(ArithmeticFormulaTest, CopyConstructor) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::LT;
-  formula_1.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_1.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_1.constant_ = 3;
 
   PublicArithmeticFormula formula_2(formula_1);
   EXPECT_EQ(formula_1.constant_, formula_2.constant_);
   EXPECT_EQ(formula_1.type_, formula_2.type_);
 
-  EXPECT_THAT(formula_2.variable_coefficient_map_, ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
+  EXPECT_THAT(formula_2.GetVariableCoefficientMap(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
 }
 
 TEST_F(ArithmeticFormulaTest, Str) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::LT;
-  formula_1.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_1.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_1.constant_ = 3;
 
   EXPECT_THAT(formula_1.str(), StrEq(" + x + 2y + z + 3 < 0"));
 
   formula_1.type_ = ArithmeticFormula::Type::GE;
-  formula_1.variable_coefficient_map_["x"] = -1;
-  formula_1.variable_coefficient_map_["y"] = -2;
-  formula_1.set_variable_coefficient("x", -1);
+  formula_1.SetVariableCoefficient("x", -1);
+  formula_1.SetVariableCoefficient("y", -2);
   formula_1.constant_ = 0;
   EXPECT_THAT(formula_1.str(), StrEq(" - x - 2y + z >= 0"));
 
@@ -74,177 +72,179 @@ TEST_F(ArithmeticFormulaTest, Str) {
 
 TEST_F(ArithmeticFormulaTest, SetType) {
   PublicArithmeticFormula formula_1;
-  formula_1.set_type(ArithmeticFormula::Type::LT);
+  formula_1.SetType(ArithmeticFormula::Type::LT);
   EXPECT_EQ(ArithmeticFormula::Type::LT, formula_1.type_);
 }
 
 TEST_F(ArithmeticFormulaTest, GetType) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::GE;
-  EXPECT_EQ(ArithmeticFormula::Type::GE, formula_1.get_type());
+  EXPECT_EQ(ArithmeticFormula::Type::GE, formula_1.GetType());
 }
 
 TEST_F(ArithmeticFormulaTest, GetNumberOfVariables) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::LT;
-  formula_1.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_1.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_1.constant_ = 3;
-  EXPECT_EQ(3, formula_1.get_number_of_variables());
+  EXPECT_EQ(3, formula_1.GetNumberOfVariables());
 }
 
 TEST_F(ArithmeticFormulaTest, GetVariableCoefficient) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::LT;
-  formula_1.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_1.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_1.constant_ = 3;
 
-  EXPECT_EQ(2, formula_1.get_variable_coefficient("y"));
-  EXPECT_DEATH(formula_1.get_variable_coefficient("a"), "");
+  EXPECT_EQ(2, formula_1.GetVariableCoefficient("y"));
+  EXPECT_DEATH(formula_1.GetVariableCoefficient("a"), "");
 }
 
 TEST_F(ArithmeticFormulaTest, SetVariableCoefficient) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::LT;
-  formula_1.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_1.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_1.constant_ = 3;
 
-  formula_1.set_variable_coefficient("x", -1);
-  EXPECT_EQ(-1, formula_1.variable_coefficient_map_["x"]);
-  EXPECT_DEATH(formula_1.set_variable_coefficient("a", 2), "");
+  formula_1.SetVariableCoefficient("x", -1);
+  EXPECT_EQ(-1, formula_1.GetVariableCoefficient("x"));
+  EXPECT_DEATH(formula_1.SetVariableCoefficient("a", 2), "");
 }
 
 TEST_F(ArithmeticFormulaTest, AddVariable) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::LT;
-  formula_1.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_1.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_1.constant_ = 3;
 
-  formula_1.add_variable("a", -4);
-  EXPECT_THAT(formula_1.variable_coefficient_map_, ElementsAre(Pair("a", -4), Pair("x", 1), Pair("y", 2), Pair("z", 1)));
-  EXPECT_DEATH(formula_1.add_variable("x", 2), "");
+  formula_1.AddVariable("a", -4);
+  EXPECT_THAT(formula_1.GetVariableCoefficientMap(), ElementsAre(Pair("a", -4), Pair("x", 1), Pair("y", 2), Pair("z", 1)));
+  EXPECT_DEATH(formula_1.AddVariable("x", 2), "");
 }
 
 TEST_F(ArithmeticFormulaTest, GetCoefficients) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::LT;
-  formula_1.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_1.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_1.constant_ = 3;
 
-  EXPECT_THAT(formula_1.get_coefficients(), ElementsAre(1, 2, 1));
+  EXPECT_THAT(formula_1.GetCoefficients(), ElementsAre(1, 2, 1));
 }
 
 TEST_F(ArithmeticFormulaTest, GetConstant) {
   PublicArithmeticFormula formula_1;
   formula_1.constant_ = 4;
-  EXPECT_EQ(4, formula_1.get_constant());
+  EXPECT_EQ(4, formula_1.GetConstant());
 }
 
 TEST_F(ArithmeticFormulaTest, SetConstant) {
   PublicArithmeticFormula formula_1;
-  formula_1.set_constant(-3);
+  formula_1.SetConstant(-3);
   EXPECT_EQ(-3, formula_1.constant_);
 }
 
 TEST_F(ArithmeticFormulaTest, IsConstant) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::LT;
-  formula_1.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_1.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_1.constant_ = 3;
 
-  EXPECT_FALSE(formula_1.is_constant());
-  formula_1.variable_coefficient_map_ = {{"x", 0}, {"y", 0}, {"z", 0}};
-  EXPECT_TRUE(formula_1.is_constant());
+  EXPECT_FALSE(formula_1.IsConstant());
+  formula_1.SetVariableCoefficientMap({{"x", 0}, {"y", 0}, {"z", 0}});
+  EXPECT_TRUE(formula_1.IsConstant());
 }
 
 TEST_F(ArithmeticFormulaTest, ResetCoefficients) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::LT;
-  formula_1.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_1.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_1.constant_ = 3;
 
-  formula_1.reset_coefficients();
-  EXPECT_THAT(formula_1.variable_coefficient_map_, ElementsAre(Pair("x", 0), Pair("y", 0), Pair("z", 0)));
+  formula_1.ResetCoefficients();
+  EXPECT_THAT(formula_1.GetVariableCoefficientMap(), ElementsAre(Pair("x", 0), Pair("y", 0), Pair("z", 0)));
   EXPECT_EQ(3, formula_1.constant_);
-  formula_1.reset_coefficients(2);
-  EXPECT_THAT(formula_1.variable_coefficient_map_, ElementsAre(Pair("x", 2), Pair("y", 2), Pair("z", 2)));
+  formula_1.ResetCoefficients(2);
+  EXPECT_THAT(formula_1.GetVariableCoefficientMap(), ElementsAre(Pair("x", 2), Pair("y", 2), Pair("z", 2)));
 }
 
 TEST_F(ArithmeticFormulaTest, GetVariableIndex) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::LT;
-  formula_1.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_1.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_1.constant_ = 3;
 
-  EXPECT_EQ(0, formula_1.get_variable_index("x"));
-  EXPECT_EQ(1, formula_1.get_variable_index("y"));
-  EXPECT_EQ(2, formula_1.get_variable_index("z"));
-  formula_1.variable_coefficient_map_["a"] = 1;
-  EXPECT_EQ(0, formula_1.get_variable_index("a"));
-  EXPECT_EQ(1, formula_1.get_variable_index("x"));
-  EXPECT_EQ(2, formula_1.get_variable_index("y"));
-  EXPECT_EQ(3, formula_1.get_variable_index("z"));
+  EXPECT_EQ(0, formula_1.GetVariableIndex("x"));
+  EXPECT_EQ(1, formula_1.GetVariableIndex("y"));
+  EXPECT_EQ(2, formula_1.GetVariableIndex("z"));
+  formula_1.AddVariable("a", 1);
+  EXPECT_EQ(0, formula_1.GetVariableIndex("a"));
+  EXPECT_EQ(1, formula_1.GetVariableIndex("x"));
+  EXPECT_EQ(2, formula_1.GetVariableIndex("y"));
+  EXPECT_EQ(3, formula_1.GetVariableIndex("z"));
 }
 
 TEST_F(ArithmeticFormulaTest, Add) {
   PublicArithmeticFormula formula_0;
-  formula_0.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_0.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_0.constant_ = 0;
   PublicArithmeticFormula formula_1;
-  formula_1.variable_coefficient_map_ = {{"x", -1}, {"y", -2}, {"z", -3}};
+  formula_1.SetVariableCoefficientMap({{"x", -1}, {"y", -2}, {"z", -3}});
   formula_1.constant_ = 5;
   PublicArithmeticFormula formula_2;
-  formula_2.variable_coefficient_map_= {{"a", -1}, {"y", 1}, {"b", 3}, {"z", 5}, {"c", 7}};
+  formula_2.SetVariableCoefficientMap({{"a", -1}, {"y", 1}, {"b", 3}, {"z", 5}, {"c", 7}});
   formula_2.constant_ = -3;
 
   auto result = formula_0.Add(&formula_1);
   PublicArithmeticFormula* presult = static_cast<PublicArithmeticFormula*>(result);
 
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("x", 0), Pair("y", 0), Pair("z", -2)));
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("x", 0), Pair("y", 0), Pair("z", -2)));
   EXPECT_EQ(5, presult->constant_);
   delete result;
 
   result = formula_0.Add(&formula_2);
+  presult = static_cast<PublicArithmeticFormula*>(result);
 
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("a", -1), Pair("b", 3), Pair("c", 7), Pair("x", 1), Pair("y", 3), Pair("z", 6)));
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("a", -1), Pair("b", 3), Pair("c", 7), Pair("x", 1), Pair("y", 3), Pair("z", 6)));
   EXPECT_EQ(-3, presult->constant_);
   delete result;
 }
 
 TEST_F(ArithmeticFormulaTest, Substract) {
   PublicArithmeticFormula formula_0;
-  formula_0.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_0.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_0.constant_ = 0;
   PublicArithmeticFormula formula_1;
-  formula_1.variable_coefficient_map_ = {{"x", -1}, {"y", -2}, {"z", -3}};
+  formula_1.SetVariableCoefficientMap({{"x", -1}, {"y", -2}, {"z", -3}});
   formula_1.constant_ = 5;
   PublicArithmeticFormula formula_2;
-  formula_2.variable_coefficient_map_= {{"a", -1}, {"y", 1}, {"b", 3}, {"z", 5}, {"c", 7}};
+  formula_2.SetVariableCoefficientMap({{"a", -1}, {"y", 1}, {"b", 3}, {"z", 5}, {"c", 7}});
   formula_2.constant_ = -3;
 
   auto result = formula_0.Subtract(&formula_1);
   PublicArithmeticFormula* presult = static_cast<PublicArithmeticFormula*>(result);
 
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("x", 2), Pair("y", 4), Pair("z", 4)));
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("x", 2), Pair("y", 4), Pair("z", 4)));
   EXPECT_EQ(-5, presult->constant_);
   delete result;
 
   result = formula_0.Subtract(&formula_2);
+  presult = static_cast<PublicArithmeticFormula*>(result);
 
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("a", 1), Pair("b", -3), Pair("c", -7), Pair("x", 1), Pair("y", 1), Pair("z", -4)));
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("a", 1), Pair("b", -3), Pair("c", -7), Pair("x", 1), Pair("y", 1), Pair("z", -4)));
   EXPECT_EQ(3, presult->constant_);
   delete result;
 }
 
 TEST_F(ArithmeticFormulaTest, Multiply) {
   PublicArithmeticFormula formula_0;
-  formula_0.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_0.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_0.constant_ = 5;
   formula_0.type_ = ArithmeticFormula::Type::EQ;
 
   auto result = formula_0.Multiply(-2);
   PublicArithmeticFormula* presult = static_cast<PublicArithmeticFormula*>(result);
 
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("x", -2), Pair("y", -4), Pair("z", -2)));
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("x", -2), Pair("y", -4), Pair("z", -2)));
   EXPECT_EQ(-10, presult->constant_);
   EXPECT_EQ(ArithmeticFormula::Type::EQ, presult->type_);
   delete result;
@@ -252,49 +252,54 @@ TEST_F(ArithmeticFormulaTest, Multiply) {
 
 TEST_F(ArithmeticFormulaTest, negate) {
   PublicArithmeticFormula formula_0;
-  formula_0.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_0.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_0.constant_ = 5;
   formula_0.type_ = ArithmeticFormula::Type::EQ;
 
   auto result = formula_0.negate();
   PublicArithmeticFormula* presult = static_cast<PublicArithmeticFormula*>(result);
 
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
   EXPECT_EQ(5, presult->constant_);
   EXPECT_EQ(ArithmeticFormula::Type::NOTEQ, presult->type_);
   delete result;
 
   formula_0.type_ = ArithmeticFormula::Type::NOTEQ;
   result = formula_0.negate();
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
+  presult = static_cast<PublicArithmeticFormula*>(result);
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
   EXPECT_EQ(5, presult->constant_);
   EXPECT_EQ(ArithmeticFormula::Type::EQ, presult->type_);
   delete result;
 
   formula_0.type_ = ArithmeticFormula::Type::GT;
   result = formula_0.negate();
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
+  presult = static_cast<PublicArithmeticFormula*>(result);
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
   EXPECT_EQ(5, presult->constant_);
   EXPECT_EQ(ArithmeticFormula::Type::LE, presult->type_);
   delete result;
 
   formula_0.type_ = ArithmeticFormula::Type::GE;
   result = formula_0.negate();
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
+  presult = static_cast<PublicArithmeticFormula*>(result);
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
   EXPECT_EQ(5, presult->constant_);
   EXPECT_EQ(ArithmeticFormula::Type::LT, presult->type_);
   delete result;
 
   formula_0.type_ = ArithmeticFormula::Type::LT;
   result = formula_0.negate();
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
+  presult = static_cast<PublicArithmeticFormula*>(result);
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
   EXPECT_EQ(5, presult->constant_);
   EXPECT_EQ(ArithmeticFormula::Type::GE, presult->type_);
   delete result;
 
   formula_0.type_ = ArithmeticFormula::Type::LE;
   result = formula_0.negate();
-  EXPECT_THAT(presult->variable_coefficient_map_, ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
+  presult = static_cast<PublicArithmeticFormula*>(result);
+  EXPECT_THAT(presult->GetVariableCoefficientMap(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 1)));
   EXPECT_EQ(5, presult->constant_);
   EXPECT_EQ(ArithmeticFormula::Type::GT, presult->type_);
   delete result;
@@ -302,45 +307,45 @@ TEST_F(ArithmeticFormulaTest, negate) {
 
 TEST_F(ArithmeticFormulaTest, Simplify) {
   PublicArithmeticFormula formula_0;
-  formula_0.variable_coefficient_map_ = {{"x", 2}, {"y", 4}, {"z", 6}};
+  formula_0.SetVariableCoefficientMap({{"x", 2}, {"y", 4}, {"z", 6}});
   formula_0.constant_ = 5;
   formula_0.type_ = ArithmeticFormula::Type::LT;
 
   EXPECT_TRUE(formula_0.Simplify());
-  EXPECT_THAT(formula_0.variable_coefficient_map_, ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 3)));
+  EXPECT_THAT(formula_0.GetVariableCoefficientMap(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 3)));
   EXPECT_EQ(2, formula_0.constant_);
 
   PublicArithmeticFormula formula_1;
-  formula_1.variable_coefficient_map_ = {{"x", 2}, {"y", 4}, {"z", 6}};
+  formula_1.SetVariableCoefficientMap({{"x", 2}, {"y", 4}, {"z", 6}});
   formula_1.constant_ = 5;
   formula_1.type_ = ArithmeticFormula::Type::EQ;
 
   EXPECT_FALSE(formula_1.Simplify());
-  EXPECT_THAT(formula_1.variable_coefficient_map_, ElementsAre(Pair("x", 2), Pair("y", 4), Pair("z", 6)));
+  EXPECT_THAT(formula_1.GetVariableCoefficientMap(), ElementsAre(Pair("x", 2), Pair("y", 4), Pair("z", 6)));
   EXPECT_EQ(5, formula_1.constant_);
 
   PublicArithmeticFormula formula_2;
-  formula_2.variable_coefficient_map_ = {{"x", 2}, {"y", 4}, {"z", 6}};
+  formula_2.SetVariableCoefficientMap({{"x", 2}, {"y", 4}, {"z", 6}});
   formula_2.constant_ = -5;
   formula_2.type_ = ArithmeticFormula::Type::LT;
 
   EXPECT_TRUE(formula_2.Simplify());
-  EXPECT_THAT(formula_2.variable_coefficient_map_, ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 3)));
+  EXPECT_THAT(formula_2.GetVariableCoefficientMap(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 3)));
   EXPECT_EQ(-3, formula_2.constant_);
 
   PublicArithmeticFormula formula_3;
-  formula_3.variable_coefficient_map_ = {{"x", 2}};
+  formula_3.SetVariableCoefficientMap({{"x", 2}});
   formula_3.constant_ = 3;
   formula_3.type_ = ArithmeticFormula::Type::LT;
 
   EXPECT_TRUE(formula_3.Simplify());
-  EXPECT_THAT(formula_3.variable_coefficient_map_, ElementsAre(Pair("x", 1)));
+  EXPECT_THAT(formula_3.GetVariableCoefficientMap(), ElementsAre(Pair("x", 1)));
   EXPECT_EQ(1, formula_3.constant_);
 }
 
 TEST_F(ArithmeticFormulaTest, CountOnes) {
   PublicArithmeticFormula formula_0;
-  formula_0.variable_coefficient_map_ = {{"x", 1}, {"y", 2}, {"z", 3}};
+  formula_0.SetVariableCoefficientMap({{"x", 1}, {"y", 2}, {"z", 3}});
   formula_0.constant_ = 5;
   formula_0.type_ = ArithmeticFormula::Type::LT;
 
@@ -349,9 +354,9 @@ TEST_F(ArithmeticFormulaTest, CountOnes) {
   EXPECT_EQ(3, formula_0.CountOnes(3));
   EXPECT_EQ(4, formula_0.CountOnes(5));
 
-  formula_0.variable_coefficient_map_["xx"] = 0;
-  formula_0.variable_coefficient_map_["yy"] = 0;
-  formula_0.variable_coefficient_map_["zz"] = 0;
+  formula_0.AddVariable("xx", 0);
+  formula_0.AddVariable("yy", 0);
+  formula_0.AddVariable("zz", 0);
 
   EXPECT_EQ(6, formula_0.CountOnes(15));
   EXPECT_EQ(6, formula_0.CountOnes(7));
@@ -361,19 +366,43 @@ TEST_F(ArithmeticFormulaTest, CountOnes) {
 
 TEST_F(ArithmeticFormulaTest, MergeVariables) {
   PublicArithmeticFormula formula_0;
-  formula_0.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_0.SetVariableCoefficientMap(variable_coefficient_map_);
   formula_0.constant_ = 5;
   formula_0.type_ = ArithmeticFormula::Type::INTERSECT;
 
   PublicArithmeticFormula formula_1;
-  formula_1.variable_coefficient_map_ = {{"a", 3}, {"x", 9}, {"zz", 5}};
+  formula_1.SetVariableCoefficientMap({{"a", 3}, {"x", 9}, {"zz", 5}});
   formula_1.type_ = ArithmeticFormula::Type::EQ;
 
-  formula_0.merge_variables(&formula_1);
-  EXPECT_THAT(formula_0.variable_coefficient_map_, ElementsAre(Pair("a", 0), Pair("x", 1), Pair("y", 2), Pair("z", 1), Pair("zz", 0)));
-  formula_1.merge_variables(&formula_0);
-  EXPECT_THAT(formula_1.variable_coefficient_map_, ElementsAre(Pair("a", 3), Pair("x", 9), Pair("y", 0), Pair("z", 0), Pair("zz", 5)));
+  formula_0.MergeVariables(&formula_1);
+  EXPECT_THAT(formula_0.GetVariableCoefficientMap(), ElementsAre(Pair("a", 0), Pair("x", 1), Pair("y", 2), Pair("z", 1), Pair("zz", 0)));
+  formula_1.MergeVariables(&formula_0);
+  EXPECT_THAT(formula_1.GetVariableCoefficientMap(), ElementsAre(Pair("a", 3), Pair("x", 9), Pair("y", 0), Pair("z", 0), Pair("zz", 5)));
+  EXPECT_EQ(&formula_0.GetVariables(), &formula_1.GetVariables());
+}
 
+TEST_F(ArithmeticFormulaTest, SharedVariableLayout) {
+  PublicArithmeticFormula formula_0;
+  formula_0.SetVariableCoefficientMap(variable_coefficient_map_);
+
+  PublicArithmeticFormula formula_1(formula_0);
+  EXPECT_EQ(&formula_0.GetVariables(), &formula_1.GetVariables());
+
+  formula_1.SetVariableCoefficient("y", 5);
+  EXPECT_EQ(&formula_0.GetVariables(), &formula_1.GetVariables());
+  EXPECT_EQ(2, formula_0.GetVariableCoefficient("y"));
+
+  formula_1.AddVariable("a", 3);
+  EXPECT_NE(&formula_0.GetVariables(), &formula_1.GetVariables());
+  EXPECT_THAT(formula_0.GetVariables(), ElementsAre("x", "y", "z"));
+  EXPECT_THAT(formula_1.GetVariables(), ElementsAre("a", "x", "y", "z"));
+  EXPECT_EQ(2, formula_1.GetVariableIndex("y"));
+  EXPECT_THAT(formula_1.GetVariableAtIndex(0), StrEq("a"));
+
+  formula_1.RemoveVariable("x");
+  EXPECT_THAT(formula_1.GetVariableCoefficientMap(), ElementsAre(Pair("a", 3), Pair("y", 5), Pair("z", 1)));
+  EXPECT_FALSE(formula_1.HasVariable("x"));
+  EXPECT_TRUE(formula_0.HasVariable("x"));
 }
 
 
@@ -0,0 +1,444 @@
+/*
+ * AutomatonTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "AutomatonTest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <utility>
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void AutomatonTest::SetUp() {
+}
+
+void AutomatonTest::TearDown() {
+}
+
+TEST_F(AutomatonTest, IntersectDisjointLanguages) {
+  auto left_auto = StringAutomaton::MakeRegexAuto("(ab)*c");
+  auto right_auto = StringAutomaton::MakeRegexAuto("a*b?d");
+  auto intersect_auto = left_auto->Intersect(right_auto);
+  EXPECT_TRUE(intersect_auto->IsEmptyLanguage());
+  EXPECT_EQ(1, intersect_auto->getDFA()->ns);
+  delete left_auto;
+  delete right_auto;
+  delete intersect_auto;
+}
+
+TEST_F(AutomatonTest, IntersectOverlappingLanguages) {
+  auto left_auto = StringAutomaton::MakeRegexAuto("(ab)*c");
+  auto right_auto = StringAutomaton::MakeRegexAuto("a(ba)*bc|c|d");
+  auto expected_auto = StringAutomaton::MakeRegexAuto("(ab)*c");
+  auto intersect_auto = left_auto->Intersect(right_auto);
+  EXPECT_FALSE(intersect_auto->IsEmptyLanguage());
+  EXPECT_TRUE(intersect_auto->IsEqual(expected_auto));
+  delete left_auto;
+  delete right_auto;
+  delete expected_auto;
+  delete intersect_auto;
+}
+
+TEST_F(AutomatonTest, ProfileRecordsOperations) {
+  auto left_auto = StringAutomaton::MakeRegexAuto("(ab)*c");
+  auto right_auto = StringAutomaton::MakeRegexAuto("a(ba)*bc|c|d");
+  Util::Profile profile;
+  {
+    Util::Profiler::ScopedProfile scoped_profile(&profile);
+    auto intersect_auto = left_auto->Intersect(right_auto);
+    auto union_auto = left_auto->Union(right_auto);
+    delete intersect_auto;
+    delete union_auto;
+  }
+  EXPECT_FALSE(Util::Profiler::IsActive());
+
+  auto& operations = profile.GetOperations().GetTimings();
+  ASSERT_EQ(2, operations.size());
+  EXPECT_EQ("intersect", operations[0].name);
+  EXPECT_EQ(1, operations[0].calls);
+  EXPECT_EQ("union", operations[1].name);
+  EXPECT_GT(profile.GetNumOfAutomata(), 2);
+  EXPECT_GE(profile.GetPeakNumOfStates(), right_auto->getDFA()->ns);
+
+  // operations outside of the scope are not recorded
+  auto intersect_auto = left_auto->Intersect(right_auto);
+  EXPECT_EQ(1, profile.GetOperations().GetTimings()[0].calls);
+
+  std::string json = profile.ToJson();
+  EXPECT_THAT(json, HasSubstr("\"operations\": ["));
+  EXPECT_THAT(json, HasSubstr("{\"name\": \"intersect\", \"count\": 1, "));
+  EXPECT_THAT(json, HasSubstr("\"passes\": []"));
+  profile.Clear();
+  EXPECT_EQ(0, profile.GetNumOfAutomata());
+  EXPECT_TRUE(profile.GetOperations().GetTimings().empty());
+  delete left_auto;
+  delete right_auto;
+  delete intersect_auto;
+}
+
+TEST_F(AutomatonTest, CycleQueries) {
+  auto cyclic_auto = StringAutomaton::MakeRegexAuto("(ab)*c");
+  auto acyclic_auto = StringAutomaton::MakeRegexAuto("abc|d");
+  const int cyclic_initial_state = cyclic_auto->getDFA()->s;
+  const int acyclic_initial_state = acyclic_auto->getDFA()->s;
+  EXPECT_TRUE(cyclic_auto->isCyclic());
+  EXPECT_TRUE(cyclic_auto->isInCycle(cyclic_initial_state));
+  EXPECT_TRUE(cyclic_auto->isStateReachableFrom(cyclic_initial_state, cyclic_initial_state));
+  EXPECT_FALSE(acyclic_auto->isCyclic());
+  EXPECT_FALSE(acyclic_auto->isInCycle(acyclic_initial_state));
+  EXPECT_FALSE(acyclic_auto->isStateReachableFrom(acyclic_initial_state, acyclic_initial_state));
+  delete cyclic_auto;
+  delete acyclic_auto;
+}
+
+/**
+ * Reference enumeration: every string over the alphabet of length at most bound that the automaton
+ * accepts, the models that GetModelsWithinBound returned when it ran a BFS from each state.
+ */
+static std::set<std::string> GetAcceptedStrings(StringAutomaton_ptr string_auto, const std::string& alphabet, const int bound) {
+  std::set<std::string> accepted_strings;
+  std::vector<std::string> strings {""};
+  for (int length = 0; length <= bound; ++length) {
+    std::vector<std::string> next_strings;
+    for (auto& value : strings) {
+      auto value_auto = StringAutomaton::MakeString(value);
+      auto intersect_auto = string_auto->Intersect(value_auto);
+      if (not intersect_auto->IsEmptyLanguage()) {
+        accepted_strings.insert(value);
+      }
+      delete value_auto;
+      delete intersect_auto;
+      for (char c : alphabet) {
+        next_strings.push_back(value + c);
+      }
+    }
+    strings = next_strings;
+  }
+  return accepted_strings;
+}
+
+TEST_F(AutomatonTest, ModelsWithinBoundMatchReferenceEnumeration) {
+  for (std::string regex : { "(ab)*c|d", "a(b|c)*", "(a|b)(a|b)?c*", "[a-c]*d" }) {
+    auto string_auto = StringAutomaton::MakeRegexAuto(regex);
+    auto expected_models = GetAcceptedStrings(string_auto, "abcd", 4);
+    string_auto->GetFormula()->AddVariable("x", 1);
+    auto models = string_auto->GetModelsWithinBound(-1, 4);
+    ASSERT_EQ(1, models.size());
+    EXPECT_EQ(expected_models, std::set<std::string>(models["x"].begin(), models["x"].end())) << regex;
+    EXPECT_EQ(expected_models.size(), models["x"].size()) << regex;
+
+    auto some_models = string_auto->GetModelsWithinBound(3, 4);
+    ASSERT_EQ(3, some_models["x"].size()) << regex;
+    for (auto& model : some_models["x"]) {
+      EXPECT_EQ(1, expected_models.count(model)) << regex << " " << model;
+    }
+    delete string_auto;
+  }
+}
+
+TEST_F(AutomatonTest, ForEachModelWithinBoundStreams) {
+  auto string_auto = StringAutomaton::MakeRegexAuto("(ab)*c|d");
+  std::vector<std::string> models;
+  string_auto->ForEachModelWithinBound(5, [&models](const std::string& model) {
+    models.push_back(model);
+    return true;
+  });
+  EXPECT_EQ(std::set<std::string>({ "c", "d", "abc", "ababc" }),
+            std::set<std::string>(models.begin(), models.end()));
+  EXPECT_EQ(4, models.size());
+  delete string_auto;
+
+  // any string of length 64 has 2^512 models, they are never materialized
+  auto any_string_auto = StringAutomaton::MakeRegexAuto(std::string(64, '.'));
+  int num_of_calls = 0;
+  std::string first_model;
+  any_string_auto->ForEachModelWithinBound(64, [&](const std::string& model) {
+    first_model = model;
+    return ++num_of_calls < 2;
+  });
+  EXPECT_EQ(2, num_of_calls);
+  EXPECT_EQ(64, first_model.size());
+  delete any_string_auto;
+}
+
+TEST_F(AutomatonTest, BinaryIntModelsWithinBoundMatchReferenceEnumeration) {
+  auto formula = new ArithmeticFormula();
+  formula->SetType(ArithmeticFormula::Type::LE);
+  formula->AddVariable("x", 1);
+  formula->AddVariable("y", 2);
+  formula->SetConstant(-9);
+  auto binary_auto = BinaryIntAutomaton::MakeAutomaton(formula, true);
+  auto models = binary_auto->GetModelsWithinBound(1000, 5);
+  ASSERT_EQ(2, models.size());
+  ASSERT_EQ(models["x"].size(), models["y"].size());
+
+  std::set<std::pair<int, int>> expected_models;
+  for (int x = 0; x <= 9; ++x) {
+    for (int y = 0; x + 2 * y <= 9; ++y) {
+      expected_models.insert(std::make_pair(x, y));
+    }
+  }
+  std::set<std::pair<int, int>> actual_models;
+  for (std::size_t i = 0; i < models["x"].size(); ++i) {
+    actual_models.insert(std::make_pair(std::stoi(models["x"][i]), std::stoi(models["y"][i])));
+  }
+  EXPECT_EQ(expected_models, actual_models);
+  EXPECT_EQ(expected_models.size(), models["x"].size());
+  delete binary_auto;
+}
+
+TEST_F(AutomatonTest, ConcatAndCaseConversion) {
+  auto left_auto = StringAutomaton::MakeRegexAuto("(ab)*");
+  auto right_auto = StringAutomaton::MakeRegexAuto("c[A-Z]?");
+  auto concat_auto = left_auto->Concat(right_auto);
+  auto expected_concat_auto = StringAutomaton::MakeRegexAuto("(ab)*c[A-Z]?");
+  EXPECT_TRUE(concat_auto->IsEqual(expected_concat_auto));
+
+  auto lower_case_auto = concat_auto->ToLowerCase();
+  auto expected_lower_case_auto = StringAutomaton::MakeRegexAuto("(ab)*c[a-z]?");
+  EXPECT_TRUE(lower_case_auto->IsEqual(expected_lower_case_auto));
+
+  auto upper_case_auto = concat_auto->ToUpperCase();
+  auto expected_upper_case_auto = StringAutomaton::MakeRegexAuto("(AB)*C[A-Z]?");
+  EXPECT_TRUE(upper_case_auto->IsEqual(expected_upper_case_auto));
+
+  delete left_auto;
+  delete right_auto;
+  delete concat_auto;
+  delete expected_concat_auto;
+  delete lower_case_auto;
+  delete expected_lower_case_auto;
+  delete upper_case_auto;
+  delete expected_upper_case_auto;
+}
+
+/**
+ * Exposes the replace engine of the automaton
+ */
+class ReplaceEngine : public Automaton {
+ public:
+  using Automaton::DFAExtendExtrabit;
+  using Automaton::DFAIntersect;
+  using Automaton::GetBddVariableIndices;
+  using Automaton::dfa_replace_step1_duplicate;
+  using Automaton::dfa_replace_step2_match_compliment;
+  using Automaton::find_sink;
+  using Automaton::getSharp0WithExtraBit;
+  using Automaton::getSharp1WithExtraBit;
+  using Automaton::get_match;
+};
+
+/**
+ * Reference closures: a search from the sharp1 target of every state over linked worklists,
+ * the way the replace engine found them before closures were shared.
+ */
+static std::vector<std::vector<int>> GetMatchByStateSearch(DFA_ptr dfa, const int var) {
+  const int sink = ReplaceEngine::find_sink(dfa);
+  char* sharp1 = ReplaceEngine::getSharp1WithExtraBit(var);
+  char* sharp0 = ReplaceEngine::getSharp0WithExtraBit(var);
+  auto is_on_path = [var](trace_descr trace, const char* symbol) {
+    for (int j = 0; j < var + 1; j++) {
+      trace_descr tp = trace;
+      while (tp and (int) tp->index != j) {
+        tp = tp->next;
+      }
+      if (tp and symbol[j] != (tp->value ? '1' : '0')) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  std::vector<std::vector<int>> closures(dfa->ns);
+  for (int i = 0; i < dfa->ns; i++) {
+    if (i == sink) {
+      continue;
+    }
+    int next = -1;
+    paths state_paths = make_paths(dfa->bddm, dfa->q[i]);
+    for (paths pp = state_paths; pp and next < 0; pp = pp->next) {
+      if ((int) pp->to != sink and is_on_path(pp->trace, sharp1)) {
+        next = pp->to;
+      }
+    }
+    kill_paths(state_paths);
+    if (next < 0) {
+      continue;
+    }
+
+    // pending states are not enqueued twice
+    std::vector<int> worklist { next };
+    std::vector<bool> is_visited(dfa->ns, false);
+    while (not worklist.empty()) {
+      const int current = worklist.front();
+      worklist.erase(worklist.begin());
+      is_visited[current] = true;
+      state_paths = make_paths(dfa->bddm, dfa->q[current]);
+      for (paths pp = state_paths; pp; pp = pp->next) {
+        const int to = pp->to;
+        if (to == sink) {
+          continue;
+        }
+        const bool is_sharp0 = is_on_path(pp->trace, sharp0);
+        if (is_sharp0 and std::find(closures[i].begin(), closures[i].end(), to) == closures[i].end()) {
+          closures[i].push_back(to);
+        }
+        trace_descr tp = pp->trace;
+        while (tp and (int) tp->index != var) {
+          tp = tp->next;
+        }
+        if ((tp == nullptr or tp->value) and not is_visited[to] and not is_sharp0
+            and std::find(worklist.begin(), worklist.end(), to) == worklist.end()) {
+          worklist.push_back(to);
+        }
+      }
+      kill_paths(state_paths);
+    }
+  }
+  free(sharp1);
+  free(sharp0);
+  return closures;
+}
+
+TEST_F(AutomatonTest, MatchClosuresEqualPerStateSearch) {
+  const std::vector<std::pair<std::string, std::string>> cases {
+    { ".*", "<" },
+    { "(<[a-z]+>[a-z ]*</[a-z]+>)*", "<" },
+    { ".*(select|union|drop).*", "(select|union|drop)" },
+    { "(&[a-z]+;|[a-z0-9 ])*", "&" },
+    { "(ab)*c", "b*" },
+  };
+  // replace extends the 8 bit alphabet with an extra bit and runs the engine on one more
+  const int var = 8;
+  const int engine_var = var + 1;
+  // indices are cached by the automaton, not owned
+  int* indices = ReplaceEngine::GetBddVariableIndices(engine_var + 1);
+  int num_of_closures = 0;
+  for (auto& replace_case : cases) {
+    auto subject_auto = StringAutomaton::MakeRegexAuto(replace_case.first);
+    auto search_auto = StringAutomaton::MakeRegexAuto(replace_case.second);
+    DFA_ptr subject_dfa = ReplaceEngine::DFAExtendExtrabit(subject_auto->getDFA(), var);
+    DFA_ptr search_dfa = ReplaceEngine::DFAExtendExtrabit(search_auto->getDFA(), var);
+    DFA_ptr duplicate_dfa = ReplaceEngine::dfa_replace_step1_duplicate(subject_dfa, engine_var, indices);
+    DFA_ptr match_dfa = ReplaceEngine::dfa_replace_step2_match_compliment(search_dfa, engine_var, indices);
+    DFA_ptr marked_dfa = ReplaceEngine::DFAIntersect(duplicate_dfa, match_dfa);
+
+    auto closures = ReplaceEngine::get_match(marked_dfa, engine_var, indices);
+    auto expected_closures = GetMatchByStateSearch(marked_dfa, engine_var);
+    ASSERT_EQ(expected_closures.size(), closures.counts.size()) << replace_case.first;
+    for (std::size_t s = 0; s < expected_closures.size(); ++s) {
+      std::vector<int> closure(closures.states.begin() + closures.offsets[s],
+                               closures.states.begin() + closures.offsets[s] + closures.counts[s]);
+      // same states in the same order, the auxiliary bits of the replace edges follow the order
+      EXPECT_EQ(expected_closures[s], closure) << replace_case.first << " state " << s;
+      num_of_closures += (closures.counts[s] > 0) ? 1 : 0;
+    }
+
+    dfaFree(subject_dfa);
+    dfaFree(search_dfa);
+    dfaFree(duplicate_dfa);
+    dfaFree(match_dfa);
+    dfaFree(marked_dfa);
+    delete subject_auto;
+    delete search_auto;
+  }
+  EXPECT_GT(num_of_closures, 0);
+}
+
+TEST_F(AutomatonTest, SaveAndLoadStringAutomaton) {
+  auto string_auto = StringAutomaton::MakeRegexAuto("(ab)*c|d[a-z]+");
+  std::stringstream data;
+  {
+    cereal::BinaryOutputArchive ar(data);
+    string_auto->save(ar);
+  }
+  auto loaded_auto = StringAutomaton::MakePhi();
+  {
+    cereal::BinaryInputArchive ar(data);
+    loaded_auto->load(ar);
+  }
+  EXPECT_EQ(string_auto->getDFA()->ns, loaded_auto->getDFA()->ns);
+  EXPECT_TRUE(loaded_auto->IsEqual(string_auto));
+  EXPECT_EQ(string_auto->Count(6), loaded_auto->Count(6));
+  delete string_auto;
+  delete loaded_auto;
+}
+
+TEST_F(AutomatonTest, SaveAndLoadBinaryIntAutomatonFile) {
+  auto formula = new ArithmeticFormula();
+  formula->SetType(ArithmeticFormula::Type::LE);
+  formula->AddVariable("x", 1);
+  formula->AddVariable("y", 2);
+  formula->SetConstant(-9);
+  auto binary_auto = BinaryIntAutomaton::MakeAutomaton(formula, true);
+  const std::string file_name = "automaton_format_test.bin";
+  binary_auto->SaveToFile(file_name);
+  auto loaded_auto = BinaryIntAutomaton::LoadFromFile(file_name);
+  std::remove(file_name.c_str());
+
+  EXPECT_TRUE(loaded_auto->is_natural_number());
+  EXPECT_EQ(binary_auto->GetFormula()->GetVariableCoefficientMap(), loaded_auto->GetFormula()->GetVariableCoefficientMap());
+  EXPECT_EQ(binary_auto->GetFormula()->GetConstant(), loaded_auto->GetFormula()->GetConstant());
+  EXPECT_TRUE(loaded_auto->IsEqual(binary_auto));
+  delete binary_auto;
+  delete loaded_auto;
+}
+
+/**
+ * Exposes loading a dfa image
+ */
+class ImageAutomaton : public StringAutomaton {
+ public:
+  using StringAutomaton::StringAutomaton;
+  using Automaton::SetDFAImage;
+};
+
+TEST_F(AutomatonTest, RejectsDFAImageWithUnorderedVariables) {
+  // two leaves and two nodes on variable 5, the root tests variable 5 again below itself
+  DFAImage image;
+  image.num_of_states = 2;
+  image.initial_state = 0;
+  image.finals = { 0, 1 };
+  image.nodes = { BDD_LEAF_INDEX, 0, 0, BDD_LEAF_INDEX, 1, 0, 5, 0, 1, 5, 2, 0 };
+  image.roots = { 3, 1 };
+  auto phi_auto = StringAutomaton::MakePhi();
+  ImageAutomaton image_auto (dfaCopy(phi_auto->getDFA()), phi_auto->get_number_of_bdd_variables());
+  EXPECT_DEATH(image_auto.SetDFAImage(image), "invalid dfa image");
+  delete phi_auto;
+}
+
+TEST_F(AutomatonTest, LoadTruncatedStringAutomatonFileThrows) {
+  auto string_auto = StringAutomaton::MakeRegexAuto("(ab)*c|d[a-z]+");
+  const std::string file_name = "automaton_truncated_test.bin";
+  string_auto->SaveToFile(file_name);
+  std::string data;
+  {
+    std::ifstream in(file_name, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream out(file_name, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size() / 2);
+  }
+  EXPECT_THROW(StringAutomaton::LoadFromFile(file_name), cereal::Exception);
+  std::remove(file_name.c_str());
+  delete string_auto;
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
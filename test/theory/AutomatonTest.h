@@ -0,0 +1,33 @@
+/*
+ * AutomatonTest.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef THEORY_AUTOMATONTEST_H_
+#define THEORY_AUTOMATONTEST_H_
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/BinaryIntAutomaton.h"
+#include "theory/StringAutomaton.h"
+#include "utils/Profiler.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class AutomatonTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_AUTOMATONTEST_H_ */
@@ -102,6 +102,50 @@ TEST_F(BinaryIntAutomatonTest, MakePhi) {
   // TODO add an automaton check wrt a expectation
 }
 
+TEST_F(BinaryIntAutomatonTest, SymbolicConstructionMatchesEnumeration) {
+  for (auto type : { ArithmeticFormula::Type::EQ, ArithmeticFormula::Type::NOTEQ, ArithmeticFormula::Type::LT,
+                     ArithmeticFormula::Type::LE, ArithmeticFormula::Type::GT, ArithmeticFormula::Type::GE }) {
+    for (bool is_natural_number : { true, false }) {
+      for (int constant : { -5, -2, 0, 1, 3 }) {
+        auto formula = new ArithmeticFormula();
+        formula->SetType(type);
+        formula->SetConstant(constant);
+        formula->AddVariable("x", 1);
+        formula->AddVariable("y", -1);
+        formula->AddVariable("z", 3);
+
+        Option::Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION = true;
+        auto symbolic_auto = BinaryIntAutomaton::MakeAutomaton(formula->clone(), is_natural_number);
+        Option::Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION = false;
+        auto enumerated_auto = BinaryIntAutomaton::MakeAutomaton(formula->clone(), is_natural_number);
+        EXPECT_TRUE(symbolic_auto->IsEqual(enumerated_auto)) << *formula << " natural: " << is_natural_number;
+        delete symbolic_auto;
+        delete enumerated_auto;
+        delete formula;
+      }
+    }
+  }
+  Option::Theory::USE_SYMBOLIC_ARITHMETIC_CONSTRUCTION = true;
+}
+
+TEST_F(BinaryIntAutomatonTest, SymbolicConstructionManyVariables) {
+  // 2^40 assignments per carry state for the enumerating construction
+  auto formula = new ArithmeticFormula();
+  formula->SetType(ArithmeticFormula::Type::EQ);
+  formula->SetConstant(-7);
+  for (int i = 0; i < 40; ++i) {
+    formula->AddVariable("x" + std::to_string(100 + i), (i % 2 == 0) ? 1 : 2);
+  }
+  auto equality_auto = BinaryIntAutomaton::MakeAutomaton(formula, true);
+  ASSERT_FALSE(equality_auto->IsEmptyLanguage());
+  int sum = 0;
+  for (auto& var_value : equality_auto->GetAnAcceptingIntForEachVar()) {
+    sum += var_value.second * equality_auto->GetFormula()->GetVariableCoefficient(var_value.first);
+  }
+  EXPECT_EQ(7, sum);
+  delete equality_auto;
+}
+
 //TEST_F(BinaryIntAutomatonTest, Complement) {
 //  std::stringstream ss;
 //    std::string expected;
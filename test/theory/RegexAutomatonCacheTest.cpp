@@ -0,0 +1,53 @@
+/*
+ * RegexAutomatonCacheTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "RegexAutomatonCacheTest.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void RegexAutomatonCacheTest::SetUp() {
+}
+
+void RegexAutomatonCacheTest::TearDown() {
+}
+
+std::string RegexAutomatonCacheTest::GetKey(const std::string regex, const int number_of_bdd_variables) {
+  Util::RegularExpression regular_expression(regex);
+  std::unordered_map<Util::RegularExpression_ptr, std::string> keys;
+  return RegexAutomatonCache::GetKey(&regular_expression, number_of_bdd_variables, keys);
+}
+
+TEST_F(RegexAutomatonCacheTest, UnionOperandsAreSorted) {
+  EXPECT_EQ(GetKey("(a|b|c)"), GetKey("(c|(b|a))"));
+  EXPECT_EQ(GetKey("(ab|ab)"), GetKey("ab"));
+  EXPECT_NE(GetKey("(a|b)"), GetKey("(a&b)"));
+}
+
+TEST_F(RegexAutomatonCacheTest, ConcatenatedLiteralsAreMerged) {
+  EXPECT_EQ(GetKey("abc"), GetKey("a(bc)"));
+  EXPECT_EQ(GetKey("a[0-9]+bc"), GetKey("(a[0-9]+)(b)c"));
+  EXPECT_NE(GetKey("ab"), GetKey("ba"));
+}
+
+TEST_F(RegexAutomatonCacheTest, KeysAreUnambiguous) {
+  EXPECT_NE(GetKey("a*"), GetKey("a+"));
+  EXPECT_NE(GetKey("a{2,}"), GetKey("a{2,3}"));
+  EXPECT_NE(GetKey("[a-z]+"), GetKey("[a-y]+"));
+  EXPECT_NE(GetKey("(a|b)c"), GetKey("(a|bc)"));
+  EXPECT_THAT(GetKey("[a-z]+", 8), StrEq("8/+[az"));
+  EXPECT_NE(GetKey("[a-z]+", 8), GetKey("[a-z]+", 9));
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
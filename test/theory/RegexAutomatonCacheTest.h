@@ -0,0 +1,42 @@
+/*
+ * RegexAutomatonCacheTest.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef THEORY_REGEXAUTOMATONCACHETEST_H_
+#define THEORY_REGEXAUTOMATONCACHETEST_H_
+
+#include <string>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/RegexAutomatonCache.h"
+#include "utils/RegularExpression.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class RegexAutomatonCacheTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * @param regex
+   * @param number_of_bdd_variables
+   * @return cache key of the parsed regular expression
+   */
+  static std::string GetKey(const std::string regex, const int number_of_bdd_variables = 8);
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_REGEXAUTOMATONCACHETEST_H_ */
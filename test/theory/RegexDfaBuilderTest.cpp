@@ -0,0 +1,114 @@
+/*
+ * RegexDfaBuilderTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "RegexDfaBuilderTest.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void RegexDfaBuilderTest::SetUp() {
+}
+
+void RegexDfaBuilderTest::TearDown() {
+  Option::Theory::USE_DIRECT_REGEX_CONSTRUCTION = true;
+}
+
+bool RegexDfaBuilderTest::Accepts(const RegexDfaBuilder& dfa_builder, const std::string str) {
+  int state = 0;
+  for (char c : str) {
+    int next_state = dfa_builder.GetSinkState();
+    for (auto& transition : dfa_builder.GetTransitions(state)) {
+      if (transition.first == (unsigned char) c) {
+        next_state = transition.second;
+      }
+    }
+    state = next_state;
+  }
+  return dfa_builder.IsAcceptingState(state);
+}
+
+StringAutomaton_ptr RegexDfaBuilderTest::MakeRegexAuto(const std::string regex, const bool use_direct_construction) {
+  Option::Theory::USE_DIRECT_REGEX_CONSTRUCTION = use_direct_construction;
+  StringAutomaton::GetRegexAutoCache().Clear();
+  return StringAutomaton::MakeRegexAuto(regex);
+}
+
+TEST_F(RegexDfaBuilderTest, IsSupported) {
+  Util::RegularExpression supported("(ab|[0-9]+)*.?");
+  Util::RegularExpression complement("~(ab)");
+  Util::RegularExpression intersection("(a|b)&a");
+  Util::RegularExpression repeat("a{2,3}");
+  EXPECT_TRUE(RegexDfaBuilder::IsSupported(&supported, 8));
+  EXPECT_FALSE(RegexDfaBuilder::IsSupported(&supported, 9));
+  EXPECT_FALSE(RegexDfaBuilder::IsSupported(&complement, 8));
+  EXPECT_FALSE(RegexDfaBuilder::IsSupported(&intersection, 8));
+  EXPECT_FALSE(RegexDfaBuilder::IsSupported(&repeat, 8));
+}
+
+TEST_F(RegexDfaBuilderTest, AlternationSharesPrefixes) {
+  Util::RegularExpression regular_expression("(abc|abd|b)");
+  RegexDfaBuilder dfa_builder(8);
+  ASSERT_TRUE(dfa_builder.Build(&regular_expression, 100));
+  // initial, a, ab, the accepting state shared by all alternatives and the sink state
+  EXPECT_EQ(5, dfa_builder.GetNumOfStates());
+  EXPECT_THAT(dfa_builder.GetTransitions(0), SizeIs(2));
+  EXPECT_TRUE(Accepts(dfa_builder, "abc"));
+  EXPECT_TRUE(Accepts(dfa_builder, "abd"));
+  EXPECT_TRUE(Accepts(dfa_builder, "b"));
+  EXPECT_FALSE(Accepts(dfa_builder, "ab"));
+  EXPECT_FALSE(Accepts(dfa_builder, "abcd"));
+}
+
+TEST_F(RegexDfaBuilderTest, CharacterClassIsOneTransition) {
+  Util::RegularExpression regular_expression("([a-z]|[0-9]|_)");
+  RegexDfaBuilder dfa_builder(8);
+  ASSERT_TRUE(dfa_builder.Build(&regular_expression, 100));
+  auto& transitions = dfa_builder.GetTransitions(0);
+  ASSERT_THAT(transitions, SizeIs(37));
+  for (auto& transition : transitions) {
+    EXPECT_EQ(transitions[0].second, transition.second);
+  }
+}
+
+TEST_F(RegexDfaBuilderTest, Repetitions) {
+  Util::RegularExpression regular_expression("(\\?|;)(ab|c)*d+e?");
+  RegexDfaBuilder dfa_builder(8);
+  ASSERT_TRUE(dfa_builder.Build(&regular_expression, 100));
+  EXPECT_TRUE(Accepts(dfa_builder, "?d"));
+  EXPECT_TRUE(Accepts(dfa_builder, ";abcabddde"));
+  EXPECT_FALSE(Accepts(dfa_builder, ";abcab"));
+  EXPECT_FALSE(Accepts(dfa_builder, ";ad"));
+  EXPECT_FALSE(Accepts(dfa_builder, "?dee"));
+}
+
+TEST_F(RegexDfaBuilderTest, StateLimit) {
+  Util::RegularExpression regular_expression(".*a.........");
+  RegexDfaBuilder dfa_builder(8);
+  EXPECT_FALSE(dfa_builder.Build(&regular_expression, 100));
+  EXPECT_TRUE(dfa_builder.Build(&regular_expression, 1 << 12));
+}
+
+TEST_F(RegexDfaBuilderTest, SameAutomatonAsBinaryConstruction) {
+  for (std::string regex : { "(\\?|;)(a|b|c|d|e|f|g|h|i|j|k|l|m|n)*", "( |\t)*", "(abc|abd|b|[0-9]+)?x",
+                             "(select|insert|update|delete).*(from|into)", "[a-c]*|(ab)+|#" }) {
+    StringAutomaton_ptr direct_auto = MakeRegexAuto(regex, true);
+    StringAutomaton_ptr binary_auto = MakeRegexAuto(regex, false);
+    EXPECT_EQ(binary_auto->getDFA()->ns, direct_auto->getDFA()->ns) << regex;
+    EXPECT_TRUE(direct_auto->IsEqual(binary_auto)) << regex;
+    delete direct_auto;
+    delete binary_auto;
+  }
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
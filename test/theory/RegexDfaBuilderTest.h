@@ -0,0 +1,49 @@
+/*
+ * RegexDfaBuilderTest.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef THEORY_REGEXDFABUILDERTEST_H_
+#define THEORY_REGEXDFABUILDERTEST_H_
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/RegexDfaBuilder.h"
+#include "theory/StringAutomaton.h"
+#include "utils/RegularExpression.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class RegexDfaBuilderTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * @param dfa_builder
+   * @param str
+   * @return true if the table built by the builder accepts the string
+   */
+  static bool Accepts(const RegexDfaBuilder& dfa_builder, const std::string str);
+
+  /**
+   * @param regex
+   * @param use_direct_construction
+   * @return regex automaton built without the regex cache
+   */
+  static StringAutomaton_ptr MakeRegexAuto(const std::string regex, const bool use_direct_construction);
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_REGEXDFABUILDERTEST_H_ */
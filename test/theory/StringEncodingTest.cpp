@@ -0,0 +1,115 @@
+/*
+ * StringEncodingTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "StringEncodingTest.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void StringEncodingTest::SetUp() {
+}
+
+void StringEncodingTest::TearDown() {
+}
+
+TEST_F(StringEncodingTest, Identity) {
+  StringEncoding encoding;
+  EXPECT_TRUE(encoding.IsIdentity());
+  EXPECT_EQ(8, encoding.GetNumOfBddVariables());
+  EXPECT_EQ((unsigned long) 'a', encoding.Encode('a'));
+  EXPECT_EQ('z', encoding.Decode((unsigned long) 'z'));
+  EXPECT_EQ(1UL, encoding.GetWeight('a'));
+}
+
+TEST_F(StringEncodingTest, IntervalClasses) {
+  StringEncoding encoding;
+  encoding.AddString("ab");
+  encoding.AddRange('0', '9');
+  encoding.Compact();
+  // [0, '0'), ['0', '9'], (':', 'a'), 'a', 'b', ('b', 255] and the widest one split twice
+  ASSERT_FALSE(encoding.IsIdentity());
+  EXPECT_EQ(8, encoding.GetAlphabetSize());
+  EXPECT_EQ(3, encoding.GetNumOfBddVariables());
+  EXPECT_EQ(encoding.Encode('0'), encoding.Encode('5'));
+  EXPECT_EQ(encoding.Encode('A'), encoding.Encode('Z'));
+  EXPECT_LT(encoding.Encode('9'), encoding.Encode('A'));
+  EXPECT_LT(encoding.Encode('a'), encoding.Encode('b'));
+  EXPECT_EQ(10UL, encoding.GetWeight(encoding.Encode('0')));
+  EXPECT_EQ(1UL, encoding.GetWeight(encoding.Encode('b')));
+
+  unsigned long total_weight = 0;
+  for (unsigned long code = 0; code < (1UL << encoding.GetNumOfBddVariables()); ++code) {
+    total_weight += encoding.GetWeight(code);
+  }
+  EXPECT_EQ((unsigned long) StringEncoding::ALPHABET_SIZE, total_weight);
+  EXPECT_EQ("ab0", encoding.Decode(encoding.Encode("ab7")));
+}
+
+TEST_F(StringEncodingTest, CodesFillBddVariables) {
+  for (std::string regex : { "a", "(ab|[0-9]+)x.", "~(a.*)", ".*(select|from).*" }) {
+    StringEncoding encoding;
+    Util::RegularExpression regular_expression (regex);
+    encoding.AddRegex(&regular_expression);
+    encoding.Compact();
+    ASSERT_FALSE(encoding.IsIdentity()) << regex;
+    EXPECT_EQ(1 << encoding.GetNumOfBddVariables(), encoding.GetAlphabetSize()) << regex;
+    for (unsigned long code = 0; code < (unsigned long) encoding.GetAlphabetSize(); ++code) {
+      EXPECT_LE(1UL, encoding.GetWeight(code)) << regex;
+      EXPECT_EQ(code, encoding.Encode(encoding.Decode(code))) << regex;
+    }
+  }
+}
+
+TEST_F(StringEncodingTest, CompactFallsBackToIdentity) {
+  StringEncoding encoding;
+  for (int c = 0; c < 200; c += 2) {
+    encoding.AddCharacter((char) c);
+  }
+  encoding.Compact();
+  EXPECT_TRUE(encoding.IsIdentity());
+  EXPECT_EQ((unsigned long) 'c', encoding.Encode('c'));
+}
+
+TEST_F(StringEncodingTest, CountMatchesIdentityEncoding) {
+  for (std::string regex : { "(ab|[0-9]+)x.", "~(a.*)", "[a-f]*b", ".*(select|from).*" }) {
+    StringEncoding encoding;
+    Util::RegularExpression regular_expression (regex);
+    encoding.AddRegex(&regular_expression);
+    encoding.Compact();
+    ASSERT_FALSE(encoding.IsIdentity()) << regex;
+
+    StringAutomaton_ptr compact_auto = StringAutomaton::MakeRegexAuto(regex, encoding);
+    StringAutomaton_ptr regex_auto = StringAutomaton::MakeRegexAuto(regex);
+    EXPECT_EQ(encoding.GetNumOfBddVariables(), compact_auto->get_number_of_bdd_variables()) << regex;
+    auto compact_counter = compact_auto->GetSymbolicCounter(encoding);
+    auto counter = regex_auto->GetSymbolicCounter();
+    for (unsigned long bound : { 0, 1, 3, 6 }) {
+      EXPECT_EQ(counter.Count(bound), compact_counter.Count(bound)) << regex << " " << bound;
+    }
+    delete compact_auto;
+    delete regex_auto;
+  }
+}
+
+TEST_F(StringEncodingTest, MakeString) {
+  StringEncoding encoding;
+  encoding.AddString("select");
+  encoding.Compact();
+  StringAutomaton_ptr string_auto = StringAutomaton::MakeString("select", encoding);
+  EXPECT_EQ(encoding.Decode(string_auto->GetAnAcceptingString()), "select");
+  EXPECT_EQ(1, string_auto->GetSymbolicCounter(encoding).Count(6));
+  delete string_auto;
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,35 @@
+/*
+ * StringEncodingTest.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef THEORY_STRINGENCODINGTEST_H_
+#define THEORY_STRINGENCODINGTEST_H_
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/StringAutomaton.h"
+#include "theory/StringEncoding.h"
+#include "utils/RegularExpression.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class StringEncodingTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_STRINGENCODINGTEST_H_ */
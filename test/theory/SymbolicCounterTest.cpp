@@ -0,0 +1,176 @@
+/*
+ * SymbolicCounterTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "SymbolicCounterTest.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void SymbolicCounterTest::SetUp() {
+  std::vector<Eigen::Triplet<BigInteger>> entries;
+  entries.push_back(Eigen::Triplet<BigInteger>(0, 0, 2));
+  entries.push_back(Eigen::Triplet<BigInteger>(0, 1, 1));
+  entries.push_back(Eigen::Triplet<BigInteger>(1, 1, 1));
+  any_binary_string_matrix_.resize(2, 2);
+  any_binary_string_matrix_.setFromTriplets(entries.begin(), entries.end());
+  any_binary_string_matrix_.makeCompressed();
+
+  entries.clear();
+  entries.push_back(Eigen::Triplet<BigInteger>(0, 1, 1));
+  entries.push_back(Eigen::Triplet<BigInteger>(1, 2, 1));
+  entries.push_back(Eigen::Triplet<BigInteger>(2, 1, 1));
+  entries.push_back(Eigen::Triplet<BigInteger>(0, 3, 1));
+  entries.push_back(Eigen::Triplet<BigInteger>(2, 3, 1));
+  entries.push_back(Eigen::Triplet<BigInteger>(3, 3, 1));
+  unary_even_matrix_.resize(4, 4);
+  unary_even_matrix_.setFromTriplets(entries.begin(), entries.end());
+  unary_even_matrix_.makeCompressed();
+}
+
+void SymbolicCounterTest::TearDown() {
+  Option::Theory::COUNTING_METHOD = Option::CountingMethod::AUTO;
+}
+
+TEST_F(SymbolicCounterTest, CountByIteration) {
+  Option::Theory::COUNTING_METHOD = Option::CountingMethod::ITERATION;
+  SymbolicCounter counter;
+  counter.set_transition_count_matrix(any_binary_string_matrix_);
+  counter.set_initialization_vector(any_binary_string_matrix_.innerVector(1));
+
+  EXPECT_EQ(BigInteger(1), counter.Count(0));
+  EXPECT_EQ(BigInteger(15), counter.Count(3));
+  EXPECT_EQ(BigInteger(7), counter.Count(2));
+}
+
+TEST_F(SymbolicCounterTest, CountbyMatrixMultiplication) {
+  SymbolicCounter counter;
+  counter.set_transition_count_matrix(any_binary_string_matrix_);
+  counter.set_initialization_vector(any_binary_string_matrix_.innerVector(1));
+
+  BigInteger expected = boost::multiprecision::pow(BigInteger(2), 1001) - 1;
+  EXPECT_EQ(expected, counter.CountbyMatrixMultiplication(1000));
+  EXPECT_EQ(BigInteger(31), counter.CountbyMatrixMultiplication(4));
+}
+
+TEST_F(SymbolicCounterTest, CountMethodsAgree) {
+  SymbolicCounter iterating_counter, squaring_counter;
+  iterating_counter.set_transition_count_matrix(any_binary_string_matrix_);
+  iterating_counter.set_initialization_vector(any_binary_string_matrix_.innerVector(1));
+  squaring_counter.set_transition_count_matrix(any_binary_string_matrix_);
+  squaring_counter.set_initialization_vector(any_binary_string_matrix_.innerVector(1));
+
+  for (unsigned long bound : {5ul, 130ul, 64ul, 513ul}) {
+    Option::Theory::COUNTING_METHOD = Option::CountingMethod::ITERATION;
+    auto iteration_result = iterating_counter.Count(bound);
+    Option::Theory::COUNTING_METHOD = Option::CountingMethod::SQUARING;
+    EXPECT_EQ(iteration_result, squaring_counter.Count(bound));
+  }
+}
+
+TEST_F(SymbolicCounterTest, CountMethodsAgreeOnLargeSparseMatrix) {
+  // a sparse dfa count matrix, each state moves to two states and may accept
+  const int num_of_states = 120;
+  std::vector<Eigen::Triplet<BigInteger>> entries;
+  for (int state = 0; state < num_of_states; ++state) {
+    entries.push_back(Eigen::Triplet<BigInteger>(state, (state + 1) % num_of_states, 1));
+    entries.push_back(Eigen::Triplet<BigInteger>(state, (state * 7 + 3) % num_of_states, 2));
+    if (state % 5 == 0) {
+      entries.push_back(Eigen::Triplet<BigInteger>(state, num_of_states, 1));
+    }
+  }
+  entries.push_back(Eigen::Triplet<BigInteger>(num_of_states, num_of_states, 1));
+  Eigen::SparseMatrix<BigInteger> matrix(num_of_states + 1, num_of_states + 1);
+  matrix.setFromTriplets(entries.begin(), entries.end());
+  matrix.makeCompressed();
+
+  SymbolicCounter iterating_counter, squaring_counter;
+  iterating_counter.set_transition_count_matrix(matrix);
+  iterating_counter.set_initialization_vector(matrix.innerVector(num_of_states));
+  squaring_counter.set_transition_count_matrix(matrix);
+  squaring_counter.set_initialization_vector(matrix.innerVector(num_of_states));
+
+  for (unsigned long bound : {1ul, 37ul, 64ul, 255ul}) {
+    Option::Theory::COUNTING_METHOD = Option::CountingMethod::ITERATION;
+    auto iteration_result = iterating_counter.Count(bound);
+    EXPECT_EQ(iteration_result, squaring_counter.CountbyMatrixMultiplication(bound));
+  }
+}
+
+TEST_F(SymbolicCounterTest, CountByRecurrence) {
+  SymbolicCounter counter, iterating_counter;
+  counter.set_transition_count_matrix(any_binary_string_matrix_);
+  counter.set_initialization_vector(any_binary_string_matrix_.innerVector(1));
+  iterating_counter.set_transition_count_matrix(any_binary_string_matrix_);
+  iterating_counter.set_initialization_vector(any_binary_string_matrix_.innerVector(1));
+
+  BigInteger expected = boost::multiprecision::pow(BigInteger(2), 2001) - 1;
+  EXPECT_EQ(expected, counter.CountByRecurrence(2000));
+  EXPECT_EQ(BigInteger(7), counter.CountByRecurrence(2));
+
+  Option::Theory::COUNTING_METHOD = Option::CountingMethod::ITERATION;
+  for (unsigned long bound = 0; bound < 40; ++bound) {
+    EXPECT_EQ(iterating_counter.Count(bound), counter.CountByRecurrence(bound));
+  }
+}
+
+TEST_F(SymbolicCounterTest, CountByModularArithmetic) {
+  SymbolicCounter counter;
+  counter.set_transition_count_matrix(any_binary_string_matrix_);
+  counter.set_initialization_vector(any_binary_string_matrix_.innerVector(1));
+
+  for (unsigned long bound : {0ul, 5ul, 63ul, 64ul, 127ul, 128ul, 700ul}) {
+    EXPECT_EQ(boost::multiprecision::pow(BigInteger(2), bound + 1) - 1, counter.CountByModularArithmetic(bound));
+  }
+}
+
+TEST_F(SymbolicCounterTest, CountRange) {
+  Option::Theory::COUNTING_METHOD = Option::CountingMethod::ITERATION;
+  SymbolicCounter counter;
+  counter.set_transition_count_matrix(any_binary_string_matrix_);
+  counter.set_initialization_vector(any_binary_string_matrix_.innerVector(1));
+
+  std::vector<unsigned long> bounds {10, 3, 0, 10, 64};
+  auto results = counter.CountRange(bounds);
+  ASSERT_EQ(bounds.size(), results.size());
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    EXPECT_EQ(boost::multiprecision::pow(BigInteger(2), bounds[i] + 1) - 1, results[i]);
+  }
+  EXPECT_EQ(64ul, counter.get_bound());
+}
+
+TEST_F(SymbolicCounterTest, CountUnary) {
+  SymbolicCounter counter;
+  counter.set_type(SymbolicCounter::Type::UNARYINT);
+  counter.set_transition_count_matrix(unary_even_matrix_);
+  counter.set_initialization_vector(unary_even_matrix_.innerVector(3));
+
+  EXPECT_EQ(BigInteger(1), counter.Count(0));
+  EXPECT_EQ(BigInteger(4), counter.Count(3));
+  EXPECT_EQ(boost::multiprecision::pow(BigInteger(2), 199), counter.Count(200));
+  EXPECT_EQ(BigInteger(2), counter.GetMinBound(2));
+}
+
+TEST_F(SymbolicCounterTest, CountUnaryExactBound) {
+  unary_even_matrix_.coeffRef(3, 3) = 0;
+  SymbolicCounter counter;
+  counter.set_type(SymbolicCounter::Type::UNARYINT);
+  counter.set_transition_count_matrix(unary_even_matrix_);
+  counter.set_initialization_vector(unary_even_matrix_.innerVector(3));
+
+  // 2^bound - 1 is odd unless bound is 0
+  EXPECT_EQ(BigInteger(1), counter.Count(0));
+  EXPECT_EQ(BigInteger(0), counter.Count(70));
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,46 @@
+/*
+ * SymbolicCounterTest.h
+ *
+ *  Created on: Oct 17, 2026
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved. 
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef THEORY_SYMBOLICCOUNTERTEST_H_
+#define THEORY_SYMBOLICCOUNTERTEST_H_
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/options/Theory.h"
+#include "theory/SymbolicCounter.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class SymbolicCounterTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Count matrix of an automaton accepting any string over a binary alphabet,
+   * state 1 is the artificial accepting state
+   */
+  Eigen::SparseMatrix<BigInteger> any_binary_string_matrix_;
+
+  /**
+   * Count matrix of a unary automaton accepting even numbers, 0 -> 1 -> 2 -> 1,
+   * states 0 and 2 are accepting, state 3 is the artificial accepting state
+   */
+  Eigen::SparseMatrix<BigInteger> unary_even_matrix_;
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_SYMBOLICCOUNTERTEST_H_ */